@@ -0,0 +1,406 @@
+/*
+ * BenchCommon.hpp
+ *
+ *  Created on: 2026/10/18
+ *      Author: Shibasaki
+ *
+ * ベンチマーク共通処理
+ * 計時、統計量、CPU固定、最適化抑止、JSON出力
+ */
+
+#ifndef MYDSP_BENCH_BENCHCOMMON_HPP_
+#define MYDSP_BENCH_BENCHCOMMON_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#if defined(__linux__)
+  #include <sched.h>
+#endif
+
+namespace MyDSPBench
+{
+  using Clock = std::chrono::steady_clock;
+
+  // 計算結果が最適化で消去されないようにする
+  template <class T>
+  inline void DoNotOptimize(const T &value)
+  {
+#if defined(__GNUC__)
+    asm volatile("" : : "m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+  }
+
+  // メモリの内容がコンパイラに既知でないものとして扱わせる
+  inline void ClobberMemory(void)
+  {
+#if defined(__GNUC__)
+    asm volatile("" : : : "memory");
+#endif
+  }
+
+  // 実行スレッドを指定CPUに固定する
+  // cpu < 0 の場合は現在実行中のCPUに固定する
+  // 固定できたCPU番号を返す(失敗時は-1)
+  inline int PinToCpu(int cpu)
+  {
+#if defined(__linux__)
+    if (cpu < 0)
+    {
+      cpu = sched_getcpu();
+      if (cpu < 0)
+      {
+        return -1;
+      }
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return (sched_setaffinity(0, sizeof(set), &set) == 0) ? cpu : -1;
+#else
+    (void)cpu;
+    return -1;
+#endif
+  }
+
+  // 決定的な擬似乱数(xorshift64*)
+  class Random
+  {
+  private:
+    std::uint64_t x;
+
+  public:
+    explicit Random(std::uint64_t seed = 0x9E3779B97F4A7C15ull) : x(seed ? seed : 1) {}
+
+    std::uint64_t NextU64(void)
+    {
+      x ^= x >> 12;
+      x ^= x << 25;
+      x ^= x >> 27;
+      return x * 0x2545F4914F6CDD1Dull;
+    }
+
+    // [lo, hi)の一様乱数
+    double Uniform(double lo, double hi)
+    {
+      return lo + (hi - lo) * (static_cast<double>(NextU64() >> 11) * (1.0 / 9007199254740992.0));
+    }
+  };
+
+  // 統計量
+  struct Summary
+  {
+    double min;
+    double median;
+    double mean;
+    double stddev;
+    double max;
+  };
+
+  inline Summary Summarize(std::vector<double> values)
+  {
+    Summary s{0, 0, 0, 0, 0};
+    if (values.empty())
+    {
+      return s;
+    }
+    std::sort(values.begin(), values.end());
+    const std::size_t n = values.size();
+    s.min = values.front();
+    s.max = values.back();
+    s.median = (n % 2 == 1) ? values[n/2] : 0.5 * (values[n/2-1] + values[n/2]);
+    double sum = 0;
+    for (double v : values)
+    {
+      sum += v;
+    }
+    s.mean = sum / n;
+    double sq = 0;
+    for (double v : values)
+    {
+      sq += (v - s.mean) * (v - s.mean);
+    }
+    s.stddev = (n > 1) ? std::sqrt(sq / (n - 1)) : 0.0;
+    return s;
+  }
+
+  // 計測条件
+  struct Options
+  {
+    double warmup_ms = 50.0;    // 計測前の空回し時間
+    double min_time_ms = 20.0;  // 1回の計測の最低時間
+    int repetitions = 10;       // 計測の繰り返し回数
+    int cpu = -1;               // 固定するCPU(-1: 起動時のCPU)
+    bool pin = true;            // CPUを固定するか
+    std::string filter;         // 名前にこの文字列を含むものだけ実行
+    std::string json_path;      // JSONの出力先(空なら出力しない)
+  };
+
+  // 共通のコマンドライン引数の解釈
+  // 解釈できない引数があればfalseを返す
+  inline bool ParseOptions(int argc, char** argv, Options &opt, std::ostream &err)
+  {
+    for (int i = 1; i < argc; ++i)
+    {
+      const std::string arg = argv[i];
+      auto value = [&](void) -> const char*
+      {
+        return (i + 1 < argc) ? argv[++i] : nullptr;
+      };
+      const char* v = nullptr;
+      if (arg == "--warmup-ms" && (v = value()))
+      {
+        opt.warmup_ms = std::atof(v);
+      }
+      else if (arg == "--min-time-ms" && (v = value()))
+      {
+        opt.min_time_ms = std::atof(v);
+      }
+      else if (arg == "--repetitions" && (v = value()))
+      {
+        opt.repetitions = std::max(1, std::atoi(v));
+      }
+      else if (arg == "--cpu" && (v = value()))
+      {
+        opt.cpu = std::atoi(v);
+      }
+      else if (arg == "--no-pin")
+      {
+        opt.pin = false;
+      }
+      else if (arg == "--filter" && (v = value()))
+      {
+        opt.filter = v;
+      }
+      else if (arg == "--json" && (v = value()))
+      {
+        opt.json_path = v;
+      }
+      else
+      {
+        err << "usage: " << argv[0]
+            << " [--warmup-ms ms] [--min-time-ms ms] [--repetitions n] [--cpu n] [--no-pin]"
+               " [--filter substring] [--json path]\n";
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // JSON文字列のエスケープ
+  inline std::string JsonEscape(const std::string &s)
+  {
+    std::string out;
+    out.reserve(s.size() + 2);
+    for (char c : s)
+    {
+      switch (c)
+      {
+      case '"':  out += "\\\""; break;
+      case '\\': out += "\\\\"; break;
+      case '\n': out += "\\n";  break;
+      case '\t': out += "\\t";  break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20)
+        {
+          char buf[8];
+          std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+          out += buf;
+        }
+        else
+        {
+          out += c;
+        }
+      }
+    }
+    return "\"" + out + "\"";
+  }
+
+  // JSONの数値表現(非有限値はnull)
+  inline std::string JsonNumber(double v)
+  {
+    if (!std::isfinite(v))
+    {
+      return "null";
+    }
+    std::ostringstream os;
+    os.precision(9);
+    os << v;
+    return os.str();
+  }
+
+  // 実行環境の情報(JSONのcontextオブジェクトの中身)
+  inline std::string ContextJson(int pinned_cpu)
+  {
+    char date[32] = {};
+    const std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+#if defined(__clang__)
+    const std::string compiler = std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+    const std::string compiler = std::string("gcc ") + __VERSION__;
+#elif defined(_MSC_VER)
+    const std::string compiler = "msvc " + std::to_string(_MSC_VER);
+#else
+    const std::string compiler = "unknown";
+#endif
+#if defined(NDEBUG)
+    const char* build = "release";
+#else
+    const char* build = "debug";
+#endif
+    std::ostringstream os;
+    os << "\"date\": " << JsonEscape(date)
+       << ", \"compiler\": " << JsonEscape(compiler)
+       << ", \"build\": " << JsonEscape(build)
+       << ", \"pinned_cpu\": " << pinned_cpu;
+    return os.str();
+  }
+
+  // ベンチマーク項目
+  struct Case
+  {
+    std::string kernel; // 対象(FIR, SinCos, ...)
+    std::string type;   // サンプル型
+    std::string param;  // タップ数・段数など
+    std::string mode;   // per-call / block など
+    std::function<std::size_t(void)> run; // 1回分を処理し、処理したサンプル数を返す
+
+    std::string Name(void) const
+    {
+      return kernel + "/" + type + (param.empty() ? "" : "/" + param) + "/" + mode;
+    }
+  };
+
+  // ベンチマーク結果
+  struct Result
+  {
+    Case bench;
+    std::size_t samples_per_repetition;
+    Summary ns_per_sample;
+    double samples_per_second; // ns_per_sampleの中央値から求める
+  };
+
+  // 1項目の計測
+  // 空回しの後、min_time_ms以上かかる回数を1回の計測としてrepetitions回繰り返す
+  inline Result Measure(const Case &bench, const Options &opt)
+  {
+    using ms = std::chrono::duration<double, std::milli>;
+    using ns = std::chrono::duration<double, std::nano>;
+
+    const Clock::time_point warmup_start = Clock::now();
+    std::size_t samples = 0;
+    std::size_t calls = 0;
+    do
+    {
+      samples += bench.run();
+      ++calls;
+    } while (ms(Clock::now() - warmup_start).count() < opt.warmup_ms);
+
+    const double ms_per_call = ms(Clock::now() - warmup_start).count() / calls;
+    const std::size_t iterations = std::max<std::size_t>(1,
+      static_cast<std::size_t>(std::ceil(opt.min_time_ms / std::max(ms_per_call, 1e-6))));
+
+    std::vector<double> values;
+    values.reserve(opt.repetitions);
+    std::size_t samples_per_repetition = 0;
+    for (int rep = 0; rep < opt.repetitions; ++rep)
+    {
+      samples = 0;
+      const Clock::time_point start = Clock::now();
+      for (std::size_t i = 0; i < iterations; ++i)
+      {
+        samples += bench.run();
+      }
+      const double elapsed = ns(Clock::now() - start).count();
+      values.push_back(elapsed / static_cast<double>(samples));
+      samples_per_repetition = samples;
+    }
+
+    Result result{bench, samples_per_repetition, Summarize(values), 0.0};
+    result.samples_per_second = (result.ns_per_sample.median > 0) ? 1e9 / result.ns_per_sample.median : 0.0;
+    return result;
+  }
+
+  // 全項目の計測と結果の出力
+  // 標準出力に表形式、opt.json_pathが指定されていればJSONを出力する
+  inline int RunCases(const std::vector<Case> &cases, const Options &opt, const char* suite)
+  {
+    const int pinned_cpu = opt.pin ? PinToCpu(opt.cpu) : -1;
+    std::cout << suite << ": pinned cpu " << pinned_cpu << ", " << opt.repetitions << " repetitions\n";
+    std::cout << std::left << std::setw(48) << "name" << std::right
+              << std::setw(12) << "ns/sample" << std::setw(12) << "min" << std::setw(10) << "stddev%"
+              << std::setw(14) << "MSamples/s" << "\n";
+
+    std::vector<Result> results;
+    for (const Case &bench : cases)
+    {
+      if (!opt.filter.empty() && bench.Name().find(opt.filter) == std::string::npos)
+      {
+        continue;
+      }
+      const Result r = Measure(bench, opt);
+      const double cv = (r.ns_per_sample.mean > 0) ? 100.0 * r.ns_per_sample.stddev / r.ns_per_sample.mean : 0.0;
+      std::cout << std::left << std::setw(48) << bench.Name() << std::right << std::fixed
+                << std::setprecision(3) << std::setw(12) << r.ns_per_sample.median
+                << std::setw(12) << r.ns_per_sample.min
+                << std::setprecision(1) << std::setw(10) << cv
+                << std::setprecision(2) << std::setw(14) << r.samples_per_second * 1e-6 << "\n";
+      std::cout.unsetf(std::ios::floatfield);
+      results.push_back(r);
+    }
+
+    if (opt.json_path.empty())
+    {
+      return 0;
+    }
+    std::ofstream os(opt.json_path);
+    if (!os)
+    {
+      std::cerr << "cannot open " << opt.json_path << "\n";
+      return 1;
+    }
+    os << "{\n  \"suite\": " << JsonEscape(suite) << ",\n  \"context\": {" << ContextJson(pinned_cpu)
+       << "},\n  \"benchmarks\": [";
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+      const Result &r = results[i];
+      os << (i ? ",\n" : "\n")
+         << "    {\"name\": " << JsonEscape(r.bench.Name())
+         << ", \"kernel\": " << JsonEscape(r.bench.kernel)
+         << ", \"type\": " << JsonEscape(r.bench.type)
+         << ", \"param\": " << JsonEscape(r.bench.param)
+         << ", \"mode\": " << JsonEscape(r.bench.mode)
+         << ", \"samples_per_repetition\": " << r.samples_per_repetition
+         << ", \"repetitions\": " << opt.repetitions
+         << ", \"ns_per_sample\": {\"min\": " << JsonNumber(r.ns_per_sample.min)
+         << ", \"median\": " << JsonNumber(r.ns_per_sample.median)
+         << ", \"mean\": " << JsonNumber(r.ns_per_sample.mean)
+         << ", \"stddev\": " << JsonNumber(r.ns_per_sample.stddev)
+         << ", \"max\": " << JsonNumber(r.ns_per_sample.max) << "}"
+         << ", \"samples_per_second\": " << JsonNumber(r.samples_per_second) << "}";
+    }
+    os << "\n  ]\n}\n";
+    return os ? 0 : 1;
+  }
+
+} /* namespace MyDSPBench */
+
+
+#endif /* MYDSP_BENCH_BENCHCOMMON_HPP_ */
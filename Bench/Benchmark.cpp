@@ -0,0 +1,1121 @@
+/*
+ * Benchmark.cpp
+ *
+ *  Created on: 2026/10/18
+ *      Author: Shibasaki
+ *
+ * ライブラリ全体のベンチマーク
+ * 各カーネルについてサンプルあたりの処理時間とスループットを計測する
+ * per-call: 1サンプルずつ呼び出して結果を捨てる
+ * block   : std::transform等でブロック単位に処理して配列へ書き出す
+ * process : ブロック処理API(Process等)を呼び出す
+ * eigen-block: Eigen型のサンプル列をチャネル数×サンプル数の行列としてProcessに渡す
+ */
+
+#if defined(MYDSP_BENCH_WITH_EIGEN)
+  #include "Eigen/Core"
+#endif
+#include "MyDSP/Filter.hpp"
+#include "MyDSP/DynamicFilter.hpp"
+#include "MyDSP/Controller.hpp"
+#include "MyDSP/Spectrum.hpp"
+#include "MyDSP/FFT.hpp"
+#include "MyDSP/STFT.hpp"
+#include "MyDSP/Statistics.hpp"
+#include "MyDSP/Resampler.hpp"
+#include "MyDSP/Demodulator.hpp"
+#include "MyDSP/FrequencyResponse.hpp"
+#include "MyDSP/Kalman.hpp"
+#include "MyDSP/Math.hpp"
+#include "MyDSP/Dispatch.hpp"
+#include "BenchCommon.hpp"
+#include <algorithm>
+#include <complex>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+  using namespace MyDSPBench;
+
+  // 1回の計測単位となるブロック長
+  constexpr std::size_t block_size = 4096;
+
+  // 型名
+  template <class T> struct TypeName;
+  template <> struct TypeName<float>  { static std::string Get() { return "float"; } };
+  template <> struct TypeName<double> { static std::string Get() { return "double"; } };
+  template <class T> struct TypeName<std::complex<T>>
+  {
+    static std::string Get() { return "complex<" + TypeName<T>::Get() + ">"; }
+  };
+#if defined(MYDSP_BENCH_WITH_EIGEN)
+  template <class T, int R, int C, int O, int MR, int MC> struct TypeName<Eigen::Matrix<T,R,C,O,MR,MC>>
+  {
+    static std::string Get() { return "Eigen" + std::to_string(R) + "x" + std::to_string(C) + "<" + TypeName<T>::Get() + ">"; }
+  };
+#endif
+
+  // 入力サンプルの生成
+  template <class T>
+  void RandomSample(T &value, Random &rng)
+  {
+    value = static_cast<T>(rng.Uniform(-1.0, 1.0));
+  }
+
+  template <class T>
+  void RandomSample(std::complex<T> &value, Random &rng)
+  {
+    value = std::complex<T>(static_cast<T>(rng.Uniform(-1.0, 1.0)), static_cast<T>(rng.Uniform(-1.0, 1.0)));
+  }
+
+#if defined(MYDSP_BENCH_WITH_EIGEN)
+  template <class T, int R, int C, int O, int MR, int MC>
+  void RandomSample(Eigen::Matrix<T,R,C,O,MR,MC> &value, Random &rng)
+  {
+    for (Eigen::Index i = 0; i < value.size(); ++i)
+    {
+      value(i) = static_cast<T>(rng.Uniform(-1.0, 1.0));
+    }
+  }
+#endif
+
+  template <class T>
+  std::shared_ptr<std::vector<T>> RandomBlock(std::size_t length, std::uint64_t seed = 1)
+  {
+    Random rng(seed);
+    auto block = std::make_shared<std::vector<T>>(length);
+    for (T &value : *block)
+    {
+      RandomSample(value, rng);
+    }
+    return block;
+  }
+
+  // 安定な双二次フィルタの係数(y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] + a1 y[n-1] + a2 y[n-2])
+  template <class T2, std::size_t NumStages>
+  struct BiquadCoeffs
+  {
+    T2 values[NumStages][5];
+    BiquadCoeffs()
+    {
+      for (auto &stage : values)
+      {
+        stage[0] = T2(0.2);
+        stage[1] = T2(0.4);
+        stage[2] = T2(0.2);
+        stage[3] = T2(0.6);
+        stage[4] = T2(-0.2);
+      }
+    }
+  };
+
+  // 係数が複素数か(項目名の区別に使う)
+  template <class T> struct IsComplex : std::false_type {};
+  template <class T> struct IsComplex<std::complex<T>> : std::true_type {};
+
+  // 移動平均のFIR係数
+  template <class T2, std::size_t NumTaps>
+  struct FIRCoeffs
+  {
+    T2 values[NumTaps];
+    FIRCoeffs()
+    {
+      for (auto &value : values)
+      {
+        value = T2(1) / T2(NumTaps);
+      }
+    }
+  };
+
+  // フィルタ類(operator()を持つもの)のper-call/block両方の項目を追加
+  template <class Filter, class Sample>
+  void AddFilterCases(std::vector<Case> &cases, const std::string &kernel, const std::string &param,
+    std::shared_ptr<Filter> filter)
+  {
+    const auto in  = RandomBlock<Sample>(block_size);
+    const auto out = std::make_shared<std::vector<Sample>>(block_size, in->front());
+    const std::string type = TypeName<Sample>::Get();
+
+    cases.push_back(Case{kernel, type, param, "per-call", [filter, in]()
+    {
+      for (const Sample &x : *in)
+      {
+        const Sample y = (*filter)(x);
+        DoNotOptimize(y);
+      }
+      return in->size();
+    }});
+
+    cases.push_back(Case{kernel, type, param, "block", [filter, in, out]()
+    {
+      std::transform(in->begin(), in->end(), out->begin(), std::ref(*filter));
+      DoNotOptimize(out->front());
+      ClobberMemory();
+      return in->size();
+    }});
+  }
+
+  // ブロック処理API(Process(in, out, length))の項目を追加
+  template <class Filter, class Sample>
+  void AddProcessCase(std::vector<Case> &cases, const std::string &kernel, const std::string &param,
+    std::shared_ptr<Filter> filter)
+  {
+    const auto in  = RandomBlock<Sample>(block_size);
+    const auto out = std::make_shared<std::vector<Sample>>(block_size, in->front());
+
+    cases.push_back(Case{kernel, TypeName<Sample>::Get(), param, "process", [filter, in, out]()
+    {
+      filter->Process(in->data(), out->data(), in->size());
+      DoNotOptimize(out->front());
+      ClobberMemory();
+      return in->size();
+    }});
+  }
+
+#if defined(MYDSP_BENCH_WITH_EIGEN)
+  // Eigen型のブロック処理API(Process(Eigen::Ref, Eigen::Ref))の項目を追加
+  // サンプル数は列数で数える
+  template <class Filter, class Sample>
+  void AddEigenBlockCase(std::vector<Case> &cases, const std::string &kernel, const std::string &param,
+    std::shared_ptr<Filter> filter)
+  {
+    using Block = typename Filter::Block;
+    const auto in  = std::make_shared<Block>(Block::Random(Sample::SizeAtCompileTime, block_size));
+    const auto out = std::make_shared<Block>(Sample::SizeAtCompileTime, block_size);
+
+    cases.push_back(Case{kernel, TypeName<Sample>::Get(), param, "eigen-block", [filter, in, out]()
+    {
+      filter->Process(*in, *out);
+      DoNotOptimize(out->data()[0]);
+      ClobberMemory();
+      return static_cast<std::size_t>(in->cols());
+    }});
+  }
+
+  template <class Sample, class T2, std::size_t NumTaps, std::size_t NumStages>
+  void AddEigenBlock(std::vector<Case> &cases)
+  {
+    using FIR  = MyDSP::FIR<Sample,T2,NumTaps>;
+    using DF1  = MyDSP::IIRBiquadCascadeDF1<Sample,T2,NumStages>;
+    using DF2T = MyDSP::IIRBiquadCascadeDF2T<Sample,T2,NumStages>;
+    const FIRCoeffs<T2,NumTaps> fir_coeffs;
+    const BiquadCoeffs<T2,NumStages> biquad_coeffs;
+    const std::string taps = std::to_string(NumTaps) + "taps";
+    const std::string stages = std::to_string(NumStages) + "stages";
+    AddEigenBlockCase<FIR,Sample>(cases, "FIR", taps, std::make_shared<FIR>(fir_coeffs.values));
+    AddEigenBlockCase<DF1,Sample>(cases, "IIRBiquadCascadeDF1", stages, std::make_shared<DF1>(biquad_coeffs.values));
+    AddEigenBlockCase<DF2T,Sample>(cases, "IIRBiquadCascadeDF2T", stages, std::make_shared<DF2T>(biquad_coeffs.values));
+  }
+#endif
+
+  template <class Sample, class T2, std::size_t NumTaps>
+  void AddFIR(std::vector<Case> &cases)
+  {
+    using Filter = MyDSP::FIR<Sample,T2,NumTaps>;
+    const FIRCoeffs<T2,NumTaps> coeffs;
+    const std::string param = std::to_string(NumTaps) + "taps" + (IsComplex<T2>::value ? "/complex-coeffs" : "");
+    AddFilterCases<Filter,Sample>(cases, "FIR", param, std::make_shared<Filter>(coeffs.values));
+    AddProcessCase<Filter,Sample>(cases, "FIR", param, std::make_shared<Filter>(coeffs.values));
+  }
+
+  template <class Sample, class T2, std::size_t NumStages>
+  void AddBiquad(std::vector<Case> &cases)
+  {
+    using DF1  = MyDSP::IIRBiquadCascadeDF1<Sample,T2,NumStages>;
+    using DF2T = MyDSP::IIRBiquadCascadeDF2T<Sample,T2,NumStages>;
+    const BiquadCoeffs<T2,NumStages> coeffs;
+    const std::string param = std::to_string(NumStages) + "stages" + (IsComplex<T2>::value ? "/complex-coeffs" : "");
+    AddFilterCases<DF1,Sample>(cases, "IIRBiquadCascadeDF1", param, std::make_shared<DF1>(coeffs.values));
+    AddProcessCase<DF1,Sample>(cases, "IIRBiquadCascadeDF1", param, std::make_shared<DF1>(coeffs.values));
+    AddFilterCases<DF2T,Sample>(cases, "IIRBiquadCascadeDF2T", param, std::make_shared<DF2T>(coeffs.values));
+    AddProcessCase<DF2T,Sample>(cases, "IIRBiquadCascadeDF2T", param, std::make_shared<DF2T>(coeffs.values));
+  }
+
+  // Arenaに確保する実行時サイズのフィルタ
+  // 領域はフィルタと同じ寿命で保持する
+  template <class Filter>
+  struct ArenaBacked
+  {
+    std::vector<unsigned char> buffer;
+    MyDSP::Arena arena;
+    Filter filter;
+
+    template <class Coeffs>
+    ArenaBacked(const Coeffs &coeffs, std::size_t size) :
+      buffer(Filter::RequiredBytes(size) + MyDSP::Arena::Alignment),
+      arena(buffer.data(), buffer.size()),
+      filter(arena, coeffs, size)
+    {}
+  };
+
+  template <class Filter, class Coeffs>
+  std::shared_ptr<Filter> MakeArenaBacked(const Coeffs &coeffs, std::size_t size)
+  {
+    const auto holder = std::make_shared<ArenaBacked<Filter>>(coeffs, size);
+    return std::shared_ptr<Filter>(holder, &holder->filter);
+  }
+
+  template <class Sample, class T2, std::size_t NumTaps>
+  void AddFIRDynamic(std::vector<Case> &cases)
+  {
+    using Filter = MyDSP::FIRDynamic<Sample,T2>;
+    const FIRCoeffs<T2,NumTaps> coeffs;
+    const std::string param = std::to_string(NumTaps) + "taps";
+    AddFilterCases<Filter,Sample>(cases, "FIRDynamic", param, MakeArenaBacked<Filter>(coeffs.values, NumTaps));
+    AddProcessCase<Filter,Sample>(cases, "FIRDynamic", param, MakeArenaBacked<Filter>(coeffs.values, NumTaps));
+  }
+
+  template <class Sample, class T2, std::size_t NumStages>
+  void AddBiquadDynamic(std::vector<Case> &cases)
+  {
+    using DF1  = MyDSP::IIRBiquadCascadeDF1Dynamic<Sample,T2>;
+    using DF2T = MyDSP::IIRBiquadCascadeDF2TDynamic<Sample,T2>;
+    const BiquadCoeffs<T2,NumStages> coeffs;
+    const std::string param = std::to_string(NumStages) + "stages";
+    AddFilterCases<DF1,Sample>(cases, "IIRBiquadCascadeDF1Dynamic", param, MakeArenaBacked<DF1>(coeffs.values, NumStages));
+    AddFilterCases<DF2T,Sample>(cases, "IIRBiquadCascadeDF2TDynamic", param, MakeArenaBacked<DF2T>(coeffs.values, NumStages));
+    AddProcessCase<DF2T,Sample>(cases, "IIRBiquadCascadeDF2TDynamic", param, MakeArenaBacked<DF2T>(coeffs.values, NumStages));
+  }
+
+  // 多チャネルIIRフィルタ(チャネル方向のベクトル化)
+  // サンプル数は全チャネルの合計で数える
+  template <class T, std::size_t NumStages, std::size_t NumChannels>
+  void AddBiquadBank(std::vector<Case> &cases)
+  {
+    using Bank = MyDSP::IIRBiquadCascadeDF2TBank<T,NumStages,NumChannels>;
+    const BiquadCoeffs<T,NumStages> coeffs;
+    const auto bank = std::make_shared<Bank>(coeffs.values);
+    const auto in  = RandomBlock<T>(block_size);
+    const auto out = std::make_shared<std::vector<T>>(block_size);
+    const std::string param = std::to_string(NumStages) + "stages/" + std::to_string(NumChannels) + "ch";
+
+    cases.push_back(Case{"IIRBiquadCascadeDF2TBank", TypeName<T>::Get(), param, "process", [bank, in, out]()
+    {
+      bank->Process(in->data(), out->data(), in->size() / NumChannels);
+      DoNotOptimize(out->front());
+      ClobberMemory();
+      return in->size();
+    }});
+  }
+
+  // 先読み形式の1チャネルIIRフィルタ
+  // 比較用に、同じ段数の直接型II転置構成のブロック処理を"/serial"として追加する
+  template <class T, std::size_t NumStages>
+  void AddBiquadLookAhead(std::vector<Case> &cases)
+  {
+    using DF2T = MyDSP::IIRBiquadCascadeDF2T<T,T,NumStages>;
+    const BiquadCoeffs<T,NumStages> coeffs;
+    const std::string param = std::to_string(NumStages) + "stages";
+    AddProcessCase<DF2T,T>(cases, "IIRBiquadCascadeDF2TLookAhead", param + "/serial", std::make_shared<DF2T>(coeffs.values));
+    AddProcessCase<MyDSP::IIRBiquadCascadeDF2TLookAhead<T,NumStages,4>,T>(cases, "IIRBiquadCascadeDF2TLookAhead",
+      param + "/block4", std::make_shared<MyDSP::IIRBiquadCascadeDF2TLookAhead<T,NumStages,4>>(coeffs.values));
+    AddProcessCase<MyDSP::IIRBiquadCascadeDF2TLookAhead<T,NumStages,8>,T>(cases, "IIRBiquadCascadeDF2TLookAhead",
+      param + "/block8", std::make_shared<MyDSP::IIRBiquadCascadeDF2TLookAhead<T,NumStages,8>>(coeffs.values));
+  }
+
+  // 格納型の名称(項目名に使う)
+  template <class T> struct StorageName;
+  template <> struct StorageName<float>           { static std::string Get() { return "float"; } };
+  template <> struct StorageName<MyDSP::Half>     { static std::string Get() { return "half"; } };
+  template <> struct StorageName<MyDSP::BFloat16> { static std::string Get() { return "bf16"; } };
+
+  // 縮小精度の格納形式
+  // 多数のインスタンスを短いブロックずつ順に処理し、係数・状態変数の読み書きが支配的になる条件で計測する
+  // サンプル数は全インスタンス(全チャネル)の合計で数える
+  template <class TC, class TS>
+  void AddCompactStorage(std::vector<Case> &cases)
+  {
+    constexpr std::size_t num_taps = 32;
+    constexpr std::size_t num_filters = 16384;
+    constexpr std::size_t num_stages = 4;
+    constexpr std::size_t num_channels = 8192;
+    constexpr std::size_t frames = 16;
+    using Filter = MyDSP::FIR<float,TC,num_taps,TS>;
+    using Bank = MyDSP::IIRBiquadCascadeDF2TBank<float,num_stages,num_channels,TC,TS>;
+    const std::string storage = "coeffs-" + StorageName<TC>::Get() + "/state-" + StorageName<TS>::Get();
+
+    const FIRCoeffs<float,num_taps> fir_coeffs;
+    const auto filters = std::make_shared<std::vector<Filter>>(num_filters, Filter(fir_coeffs.values));
+    const auto in  = RandomBlock<float>(num_filters * frames);
+    const auto out = std::make_shared<std::vector<float>>(in->size());
+    cases.push_back(Case{"FIR", "float", std::to_string(num_taps) + "taps/" + std::to_string(num_filters) + "x/" + storage,
+      "process", [filters, in, out]()
+    {
+      for (std::size_t i = 0; i < num_filters; ++i)
+      {
+        (*filters)[i].Process(in->data() + i * frames, out->data() + i * frames, frames);
+      }
+      DoNotOptimize(out->front());
+      ClobberMemory();
+      return in->size();
+    }});
+
+    const BiquadCoeffs<float,num_stages> biquad_coeffs;
+    const auto bank = std::make_shared<Bank>(biquad_coeffs.values);
+    const auto bank_in  = RandomBlock<float>(num_channels * frames);
+    const auto bank_out = std::make_shared<std::vector<float>>(bank_in->size());
+    cases.push_back(Case{"IIRBiquadCascadeDF2TBank", "float",
+      std::to_string(num_stages) + "stages/" + std::to_string(num_channels) + "ch/" + storage,
+      "process", [bank, bank_in, bank_out]()
+    {
+      bank->Process(bank_in->data(), bank_out->data(), frames);
+      DoNotOptimize(bank_out->front());
+      ClobberMemory();
+      return bank_in->size();
+    }});
+  }
+
+  // 状態変数の保存・復元と定常状態での初期化
+  // 多数のフィルタをチェックポイントから再開する条件で、1フィルタあたりの時間を計測する(サンプル数の代わりにフィルタ数で数える)
+  template <class Filter>
+  void AddStateSnapshot(std::vector<Case> &cases, const std::string &kernel, const std::string &param,
+    const std::shared_ptr<std::vector<Filter>> &filters)
+  {
+    const std::size_t bytes = Filter::StateBytes();
+    const auto checkpoint = std::make_shared<std::vector<unsigned char>>(bytes * filters->size());
+    cases.push_back(Case{kernel, "float", param, "save", [filters, checkpoint]()
+    {
+      std::size_t offset = 0;
+      for (const Filter &filter : *filters)
+      {
+        offset += filter.SaveState(checkpoint->data() + offset, checkpoint->size() - offset);
+      }
+      DoNotOptimize(checkpoint->front());
+      ClobberMemory();
+      return filters->size();
+    }});
+    cases.push_back(Case{kernel, "float", param, "restore", [filters, checkpoint]()
+    {
+      std::size_t offset = 0;
+      for (Filter &filter : *filters)
+      {
+        offset += filter.RestoreState(checkpoint->data() + offset, checkpoint->size() - offset);
+      }
+      DoNotOptimize(filters->front());
+      ClobberMemory();
+      return filters->size();
+    }});
+    cases.push_back(Case{kernel, "float", param, "steady-state", [filters]()
+    {
+      for (Filter &filter : *filters)
+      {
+        filter.InitSteadyState(0.5f);
+      }
+      DoNotOptimize(filters->front());
+      ClobberMemory();
+      return filters->size();
+    }});
+  }
+
+  template <std::size_t NumStages, std::size_t NumTaps>
+  void AddStateSnapshot(std::vector<Case> &cases)
+  {
+    constexpr std::size_t num_filters = 4096;
+    using Biquad = MyDSP::IIRBiquadCascadeDF2T<float,float,NumStages>;
+    using Filter = MyDSP::FIR<float,float,NumTaps>;
+    const BiquadCoeffs<float,NumStages> biquad_coeffs;
+    const FIRCoeffs<float,NumTaps> fir_coeffs;
+    const std::string count = std::to_string(num_filters) + "x";
+    AddStateSnapshot<Biquad>(cases, "IIRBiquadCascadeDF2T", std::to_string(NumStages) + "stages/" + count,
+      std::make_shared<std::vector<Biquad>>(num_filters, Biquad(biquad_coeffs.values)));
+    AddStateSnapshot<Filter>(cases, "FIR", std::to_string(NumTaps) + "taps/" + count,
+      std::make_shared<std::vector<Filter>>(num_filters, Filter(fir_coeffs.values)));
+  }
+
+  // 周波数応答の評価
+  // 4096点の格子([0 π))での応答を求める時間を1点あたりで計測する
+  // 比較用に、点ごとにstd::polarでz^-1を求めてstd::complexで計算する項目を"polar"として追加する
+  constexpr std::size_t response_points = 4096;
+
+  // 周波数応答を求める格子([0 π)の等間隔)
+  template <class T>
+  std::shared_ptr<std::vector<T>> ResponseGrid(void)
+  {
+    const auto omegas = std::make_shared<std::vector<T>>(response_points);
+    for (std::size_t i = 0; i < response_points; ++i)
+    {
+      (*omegas)[i] = MyDSP::Pi<T>() * static_cast<T>(i) / static_cast<T>(response_points);
+    }
+    return omegas;
+  }
+
+  template <class T, std::size_t NumStages>
+  void AddBiquadResponse(std::vector<Case> &cases)
+  {
+    constexpr std::size_t num_points = response_points;
+    const auto biquad = std::make_shared<BiquadCoeffs<T,NumStages>>();
+    const auto omegas = ResponseGrid<T>();
+    const auto out = std::make_shared<std::vector<std::complex<T>>>(num_points);
+    const T step = MyDSP::Pi<T>() / static_cast<T>(num_points);
+    const std::string biquad_param = std::to_string(NumStages) + "stages/" + std::to_string(num_points) + "pts";
+
+    cases.push_back(Case{"FrequencyResponse", TypeName<T>::Get(), "biquad/" + biquad_param, "polar", [biquad, omegas, out]()
+    {
+      for (std::size_t i = 0; i < omegas->size(); ++i)
+      {
+        const std::complex<T> z1 = std::polar(T(1), -(*omegas)[i]);
+        const std::complex<T> z2 = z1 * z1;
+        std::complex<T> h(1);
+        for (const auto &c : biquad->values)
+        {
+          h *= (c[0] + c[1] * z1 + c[2] * z2) / (T(1) - c[3] * z1 - c[4] * z2);
+        }
+        (*out)[i] = h;
+      }
+      DoNotOptimize(out->front());
+      ClobberMemory();
+      return omegas->size();
+    }});
+    cases.push_back(Case{"FrequencyResponse", TypeName<T>::Get(), "biquad/" + biquad_param, "array", [biquad, omegas, out]()
+    {
+      MyDSP::FrequencyResponse(biquad->values, omegas->data(), out->data(), omegas->size());
+      DoNotOptimize(out->front());
+      ClobberMemory();
+      return omegas->size();
+    }});
+    cases.push_back(Case{"FrequencyResponse", TypeName<T>::Get(), "biquad/" + biquad_param, "uniform", [biquad, step, out]()
+    {
+      MyDSP::FrequencyResponseUniform(biquad->values, T(0), step, out->data(), num_points);
+      DoNotOptimize(out->front());
+      ClobberMemory();
+      return num_points;
+    }});
+  }
+
+  // FIRフィルタの周波数応答
+  // FFTによる項目は格子2πk/8192(k = 0..4096)の4097点を求める
+  template <class T, std::size_t NumTaps>
+  void AddFIRResponse(std::vector<Case> &cases)
+  {
+    constexpr std::size_t num_points = response_points;
+    constexpr std::size_t fft_size = 2 * response_points;
+    const auto fir = std::make_shared<FIRCoeffs<T,NumTaps>>();
+    const auto omegas = ResponseGrid<T>();
+    const auto out = std::make_shared<std::vector<std::complex<T>>>(num_points + 1);
+    const T step = MyDSP::Pi<T>() / static_cast<T>(num_points);
+    const std::string fir_param = std::to_string(NumTaps) + "taps/" + std::to_string(num_points) + "pts";
+
+    cases.push_back(Case{"FrequencyResponse", TypeName<T>::Get(), "fir/" + fir_param, "polar", [fir, omegas, out]()
+    {
+      for (std::size_t i = 0; i < omegas->size(); ++i)
+      {
+        std::complex<T> h;
+        for (std::size_t k = 0; k < NumTaps; ++k)
+        {
+          h += fir->values[NumTaps-1-k] * std::polar(T(1), -(*omegas)[i] * static_cast<T>(k));
+        }
+        (*out)[i] = h;
+      }
+      DoNotOptimize(out->front());
+      ClobberMemory();
+      return omegas->size();
+    }});
+    cases.push_back(Case{"FrequencyResponse", TypeName<T>::Get(), "fir/" + fir_param, "uniform", [fir, step, out]()
+    {
+      MyDSP::FrequencyResponseUniform(fir->values, T(0), step, out->data(), num_points);
+      DoNotOptimize(out->front());
+      ClobberMemory();
+      return num_points;
+    }});
+    const auto fft = std::make_shared<MyDSP::FIRFrequencyResponseFFT<T,fft_size>>();
+    cases.push_back(Case{"FrequencyResponse", TypeName<T>::Get(), "fir/" + fir_param, "fft", [fir, fft, out]()
+    {
+      (*fft)(fir->values, out->data());
+      DoNotOptimize(out->front());
+      ClobberMemory();
+      return num_points;
+    }});
+  }
+
+  // 移動窓の統計量の項目を追加
+  // 比較用に、同じ窓長の移動平均を係数が全て1/NのFIRフィルタで計算する項目も追加する
+  template <class T, std::size_t N, std::size_t NumChannels>
+  void AddMovingStatistics(std::vector<Case> &cases)
+  {
+    using Average  = MyDSP::MovingAverage<T,N>;
+    using Variance = MyDSP::MovingVariance<T,N>;
+    using RMS      = MyDSP::MovingRMS<T,N>;
+    using Boxcar   = MyDSP::FIR<T,T,N>;
+    using Bank     = MyDSP::MovingVarianceBank<T,N,NumChannels>;
+    const std::string param = std::to_string(N);
+    const FIRCoeffs<T,N> coeffs;
+    AddFilterCases<Average,T>(cases, "MovingAverage", param, std::make_shared<Average>());
+    AddProcessCase<Average,T>(cases, "MovingAverage", param, std::make_shared<Average>());
+    AddProcessCase<Boxcar,T>(cases, "MovingAverage", param + "/fir", std::make_shared<Boxcar>(coeffs.values));
+    AddProcessCase<Variance,T>(cases, "MovingVariance", param, std::make_shared<Variance>());
+    AddProcessCase<RMS,T>(cases, "MovingRMS", param, std::make_shared<RMS>());
+
+    const auto bank = std::make_shared<Bank>();
+    const auto in  = RandomBlock<T>(block_size);
+    const auto out = std::make_shared<std::vector<T>>(block_size);
+    cases.push_back(Case{"MovingVarianceBank", TypeName<T>::Get(), param + "/" + std::to_string(NumChannels) + "ch",
+      "process", [bank, in, out]()
+    {
+      bank->Process(in->data(), out->data(), in->size() / NumChannels);
+      DoNotOptimize(out->front());
+      ClobberMemory();
+      return in->size();
+    }});
+  }
+
+  // メディアンフィルタ・移動最小値/最大値の項目を追加
+  // "/sort"は窓ごとにコピーして中央値を選択する素朴な実装
+  template <class T, std::size_t N>
+  void AddRankFilters(std::vector<Case> &cases)
+  {
+    using Median = MyDSP::MedianFilter<T,N>;
+    const std::string param = std::to_string(N);
+    AddFilterCases<Median,T>(cases, "MedianFilter", param, std::make_shared<Median>());
+    AddProcessCase<Median,T>(cases, "MedianFilter", param, std::make_shared<Median>());
+    AddProcessCase<MyDSP::MovingMin<T,N>,T>(cases, "MovingMin", param, std::make_shared<MyDSP::MovingMin<T,N>>());
+    AddProcessCase<MyDSP::MovingMax<T,N>,T>(cases, "MovingMax", param, std::make_shared<MyDSP::MovingMax<T,N>>());
+
+    const auto in  = RandomBlock<T>(block_size);
+    const auto out = std::make_shared<std::vector<T>>(block_size);
+    cases.push_back(Case{"MedianFilter", TypeName<T>::Get(), param + "/sort", "process", [in, out]()
+    {
+      T window[N];
+      for (std::size_t n = N; n <= in->size(); ++n)
+      {
+        std::copy(in->data() + n - N, in->data() + n, window);
+        std::nth_element(window, window + N / 2, window + N);
+        (*out)[n-1] = window[N/2];
+      }
+      DoNotOptimize(out->back());
+      ClobberMemory();
+      return in->size() - N + 1;
+    }});
+  }
+
+  // 任意比のリサンプラの項目を追加
+  // 出力サンプル数を単位に数える
+  template <class T>
+  void AddResampler(std::vector<Case> &cases)
+  {
+    using Resampler = MyDSP::ArbitraryResampler<T>;
+    const std::string type = TypeName<T>::Get();
+    const double ratios[][2] = {{44100.0, 48000.0}, {48000.0, 44100.0 * 1.0001}};
+    for (const auto &ratio : ratios)
+    {
+      const auto resampler = std::make_shared<Resampler>(ratio[1] / ratio[0]);
+      const auto in  = RandomBlock<T>(block_size);
+      const auto out = std::make_shared<std::vector<T>>(resampler->MaxOutputLength(block_size) * 2);
+      const std::string param = std::to_string(Resampler::NumTaps) + "x" + std::to_string(Resampler::NumPhases) + "/"
+        + std::to_string(static_cast<int>(ratio[0])) + "to" + std::to_string(static_cast<int>(ratio[1]));
+      cases.push_back(Case{"ArbitraryResampler", type, param, "process", [resampler, in, out]()
+      {
+        const MyDSP::ResamplerResult result = resampler->Process(in->data(), in->size(), out->data(), out->size());
+        DoNotOptimize(out->front());
+        ClobberMemory();
+        return result.produced;
+      }});
+    }
+  }
+
+  // 復調器の項目を追加
+  // "/3pass"はFIRによるヒルベルト変換、Atan2、差分と折り返しを別々に行う実装
+  template <class T>
+  void AddDemodulator(std::vector<Case> &cases)
+  {
+    constexpr std::size_t num_coeffs = 16;
+    using FM = MyDSP::FMDemodulator<T,num_coeffs>;
+    using Hilbert = MyDSP::FIR<T,T,FM::NumTaps>;
+    const std::string type = TypeName<T>::Get();
+    const std::string param = std::to_string(FM::NumTaps) + "taps";
+    const auto in  = RandomBlock<T>(block_size);
+    const auto out = std::make_shared<std::vector<T>>(block_size);
+    const auto env = std::make_shared<std::vector<T>>(block_size);
+
+    AddProcessCase<FM,T>(cases, "FMDemodulator", param, std::make_shared<FM>());
+    AddProcessCase<MyDSP::PhaseDemodulator<T,num_coeffs>,T>(cases, "PhaseDemodulator", param,
+      std::make_shared<MyDSP::PhaseDemodulator<T,num_coeffs>>());
+    const auto fm = std::make_shared<FM>();
+    cases.push_back(Case{"FMDemodulator", type, param + "/envelope", "process", [fm, in, out, env]()
+    {
+      fm->Process(in->data(), out->data(), in->size(), env->data());
+      DoNotOptimize(out->front());
+      DoNotOptimize(env->front());
+      ClobberMemory();
+      return in->size();
+    }});
+
+    T coeffs[FM::NumTaps] = {};
+    for (std::size_t k = 0; k < num_coeffs; ++k)
+    {
+      coeffs[FM::Delay-2*k-1] = -MyDSP::Internal::HilbertCoeffs<T,num_coeffs>::values[k];
+      coeffs[FM::Delay+2*k+1] = MyDSP::Internal::HilbertCoeffs<T,num_coeffs>::values[k];
+    }
+    const auto hilbert = std::make_shared<Hilbert>(coeffs);
+    const auto delay = std::make_shared<std::vector<T>>(FM::Delay + block_size);
+    const auto quad = std::make_shared<std::vector<T>>(block_size);
+    cases.push_back(Case{"FMDemodulator", type, param + "/3pass", "process", [hilbert, delay, quad, in, out]()
+    {
+      const std::size_t length = in->size();
+      hilbert->Process(in->data(), quad->data(), length);
+      std::copy(in->begin(), in->end(), delay->begin() + FM::Delay);
+      T prev = 0;
+      for (std::size_t n = 0; n < length; ++n)
+      {
+        (*out)[n] = MyDSP::Atan2<9>((*quad)[n], (*delay)[n]);
+      }
+      for (std::size_t n = 0; n < length; ++n)
+      {
+        const T phase = (*out)[n];
+        T d = phase - prev;
+        d -= (d > MyDSP::Pi<T>()) ? MyDSP::TwoPi<T>() : (d < -MyDSP::Pi<T>()) ? -MyDSP::TwoPi<T>() : T(0);
+        prev = phase;
+        (*out)[n] = d;
+      }
+      std::copy(delay->end() - FM::Delay, delay->end(), delay->begin());
+      DoNotOptimize(out->front());
+      ClobberMemory();
+      return length;
+    }});
+  }
+
+  template <class Sample, class T2>
+  void AddPID(std::vector<Case> &cases)
+  {
+    AddFilterCases<MyDSP::PIDController<Sample>,Sample>(cases, "PIDController", "",
+      std::make_shared<MyDSP::PIDController<Sample>>(T2(1.0), T2(0.1), T2(0.01)));
+  }
+
+  // カルマンフィルタ(2次元の等速度モデル、状態4・観測2)
+  // 1024本のフィルタの予測と更新を1組として、フィルタ数を単位に数える
+  // 1本ずつのKalmanFilterを"per-call"、KalmanBankを"process"とする
+  template <class T, MyDSP::KalmanForm Form>
+  void AddKalman(std::vector<Case> &cases, const std::string &form)
+  {
+    constexpr std::size_t num_filters = 1024;
+    using Filter = MyDSP::KalmanFilter<T,4,2,Form>;
+    using Bank = MyDSP::KalmanBank<T,4,2,num_filters,Form>;
+    const T dt = T(0.01);
+    const T F[4][4] = {{1, 0, dt, 0}, {0, 1, 0, dt}, {0, 0, 1, 0}, {0, 0, 0, 1}};
+    const T H[2][4] = {{1, 0, 0, 0}, {0, 1, 0, 0}};
+    const T Q[4][4] = {{T(1e-6), 0, 0, 0}, {0, T(1e-6), 0, 0}, {0, 0, T(1e-4), 0}, {0, 0, 0, T(1e-4)}};
+    const T R[2][2] = {{T(0.01), 0}, {0, T(0.01)}};
+    const auto filters = std::make_shared<std::vector<Filter>>(num_filters, Filter(F, H, Q, R));
+    const auto bank = std::make_shared<Bank>(F, H, Q, R);
+    const auto measurements = RandomBlock<T>(num_filters * 2);
+    const std::string param = "4x2/" + form + "/" + std::to_string(num_filters) + "x";
+
+    cases.push_back(Case{"KalmanFilter", TypeName<T>::Get(), param, "per-call", [filters, measurements]()
+    {
+      std::size_t n = 0;
+      for (Filter &filter : *filters)
+      {
+        const T z[2] = {(*measurements)[n*2+0], (*measurements)[n*2+1]};
+        filter.Predict();
+        filter.Update(z);
+        ++n;
+      }
+      DoNotOptimize(filters->front());
+      ClobberMemory();
+      return n;
+    }});
+    cases.push_back(Case{"KalmanBank", TypeName<T>::Get(), param, "process", [bank, measurements]()
+    {
+      bank->Predict();
+      const std::size_t n = bank->Update(measurements->data());
+      DoNotOptimize(*bank);
+      ClobberMemory();
+      return n;
+    }});
+  }
+
+  // FFTとSTFTの項目を追加
+  // FFTは1回の変換を、STFTは入力サンプル数を単位に数える
+  template <class T>
+  void AddFFT(std::vector<Case> &cases)
+  {
+    constexpr std::size_t frame_size = 1024;
+    constexpr std::size_t hop = 256;
+    using Transform = MyDSP::FFT<T,frame_size>;
+    using Analysis = MyDSP::STFT<T,frame_size,hop>;
+    using Synthesis = MyDSP::InverseSTFT<T,frame_size,hop>;
+    const std::string type = TypeName<T>::Get();
+
+    const auto fft = std::make_shared<Transform>();
+    const auto re = RandomBlock<T>(frame_size);
+    const auto im = RandomBlock<T>(frame_size);
+    cases.push_back(Case{"FFT", type, std::to_string(frame_size), "process", [fft, re, im]()
+    {
+      fft->Forward(re->data(), im->data());
+      fft->Inverse(re->data(), im->data());
+      ClobberMemory();
+      return static_cast<std::size_t>(2);
+    }});
+
+    const auto stft = std::make_shared<Analysis>();
+    const auto istft = std::make_shared<Synthesis>();
+    const auto in = RandomBlock<T>(block_size);
+    const auto spec_re = std::make_shared<std::vector<T>>(block_size / hop * Analysis::NumBins);
+    const auto spec_im = std::make_shared<std::vector<T>>(block_size / hop * Analysis::NumBins);
+    const auto out = std::make_shared<std::vector<T>>(block_size);
+    const std::string param = std::to_string(frame_size) + "/" + std::to_string(hop);
+    cases.push_back(Case{"STFT", type, param + "/power", "process", [stft, in]()
+    {
+      T power[Analysis::NumBins];
+      stft->Process(in->data(), in->size(), [&power](const Analysis &frame)
+      {
+        frame.GetPower(power);
+        DoNotOptimize(power[0]);
+      });
+      ClobberMemory();
+      return in->size();
+    }});
+    cases.push_back(Case{"InverseSTFT", type, param, "process", [istft, spec_re, spec_im, out]()
+    {
+      istft->Process(spec_re->data(), spec_im->data(), out->size() / hop, out->data());
+      ClobberMemory();
+      return out->size();
+    }});
+  }
+
+  // 周波数ビン追跡の項目を追加
+  // per-callは1サンプルずつの更新、processはブロック処理
+  template <class T>
+  void AddSpectrum(std::vector<Case> &cases)
+  {
+    using Goertzel = MyDSP::GoertzelBank<T,16>;
+    using SDFT = MyDSP::SlidingDFT<T,1024,10,20,30,40,50,60,70,80,90,100,110,120,130,140,150,160>;
+    T freqs[16];
+    for (std::size_t i = 0; i < 16; ++i)
+    {
+      freqs[i] = static_cast<T>(10 * (i + 1)) / 1024;
+    }
+    const auto goertzel = std::make_shared<Goertzel>(freqs, 1024);
+    const auto sdft = std::make_shared<SDFT>();
+    const auto in = RandomBlock<T>(block_size);
+    const std::string type = TypeName<T>::Get();
+
+    cases.push_back(Case{"GoertzelBank", type, "16bins/1024", "process", [goertzel, in]()
+    {
+      const std::size_t num_blocks = goertzel->Process(in->data(), in->size());
+      DoNotOptimize(num_blocks);
+      ClobberMemory();
+      return in->size();
+    }});
+    cases.push_back(Case{"SlidingDFT", type, "16bins/1024", "per-call", [sdft, in]()
+    {
+      for (const T &x : *in)
+      {
+        (*sdft)(x);
+      }
+      ClobberMemory();
+      return in->size();
+    }});
+    cases.push_back(Case{"SlidingDFT", type, "16bins/1024", "process", [sdft, in]()
+    {
+      sdft->Process(in->data(), in->size());
+      ClobberMemory();
+      return in->size();
+    }});
+  }
+
+  // 算術関数の項目を追加
+  // func(x, y, out0, out1): 1変数関数はyを無視し、1出力関数はout1を使わない
+  template <class T, class Func>
+  void AddMathCases(std::vector<Case> &cases, const std::string &kernel, double lo, double hi, Func func)
+  {
+    Random rng(7);
+    auto x = std::make_shared<std::vector<T>>(block_size);
+    auto y = std::make_shared<std::vector<T>>(block_size);
+    for (std::size_t i = 0; i < block_size; ++i)
+    {
+      (*x)[i] = static_cast<T>(rng.Uniform(lo, hi));
+      (*y)[i] = static_cast<T>(rng.Uniform(lo, hi));
+    }
+    auto out0 = std::make_shared<std::vector<T>>(block_size);
+    auto out1 = std::make_shared<std::vector<T>>(block_size);
+    const std::string type = TypeName<T>::Get();
+
+    cases.push_back(Case{kernel, type, "", "per-call", [x, y, func]()
+    {
+      for (std::size_t i = 0; i < block_size; ++i)
+      {
+        T r0, r1 = T();
+        func((*x)[i], (*y)[i], r0, r1);
+        DoNotOptimize(r0);
+        DoNotOptimize(r1);
+      }
+      return block_size;
+    }});
+
+    cases.push_back(Case{kernel, type, "", "block", [x, y, out0, out1, func]()
+    {
+      const T* px = x->data();
+      const T* py = y->data();
+      T* p0 = out0->data();
+      T* p1 = out1->data();
+      for (std::size_t i = 0; i < block_size; ++i)
+      {
+        func(px[i], py[i], p0[i], p1[i]);
+      }
+      DoNotOptimize(p0[0]);
+      ClobberMemory();
+      return block_size;
+    }});
+  }
+
+  // 平方根・逆平方根・2乗ノルムの配列処理の項目を追加
+  template <class T, MyDSP::SqrtAccuracy Accuracy>
+  void AddSqrtArray(std::vector<Case> &cases, const std::string &accuracy)
+  {
+    const auto x = RandomBlock<T>(block_size, 1);
+    const auto y = RandomBlock<T>(block_size, 2);
+    const auto out = std::make_shared<std::vector<T>>(block_size);
+    for (T &v : *x)
+    {
+      v = (v + T(1)) * T(50);
+    }
+    const std::string type = TypeName<T>::Get();
+
+    cases.push_back(Case{"Sqrt", type, accuracy, "process", [x, out]()
+    {
+      MyDSP::Sqrt<Accuracy>(x->data(), out->data(), x->size());
+      DoNotOptimize(out->front());
+      ClobberMemory();
+      return x->size();
+    }});
+    cases.push_back(Case{"RSqrt", type, accuracy, "process", [x, out]()
+    {
+      MyDSP::RSqrt<Accuracy>(x->data(), out->data(), x->size());
+      DoNotOptimize(out->front());
+      ClobberMemory();
+      return x->size();
+    }});
+    cases.push_back(Case{"Hypot", type, accuracy, "process", [x, y, out]()
+    {
+      MyDSP::Hypot<Accuracy>(x->data(), y->data(), out->data(), x->size());
+      DoNotOptimize(out->front());
+      ClobberMemory();
+      return x->size();
+    }});
+    cases.push_back(Case{"HypotScaled", type, accuracy, "process", [x, y, out]()
+    {
+      MyDSP::HypotScaled<Accuracy>(x->data(), y->data(), out->data(), x->size());
+      DoNotOptimize(out->front());
+      ClobberMemory();
+      return x->size();
+    }});
+  }
+
+  // IQ信号(std::complexの配列)の絶対値
+  // 比較用に、std::absとMyDSP::Hypotを1サンプルずつ呼び出す項目を"block"として追加する
+  template <class T>
+  void AddMagnitude(std::vector<Case> &cases)
+  {
+    const auto iq = RandomBlock<std::complex<T>>(block_size);
+    const auto out = std::make_shared<std::vector<T>>(block_size);
+    const std::string type = TypeName<T>::Get();
+
+    cases.push_back(Case{"Magnitude", type, "std::abs", "block", [iq, out]()
+    {
+      std::transform(iq->begin(), iq->end(), out->begin(), [](const std::complex<T> &z) { return std::abs(z); });
+      DoNotOptimize(out->front());
+      ClobberMemory();
+      return iq->size();
+    }});
+    cases.push_back(Case{"Magnitude", type, "Hypot", "block", [iq, out]()
+    {
+      std::transform(iq->begin(), iq->end(), out->begin(),
+        [](const std::complex<T> &z) { return MyDSP::Hypot(z.real(), z.imag()); });
+      DoNotOptimize(out->front());
+      ClobberMemory();
+      return iq->size();
+    }});
+    cases.push_back(Case{"Magnitude", type, "exact", "process", [iq, out]()
+    {
+      MyDSP::Magnitude(iq->data(), out->data(), iq->size());
+      DoNotOptimize(out->front());
+      ClobberMemory();
+      return iq->size();
+    }});
+    cases.push_back(Case{"Magnitude", type, "high", "process", [iq, out]()
+    {
+      MyDSP::Magnitude<MyDSP::SqrtAccuracy::High>(iq->data(), out->data(), iq->size());
+      DoNotOptimize(out->front());
+      ClobberMemory();
+      return iq->size();
+    }});
+    cases.push_back(Case{"Magnitude", type, "scaled/high", "process", [iq, out]()
+    {
+      MyDSP::MagnitudeScaled<MyDSP::SqrtAccuracy::High>(iq->data(), out->data(), iq->size());
+      DoNotOptimize(out->front());
+      ClobberMemory();
+      return iq->size();
+    }});
+  }
+
+  template <class T>
+  void AddMath(std::vector<Case> &cases)
+  {
+    AddMathCases<T>(cases, "SinCos", -MyDSP::Pi<double>(), MyDSP::Pi<double>(), [](T x, T, T &s, T &c)
+    {
+      MyDSP::SinCos(x, &s, &c);
+    });
+    AddMathCases<T>(cases, "SinCos<7>", -MyDSP::Pi<double>(), MyDSP::Pi<double>(), [](T x, T, T &s, T &c)
+    {
+      MyDSP::SinCos<7>(x, &s, &c);
+    });
+    {
+      const auto theta = RandomBlock<T>(block_size);
+      for (T &x : *theta)
+      {
+        x *= MyDSP::Pi<T>();
+      }
+      const auto s = std::make_shared<std::vector<T>>(block_size);
+      const auto c = std::make_shared<std::vector<T>>(block_size);
+      cases.push_back(Case{"SinCos<7>", TypeName<T>::Get(), "", "process", [theta, s, c]()
+      {
+        MyDSP::SinCos<7>(theta->data(), s->data(), c->data(), theta->size());
+        DoNotOptimize(s->front());
+        ClobberMemory();
+        return theta->size();
+      }});
+    }
+    AddMathCases<T>(cases, "std::sin+cos", -MyDSP::Pi<double>(), MyDSP::Pi<double>(), [](T x, T, T &s, T &c)
+    {
+      s = std::sin(x);
+      c = std::cos(x);
+    });
+    AddMathCases<T>(cases, "Atan", -4.0, 4.0, [](T x, T, T &r, T &)
+    {
+      r = MyDSP::Atan(x);
+    });
+    AddMathCases<T>(cases, "std::atan", -4.0, 4.0, [](T x, T, T &r, T &)
+    {
+      r = std::atan(x);
+    });
+    AddMathCases<T>(cases, "Atan2", -1.0, 1.0, [](T x, T y, T &r, T &)
+    {
+      r = MyDSP::Atan2(y, x);
+    });
+    AddMathCases<T>(cases, "std::atan2", -1.0, 1.0, [](T x, T y, T &r, T &)
+    {
+      r = std::atan2(y, x);
+    });
+    AddMathCases<T>(cases, "Sqrt", 0.0, 100.0, [](T x, T, T &r, T &)
+    {
+      r = MyDSP::Sqrt(x);
+    });
+    AddMathCases<T>(cases, "std::sqrt", 0.0, 100.0, [](T x, T, T &r, T &)
+    {
+      r = std::sqrt(x);
+    });
+    AddMathCases<T>(cases, "Hypot", -100.0, 100.0, [](T x, T y, T &r, T &)
+    {
+      r = MyDSP::Hypot(x, y);
+    });
+    AddMathCases<T>(cases, "std::hypot", -100.0, 100.0, [](T x, T y, T &r, T &)
+    {
+      r = std::hypot(x, y);
+    });
+    AddSqrtArray<T,MyDSP::SqrtAccuracy::Fast>(cases, "fast");
+    AddSqrtArray<T,MyDSP::SqrtAccuracy::High>(cases, "high");
+    AddSqrtArray<T,MyDSP::SqrtAccuracy::Exact>(cases, "exact");
+    AddMagnitude<T>(cases);
+  }
+
+  std::vector<Case> AllCases(void)
+  {
+    std::vector<Case> cases;
+
+    AddFIR<float,float,8>(cases);
+    AddFIR<float,float,32>(cases);
+    AddFIR<float,float,128>(cases);
+    AddFIR<float,float,512>(cases);
+    AddFIR<double,double,32>(cases);
+    AddFIR<double,double,128>(cases);
+    AddFIR<std::complex<float>,float,32>(cases);
+    AddFIR<std::complex<float>,float,128>(cases);
+    AddFIR<std::complex<float>,std::complex<float>,32>(cases);
+    AddFIR<std::complex<double>,double,32>(cases);
+
+    AddBiquad<float,float,1>(cases);
+    AddBiquad<float,float,4>(cases);
+    AddBiquad<float,float,8>(cases);
+    AddBiquad<double,double,1>(cases);
+    AddBiquad<double,double,4>(cases);
+    AddBiquad<std::complex<float>,float,4>(cases);
+    AddBiquad<std::complex<double>,double,4>(cases);
+    AddBiquad<std::complex<float>,std::complex<float>,4>(cases);
+
+#if defined(MYDSP_BENCH_WITH_EIGEN)
+    AddFIR<Eigen::Vector4f,float,32>(cases);
+    AddBiquad<Eigen::Vector4f,float,4>(cases);
+    AddBiquad<Eigen::Vector2d,double,4>(cases);
+    AddPID<Eigen::Vector4f,float>(cases);
+    AddEigenBlock<Eigen::Vector4f,float,32,4>(cases);
+    AddEigenBlock<Eigen::Vector2d,double,32,4>(cases);
+    AddEigenBlock<Eigen::Matrix<float,8,1>,float,32,4>(cases);
+#endif
+
+    AddFIRDynamic<float,float,32>(cases);
+    AddFIRDynamic<float,float,128>(cases);
+    AddFIRDynamic<std::complex<float>,float,32>(cases);
+    AddBiquadDynamic<float,float,4>(cases);
+    AddBiquadDynamic<double,double,4>(cases);
+
+    AddBiquadBank<float,4,8>(cases);
+    AddBiquadBank<float,4,16>(cases);
+    AddBiquadBank<double,4,8>(cases);
+    AddBiquadLookAhead<float,1>(cases);
+    AddBiquadLookAhead<float,2>(cases);
+    AddBiquadLookAhead<float,4>(cases);
+    AddBiquadLookAhead<float,8>(cases);
+    AddBiquadLookAhead<double,1>(cases);
+    AddBiquadLookAhead<double,4>(cases);
+    AddCompactStorage<float,float>(cases);
+    AddCompactStorage<MyDSP::Half,float>(cases);
+    AddCompactStorage<MyDSP::Half,MyDSP::Half>(cases);
+    AddCompactStorage<MyDSP::BFloat16,MyDSP::BFloat16>(cases);
+    AddStateSnapshot<4,63>(cases);
+    AddBiquadResponse<float,4>(cases);
+    AddBiquadResponse<double,4>(cases);
+    AddFIRResponse<float,63>(cases);
+    AddFIRResponse<float,1023>(cases);
+    AddFIRResponse<double,63>(cases);
+
+    AddPID<float,float>(cases);
+    AddPID<double,double>(cases);
+    AddKalman<float,MyDSP::KalmanForm::Standard>(cases, "standard");
+    AddKalman<float,MyDSP::KalmanForm::Joseph>(cases, "joseph");
+    AddKalman<float,MyDSP::KalmanForm::SquareRoot>(cases, "sqrt");
+    AddKalman<double,MyDSP::KalmanForm::Joseph>(cases, "joseph");
+
+    AddMovingStatistics<float,1024,8>(cases);
+    AddMovingStatistics<double,1024,8>(cases);
+    AddRankFilters<float,31>(cases);
+    AddRankFilters<float,255>(cases);
+    AddResampler<float>(cases);
+    AddResampler<double>(cases);
+    AddDemodulator<float>(cases);
+    AddDemodulator<double>(cases);
+
+    AddSpectrum<float>(cases);
+    AddSpectrum<double>(cases);
+    AddFFT<float>(cases);
+    AddFFT<double>(cases);
+
+    AddMath<float>(cases);
+    AddMath<double>(cases);
+
+    return cases;
+  }
+
+} /* namespace */
+
+int main(int argc, char** argv)
+{
+  MyDSPBench::Options opt;
+  if (!MyDSPBench::ParseOptions(argc, argv, opt, std::cerr))
+  {
+    return 2;
+  }
+  std::cout << "simd level: " << MyDSP::SimdLevelName(MyDSP::GetSimdLevel()) << "\n";
+  return MyDSPBench::RunCases(AllCases(), opt, "MyDSPBenchmark");
+}
@@ -0,0 +1,312 @@
+/*
+ * LookAheadAccuracy.cpp
+ *
+ *  Created on: 2026/10/18
+ *      Author: Shibasaki
+ *
+ * 先読み形式の双二次IIRフィルタ(IIRBiquadCascadeDF2TLookAhead)の数値安定性の確認
+ * 同じ係数をlong doubleの漸化式で処理した出力を基準として、1サンプルずつの漸化式(IIRBiquadCascadeDF2T)と
+ * 先読み形式の出力のSN比を比べる。極が単位円に近いほど状態変数の丸め誤差が増幅されるので、
+ * 遮断周波数の低いフィルタや鋭い共振器で両者の差が開かないか(degraded)、長い入力で誤差が増え続けないか(UNSTABLE)を確かめる
+ * 終了コードはUNSTABLEのときだけ1にする
+ */
+
+#include "MyDSP/Filter.hpp"
+#include "MyDSP/Const.hpp"
+#include "BenchCommon.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+  using namespace MyDSPBench;
+
+  // 評価結果
+  struct Variant
+  {
+    std::string design;  // 設計条件
+    std::string type;    // サンプルの型
+    std::size_t block;   // 先読みのブロック長
+    double pole_radius;  // 極の最大半径
+    double snr_serial;   // 漸化式の出力のSN比(基準に対して)
+    double snr_block;    // 先読み形式の出力のSN比
+    double max_diff;     // 漸化式と先読み形式の出力の差の最大値
+    double drift_db;     // 先読み形式の誤差電力の、入力の後半と前半の比
+    bool stable;         // 先読み形式の誤差が増え続けていないか(後半の誤差電力が前半の6dB以内で、有限値か)
+    bool degraded;       // 先読み形式のSN比が漸化式より6dB以上低いか
+  };
+
+  // 双二次フィルタの係数(y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] + a1 y[n-1] + a2 y[n-2])
+  template <std::size_t NumStages>
+  struct Design
+  {
+    std::string name;
+    double values[NumStages][5];
+  };
+
+  // 双一次変換によるButterworth低域通過フィルタ(2*NumStages次)
+  // cutoff: 遮断周波数(サンプリング周波数で正規化)
+  template <std::size_t NumStages>
+  Design<NumStages> Butterworth(double cutoff)
+  {
+    Design<NumStages> design;
+    design.name = std::to_string(NumStages * 2) + "th-butterworth-" + std::to_string(cutoff).substr(0, 5);
+    const double omega = 2.0 * MyDSP::Pi<double>() * cutoff;
+    for (std::size_t stage = 0; stage < NumStages; ++stage)
+    {
+      const double q = 1.0 / (2.0 * std::cos(MyDSP::Pi<double>() * (2.0 * stage + 1.0) / (4.0 * NumStages)));
+      const double alpha = std::sin(omega) / (2.0 * q);
+      const double cosw = std::cos(omega);
+      const double a0 = 1.0 + alpha;
+      design.values[stage][0] = (1.0 - cosw) * 0.5 / a0;
+      design.values[stage][1] = (1.0 - cosw) / a0;
+      design.values[stage][2] = (1.0 - cosw) * 0.5 / a0;
+      design.values[stage][3] = 2.0 * cosw / a0;
+      design.values[stage][4] = -(1.0 - alpha) / a0;
+    }
+    return design;
+  }
+
+  // 極の半径radius、中心周波数center(正規化周波数)の共振器(帯域通過)
+  Design<1> Resonator(double radius, double center)
+  {
+    Design<1> design;
+    design.name = "resonator-r" + std::to_string(radius).substr(0, 7);
+    const double theta = 2.0 * MyDSP::Pi<double>() * center;
+    design.values[0][0] = (1.0 - radius * radius) * 0.5;
+    design.values[0][1] = 0.0;
+    design.values[0][2] = -(1.0 - radius * radius) * 0.5;
+    design.values[0][3] = 2.0 * radius * std::cos(theta);
+    design.values[0][4] = -radius * radius;
+    return design;
+  }
+
+  // 極の最大半径(z^2 - a1 z - a2 = 0 の根)
+  template <std::size_t NumStages>
+  double PoleRadius(const Design<NumStages> &design)
+  {
+    double radius = 0;
+    for (const auto &c : design.values)
+    {
+      const double disc = c[3] * c[3] + 4.0 * c[4];
+      const double r = (disc < 0) ? std::sqrt(-c[4])
+        : std::max(std::fabs(c[3] + std::sqrt(disc)), std::fabs(c[3] - std::sqrt(disc))) * 0.5;
+      radius = std::max(radius, r);
+    }
+    return radius;
+  }
+
+  // 誤差電力と信号電力の比(dB)
+  template <class T>
+  double SNR(const std::vector<long double> &ref, const std::vector<T> &out, std::size_t begin, std::size_t end)
+  {
+    long double power = 0;
+    long double error = 0;
+    for (std::size_t n = begin; n < end; ++n)
+    {
+      const long double e = out[n] - ref[n];
+      power += ref[n] * ref[n];
+      error += e * e;
+    }
+    return 10.0 * std::log10(static_cast<double>(power / error));
+  }
+
+  class Harness
+  {
+  private:
+    const Options &opt;
+    const std::size_t length;
+    const std::size_t chunk;
+    std::vector<double> input;
+    std::vector<Variant> variants;
+
+  public:
+    Harness(const Options &opt, std::size_t length, std::size_t chunk) :
+      opt(opt),
+      length(length),
+      chunk(chunk),
+      input(length)
+    {
+      Random rng(11);
+      for (double &value : input)
+      {
+        value = rng.Uniform(-1.0, 1.0);
+      }
+    }
+
+    const std::vector<Variant>& Get(void) const
+    {
+      return variants;
+    }
+
+    template <class T, std::size_t BlockSize, std::size_t NumStages>
+    void Run(const Design<NumStages> &design)
+    {
+      if (!opt.filter.empty() && design.name.find(opt.filter) == std::string::npos)
+      {
+        return;
+      }
+
+      // 基準(Tに丸めた係数と入力をlong doubleの漸化式で処理)
+      T coeffs[NumStages][5];
+      long double c[NumStages][5];
+      long double d[NumStages][2] = {};
+      for (std::size_t stage = 0; stage < NumStages; ++stage)
+      {
+        for (std::size_t i = 0; i < 5; ++i)
+        {
+          coeffs[stage][i] = static_cast<T>(design.values[stage][i]);
+          c[stage][i] = coeffs[stage][i];
+        }
+      }
+      std::vector<T> x(input.begin(), input.end());
+      std::vector<long double> ref(length);
+      for (std::size_t n = 0; n < length; ++n)
+      {
+        ref[n] = MyDSP::Internal::BiquadDF2TStepKernel(&c[0][0], &d[0][0], NumStages, static_cast<long double>(x[n]));
+      }
+
+      // 漸化式と先読み形式(chunkサンプルずつ処理し、端数の漸化式も含めて確かめる)
+      MyDSP::IIRBiquadCascadeDF2T<T,T,NumStages> serial(coeffs);
+      MyDSP::IIRBiquadCascadeDF2TLookAhead<T,NumStages,BlockSize> block(coeffs);
+      std::vector<T> out_serial(length);
+      std::vector<T> out_block(length);
+      for (std::size_t n = 0; n < length; n += chunk)
+      {
+        const std::size_t m = std::min(chunk, length - n);
+        serial.Process(x.data() + n, out_serial.data() + n, m);
+        block.Process(x.data() + n, out_block.data() + n, m);
+      }
+
+      Variant v{design.name, std::is_same<T,float>::value ? "float" : "double", BlockSize, PoleRadius(design),
+        0, 0, 0, 0, false, false};
+      v.snr_serial = SNR(ref, out_serial, 0, length);
+      v.snr_block = SNR(ref, out_block, 0, length);
+      for (std::size_t n = 0; n < length; ++n)
+      {
+        const double diff = std::fabs(static_cast<double>(out_block[n]) - static_cast<double>(out_serial[n]));
+        if (!(diff <= v.max_diff)) // NaNも最悪値として記録する
+        {
+          v.max_diff = diff;
+        }
+      }
+      v.drift_db = SNR(ref, out_block, 0, length / 4) - SNR(ref, out_block, length - length / 4, length);
+      v.stable = std::isfinite(v.snr_block) && (v.drift_db < 6.0);
+      v.degraded = v.snr_block < v.snr_serial - 6.0;
+      variants.push_back(v);
+    }
+  };
+
+  template <std::size_t NumStages>
+  void Run(Harness &h, const Design<NumStages> &design)
+  {
+    h.Run<float,4>(design);
+    h.Run<float,8>(design);
+    h.Run<double,4>(design);
+    h.Run<double,8>(design);
+  }
+
+  void Sweep(Harness &h)
+  {
+    Run(h, Butterworth<2>(0.1));
+    Run(h, Butterworth<2>(0.01));
+    Run(h, Butterworth<2>(0.001));
+    Run(h, Butterworth<4>(0.05));
+    Run(h, Butterworth<4>(0.002));
+    Run(h, Resonator(0.999, 0.05));
+    Run(h, Resonator(0.9999, 0.01));
+  }
+
+  void Print(const std::vector<Variant> &variants, std::size_t length, std::size_t chunk)
+  {
+    std::cout << "input: uniform white noise, " << length << " samples, processed in chunks of " << chunk << "\n";
+    std::cout << std::left << std::setw(28) << "design" << std::setw(8) << "type" << std::right << std::setw(6) << "block"
+              << std::setw(13) << "pole_radius" << std::setw(12) << "snr_serial" << std::setw(11) << "snr_block"
+              << std::setw(12) << "max_diff" << std::setw(10) << "drift_db" << "  result\n";
+    for (const Variant &v : variants)
+    {
+      std::cout << std::left << std::setw(28) << v.design << std::setw(8) << v.type << std::right << std::setw(6) << v.block
+                << std::fixed << std::setprecision(6) << std::setw(13) << v.pole_radius
+                << std::setprecision(1) << std::setw(12) << v.snr_serial << std::setw(11) << v.snr_block
+                << std::scientific << std::setprecision(2) << std::setw(12) << v.max_diff
+                << std::fixed << std::setprecision(1) << std::setw(10) << v.drift_db
+                << "  " << (!v.stable ? "UNSTABLE" : v.degraded ? "degraded" : "ok") << "\n";
+      std::cout.unsetf(std::ios::floatfield);
+    }
+  }
+
+  int WriteJson(const std::vector<Variant> &variants, std::size_t length, std::size_t chunk, const std::string &path)
+  {
+    std::ofstream os(path);
+    if (!os)
+    {
+      std::cerr << "cannot open " << path << "\n";
+      return 1;
+    }
+    os << "{\n  \"suite\": \"MyDSPLookAheadAccuracy\",\n  \"context\": {" << ContextJson(-1)
+       << "},\n  \"length\": " << length << ",\n  \"chunk\": " << chunk << ",\n  \"variants\": [";
+    for (std::size_t i = 0; i < variants.size(); ++i)
+    {
+      const Variant &v = variants[i];
+      os << (i ? ",\n" : "\n")
+         << "    {\"design\": " << JsonEscape(v.design)
+         << ", \"type\": " << JsonEscape(v.type)
+         << ", \"block\": " << v.block
+         << ", \"pole_radius\": " << JsonNumber(v.pole_radius)
+         << ", \"snr_serial\": " << JsonNumber(v.snr_serial)
+         << ", \"snr_block\": " << JsonNumber(v.snr_block)
+         << ", \"max_diff\": " << JsonNumber(v.max_diff)
+         << ", \"drift_db\": " << JsonNumber(v.drift_db)
+         << ", \"stable\": " << (v.stable ? "true" : "false")
+         << ", \"degraded\": " << (v.degraded ? "true" : "false") << "}";
+    }
+    os << "\n  ]\n}\n";
+    return os ? 0 : 1;
+  }
+
+} /* namespace */
+
+int main(int argc, char** argv)
+{
+  // 本プログラム固有の引数を取り除いてから共通の引数を解釈する
+  std::size_t length = 1u << 20;
+  std::size_t chunk = 250; // ブロック長の倍数でない長さにして端数の処理も通す
+  std::vector<char*> args{argv[0]};
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    if (arg == "--length" && i + 1 < argc)
+    {
+      length = std::max<std::size_t>(1024, static_cast<std::size_t>(std::atof(argv[++i])));
+    }
+    else if (arg == "--chunk" && i + 1 < argc)
+    {
+      chunk = std::max<std::size_t>(1, static_cast<std::size_t>(std::atof(argv[++i])));
+    }
+    else
+    {
+      args.push_back(argv[i]);
+    }
+  }
+
+  MyDSPBench::Options opt;
+  if (!MyDSPBench::ParseOptions(static_cast<int>(args.size()), args.data(), opt, std::cerr))
+  {
+    std::cerr << "additional options: [--length samples] [--chunk samples]\n";
+    return 2;
+  }
+
+  Harness harness(opt, length, chunk);
+  Sweep(harness);
+
+  Print(harness.Get(), length, chunk);
+  const bool all_ok = std::all_of(harness.Get().begin(), harness.Get().end(), [](const Variant &v) { return v.stable; });
+  const int status = opt.json_path.empty() ? 0 : WriteJson(harness.Get(), length, chunk, opt.json_path);
+  return (status != 0) ? status : (all_ok ? 0 : 1);
+}
@@ -0,0 +1,474 @@
+/*
+ * MathAccuracy.cpp
+ *
+ *  Created on: 2026/10/18
+ *      Author: Shibasaki
+ *
+ * Math.hpp の近似関数の精度と速度の特性評価
+ * 密な入力格子上でlong double版cmathを基準に絶対誤差(最大・RMS)とULP誤差を求め、
+ * 併せてスループットを計測する
+ * 平方根・逆平方根・2乗ノルムは Dispatch.hpp の配列処理(Sqrt[精度]等)も評価する
+ * --budget を指定すると、各関数について最大絶対誤差が予算内で最も速い実装を表示する
+ */
+
+#include "MyDSP/Math.hpp"
+#include "MyDSP/Dispatch.hpp"
+#include "BenchCommon.hpp"
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+  using namespace MyDSPBench;
+
+  // 誤差の統計量
+  struct ErrorStats
+  {
+    double max_abs = 0;
+    double rms_abs = 0;
+    double max_ulp = 0;
+    double worst_input = 0; // 最大絶対誤差を与えた入力(2変数関数では第1引数)
+  };
+
+  // 評価結果
+  struct Variant
+  {
+    std::string function; // atan, atan2, sin, cos, sqrt, rsqrt, hypot
+    std::string name;     // 実装名
+    std::string type;
+    ErrorStats error;
+    Summary ns_per_sample;
+  };
+
+  // 基準値に対するULP誤差
+  template <class T>
+  double UlpError(T value, long double reference)
+  {
+    const T ref = static_cast<T>(reference);
+    const T mag = std::fabs(ref);
+    const T ulp = std::max(std::nextafter(mag, std::numeric_limits<T>::infinity()) - mag,
+      std::numeric_limits<T>::min());
+    return static_cast<double>(std::fabs(static_cast<long double>(value) - reference) / ulp);
+  }
+
+  // 誤差の集計
+  template <class T>
+  class ErrorAccumulator
+  {
+  private:
+    ErrorStats stats;
+    long double sum_sq = 0;
+    std::size_t count = 0;
+
+  public:
+    void Add(T value, long double reference, double input)
+    {
+      const double abs_err = static_cast<double>(std::fabs(static_cast<long double>(value) - reference));
+      if (!(abs_err <= stats.max_abs)) // NaNも最悪値として記録する
+      {
+        stats.max_abs = abs_err;
+        stats.worst_input = input;
+      }
+      stats.max_ulp = std::max(stats.max_ulp, UlpError(value, reference));
+      sum_sq += static_cast<long double>(abs_err) * abs_err;
+      ++count;
+    }
+
+    ErrorStats Get(void) const
+    {
+      ErrorStats s = stats;
+      s.rms_abs = (count > 0) ? static_cast<double>(std::sqrt(sum_sq / count)) : 0.0;
+      return s;
+    }
+  };
+
+  template <class T> std::string TypeName(void);
+  template <> std::string TypeName<float>(void)  { return "float"; }
+  template <> std::string TypeName<double>(void) { return "double"; }
+
+  // 格子と計測用ブロック
+  template <class T>
+  struct Grid
+  {
+    std::vector<T> x, y;       // 誤差評価用の格子(1変数関数ではyを使わない)
+    std::shared_ptr<std::vector<T>> bx, by; // 速度計測用のブロック(格子からの無作為抽出)
+
+    void MakeBlocks(std::size_t length)
+    {
+      Random rng(3);
+      bx = std::make_shared<std::vector<T>>(length);
+      by = std::make_shared<std::vector<T>>(length);
+      for (std::size_t i = 0; i < length; ++i)
+      {
+        const std::size_t j = static_cast<std::size_t>(rng.NextU64() % x.size());
+        (*bx)[i] = x[j];
+        (*by)[i] = y.empty() ? T() : y[j];
+      }
+    }
+  };
+
+  template <class T>
+  Grid<T> LinearGrid(double lo, double hi, std::size_t points)
+  {
+    Grid<T> g;
+    g.x.resize(points);
+    for (std::size_t i = 0; i < points; ++i)
+    {
+      g.x[i] = static_cast<T>(lo + (hi - lo) * static_cast<double>(i) / static_cast<double>(points - 1));
+    }
+    g.MakeBlocks(4096);
+    return g;
+  }
+
+  template <class T>
+  Grid<T> SquareGrid(double lo, double hi, std::size_t points)
+  {
+    const std::size_t side = std::max<std::size_t>(2, static_cast<std::size_t>(std::sqrt(static_cast<double>(points))));
+    Grid<T> g;
+    g.x.reserve(side * side);
+    g.y.reserve(side * side);
+    for (std::size_t i = 0; i < side; ++i)
+    {
+      for (std::size_t j = 0; j < side; ++j)
+      {
+        g.x.push_back(static_cast<T>(lo + (hi - lo) * static_cast<double>(i) / static_cast<double>(side - 1)));
+        g.y.push_back(static_cast<T>(lo + (hi - lo) * static_cast<double>(j) / static_cast<double>(side - 1)));
+      }
+    }
+    g.MakeBlocks(4096);
+    return g;
+  }
+
+  class Harness
+  {
+  private:
+    const Options &opt;
+    std::vector<Variant> variants;
+
+    // 速度計測
+    // block(x, y, out, length)でブロック単位に処理する
+    template <class T, class Block>
+    Summary Throughput(const std::string &function, const std::string &name, const Grid<T> &g, Block block)
+    {
+      auto bx = g.bx;
+      auto by = g.by;
+      auto out = std::make_shared<std::vector<T>>(bx->size());
+      const Case bench{function, TypeName<T>(), "", name, [bx, by, out, block]()
+      {
+        block(bx->data(), by->data(), out->data(), bx->size());
+        DoNotOptimize(out->front());
+        ClobberMemory();
+        return bx->size();
+      }};
+      return Measure(bench, opt).ns_per_sample;
+    }
+
+    // 1サンプルずつの関数をブロック単位の処理にする
+    template <class T, class Func>
+    static std::function<void(const T*, const T*, T*, std::size_t)> PerSample(Func func)
+    {
+      return [func](const T* x, const T* y, T* out, std::size_t length)
+      {
+        for (std::size_t i = 0; i < length; ++i)
+        {
+          out[i] = func(x[i], y[i]);
+        }
+      };
+    }
+
+    bool Skip(const std::string &function, const std::string &name) const
+    {
+      return !opt.filter.empty() && (function + "/" + name).find(opt.filter) == std::string::npos;
+    }
+
+  public:
+    explicit Harness(const Options &opt) : opt(opt) {}
+
+    const std::vector<Variant>& Get(void) const
+    {
+      return variants;
+    }
+
+    // 1変数関数
+    template <class T, class Func, class Ref>
+    void Unary(const std::string &function, const std::string &name, const Grid<T> &g, Func func, Ref ref)
+    {
+      if (Skip(function, name))
+      {
+        return;
+      }
+      ErrorAccumulator<T> acc;
+      for (const T x : g.x)
+      {
+        acc.Add(func(x), ref(static_cast<long double>(x)), static_cast<double>(x));
+      }
+      auto block = PerSample<T>([func](T x, T) { return func(x); });
+      variants.push_back(Variant{function, name, TypeName<T>(), acc.Get(), Throughput(function, name, g, block)});
+    }
+
+    // 2変数関数
+    template <class T, class Func, class Ref>
+    void Binary(const std::string &function, const std::string &name, const Grid<T> &g, Func func, Ref ref)
+    {
+      if (Skip(function, name))
+      {
+        return;
+      }
+      ErrorAccumulator<T> acc;
+      for (std::size_t i = 0; i < g.x.size(); ++i)
+      {
+        acc.Add(func(g.x[i], g.y[i]), ref(static_cast<long double>(g.x[i]), static_cast<long double>(g.y[i])),
+          static_cast<double>(g.x[i]));
+      }
+      variants.push_back(Variant{function, name, TypeName<T>(), acc.Get(), Throughput(function, name, g, PerSample<T>(func))});
+    }
+
+    // 配列処理の関数(block(x, y, out, length)、1変数関数ではyを使わない)
+    template <class T, class Block, class Ref>
+    void Array(const std::string &function, const std::string &name, const Grid<T> &g, Block block, Ref ref)
+    {
+      if (Skip(function, name))
+      {
+        return;
+      }
+      std::vector<T> y = g.y;
+      y.resize(g.x.size());
+      std::vector<T> out(g.x.size());
+      block(g.x.data(), y.data(), out.data(), g.x.size());
+      ErrorAccumulator<T> acc;
+      for (std::size_t i = 0; i < g.x.size(); ++i)
+      {
+        acc.Add(out[i], ref(static_cast<long double>(g.x[i]), static_cast<long double>(y[i])), static_cast<double>(g.x[i]));
+      }
+      variants.push_back(Variant{function, name, TypeName<T>(), acc.Get(), Throughput(function, name, g, block)});
+    }
+  };
+
+  template <std::size_t Order, class T>
+  void AtanOrder(Harness &h, const Grid<T> &g1, const Grid<T> &g2)
+  {
+    const std::string name = "Atan<" + std::to_string(Order) + ">";
+    h.Unary<T>("atan", name, g1, [](T x) { return MyDSP::Atan<Order>(x); },
+      [](long double x) { return std::atan(x); });
+    h.Binary<T>("atan2", "Atan2<" + std::to_string(Order) + ">", g2, [](T x, T y) { return MyDSP::Atan2<Order>(y, x); },
+      [](long double x, long double y) { return std::atan2(y, x); });
+  }
+
+  template <std::size_t Order, class T>
+  void SinCosOrder(Harness &h, const Grid<T> &g)
+  {
+    const std::string name = "SinCos<" + std::to_string(Order) + ">";
+    h.Unary<T>("sin", name, g, [](T x) { T s, c; MyDSP::SinCos<Order>(x, &s, &c); return s; },
+      [](long double x) { return std::sin(x); });
+    h.Unary<T>("cos", name, g, [](T x) { T s, c; MyDSP::SinCos<Order>(x, &s, &c); return c; },
+      [](long double x) { return std::cos(x); });
+  }
+
+  // 平方根・逆平方根・2乗ノルムの配列処理
+  template <MyDSP::SqrtAccuracy Accuracy, class T>
+  void SqrtArray(Harness &h, const std::string &accuracy, const Grid<T> &sqrt_grid, const Grid<T> &rsqrt_grid,
+    const Grid<T> &hypot_grid)
+  {
+    h.Array<T>("sqrt", "Sqrt[" + accuracy + "]", sqrt_grid,
+      [](const T* x, const T*, T* out, std::size_t n) { MyDSP::Sqrt<Accuracy>(x, out, n); },
+      [](long double x, long double) { return std::sqrt(x); });
+    h.Array<T>("rsqrt", "RSqrt[" + accuracy + "]", rsqrt_grid,
+      [](const T* x, const T*, T* out, std::size_t n) { MyDSP::RSqrt<Accuracy>(x, out, n); },
+      [](long double x, long double) { return 1 / std::sqrt(x); });
+    h.Array<T>("hypot", "Hypot[" + accuracy + "]", hypot_grid,
+      [](const T* x, const T* y, T* out, std::size_t n) { MyDSP::Hypot<Accuracy>(x, y, out, n); },
+      [](long double x, long double y) { return std::hypot(x, y); });
+    h.Array<T>("hypot", "HypotS[" + accuracy + "]", hypot_grid,
+      [](const T* x, const T* y, T* out, std::size_t n) { MyDSP::HypotScaled<Accuracy>(x, y, out, n); },
+      [](long double x, long double y) { return std::hypot(x, y); });
+  }
+
+  template <class T>
+  void Sweep(Harness &h, std::size_t points)
+  {
+    const Grid<T> atan_grid  = LinearGrid<T>(-16.0, 16.0, points);
+    const Grid<T> atan2_grid = SquareGrid<T>(-1.0, 1.0, points);
+    const Grid<T> trig_grid  = LinearGrid<T>(-MyDSP::Pi<double>(), MyDSP::Pi<double>(), points);
+    const Grid<T> sqrt_grid  = LinearGrid<T>(0.0, 1e4, points);
+    const Grid<T> hypot_grid = SquareGrid<T>(-1e3, 1e3, points);
+    const Grid<T> rsqrt_grid = LinearGrid<T>(1e-3, 1e4, points);
+
+    // atan / atan2
+    h.Unary<T>("atan", "Atan", atan_grid, [](T x) { return MyDSP::Atan(x); },
+      [](long double x) { return std::atan(x); });
+    h.Unary<T>("atan", "std::atan", atan_grid, [](T x) { return std::atan(x); },
+      [](long double x) { return std::atan(x); });
+    h.Binary<T>("atan2", "Atan2", atan2_grid, [](T x, T y) { return MyDSP::Atan2(y, x); },
+      [](long double x, long double y) { return std::atan2(y, x); });
+    h.Binary<T>("atan2", "std::atan2", atan2_grid, [](T x, T y) { return std::atan2(y, x); },
+      [](long double x, long double y) { return std::atan2(y, x); });
+    AtanOrder<3>(h, atan_grid, atan2_grid);
+    AtanOrder<5>(h, atan_grid, atan2_grid);
+    AtanOrder<7>(h, atan_grid, atan2_grid);
+    AtanOrder<9>(h, atan_grid, atan2_grid);
+    AtanOrder<11>(h, atan_grid, atan2_grid);
+    AtanOrder<13>(h, atan_grid, atan2_grid);
+    AtanOrder<15>(h, atan_grid, atan2_grid);
+    AtanOrder<17>(h, atan_grid, atan2_grid);
+
+    // sin / cos
+    h.Unary<T>("sin", "SinCos", trig_grid, [](T x) { T s, c; MyDSP::SinCos(x, &s, &c); return s; },
+      [](long double x) { return std::sin(x); });
+    h.Unary<T>("cos", "SinCos", trig_grid, [](T x) { T s, c; MyDSP::SinCos(x, &s, &c); return c; },
+      [](long double x) { return std::cos(x); });
+    h.Unary<T>("sin", "std::sin", trig_grid, [](T x) { return std::sin(x); },
+      [](long double x) { return std::sin(x); });
+    h.Unary<T>("cos", "std::cos", trig_grid, [](T x) { return std::cos(x); },
+      [](long double x) { return std::cos(x); });
+    SinCosOrder<3>(h, trig_grid);
+    SinCosOrder<5>(h, trig_grid);
+    SinCosOrder<7>(h, trig_grid);
+    SinCosOrder<9>(h, trig_grid);
+    SinCosOrder<11>(h, trig_grid);
+
+    // sqrt / hypot
+    h.Unary<T>("sqrt", "Sqrt", sqrt_grid, [](T x) { return MyDSP::Sqrt(x); },
+      [](long double x) { return std::sqrt(x); });
+    h.Unary<T>("sqrt", "std::sqrt", sqrt_grid, [](T x) { return std::sqrt(x); },
+      [](long double x) { return std::sqrt(x); });
+    h.Binary<T>("hypot", "Hypot", hypot_grid, [](T x, T y) { return MyDSP::Hypot(x, y); },
+      [](long double x, long double y) { return std::hypot(x, y); });
+    h.Binary<T>("hypot", "std::hypot", hypot_grid, [](T x, T y) { return std::hypot(x, y); },
+      [](long double x, long double y) { return std::hypot(x, y); });
+    h.Unary<T>("rsqrt", "1/std::sqrt", rsqrt_grid, [](T x) { return T(1) / std::sqrt(x); },
+      [](long double x) { return 1 / std::sqrt(x); });
+
+    // 配列処理(実行時に命令セットを選択)
+    SqrtArray<MyDSP::SqrtAccuracy::Fast>(h, "fast", sqrt_grid, rsqrt_grid, hypot_grid);
+    SqrtArray<MyDSP::SqrtAccuracy::Medium>(h, "medium", sqrt_grid, rsqrt_grid, hypot_grid);
+    SqrtArray<MyDSP::SqrtAccuracy::High>(h, "high", sqrt_grid, rsqrt_grid, hypot_grid);
+    SqrtArray<MyDSP::SqrtAccuracy::Exact>(h, "exact", sqrt_grid, rsqrt_grid, hypot_grid);
+  }
+
+  void Print(const std::vector<Variant> &variants)
+  {
+    std::cout << std::left << std::setw(8) << "func" << std::setw(8) << "type" << std::setw(16) << "variant"
+              << std::right << std::setw(12) << "max_abs" << std::setw(12) << "rms_abs" << std::setw(12) << "max_ulp"
+              << std::setw(12) << "worst_in" << std::setw(12) << "ns/sample" << "\n";
+    for (const Variant &v : variants)
+    {
+      std::cout << std::left << std::setw(8) << v.function << std::setw(8) << v.type << std::setw(16) << v.name
+                << std::right << std::setprecision(3) << std::scientific
+                << std::setw(12) << v.error.max_abs << std::setw(12) << v.error.rms_abs
+                << std::setw(12) << v.error.max_ulp << std::setw(12) << v.error.worst_input
+                << std::fixed << std::setw(12) << v.ns_per_sample.median << "\n";
+      std::cout.unsetf(std::ios::floatfield);
+    }
+  }
+
+  // 予算を満たす実装のうち最速のものを表示
+  void PrintCheapest(const std::vector<Variant> &variants, double budget)
+  {
+    std::cout << "\ncheapest variant with max_abs <= " << budget << "\n";
+    for (std::size_t i = 0; i < variants.size(); ++i)
+    {
+      const Variant &v = variants[i];
+      bool first = true;
+      for (std::size_t j = 0; j < i; ++j)
+      {
+        first = first && !(variants[j].function == v.function && variants[j].type == v.type);
+      }
+      if (!first)
+      {
+        continue;
+      }
+      const Variant* best = nullptr;
+      for (const Variant &w : variants)
+      {
+        if (w.function == v.function && w.type == v.type && w.error.max_abs <= budget &&
+          (best == nullptr || w.ns_per_sample.median < best->ns_per_sample.median))
+        {
+          best = &w;
+        }
+      }
+      std::cout << "  " << std::left << std::setw(8) << v.function << std::setw(8) << v.type
+                << (best ? best->name : std::string("(none)")) << "\n";
+    }
+  }
+
+  int WriteJson(const std::vector<Variant> &variants, const std::string &path, int pinned_cpu)
+  {
+    std::ofstream os(path);
+    if (!os)
+    {
+      std::cerr << "cannot open " << path << "\n";
+      return 1;
+    }
+    os << "{\n  \"suite\": \"MyDSPMathAccuracy\",\n  \"context\": {" << ContextJson(pinned_cpu)
+       << "},\n  \"variants\": [";
+    for (std::size_t i = 0; i < variants.size(); ++i)
+    {
+      const Variant &v = variants[i];
+      os << (i ? ",\n" : "\n")
+         << "    {\"function\": " << JsonEscape(v.function)
+         << ", \"variant\": " << JsonEscape(v.name)
+         << ", \"type\": " << JsonEscape(v.type)
+         << ", \"max_abs\": " << JsonNumber(v.error.max_abs)
+         << ", \"rms_abs\": " << JsonNumber(v.error.rms_abs)
+         << ", \"max_ulp\": " << JsonNumber(v.error.max_ulp)
+         << ", \"worst_input\": " << JsonNumber(v.error.worst_input)
+         << ", \"ns_per_sample\": {\"min\": " << JsonNumber(v.ns_per_sample.min)
+         << ", \"median\": " << JsonNumber(v.ns_per_sample.median)
+         << ", \"stddev\": " << JsonNumber(v.ns_per_sample.stddev) << "}}";
+    }
+    os << "\n  ]\n}\n";
+    return os ? 0 : 1;
+  }
+
+} /* namespace */
+
+int main(int argc, char** argv)
+{
+  // 本プログラム固有の引数を取り除いてから共通の引数を解釈する
+  double budget = -1;
+  std::size_t points = 1u << 20;
+  std::vector<char*> args{argv[0]};
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    if (arg == "--budget" && i + 1 < argc)
+    {
+      budget = std::atof(argv[++i]);
+    }
+    else if (arg == "--points" && i + 1 < argc)
+    {
+      points = std::max<std::size_t>(16, static_cast<std::size_t>(std::atof(argv[++i])));
+    }
+    else
+    {
+      args.push_back(argv[i]);
+    }
+  }
+
+  MyDSPBench::Options opt;
+  opt.repetitions = 5;
+  if (!MyDSPBench::ParseOptions(static_cast<int>(args.size()), args.data(), opt, std::cerr))
+  {
+    std::cerr << "additional options: [--budget max_abs_error] [--points grid_points]\n";
+    return 2;
+  }
+  const int pinned_cpu = opt.pin ? MyDSPBench::PinToCpu(opt.cpu) : -1;
+
+  Harness harness(opt);
+  Sweep<float>(harness, points);
+  Sweep<double>(harness, points);
+
+  Print(harness.Get());
+  if (budget >= 0)
+  {
+    PrintCheapest(harness.Get(), budget);
+  }
+  return opt.json_path.empty() ? 0 : WriteJson(harness.Get(), opt.json_path, pinned_cpu);
+}
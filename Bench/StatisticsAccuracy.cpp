@@ -0,0 +1,197 @@
+/*
+ * StatisticsAccuracy.cpp
+ *
+ *  Created on: 2026/10/18
+ *      Author: Shibasaki
+ *
+ * 移動分散(MovingVariance, MovingVarianceBank)の精度の確認
+ * 直流成分を含む入力と、直流成分が途中で変化する入力について、long doubleで窓ごとに2回の走査で求めた分散を基準として誤差を測る
+ * 和は基準値(前回の再計算時の窓の平均)を引いて保持しているので、直流成分が変わってから次の再計算までは誤差が大きくなりうる
+ * そのため、変化後の窓が埋まってから最初の再計算以降(settled)の誤差で合否を判定し、それ以前(transient)の相対誤差は参考として表示する
+ * 終了コードは誤差が許容値を超えたときだけ1にする
+ */
+
+#include "MyDSP/Statistics.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+  constexpr std::size_t NumChannels = 8;
+  constexpr double Tolerance = 1e-3; // 許容する誤差(入力の雑音の分散は1/3)
+
+  // 入力の条件
+  struct Case
+  {
+    std::string name;
+    double offset_before; // 変化前の直流成分
+    double offset_after;  // 変化後の直流成分
+    std::size_t step;     // 直流成分が変化するサンプル位置
+  };
+
+  // 評価結果
+  struct Result
+  {
+    std::string target;   // 評価したクラスと処理の方法
+    std::size_t window;   // 窓長
+    std::string input;    // 入力の条件
+    double settled;       // 再計算後の誤差の最大値
+    double transient;     // 変化の直後から再計算までの相対誤差(基準の分散と雑音の分散の大きい方に対する比)の最大値
+    bool ok;
+  };
+
+  // 入力信号([sample][channel])
+  // チャネルごとに直流成分の大きさを変え、[-1, 1)の一様乱数を加える
+  std::vector<float> MakeSignal(const Case &c, std::size_t length)
+  {
+    std::mt19937 engine(12345);
+    std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+    std::vector<float> x(length * NumChannels);
+    for (std::size_t n = 0; n < length; ++n)
+    {
+      for (std::size_t ch = 0; ch < NumChannels; ++ch)
+      {
+        const double scale = 1.0 - 0.1 * static_cast<double>(ch);
+        const double offset = (n < c.step) ? c.offset_before : c.offset_after;
+        x[n * NumChannels + ch] = static_cast<float>(offset * scale) + noise(engine);
+      }
+    }
+    return x;
+  }
+
+  // 基準の分散(窓が埋まるまでは不足分を0とみなす)
+  std::vector<double> Reference(const std::vector<float> &x, std::size_t length, std::size_t window)
+  {
+    std::vector<double> y(length * NumChannels);
+    for (std::size_t n = 0; n < length; ++n)
+    {
+      for (std::size_t ch = 0; ch < NumChannels; ++ch)
+      {
+        long double mean = 0;
+        for (std::size_t i = 0; i < window && i <= n; ++i)
+        {
+          mean += x[(n - i) * NumChannels + ch];
+        }
+        mean /= static_cast<long double>(window);
+        long double sum = 0;
+        for (std::size_t i = 0; i < window; ++i)
+        {
+          const long double d = ((i <= n) ? static_cast<long double>(x[(n - i) * NumChannels + ch]) : 0.0L) - mean;
+          sum += d * d;
+        }
+        y[n * NumChannels + ch] = static_cast<double>(sum / static_cast<long double>(window));
+      }
+    }
+    return y;
+  }
+
+  // 出力と基準の比較
+  // channels: 比較するチャネル数(先頭から)
+  Result Compare(const std::string &target, std::size_t window, const Case &c, const std::vector<float> &y,
+    const std::vector<double> &reference, std::size_t length, std::size_t channels)
+  {
+    // 再計算はwindowサンプルごとに行われるので、変化後の窓が埋まってからwindowサンプル経てば再計算を1回以上通る
+    const std::size_t settled_from = c.step + 2 * window;
+    Result result{target, window, c.name, 0.0, 0.0, true};
+    for (std::size_t n = c.step; n < length; ++n)
+    {
+      for (std::size_t ch = 0; ch < channels; ++ch)
+      {
+        const double expected = reference[n * NumChannels + ch];
+        const double error = std::abs(static_cast<double>(y[n * NumChannels + ch]) - expected);
+        if (n >= settled_from)
+        {
+          result.settled = std::isfinite(error) ? std::max(result.settled, error) : HUGE_VAL;
+        }
+        else
+        {
+          const double relative = error / std::max(expected, 1.0 / 3.0);
+          result.transient = std::isfinite(relative) ? std::max(result.transient, relative) : HUGE_VAL;
+        }
+      }
+    }
+    result.ok = result.settled <= Tolerance;
+    return result;
+  }
+
+  template <std::size_t N>
+  void Evaluate(const Case &c, std::vector<Result> &results)
+  {
+    const std::size_t length = c.step + 4 * N;
+    const std::vector<float> x = MakeSignal(c, length);
+    const std::vector<double> reference = Reference(x, length, N);
+    std::vector<float> y(length * NumChannels);
+
+    // 1チャネル(1サンプルずつ)
+    {
+      MyDSP::MovingVariance<float,N> filter;
+      for (std::size_t n = 0; n < length; ++n)
+      {
+        y[n * NumChannels] = filter(x[n * NumChannels]);
+      }
+      results.push_back(Compare("MovingVariance", N, c, y, reference, length, 1));
+    }
+    // 多チャネル(1フレームずつ)
+    {
+      MyDSP::MovingVarianceBank<float,N,NumChannels> filter;
+      for (std::size_t n = 0; n < length; ++n)
+      {
+        float in[NumChannels];
+        float out[NumChannels];
+        std::copy(&x[n * NumChannels], &x[n * NumChannels] + NumChannels, in);
+        filter(in, out);
+        std::copy(out, out + NumChannels, &y[n * NumChannels]);
+      }
+      results.push_back(Compare("MovingVarianceBank", N, c, y, reference, length, NumChannels));
+    }
+    // 多チャネル(ブロック処理, 窓長の倍数でないブロック長にして再計算の位置をずらす)
+    {
+      MyDSP::MovingVarianceBank<float,N,NumChannels> filter;
+      const std::size_t chunk = 100;
+      for (std::size_t pos = 0; pos < length; pos += chunk)
+      {
+        const std::size_t frames = std::min(chunk, length - pos);
+        filter.Process(&x[pos * NumChannels], &y[pos * NumChannels], frames);
+      }
+      results.push_back(Compare("MovingVarianceBank::Process", N, c, y, reference, length, NumChannels));
+    }
+  }
+
+  void Print(const std::vector<Result> &results)
+  {
+    std::cout << std::left << std::setw(28) << "target" << std::right << std::setw(7) << "window" << "  "
+      << std::left << std::setw(16) << "input" << std::right << std::setw(13) << "settled" << std::setw(13) << "transient"
+      << "  result\n";
+    for (const Result &r : results)
+    {
+      std::cout << std::left << std::setw(28) << r.target << std::right << std::setw(7) << r.window << "  "
+        << std::left << std::setw(16) << r.input << std::right << std::scientific << std::setprecision(3)
+        << std::setw(13) << r.settled << std::setw(13) << r.transient << std::defaultfloat
+        << "  " << (r.ok ? "ok" : "FAILED") << "\n";
+    }
+  }
+}
+
+int main(void)
+{
+  const std::vector<Case> cases{
+    {"dc 1e4",        1e4,  1e4,  0},
+    {"step 0->1e4",   0.0,  1e4,  500},
+    {"step 1e4->0",   1e4,  0.0,  500},
+    {"step -3e3->5e3", -3e3, 5e3, 1000},
+  };
+  std::vector<Result> results;
+  for (const Case &c : cases)
+  {
+    Evaluate<64>(c, results);
+    Evaluate<256>(c, results);
+  }
+  Print(results);
+  const bool all_ok = std::all_of(results.begin(), results.end(), [](const Result &r) { return r.ok; });
+  return all_ok ? 0 : 1;
+}
@@ -0,0 +1,465 @@
+/*
+ * StorageAccuracy.cpp
+ *
+ *  Created on: 2026/10/18
+ *      Author: Shibasaki
+ *
+ * 係数・状態変数を縮小精度(Half/BFloat16)で格納したフィルタの精度の評価
+ * フィルタの種類ごとに、係数・状態変数ともfloatのフィルタの出力を基準として
+ * 白色雑音入力に対する出力のSN比と最大絶対誤差、係数の丸めによる周波数応答の誤差、
+ * IIRフィルタでは丸めた係数の極の最大半径を求める
+ * --budget を指定すると、各フィルタについてSN比が基準を満たす最小の格納形式を表示する
+ */
+
+#include "MyDSP/Filter.hpp"
+#include "MyDSP/Storage.hpp"
+#include "MyDSP/Const.hpp"
+#include "BenchCommon.hpp"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+  using namespace MyDSPBench;
+
+  // 評価結果
+  struct Variant
+  {
+    std::string filter;  // FIR, IIRBiquadCascadeDF2T, IIRBiquadCascadeDF2TBank
+    std::string param;   // 設計条件
+    std::string coeffs;  // 係数の格納型
+    std::string state;   // 状態変数の格納型
+    std::size_t bytes;   // フィルタ1個(バンクは1チャネル)あたりの大きさ
+    double snr_db;       // 出力のSN比
+    double max_abs;      // 出力の最大絶対誤差
+    double response_db;  // 周波数応答の誤差の最大値(20log10|H_q - H|)
+    double pole_radius;  // 丸めた係数の極の最大半径(FIRでは0)
+  };
+
+  template <class T> struct StorageName;
+  template <> struct StorageName<float>           { static std::string Get() { return "float"; } };
+  template <> struct StorageName<MyDSP::Half>     { static std::string Get() { return "half"; } };
+  template <> struct StorageName<MyDSP::BFloat16> { static std::string Get() { return "bf16"; } };
+
+  // 評価条件
+  struct Condition
+  {
+    std::size_t length = 1u << 16; // 入力の長さ
+    std::size_t block = 64;        // Processに渡すブロック長(状態変数の丸めはブロックごと)
+  };
+
+  // 一様白色雑音([-1 1))
+  std::vector<float> Noise(std::size_t length)
+  {
+    Random rng(7);
+    std::vector<float> x(length);
+    for (float &value : x)
+    {
+      value = static_cast<float>(rng.Uniform(-1.0, 1.0));
+    }
+    return x;
+  }
+
+  // 出力の誤差の集計
+  void CompareOutputs(const std::vector<float> &ref, const std::vector<float> &out, Variant &v)
+  {
+    double power = 0;
+    double error = 0;
+    v.max_abs = 0;
+    for (std::size_t n = 0; n < ref.size(); ++n)
+    {
+      const double e = static_cast<double>(out[n]) - static_cast<double>(ref[n]);
+      power += static_cast<double>(ref[n]) * ref[n];
+      error += e * e;
+      if (!(std::fabs(e) <= v.max_abs)) // NaNも最悪値として記録する
+      {
+        v.max_abs = std::fabs(e);
+      }
+    }
+    v.snr_db = 10.0 * std::log10(power / error);
+  }
+
+  // ブロックごとの処理
+  template <class Filter>
+  std::vector<float> Run(Filter &filter, const std::vector<float> &in, std::size_t block)
+  {
+    std::vector<float> out(in.size());
+    for (std::size_t n = 0; n < in.size(); n += block)
+    {
+      filter.Process(in.data() + n, out.data() + n, std::min(block, in.size() - n));
+    }
+    return out;
+  }
+
+  // 周波数応答の誤差(周波数の格子上の|H_q - H|の最大値をdBで表す)
+  template <class Response>
+  double ResponseError(Response response_ref, Response response)
+  {
+    constexpr std::size_t points = 4096;
+    double max_err = 0;
+    for (std::size_t k = 0; k <= points; ++k)
+    {
+      const double omega = MyDSP::Pi<double>() * static_cast<double>(k) / points;
+      max_err = std::max(max_err, std::abs(response(omega) - response_ref(omega)));
+    }
+    return 20.0 * std::log10(max_err);
+  }
+
+  // FIRフィルタの周波数応答
+  struct FIRResponse
+  {
+    std::vector<double> h;
+    std::complex<double> operator()(double omega) const
+    {
+      std::complex<double> sum = 0;
+      for (std::size_t k = 0; k < h.size(); ++k)
+      {
+        sum += h[k] * std::polar(1.0, -omega * static_cast<double>(k));
+      }
+      return sum;
+    }
+  };
+
+  // 従属型双二次IIRフィルタの周波数応答
+  // y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] + a1 y[n-1] + a2 y[n-2]
+  struct BiquadResponse
+  {
+    std::vector<double> c; // [stage][5]
+    std::complex<double> operator()(double omega) const
+    {
+      const std::complex<double> z1 = std::polar(1.0, -omega);
+      const std::complex<double> z2 = z1 * z1;
+      std::complex<double> h = 1;
+      for (std::size_t i = 0; i + 5 <= c.size(); i += 5)
+      {
+        h *= (c[i] + c[i+1] * z1 + c[i+2] * z2) / (1.0 - c[i+3] * z1 - c[i+4] * z2);
+      }
+      return h;
+    }
+
+    // 極の最大半径(z^2 - a1 z - a2 = 0 の根)
+    double PoleRadius(void) const
+    {
+      double radius = 0;
+      for (std::size_t i = 0; i + 5 <= c.size(); i += 5)
+      {
+        const std::complex<double> d = std::sqrt(std::complex<double>(c[i+3] * c[i+3] + 4.0 * c[i+4]));
+        radius = std::max(radius, std::max(std::abs((c[i+3] + d) * 0.5), std::abs((c[i+3] - d) * 0.5)));
+      }
+      return radius;
+    }
+  };
+
+  // Blackman窓をかけた窓関数法による低域通過FIRフィルタ
+  // cutoff: 遮断周波数(サンプリング周波数で正規化)
+  template <std::size_t NumTaps>
+  struct LowpassFIR
+  {
+    float values[NumTaps];
+    explicit LowpassFIR(double cutoff)
+    {
+      const double center = (NumTaps - 1) * 0.5;
+      for (std::size_t k = 0; k < NumTaps; ++k)
+      {
+        const double t = static_cast<double>(k) - center;
+        const double phase = 2.0 * MyDSP::Pi<double>() * static_cast<double>(k) / (NumTaps - 1);
+        const double window = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+        const double sinc = (t == 0) ? 2.0 * cutoff
+          : std::sin(2.0 * MyDSP::Pi<double>() * cutoff * t) / (MyDSP::Pi<double>() * t);
+        values[k] = static_cast<float>(sinc * window);
+      }
+    }
+  };
+
+  // 双一次変換によるButterworth低域通過フィルタ(2*NumStages次)
+  template <std::size_t NumStages>
+  struct ButterworthBiquads
+  {
+    float values[NumStages][5];
+    explicit ButterworthBiquads(double cutoff)
+    {
+      const double omega = 2.0 * MyDSP::Pi<double>() * cutoff;
+      for (std::size_t stage = 0; stage < NumStages; ++stage)
+      {
+        const double q = 1.0 / (2.0 * std::cos(MyDSP::Pi<double>() * (2.0 * stage + 1.0) / (4.0 * NumStages)));
+        const double alpha = std::sin(omega) / (2.0 * q);
+        const double cosw = std::cos(omega);
+        const double a0 = 1.0 + alpha;
+        values[stage][0] = static_cast<float>((1.0 - cosw) * 0.5 / a0);
+        values[stage][1] = static_cast<float>((1.0 - cosw) / a0);
+        values[stage][2] = static_cast<float>((1.0 - cosw) * 0.5 / a0);
+        values[stage][3] = static_cast<float>(2.0 * cosw / a0);
+        values[stage][4] = static_cast<float>(-(1.0 - alpha) / a0);
+      }
+    }
+  };
+
+  class Harness
+  {
+  private:
+    const Options &opt;
+    const Condition &cond;
+    const std::vector<float> input;
+    std::vector<Variant> variants;
+
+    bool Selected(const std::string &filter, const std::string &param) const
+    {
+      return opt.filter.empty() || (filter + "/" + param).find(opt.filter) != std::string::npos;
+    }
+
+  public:
+    Harness(const Options &opt, const Condition &cond) :
+      opt(opt),
+      cond(cond),
+      input(Noise(cond.length))
+    {}
+
+    const std::vector<Variant>& Get(void) const
+    {
+      return variants;
+    }
+
+    // FIRフィルタ
+    template <class TC, class TS, std::size_t NumTaps>
+    void FIR(const std::string &param, const LowpassFIR<NumTaps> &design)
+    {
+      if (!Selected("FIR", param))
+      {
+        return;
+      }
+      using Reference = MyDSP::FIR<float,float,NumTaps>;
+      using Filter = MyDSP::FIR<float,TC,NumTaps,TS>;
+      std::unique_ptr<Reference> reference(new Reference(design.values));
+      std::unique_ptr<Filter> filter(new Filter(design.values));
+
+      Variant v{"FIR", param, StorageName<TC>::Get(), StorageName<TS>::Get(), sizeof(Filter), 0, 0, 0, 0};
+      CompareOutputs(Run(*reference, input, cond.block), Run(*filter, input, cond.block), v);
+      FIRResponse ref_response{std::vector<double>(design.values, design.values + NumTaps)};
+      FIRResponse response{std::vector<double>(NumTaps)};
+      for (std::size_t k = 0; k < NumTaps; ++k)
+      {
+        response.h[k] = static_cast<float>(filter->GetCoeffs()[k]);
+      }
+      v.response_db = ResponseError(ref_response, response);
+      variants.push_back(v);
+    }
+
+    // 従属型双二次IIRフィルタ(1チャネル、および多チャネル版の1チャネル分)
+    template <class TC, class TS, std::size_t NumStages>
+    void Biquad(const std::string &param, const ButterworthBiquads<NumStages> &design)
+    {
+      constexpr std::size_t num_channels = 8;
+      using Reference = MyDSP::IIRBiquadCascadeDF2T<float,float,NumStages>;
+      using Filter = MyDSP::IIRBiquadCascadeDF2T<float,TC,NumStages,TS>;
+      using ReferenceBank = MyDSP::IIRBiquadCascadeDF2TBank<float,NumStages,num_channels>;
+      using Bank = MyDSP::IIRBiquadCascadeDF2TBank<float,NumStages,num_channels,TC,TS>;
+
+      BiquadResponse ref_response{std::vector<double>(&design.values[0][0], &design.values[0][0] + NumStages * 5)};
+      BiquadResponse response{std::vector<double>(NumStages * 5)};
+      for (std::size_t i = 0; i < NumStages * 5; ++i)
+      {
+        response.c[i] = static_cast<float>(static_cast<TC>((&design.values[0][0])[i]));
+      }
+
+      if (Selected("IIRBiquadCascadeDF2T", param))
+      {
+        Reference reference(design.values);
+        Filter filter(design.values);
+        Variant v{"IIRBiquadCascadeDF2T", param, StorageName<TC>::Get(), StorageName<TS>::Get(), sizeof(Filter),
+          0, 0, 0, response.PoleRadius()};
+        CompareOutputs(Run(reference, input, cond.block), Run(filter, input, cond.block), v);
+        v.response_db = ResponseError(ref_response, response);
+        variants.push_back(v);
+      }
+
+      if (Selected("IIRBiquadCascadeDF2TBank", param))
+      {
+        // 全チャネルに同じ入力を与え、全チャネル分の出力を比較する
+        std::unique_ptr<ReferenceBank> reference(new ReferenceBank(design.values));
+        std::unique_ptr<Bank> bank(new Bank(design.values));
+        std::vector<float> in(input.size() * num_channels);
+        for (std::size_t n = 0; n < input.size(); ++n)
+        {
+          std::fill(in.begin() + n * num_channels, in.begin() + (n + 1) * num_channels, input[n]);
+        }
+        std::vector<float> ref_out(in.size());
+        std::vector<float> out(in.size());
+        for (std::size_t n = 0; n < input.size(); n += cond.block)
+        {
+          const std::size_t frames = std::min(cond.block, input.size() - n);
+          reference->Process(in.data() + n * num_channels, ref_out.data() + n * num_channels, frames);
+          bank->Process(in.data() + n * num_channels, out.data() + n * num_channels, frames);
+        }
+        Variant v{"IIRBiquadCascadeDF2TBank", param, StorageName<TC>::Get(), StorageName<TS>::Get(),
+          sizeof(Bank) / num_channels, 0, 0, 0, response.PoleRadius()};
+        CompareOutputs(ref_out, out, v);
+        v.response_db = ResponseError(ref_response, response);
+        variants.push_back(v);
+      }
+    }
+  };
+
+  // 格納形式の組み合わせ(係数・状態変数とも縮小精度、係数のみ縮小精度)
+  template <std::size_t NumTaps>
+  void FIRStorages(Harness &h, const std::string &param, const LowpassFIR<NumTaps> &design)
+  {
+    h.FIR<float,float>(param, design);
+    h.FIR<MyDSP::Half,float>(param, design);
+    h.FIR<MyDSP::Half,MyDSP::Half>(param, design);
+    h.FIR<MyDSP::BFloat16,float>(param, design);
+    h.FIR<MyDSP::BFloat16,MyDSP::BFloat16>(param, design);
+  }
+
+  template <std::size_t NumStages>
+  void BiquadStorages(Harness &h, const std::string &param, const ButterworthBiquads<NumStages> &design)
+  {
+    h.Biquad<float,float>(param, design);
+    h.Biquad<MyDSP::Half,float>(param, design);
+    h.Biquad<MyDSP::Half,MyDSP::Half>(param, design);
+    h.Biquad<MyDSP::BFloat16,float>(param, design);
+    h.Biquad<MyDSP::BFloat16,MyDSP::BFloat16>(param, design);
+  }
+
+  void Sweep(Harness &h)
+  {
+    FIRStorages(h, "63taps/lowpass-0.1", LowpassFIR<63>(0.1));
+    FIRStorages(h, "255taps/lowpass-0.01", LowpassFIR<255>(0.01));
+    BiquadStorages(h, "4th/butterworth-0.1", ButterworthBiquads<2>(0.1));
+    BiquadStorages(h, "4th/butterworth-0.01", ButterworthBiquads<2>(0.01));
+    BiquadStorages(h, "4th/butterworth-0.001", ButterworthBiquads<2>(0.001));
+    BiquadStorages(h, "8th/butterworth-0.05", ButterworthBiquads<4>(0.05));
+  }
+
+  void Print(const std::vector<Variant> &variants, const Condition &cond)
+  {
+    std::cout << "input: uniform white noise, " << cond.length << " samples, block " << cond.block << "\n";
+    std::cout << std::left << std::setw(26) << "filter" << std::setw(24) << "param" << std::setw(8) << "coeffs"
+              << std::setw(8) << "state" << std::right << std::setw(8) << "bytes" << std::setw(10) << "snr_db"
+              << std::setw(12) << "max_abs" << std::setw(10) << "resp_db" << std::setw(12) << "pole_radius" << "\n";
+    for (const Variant &v : variants)
+    {
+      std::cout << std::left << std::setw(26) << v.filter << std::setw(24) << v.param << std::setw(8) << v.coeffs
+                << std::setw(8) << v.state << std::right << std::setw(8) << v.bytes
+                << std::fixed << std::setprecision(1) << std::setw(10) << v.snr_db
+                << std::scientific << std::setprecision(2) << std::setw(12) << v.max_abs
+                << std::fixed << std::setprecision(1) << std::setw(10) << v.response_db;
+      if (v.pole_radius > 0)
+      {
+        std::cout << std::setprecision(7) << std::setw(12) << v.pole_radius;
+      }
+      std::cout << "\n";
+      std::cout.unsetf(std::ios::floatfield);
+    }
+  }
+
+  // SN比の基準を満たす格納形式のうち最小のものを表示
+  void PrintSmallest(const std::vector<Variant> &variants, double budget)
+  {
+    std::cout << "\nsmallest storage with snr_db >= " << budget << "\n";
+    for (std::size_t i = 0; i < variants.size(); ++i)
+    {
+      const Variant &v = variants[i];
+      bool first = true;
+      for (std::size_t j = 0; j < i; ++j)
+      {
+        first = first && !(variants[j].filter == v.filter && variants[j].param == v.param);
+      }
+      if (!first)
+      {
+        continue;
+      }
+      const Variant* best = nullptr;
+      for (const Variant &w : variants)
+      {
+        if (w.filter == v.filter && w.param == v.param && w.snr_db >= budget && w.pole_radius < 1.0 &&
+          (best == nullptr || w.bytes < best->bytes || (w.bytes == best->bytes && w.snr_db > best->snr_db)))
+        {
+          best = &w;
+        }
+      }
+      std::cout << "  " << std::left << std::setw(26) << v.filter << std::setw(24) << v.param
+                << (best ? "coeffs-" + best->coeffs + "/state-" + best->state : std::string("(none)")) << "\n";
+    }
+  }
+
+  int WriteJson(const std::vector<Variant> &variants, const Condition &cond, const std::string &path)
+  {
+    std::ofstream os(path);
+    if (!os)
+    {
+      std::cerr << "cannot open " << path << "\n";
+      return 1;
+    }
+    os << "{\n  \"suite\": \"MyDSPStorageAccuracy\",\n  \"context\": {" << ContextJson(-1)
+       << "},\n  \"length\": " << cond.length << ",\n  \"block\": " << cond.block << ",\n  \"variants\": [";
+    for (std::size_t i = 0; i < variants.size(); ++i)
+    {
+      const Variant &v = variants[i];
+      os << (i ? ",\n" : "\n")
+         << "    {\"filter\": " << JsonEscape(v.filter)
+         << ", \"param\": " << JsonEscape(v.param)
+         << ", \"coeffs\": " << JsonEscape(v.coeffs)
+         << ", \"state\": " << JsonEscape(v.state)
+         << ", \"bytes\": " << v.bytes
+         << ", \"snr_db\": " << JsonNumber(v.snr_db)
+         << ", \"max_abs\": " << JsonNumber(v.max_abs)
+         << ", \"response_db\": " << JsonNumber(v.response_db)
+         << ", \"pole_radius\": " << JsonNumber(v.pole_radius) << "}";
+    }
+    os << "\n  ]\n}\n";
+    return os ? 0 : 1;
+  }
+
+} /* namespace */
+
+int main(int argc, char** argv)
+{
+  // 本プログラム固有の引数を取り除いてから共通の引数を解釈する
+  double budget = -1;
+  Condition cond;
+  std::vector<char*> args{argv[0]};
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg = argv[i];
+    if (arg == "--budget" && i + 1 < argc)
+    {
+      budget = std::atof(argv[++i]);
+    }
+    else if (arg == "--block" && i + 1 < argc)
+    {
+      cond.block = std::max<std::size_t>(1, static_cast<std::size_t>(std::atof(argv[++i])));
+    }
+    else if (arg == "--length" && i + 1 < argc)
+    {
+      cond.length = std::max<std::size_t>(1024, static_cast<std::size_t>(std::atof(argv[++i])));
+    }
+    else
+    {
+      args.push_back(argv[i]);
+    }
+  }
+
+  MyDSPBench::Options opt;
+  if (!MyDSPBench::ParseOptions(static_cast<int>(args.size()), args.data(), opt, std::cerr))
+  {
+    std::cerr << "additional options: [--budget snr_db] [--block samples] [--length samples]\n";
+    return 2;
+  }
+
+  Harness harness(opt, cond);
+  Sweep(harness);
+
+  Print(harness.Get(), cond);
+  if (budget >= 0)
+  {
+    PrintSmallest(harness.Get(), budget);
+  }
+  return opt.json_path.empty() ? 0 : WriteJson(harness.Get(), cond, opt.json_path);
+}
@@ -0,0 +1,146 @@
+/*
+ * Arena.hpp
+ *
+ *  Created on: 2026/10/18
+ *      Author: Shibasaki
+ *
+ * 呼び出し側が用意した領域からの線形(バンプ)アロケータ
+ * 多数のフィルタの状態変数と係数を1つの連続領域にまとめて確保するために使う
+ * 個別の解放は行わず、Reset/Rewindでまとめて巻き戻す
+ * スレッドセーフではない(初期化時に1スレッドから使う想定)
+ */
+
+#ifndef MYDSP_ARENA_HPP_
+#define MYDSP_ARENA_HPP_
+
+#include <type_traits>
+#include <new>
+#include <cstdint>
+#include <cstddef>
+
+namespace MyDSP
+{
+  class Arena
+  {
+  public:
+    // 1回の確保ごとの境界(キャッシュライン長)
+    static constexpr std::size_t Alignment = 64;
+
+    // Alignmentの倍数への切り上げ
+    static constexpr std::size_t AlignUp(std::size_t size)
+    {
+      return (size + (Alignment - 1)) & ~(Alignment - 1);
+    }
+
+    // 要素数countの配列を確保するのに必要なバイト数
+    // 先頭がAlignment境界にある領域であれば、各確保のRequiredBytesの合計が必要な領域の大きさになる
+    template <class T>
+    static constexpr std::size_t RequiredBytes(std::size_t count)
+    {
+      return AlignUp(count * sizeof(T));
+    }
+
+  private:
+    unsigned char* begin;
+    unsigned char* top;
+    unsigned char* end;
+
+  public:
+    // コンストラクタ(領域の先頭アドレスと大きさ)
+    // 領域の所有権は移らない。Arenaおよびここから確保したオブジェクトより長く生存させること
+    Arena(void* buffer, std::size_t size) :
+      begin(static_cast<unsigned char*>(buffer)),
+      top(static_cast<unsigned char*>(buffer)),
+      end(static_cast<unsigned char*>(buffer) + size)
+    {}
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // 要素数countの配列を確保し、値初期化する
+    // 領域が足りない場合はnullptrを返す
+    template <class T>
+    T* Allocate(std::size_t count)
+    {
+      static_assert(alignof(T) <= Alignment, "Alignment of 'T' exceeds Arena::Alignment");
+      static_assert(std::is_trivially_destructible<T>::value, "Arena does not call destructors");
+
+      if (count == 0 || count > (SIZE_MAX - Alignment) / sizeof(T))
+      {
+        return nullptr;
+      }
+      const std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(top);
+      const std::size_t padding = static_cast<std::size_t>((Alignment - (addr & (Alignment - 1))) & (Alignment - 1));
+      const std::size_t bytes = RequiredBytes<T>(count);
+      if (padding > Remaining() || bytes > Remaining() - padding)
+      {
+        return nullptr;
+      }
+
+      T* ptr = reinterpret_cast<T*>(top + padding);
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        ::new (static_cast<void*>(ptr + i)) T();
+      }
+      top += padding + bytes;
+      return ptr;
+    }
+
+    // 使用済みのバイト数
+    std::size_t Used(void) const
+    {
+      return static_cast<std::size_t>(top - begin);
+    }
+
+    // 残りのバイト数
+    std::size_t Remaining(void) const
+    {
+      return static_cast<std::size_t>(end - top);
+    }
+
+    // 領域全体のバイト数
+    std::size_t Capacity(void) const
+    {
+      return static_cast<std::size_t>(end - begin);
+    }
+
+    // 使用量をUsed()で得た値まで巻き戻す(それ以降に確保したオブジェクトは無効になる)
+    void Rewind(std::size_t used)
+    {
+      if (used <= Used())
+      {
+        top = begin + used;
+      }
+    }
+
+    // 全体を巻き戻す
+    void Reset(void)
+    {
+      top = begin;
+    }
+  };
+
+  // Arena用の静的な領域
+  // 大域変数やメンバとして置けば、ヒープを使わずに済む
+  template <std::size_t Size>
+  class ArenaStorage
+  {
+  private:
+    alignas(Arena::Alignment) unsigned char buffer[Size];
+
+  public:
+    void* Data(void)
+    {
+      return buffer;
+    }
+
+    static constexpr std::size_t Capacity(void)
+    {
+      return Size;
+    }
+  };
+
+} /* namespace MyDSP */
+
+
+#endif /* MYDSP_ARENA_HPP_ */
@@ -0,0 +1,1355 @@
+/*
+ * AsyncBlockIO.hpp
+ *
+ *  Created on: 2026/10/18
+ *      Author: Shibasaki
+ *
+ * C++20のコルーチンによるサンプルブロックの非同期入出力
+ * ファイル・パイプ・ソケットからのブロックの読み込みと書き出しをawaitableにし、
+ * フィルタ処理を co_await で進むループとして書けるようにする
+ *
+ *   MyDSP::AsyncTask Stage(MyDSP::AsyncBlockSource<float> &source, MyDSP::AsyncBlockSink<float> &sink, Filter &filter)
+ *   {
+ *     while (MyDSP::SampleBlock<float> in = co_await source.Next())
+ *     {
+ *       MyDSP::SampleBlock<float> out = co_await sink.Acquire();
+ *       filter.Process(in.data, out.data, in.length);
+ *       sink.Commit(out, in.length);
+ *     }
+ *     co_await sink.Flush();
+ *   }
+ *
+ *   MyDSP::AsyncIOContext context;
+ *   MyDSP::AsyncBlockSource<float> source(context, in_fd, 4096);
+ *   MyDSP::AsyncBlockSink<float> sink(context, out_fd, 4096);
+ *   context.Run(Stage(source, sink, filter));
+ *
+ * - 入出力はNumBuffers個(既定は2)のブロックの領域を構築時に1回だけ確保して使い回す(ブロックごとの確保はない)
+ *   コルーチンがブロックnを処理している間に、ブロックn+1の読み込みとブロックn-1の書き出しが進む
+ * - 通常のファイルの読み書きはLinuxではio_uring(liburingを使わずシステムコールで直接扱う)で行う
+ *   パイプ・ソケットと、io_uringが使えない環境では読み込み用・書き込み用のワーカースレッド1本ずつで行う
+ * - 完了の処理とコルーチンの再開はすべてAsyncIOContext::Runを呼んだスレッドで行う(フィルタ処理は1スレッドのまま)
+ * - 通常のファイルは位置を指定して読み書きし(複数のブロックを同時に投入する)、
+ *   パイプ・ソケットは順序を保つため1ブロックずつ読み書きする
+ * - 読み込みはブロックが埋まるかEOFになるまで続ける(最後のブロックだけ短くなる)。サンプルの途中で終わった端数は捨てる
+ * - ファイル記述子は開いたり閉じたりしない。ブロッキングモードで渡すこと。通常のファイルの位置は進めない
+ * - 実行中の読み書きがあるままソース・シンクを破棄すると、完了するまで待つ(未投入の書き出しは捨てる)
+ * C++20(コルーチン)・POSIX環境専用。条件を満たさない場合は何も定義しない(MYDSP_HAS_ASYNC_BLOCK_IOで判定できる)
+ */
+
+#ifndef MYDSP_ASYNCBLOCKIO_HPP_
+#define MYDSP_ASYNCBLOCKIO_HPP_
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include) && defined(__unix__)
+#if __has_include(<coroutine>)
+#define MYDSP_HAS_ASYNC_BLOCK_IO 1
+#endif
+#endif
+
+#ifdef MYDSP_HAS_ASYNC_BLOCK_IO
+
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <cerrno>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+// io_uringはカーネルヘッダがあり、ファイル位置を使う読み書き(Linux 5.6以降)を指定できる場合に使う
+#if defined(__linux__) && !defined(MYDSP_DISABLE_IO_URING) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#if defined(IORING_FEAT_RW_CUR_POS) && defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define MYDSP_ASYNC_IO_URING 1
+#endif
+#endif
+#ifndef MYDSP_ASYNC_IO_URING
+#define MYDSP_ASYNC_IO_URING 0
+#endif
+
+namespace MyDSP
+{
+  // 読み書きの実装
+  enum class AsyncIOBackend
+  {
+    Auto,     // io_uringが使えればio_uring、使えなければThread
+    IoUring,
+    Thread
+  };
+
+  // 読み込んだ(または書き込む)サンプルブロック
+  // 読み込みではlengthが0ならEOF(またはエラー)
+  template <class T>
+  struct SampleBlock
+  {
+    T* data;
+    std::size_t length;
+
+    explicit operator bool(void) const noexcept
+    {
+      return length > 0;
+    }
+  };
+
+  class AsyncIOContext;
+
+  namespace Internal
+  {
+    // 1回分の読み書きの要求(ソース・シンクの各ブロックに埋め込み、使い回す)
+    struct AsyncIOOperation
+    {
+      int fd;
+      bool write;
+      unsigned char* data;
+      std::size_t bytes;
+      std::int64_t offset;  // 負ならファイル位置を使う(パイプ・ソケット)
+      std::int64_t result;  // 転送したバイト数(失敗した場合は-errno)
+      void (*complete)(AsyncIOOperation*);
+      void* owner;
+      AsyncIOOperation* next;
+    };
+
+    // 要求の侵入型FIFO
+    struct AsyncIOList
+    {
+      AsyncIOOperation* head = nullptr;
+      AsyncIOOperation* tail = nullptr;
+
+      bool Empty(void) const noexcept
+      {
+        return head == nullptr;
+      }
+
+      void Push(AsyncIOOperation* op) noexcept
+      {
+        op->next = nullptr;
+        if (tail != nullptr)
+        {
+          tail->next = op;
+        }
+        else
+        {
+          head = op;
+        }
+        tail = op;
+      }
+
+      AsyncIOOperation* Pop(void) noexcept
+      {
+        AsyncIOOperation* op = head;
+        if (op != nullptr)
+        {
+          head = op->next;
+          if (head == nullptr)
+          {
+            tail = nullptr;
+          }
+        }
+        return op;
+      }
+    };
+
+    // 要求の全量の読み書き(EOF・エラーで打ち切る。途中まで転送できていればその量を返す)
+    // パイプ・ソケットでも計算中にブロック全体が埋まるよう、ワーカースレッドの中で繰り返す
+    static inline void ExecuteAsyncIO(AsyncIOOperation* op) noexcept
+    {
+      std::size_t done = 0;
+      int error = 0;
+      while (done < op->bytes)
+      {
+        unsigned char* data = op->data + done;
+        const std::size_t bytes = op->bytes - done;
+        const off_t offset = static_cast<off_t>(op->offset + static_cast<std::int64_t>(done));
+        ssize_t result;
+        if (op->write)
+        {
+          result = (op->offset >= 0) ? pwrite(op->fd, data, bytes, offset) : write(op->fd, data, bytes);
+        }
+        else
+        {
+          result = (op->offset >= 0) ? pread(op->fd, data, bytes, offset) : read(op->fd, data, bytes);
+        }
+        if (result < 0 && errno == EINTR)
+        {
+          continue;
+        }
+        if (result <= 0)
+        {
+          error = (result < 0) ? errno : 0;
+          break;
+        }
+        done += static_cast<std::size_t>(result);
+      }
+      op->result = (done == 0 && error != 0) ? -static_cast<std::int64_t>(error) : static_cast<std::int64_t>(done);
+    }
+
+    // 位置を指定して読み書きできるファイルなら現在位置、そうでなければ-1
+    static inline std::int64_t AsyncIOStartOffset(int fd) noexcept
+    {
+      struct stat st;
+      if (fstat(fd, &st) != 0 || !(S_ISREG(st.st_mode) || S_ISBLK(st.st_mode)))
+      {
+        return -1;
+      }
+      const off_t position = lseek(fd, 0, SEEK_CUR);
+      return (position < 0) ? -1 : static_cast<std::int64_t>(position);
+    }
+
+    // ワーカースレッドによる実装
+    // 読み込みと書き込みで別のスレッドを使う(パイプの読み込みが詰まっても書き出しは進む)
+    class AsyncIOWorkers
+    {
+    private:
+      std::mutex mutex;
+      std::condition_variable work_cv;
+      std::condition_variable done_cv;
+      AsyncIOList pending[2];  // [0]: 読み込み, [1]: 書き込み
+      AsyncIOList completed;
+      std::thread workers[2];
+      bool stop = false;
+      int notify_fd = -1;      // 完了ごとに8バイトの1を書き込むファイル記述子(eventfd)
+
+    public:
+      // notify_fd: 完了を知らせるeventfd(使わない場合は-1)
+      void Start(int notify_fd = -1)
+      {
+        this->notify_fd = notify_fd;
+        for (int i = 0; i < 2; ++i)
+        {
+          workers[i] = std::thread([this, i](void)
+          {
+            Work(i);
+          });
+        }
+      }
+
+      bool IsStarted(void) const noexcept
+      {
+        return workers[0].joinable();
+      }
+
+      void Stop(void)
+      {
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          stop = true;
+        }
+        work_cv.notify_all();
+        for (std::thread &worker : workers)
+        {
+          if (worker.joinable())
+          {
+            worker.join();
+          }
+        }
+      }
+
+      void Push(AsyncIOOperation* op)
+      {
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          pending[op->write ? 1 : 0].Push(op);
+        }
+        work_cv.notify_all();
+      }
+
+      // 1つ以上完了するまで待ち、完了した要求をすべて取り出す
+      AsyncIOList Wait(void)
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        done_cv.wait(lock, [this](void)
+        {
+          return !completed.Empty();
+        });
+        return TakeLocked();
+      }
+
+      // 完了した要求をすべて取り出す(待たない)
+      AsyncIOList TryTake(void)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        return TakeLocked();
+      }
+
+    private:
+      AsyncIOList TakeLocked(void) noexcept
+      {
+        AsyncIOList list = completed;
+        completed = AsyncIOList();
+        return list;
+      }
+
+      void Work(int index)
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;)
+        {
+          work_cv.wait(lock, [this, index](void)
+          {
+            return stop || !pending[index].Empty();
+          });
+          AsyncIOOperation* op = pending[index].Pop();
+          if (op == nullptr)
+          {
+            return;
+          }
+          lock.unlock();
+          ExecuteAsyncIO(op);
+          lock.lock();
+          completed.Push(op);
+          done_cv.notify_one();
+          if (notify_fd >= 0)
+          {
+            const std::uint64_t one = 1;
+            while (write(notify_fd, &one, sizeof(one)) < 0 && errno == EINTR)
+            {
+            }
+          }
+        }
+      }
+    };
+
+#if MYDSP_ASYNC_IO_URING
+    // io_uringによる実装(リングをmmapして直接操作する)
+    class AsyncIOUring
+    {
+    private:
+      int fd = -1;
+      unsigned char* sq_ring = nullptr;
+      unsigned char* cq_ring = nullptr;
+      io_uring_sqe* sqes = nullptr;
+      std::size_t sq_ring_bytes = 0;
+      std::size_t cq_ring_bytes = 0;
+      std::size_t sqes_bytes = 0;
+      unsigned* sq_head = nullptr;
+      unsigned* sq_tail = nullptr;
+      unsigned* sq_array = nullptr;
+      unsigned* cq_head = nullptr;
+      unsigned* cq_tail = nullptr;
+      io_uring_cqe* cqes = nullptr;
+      unsigned sq_mask = 0;
+      unsigned sq_entries = 0;
+      unsigned cq_mask = 0;
+      unsigned cq_entries = 0;
+      unsigned to_submit = 0;    // SQに積んでまだカーネルに渡していない数
+      std::size_t in_flight = 0; // SQに積んでから完了を受け取るまでの数(CQのあふれを防ぐ)
+      AsyncIOList backlog;       // SQに積めなかった要求
+
+      static unsigned LoadAcquire(const unsigned* p) noexcept
+      {
+        return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+      }
+
+      static void StoreRelease(unsigned* p, unsigned value) noexcept
+      {
+        __atomic_store_n(p, value, __ATOMIC_RELEASE);
+      }
+
+    public:
+      bool Open(unsigned entries)
+      {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0)
+        {
+          return false;
+        }
+        if ((params.features & IORING_FEAT_RW_CUR_POS) == 0)
+        {
+          Close();
+          return false;
+        }
+        sq_ring_bytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_bytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap)
+        {
+          sq_ring_bytes = cq_ring_bytes = (sq_ring_bytes > cq_ring_bytes) ? sq_ring_bytes : cq_ring_bytes;
+        }
+        void* sq = mmap(nullptr, sq_ring_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+          static_cast<off_t>(IORING_OFF_SQ_RING));
+        if (sq == MAP_FAILED)
+        {
+          Close();
+          return false;
+        }
+        sq_ring = static_cast<unsigned char*>(sq);
+        if (single_mmap)
+        {
+          cq_ring = sq_ring;
+        }
+        else
+        {
+          void* cq = mmap(nullptr, cq_ring_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+            static_cast<off_t>(IORING_OFF_CQ_RING));
+          if (cq == MAP_FAILED)
+          {
+            Close();
+            return false;
+          }
+          cq_ring = static_cast<unsigned char*>(cq);
+        }
+        sqes_bytes = params.sq_entries * sizeof(io_uring_sqe);
+        void* s = mmap(nullptr, sqes_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+          static_cast<off_t>(IORING_OFF_SQES));
+        if (s == MAP_FAILED)
+        {
+          Close();
+          return false;
+        }
+        sqes = static_cast<io_uring_sqe*>(s);
+
+        sq_head = reinterpret_cast<unsigned*>(sq_ring + params.sq_off.head);
+        sq_tail = reinterpret_cast<unsigned*>(sq_ring + params.sq_off.tail);
+        sq_array = reinterpret_cast<unsigned*>(sq_ring + params.sq_off.array);
+        sq_mask = *reinterpret_cast<unsigned*>(sq_ring + params.sq_off.ring_mask);
+        sq_entries = params.sq_entries;
+        cq_head = reinterpret_cast<unsigned*>(cq_ring + params.cq_off.head);
+        cq_tail = reinterpret_cast<unsigned*>(cq_ring + params.cq_off.tail);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq_ring + params.cq_off.cqes);
+        cq_mask = *reinterpret_cast<unsigned*>(cq_ring + params.cq_off.ring_mask);
+        cq_entries = params.cq_entries;
+        return true;
+      }
+
+      void Close(void)
+      {
+        if (sqes != nullptr)
+        {
+          munmap(sqes, sqes_bytes);
+        }
+        if (cq_ring != nullptr && cq_ring != sq_ring)
+        {
+          munmap(cq_ring, cq_ring_bytes);
+        }
+        if (sq_ring != nullptr)
+        {
+          munmap(sq_ring, sq_ring_bytes);
+        }
+        if (fd >= 0)
+        {
+          close(fd);
+        }
+        fd = -1;
+        sq_ring = cq_ring = nullptr;
+        sqes = nullptr;
+      }
+
+      // 要求をすぐにカーネルへ渡す(完了を待つ間ではなく、コルーチンの計算中に読み書きが進むように)
+      // SQに積めなかった分はWaitで渡す
+      void Push(AsyncIOOperation* op) noexcept
+      {
+        backlog.Push(op);
+        Prepare();
+        if (to_submit > 0)
+        {
+          const long entered = syscall(__NR_io_uring_enter, fd, to_submit, 0u, 0u, nullptr, 0);
+          if (entered > 0)
+          {
+            to_submit -= static_cast<unsigned>(entered);
+          }
+        }
+      }
+
+      // 積んである要求を投入し、1つ以上完了するまで待って完了した要求を取り出す
+      // 待機に失敗した場合は空のリストを返す
+      AsyncIOList Wait(void)
+      {
+        AsyncIOList list;
+        for (;;)
+        {
+          Prepare();
+          const long entered = syscall(__NR_io_uring_enter, fd, to_submit, 1u, IORING_ENTER_GETEVENTS, nullptr, 0);
+          if (entered < 0)
+          {
+            if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+            {
+              continue;
+            }
+            return list;
+          }
+          to_submit -= static_cast<unsigned>(entered);
+
+          unsigned head = *cq_head;
+          const unsigned tail = LoadAcquire(cq_tail);
+          for (; head != tail; ++head)
+          {
+            const io_uring_cqe &cqe = cqes[head & cq_mask];
+            AsyncIOOperation* op = reinterpret_cast<AsyncIOOperation*>(static_cast<std::uintptr_t>(cqe.user_data));
+            op->result = cqe.res;
+            list.Push(op);
+            --in_flight;
+          }
+          StoreRelease(cq_head, head);
+          if (!list.Empty())
+          {
+            return list;
+          }
+        }
+      }
+
+    private:
+      // 待ち行列の要求をSQの空きとCQの容量の範囲でSQに積む
+      void Prepare(void) noexcept
+      {
+        unsigned tail = *sq_tail;
+        const unsigned head = LoadAcquire(sq_head);
+        while (!backlog.Empty() && tail - head < sq_entries && in_flight < cq_entries)
+        {
+          AsyncIOOperation* op = backlog.Pop();
+          const unsigned index = tail & sq_mask;
+          io_uring_sqe &sqe = sqes[index];
+          std::memset(&sqe, 0, sizeof(sqe));
+          sqe.opcode = op->write ? IORING_OP_WRITE : IORING_OP_READ;
+          sqe.fd = op->fd;
+          sqe.addr = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(op->data));
+          sqe.len = static_cast<std::uint32_t>((op->bytes < (1u << 30)) ? op->bytes : (1u << 30));
+          sqe.off = (op->offset >= 0) ? static_cast<std::uint64_t>(op->offset) : ~std::uint64_t(0);
+          sqe.user_data = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(op));
+          sq_array[index] = index;
+          ++tail;
+          ++to_submit;
+          ++in_flight;
+        }
+        StoreRelease(sq_tail, tail);
+      }
+    };
+#endif
+
+  } /* namespace Internal */
+
+  // ソース・シンクを待つコルーチン
+  // 最初のco_await(またはAsyncIOContext::Run)まで開始しない。別のAsyncTaskからco_awaitすると完了まで待つ
+  // 例外は使わない(送出された場合は終了する)
+  class AsyncTask
+  {
+  public:
+    struct promise_type
+    {
+      std::coroutine_handle<> continuation;
+
+      AsyncTask get_return_object(void) noexcept
+      {
+        return AsyncTask(std::coroutine_handle<promise_type>::from_promise(*this));
+      }
+
+      std::suspend_always initial_suspend(void) noexcept
+      {
+        return {};
+      }
+
+      // 完了したら待っているコルーチンへ制御を移す
+      struct FinalAwaiter
+      {
+        bool await_ready(void) noexcept
+        {
+          return false;
+        }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+        {
+          const std::coroutine_handle<> continuation = handle.promise().continuation;
+          return continuation ? continuation : std::noop_coroutine();
+        }
+
+        void await_resume(void) noexcept {}
+      };
+
+      FinalAwaiter final_suspend(void) noexcept
+      {
+        return {};
+      }
+
+      void return_void(void) noexcept {}
+
+      void unhandled_exception(void) noexcept
+      {
+        std::terminate();
+      }
+    };
+
+  private:
+    std::coroutine_handle<promise_type> handle;
+
+    friend class AsyncIOContext;
+
+    explicit AsyncTask(std::coroutine_handle<promise_type> handle) noexcept : handle(handle) {}
+
+  public:
+    AsyncTask(const AsyncTask&) = delete;
+    AsyncTask& operator=(const AsyncTask&) = delete;
+
+    AsyncTask(AsyncTask&& other) noexcept : handle(other.handle)
+    {
+      other.handle = nullptr;
+    }
+
+    ~AsyncTask()
+    {
+      if (handle)
+      {
+        handle.destroy();
+      }
+    }
+
+    // 完了したか
+    bool Done(void) const noexcept
+    {
+      return !handle || handle.done();
+    }
+
+    struct Awaiter
+    {
+      std::coroutine_handle<promise_type> handle;
+
+      bool await_ready(void) const noexcept
+      {
+        return !handle || handle.done();
+      }
+
+      std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept
+      {
+        handle.promise().continuation = caller;
+        return handle;
+      }
+
+      void await_resume(void) const noexcept {}
+    };
+
+    Awaiter operator co_await(void) const noexcept
+    {
+      return Awaiter{handle};
+    }
+  };
+
+  // 非同期入出力の実行環境
+  // 読み書きの完了はRun(またはDispatch)を呼んだスレッドで処理し、待っているコルーチンを再開する
+  // io_uringでは通常のファイルの読み書きをio_uringで行い、パイプ・ソケットはワーカースレッドに任せる
+  // (io_uringのパイプの読み込みは届いた分だけで完了し、続きを投入できるのが計算の後になるため)
+  // ワーカースレッドの完了はeventfdで知らせ、io_uringの完了と一緒に待つ
+  class AsyncIOContext
+  {
+  private:
+    AsyncIOBackend backend;
+    bool valid;
+    std::size_t in_flight;
+    Internal::AsyncIOWorkers workers;
+#if MYDSP_ASYNC_IO_URING
+    Internal::AsyncIOUring uring;
+    int wake_fd;                        // ワーカースレッドの完了を知らせるeventfd
+    std::uint64_t wake_value;
+    Internal::AsyncIOOperation wake_op; // wake_fdの読み込み(常に1つ投入しておく)
+#endif
+
+  public:
+    // コンストラクタ
+    // backend: Autoならio_uringを試してだめならThread。IoUringを指定して使えない場合は無効になる
+    // queue_depth: io_uringのSQの長さ(同時に投入する要求の数の目安)
+    explicit AsyncIOContext(AsyncIOBackend backend = AsyncIOBackend::Auto, unsigned queue_depth = 64) :
+      backend(AsyncIOBackend::Thread),
+      valid(false),
+      in_flight(0)
+#if MYDSP_ASYNC_IO_URING
+      ,
+      wake_fd(-1),
+      wake_value(0),
+      wake_op{}
+#endif
+    {
+#if MYDSP_ASYNC_IO_URING
+      if (backend != AsyncIOBackend::Thread && uring.Open(queue_depth))
+      {
+        this->backend = AsyncIOBackend::IoUring;
+        valid = true;
+        return;
+      }
+#else
+      (void)queue_depth;
+#endif
+      if (backend == AsyncIOBackend::IoUring)
+      {
+        return;
+      }
+      workers.Start();
+      valid = true;
+    }
+
+    AsyncIOContext(const AsyncIOContext&) = delete;
+    AsyncIOContext& operator=(const AsyncIOContext&) = delete;
+
+    ~AsyncIOContext()
+    {
+      workers.Stop();
+#if MYDSP_ASYNC_IO_URING
+      if (backend == AsyncIOBackend::IoUring)
+      {
+        uring.Close();
+      }
+      if (wake_fd >= 0)
+      {
+        close(wake_fd);
+      }
+#endif
+    }
+
+    // 構築に成功したか
+    bool IsValid(void) const noexcept
+    {
+      return valid;
+    }
+
+    // 使用している実装(IoUringまたはThread)
+    AsyncIOBackend GetBackend(void) const noexcept
+    {
+      return backend;
+    }
+
+    // 実行中の要求の数
+    std::size_t InFlight(void) const noexcept
+    {
+      return in_flight;
+    }
+
+    // 要求の投入(ソース・シンクから使う)
+    void Submit(Internal::AsyncIOOperation* op)
+    {
+      ++in_flight;
+#if MYDSP_ASYNC_IO_URING
+      if (backend == AsyncIOBackend::IoUring && (op->offset >= 0 || !StartStreamWorkers()))
+      {
+        uring.Push(op);
+        return;
+      }
+#endif
+      workers.Push(op);
+    }
+
+    // 1つ以上の要求の完了を待って完了処理を行う
+    // 実行中の要求がない場合(またはio_uringの待機に失敗した場合)はfalse
+    bool Dispatch(void)
+    {
+      if (in_flight == 0)
+      {
+        return false;
+      }
+      Internal::AsyncIOList list;
+#if MYDSP_ASYNC_IO_URING
+      if (backend == AsyncIOBackend::IoUring)
+      {
+        list = uring.Wait();
+      }
+      else
+#endif
+      {
+        list = workers.Wait();
+      }
+      if (list.Empty())
+      {
+        return false;
+      }
+      Complete(list);
+      return true;
+    }
+
+    // コルーチンを開始し、完了するまで読み書きの完了を処理する
+    // 待っている読み書きがないのに完了しない場合はfalse
+    bool Run(AsyncTask &task)
+    {
+      if (!valid || task.Done())
+      {
+        return false;
+      }
+      task.handle.resume();
+      while (!task.Done())
+      {
+        if (!Dispatch())
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    bool Run(AsyncTask &&task)
+    {
+      return Run(task);
+    }
+
+  private:
+    // 完了処理(同じ要求を再投入することがあるので、次を先に取り出しておく)
+    void Complete(const Internal::AsyncIOList &list)
+    {
+      for (Internal::AsyncIOOperation* op = list.head; op != nullptr;)
+      {
+        Internal::AsyncIOOperation* next = op->next;
+#if MYDSP_ASYNC_IO_URING
+        if (op == &wake_op)
+        {
+          uring.Push(&wake_op);
+          Complete(workers.TryTake());
+          op = next;
+          continue;
+        }
+#endif
+        --in_flight;
+        op->complete(op);
+        op = next;
+      }
+    }
+
+#if MYDSP_ASYNC_IO_URING
+    // パイプ・ソケット用のワーカースレッドを必要になった時点で開始する(eventfdを作れなければfalse)
+    bool StartStreamWorkers(void)
+    {
+      if (workers.IsStarted())
+      {
+        return true;
+      }
+      if (wake_fd < 0)
+      {
+        wake_fd = eventfd(0, EFD_CLOEXEC);
+        if (wake_fd < 0)
+        {
+          return false;
+        }
+      }
+      workers.Start(wake_fd);
+      wake_op.fd = wake_fd;
+      wake_op.write = false;
+      wake_op.data = reinterpret_cast<unsigned char*>(&wake_value);
+      wake_op.bytes = sizeof(wake_value);
+      wake_op.offset = -1;
+      uring.Push(&wake_op);
+      return true;
+    }
+#endif
+  };
+
+  // サンプルブロックのソース
+  // block_length: 1ブロックのサンプル数(多チャネルならフレーム数×チャネル数)
+  // NumBuffers: 使い回すブロックの数(コルーチンが処理中の1つを除いた分を先読みする)
+  template <class T, std::size_t NumBuffers = 2>
+  class AsyncBlockSource
+  {
+    static_assert(std::is_trivially_copyable<T>::value, "Template parameter 'T' should be trivially copyable");
+    static_assert(NumBuffers >= 2, "Template parameter 'NumBuffers' should be 2 or more");
+
+  protected:
+    enum class SlotState : unsigned char
+    {
+      Free,
+      Reading,
+      Ready,
+      InUse
+    };
+
+    // opを先頭に置き、完了した要求からブロックを引けるようにする
+    struct Slot
+    {
+      Internal::AsyncIOOperation op;
+      std::size_t filled;
+      SlotState state;
+    };
+
+    AsyncIOContext &context;
+    int fd;
+    std::size_t block_length;
+    std::unique_ptr<T[]> storage;
+    Slot slots[NumBuffers];
+    std::int64_t offset;   // 次に読む位置(パイプ・ソケットでは-1)
+    std::size_t head;      // 次に渡すブロック
+    std::size_t tail;      // 次に読み込みを始めるブロック
+    std::size_t reading;   // 読み込み中のブロックの数
+    std::size_t in_use;    // コルーチンが処理中のブロック(NumBuffersならなし)
+    bool end;
+    bool closing;
+    int error;
+    std::coroutine_handle<> waiter;
+
+  public:
+    // コンストラクタ(fdは閉じない)
+    AsyncBlockSource(AsyncIOContext &context, int fd, std::size_t block_length) :
+      context(context),
+      fd(fd),
+      block_length(block_length),
+      storage((block_length > 0) ? new T[NumBuffers * block_length] : nullptr),
+      slots{},
+      offset(Internal::AsyncIOStartOffset(fd)),
+      head(0),
+      tail(0),
+      reading(0),
+      in_use(NumBuffers),
+      end(false),
+      closing(false),
+      error(0),
+      waiter(nullptr)
+    {
+      for (Slot &slot : slots)
+      {
+        slot.op.fd = fd;
+        slot.op.write = false;
+        slot.op.complete = &AsyncBlockSource::OnComplete;
+        slot.op.owner = this;
+        slot.state = SlotState::Free;
+      }
+    }
+
+    AsyncBlockSource(const AsyncBlockSource&) = delete;
+    AsyncBlockSource& operator=(const AsyncBlockSource&) = delete;
+
+    // 読み込み中のブロックが残っていれば完了を待つ
+    ~AsyncBlockSource()
+    {
+      closing = true;
+      waiter = nullptr;
+      while (reading > 0 && context.Dispatch())
+      {
+      }
+    }
+
+    // 構築に成功したか
+    bool IsValid(void) const noexcept
+    {
+      return storage != nullptr && fd >= 0 && context.IsValid();
+    }
+
+    // 読み込みでエラーが起きた場合のerrno(なければ0)
+    int GetError(void) const noexcept
+    {
+      return error;
+    }
+
+    struct NextAwaiter
+    {
+      AsyncBlockSource &source;
+
+      bool await_ready(void)
+      {
+        source.Release();
+        source.Fill();
+        return source.slots[source.head].state != SlotState::Reading;
+      }
+
+      void await_suspend(std::coroutine_handle<> handle) noexcept
+      {
+        source.waiter = handle;
+      }
+
+      SampleBlock<T> await_resume(void) noexcept
+      {
+        return source.Take();
+      }
+    };
+
+    // 次のブロック(co_awaitで待つ)
+    // 前回渡したブロックはこの呼び出しで読み込みに戻す。EOF・エラーでは長さ0のブロックを返す
+    NextAwaiter Next(void) noexcept
+    {
+      return NextAwaiter{*this};
+    }
+
+  protected:
+    void Release(void) noexcept
+    {
+      if (in_use < NumBuffers)
+      {
+        slots[in_use].state = SlotState::Free;
+        in_use = NumBuffers;
+      }
+    }
+
+    // 空いたブロックの読み込みを順に始める(パイプ・ソケットは1つずつ)
+    void Fill(void)
+    {
+      if (!IsValid())
+      {
+        return;
+      }
+      while (!end && !closing && slots[tail].state == SlotState::Free && (offset >= 0 || reading == 0))
+      {
+        Slot &slot = slots[tail];
+        slot.filled = 0;
+        slot.state = SlotState::Reading;
+        slot.op.data = reinterpret_cast<unsigned char*>(storage.get() + tail * block_length);
+        slot.op.bytes = block_length * sizeof(T);
+        slot.op.offset = offset;
+        if (offset >= 0)
+        {
+          offset += static_cast<std::int64_t>(slot.op.bytes);
+        }
+        ++reading;
+        tail = (tail + 1) % NumBuffers;
+        context.Submit(&slot.op);
+      }
+    }
+
+    SampleBlock<T> Take(void) noexcept
+    {
+      Slot &slot = slots[head];
+      if (slot.state != SlotState::Ready)
+      {
+        return SampleBlock<T>{nullptr, 0};
+      }
+      const std::size_t length = slot.filled / sizeof(T);
+      if (length == 0)
+      {
+        slot.state = SlotState::Free;
+        return SampleBlock<T>{nullptr, 0};
+      }
+      slot.state = SlotState::InUse;
+      in_use = head;
+      head = (head + 1) % NumBuffers;
+      return SampleBlock<T>{storage.get() + in_use * block_length, length};
+    }
+
+    static void OnComplete(Internal::AsyncIOOperation* op)
+    {
+      static_cast<AsyncBlockSource*>(op->owner)->Complete(*reinterpret_cast<Slot*>(op));
+    }
+
+    void Complete(Slot &slot)
+    {
+      Internal::AsyncIOOperation &op = slot.op;
+      if (op.result > 0)
+      {
+        // ブロックが埋まるまで続きを読む
+        const std::size_t bytes = static_cast<std::size_t>(op.result);
+        slot.filled += bytes;
+        if (bytes < op.bytes && !closing)
+        {
+          op.data += bytes;
+          op.bytes -= bytes;
+          if (op.offset >= 0)
+          {
+            op.offset += op.result;
+          }
+          context.Submit(&op);
+          return;
+        }
+      }
+      else if (op.result == -EINTR && !closing)
+      {
+        context.Submit(&op);
+        return;
+      }
+      else
+      {
+        end = true;
+        if (op.result < 0)
+        {
+          error = static_cast<int>(-op.result);
+        }
+      }
+      --reading;
+      slot.state = SlotState::Ready;
+      if (closing)
+      {
+        return;
+      }
+      Fill();
+      if (waiter && slots[head].state != SlotState::Reading)
+      {
+        const std::coroutine_handle<> handle = waiter;
+        waiter = nullptr;
+        handle.resume();
+      }
+    }
+  };
+
+  // サンプルブロックのシンク
+  // Acquireで空いたブロックを受け取って書き込み、Commitで書き出しを始める
+  // 通常のファイルは複数のブロックを同時に書き出し、パイプ・ソケットは渡した順に1つずつ書き出す
+  template <class T, std::size_t NumBuffers = 2>
+  class AsyncBlockSink
+  {
+    static_assert(std::is_trivially_copyable<T>::value, "Template parameter 'T' should be trivially copyable");
+    static_assert(NumBuffers >= 2, "Template parameter 'NumBuffers' should be 2 or more");
+
+  protected:
+    enum class SlotState : unsigned char
+    {
+      Free,
+      Acquired,
+      Queued,
+      Writing
+    };
+
+    struct Slot
+    {
+      Internal::AsyncIOOperation op;
+      std::size_t bytes;
+      SlotState state;
+    };
+
+    AsyncIOContext &context;
+    int fd;
+    std::size_t block_length;
+    std::unique_ptr<T[]> storage;
+    Slot slots[NumBuffers];
+    std::int64_t offset;     // 次に書く位置(パイプ・ソケットでは-1)
+    std::size_t acquired;    // 渡したブロックの累計
+    std::size_t issued;      // 書き出しを始めた(または空で返された)ブロックの累計
+    std::size_t writing;     // 書き出し中のブロックの数
+    bool closing;
+    int error;
+    std::coroutine_handle<> acquire_waiter;
+    std::coroutine_handle<> flush_waiter;
+
+  public:
+    // コンストラクタ(fdは閉じない)
+    AsyncBlockSink(AsyncIOContext &context, int fd, std::size_t block_length) :
+      context(context),
+      fd(fd),
+      block_length(block_length),
+      storage((block_length > 0) ? new T[NumBuffers * block_length] : nullptr),
+      slots{},
+      offset(Internal::AsyncIOStartOffset(fd)),
+      acquired(0),
+      issued(0),
+      writing(0),
+      closing(false),
+      error(0),
+      acquire_waiter(nullptr),
+      flush_waiter(nullptr)
+    {
+      for (Slot &slot : slots)
+      {
+        slot.op.fd = fd;
+        slot.op.write = true;
+        slot.op.complete = &AsyncBlockSink::OnComplete;
+        slot.op.owner = this;
+        slot.state = SlotState::Free;
+      }
+    }
+
+    AsyncBlockSink(const AsyncBlockSink&) = delete;
+    AsyncBlockSink& operator=(const AsyncBlockSink&) = delete;
+
+    // 書き出し中のブロックが残っていれば完了を待つ(Commit済みで未投入のブロックは捨てる)
+    ~AsyncBlockSink()
+    {
+      closing = true;
+      acquire_waiter = nullptr;
+      flush_waiter = nullptr;
+      while (writing > 0 && context.Dispatch())
+      {
+      }
+    }
+
+    // 構築に成功したか
+    bool IsValid(void) const noexcept
+    {
+      return storage != nullptr && fd >= 0 && context.IsValid();
+    }
+
+    // 書き出しでエラーが起きた場合のerrno(なければ0)
+    int GetError(void) const noexcept
+    {
+      return error;
+    }
+
+    // ブロックの長さ(Acquireで受け取るブロックのサンプル数)
+    std::size_t GetBlockLength(void) const noexcept
+    {
+      return block_length;
+    }
+
+    struct AcquireAwaiter
+    {
+      AsyncBlockSink &sink;
+
+      bool await_ready(void) const noexcept
+      {
+        const SlotState state = sink.slots[sink.acquired % NumBuffers].state;
+        return state != SlotState::Queued && state != SlotState::Writing;
+      }
+
+      void await_suspend(std::coroutine_handle<> handle) noexcept
+      {
+        sink.acquire_waiter = handle;
+      }
+
+      SampleBlock<T> await_resume(void) noexcept
+      {
+        return sink.Take();
+      }
+    };
+
+    // 書き込み先のブロック(co_awaitで待つ)
+    // 空いたブロックがなければ書き出しの完了を待つ。無効な場合やCommitせずにNumBuffers個受け取った場合は長さ0
+    AcquireAwaiter Acquire(void) noexcept
+    {
+      return AcquireAwaiter{*this};
+    }
+
+    // Acquireで受け取ったブロックの先頭lengthサンプルの書き出しを始める(完了は待たない)
+    // 長さ0ならブロックを返すだけ。エラーが起きた後はfalse
+    bool Commit(const SampleBlock<T> &block, std::size_t length)
+    {
+      if (block.data == nullptr)
+      {
+        return false;
+      }
+      const std::size_t index = static_cast<std::size_t>(block.data - storage.get()) / block_length;
+      if (index >= NumBuffers || slots[index].state != SlotState::Acquired)
+      {
+        return false;
+      }
+      Slot &slot = slots[index];
+      slot.bytes = ((length < block_length) ? length : block_length) * sizeof(T);
+      slot.state = (slot.bytes > 0 && error == 0) ? SlotState::Queued : SlotState::Free;
+      Issue();
+      return error == 0;
+    }
+
+    struct FlushAwaiter
+    {
+      AsyncBlockSink &sink;
+
+      bool await_ready(void) const noexcept
+      {
+        return sink.Idle();
+      }
+
+      void await_suspend(std::coroutine_handle<> handle) noexcept
+      {
+        sink.flush_waiter = handle;
+      }
+
+      bool await_resume(void) const noexcept
+      {
+        return sink.error == 0;
+      }
+    };
+
+    // Commitしたブロックをすべて書き出すまで待つ(co_awaitで待つ。エラーがなければtrue)
+    FlushAwaiter Flush(void) noexcept
+    {
+      return FlushAwaiter{*this};
+    }
+
+  protected:
+    SampleBlock<T> Take(void) noexcept
+    {
+      const std::size_t index = acquired % NumBuffers;
+      if (!IsValid() || slots[index].state != SlotState::Free)
+      {
+        return SampleBlock<T>{nullptr, 0};
+      }
+      slots[index].state = SlotState::Acquired;
+      ++acquired;
+      return SampleBlock<T>{storage.get() + index * block_length, block_length};
+    }
+
+    bool Idle(void) const noexcept
+    {
+      for (const Slot &slot : slots)
+      {
+        if (slot.state == SlotState::Queued || slot.state == SlotState::Writing)
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    // Commitされたブロックを受け取った順に書き出す(パイプ・ソケットは1つずつ)
+    void Issue(void)
+    {
+      while (issued < acquired && !closing)
+      {
+        Slot &slot = slots[issued % NumBuffers];
+        if (slot.state == SlotState::Queued && error != 0)
+        {
+          slot.state = SlotState::Free;
+        }
+        if (slot.state == SlotState::Free)
+        {
+          ++issued;
+          continue;
+        }
+        if (slot.state != SlotState::Queued || (offset < 0 && writing > 0))
+        {
+          break;
+        }
+        slot.state = SlotState::Writing;
+        slot.op.data = reinterpret_cast<unsigned char*>(storage.get() + (issued % NumBuffers) * block_length);
+        slot.op.bytes = slot.bytes;
+        slot.op.offset = offset;
+        if (offset >= 0)
+        {
+          offset += static_cast<std::int64_t>(slot.bytes);
+        }
+        ++writing;
+        ++issued;
+        context.Submit(&slot.op);
+      }
+    }
+
+    static void OnComplete(Internal::AsyncIOOperation* op)
+    {
+      static_cast<AsyncBlockSink*>(op->owner)->Complete(*reinterpret_cast<Slot*>(op));
+    }
+
+    void Complete(Slot &slot)
+    {
+      Internal::AsyncIOOperation &op = slot.op;
+      if (op.result > 0 && static_cast<std::size_t>(op.result) < op.bytes && !closing)
+      {
+        // 書き切れなかった残りを続けて書く
+        op.data += op.result;
+        op.bytes -= static_cast<std::size_t>(op.result);
+        if (op.offset >= 0)
+        {
+          op.offset += op.result;
+        }
+        context.Submit(&op);
+        return;
+      }
+      if (op.result == -EINTR && !closing)
+      {
+        context.Submit(&op);
+        return;
+      }
+      if (op.result <= 0 && error == 0)
+      {
+        error = (op.result < 0) ? static_cast<int>(-op.result) : EIO;
+      }
+      --writing;
+      slot.state = SlotState::Free;
+      if (closing)
+      {
+        return;
+      }
+      Issue();
+      if (acquire_waiter && slots[acquired % NumBuffers].state == SlotState::Free)
+      {
+        const std::coroutine_handle<> handle = acquire_waiter;
+        acquire_waiter = nullptr;
+        handle.resume();
+      }
+      if (flush_waiter && Idle())
+      {
+        const std::coroutine_handle<> handle = flush_waiter;
+        flush_waiter = nullptr;
+        handle.resume();
+      }
+    }
+  };
+
+} /* namespace MyDSP */
+
+#endif /* MYDSP_HAS_ASYNC_BLOCK_IO */
+
+#endif /* MYDSP_ASYNCBLOCKIO_HPP_ */
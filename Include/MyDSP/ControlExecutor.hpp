@@ -0,0 +1,483 @@
+/*
+ * ControlExecutor.hpp
+ *
+ *  Created on: 2026/10/18
+ *      Author: Shibasaki
+ *
+ * 固定周期の制御ループの実行
+ * 登録したコールバックを専用スレッドから一定周期で呼び出し、ループごとに実行時間・起床の遅れ・周期超過を記録する
+ * 周期の同じループは1つのグループにまとめ、同じ起床時刻に登録順に続けて実行する
+ * 起床はclock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME)による絶対時刻の待機で、周期の誤差が蓄積しない
+ * CPUの固定とSCHED_FIFOは権限があれば適用する(失敗しても通常のスケジューリングで動作を続ける)
+ * 記録はInstrumentation::LatencyHistogramによるロックフリーなヒストグラムで、実行中も任意のスレッドから読み出せる
+ * POSIX環境専用(CPUの固定はLinuxのみ)
+ */
+
+#ifndef MYDSP_CONTROLEXECUTOR_HPP_
+#define MYDSP_CONTROLEXECUTOR_HPP_
+
+#include "Instrumentation.hpp"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cerrno>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+namespace MyDSP
+{
+  namespace Internal
+  {
+    // モノトニック時計の現在時刻(ns)
+    static inline std::uint64_t MonotonicNow(void) noexcept
+    {
+      timespec ts;
+      clock_gettime(CLOCK_MONOTONIC, &ts);
+      return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000u + static_cast<std::uint64_t>(ts.tv_nsec);
+    }
+
+    // 絶対時刻(ns)まで待機する(シグナルで中断された場合は待機し直す)
+    static inline void SleepUntil(std::uint64_t time_ns) noexcept
+    {
+      timespec ts;
+      ts.tv_sec = static_cast<time_t>(time_ns / 1000000000u);
+      ts.tv_nsec = static_cast<long>(time_ns % 1000000000u);
+      while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR)
+      {
+      }
+    }
+
+    // 単一書き込みスレッド用のカウンタ操作(ロック付き命令を使わない)
+    static inline void AddRelaxed(std::atomic<std::uint64_t> &counter, std::uint64_t value) noexcept
+    {
+      counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    static inline void MaxRelaxed(std::atomic<std::uint64_t> &counter, std::uint64_t value) noexcept
+    {
+      if (value > counter.load(std::memory_order_relaxed))
+      {
+        counter.store(value, std::memory_order_relaxed);
+      }
+    }
+
+    // ヒストグラムから求めたパーセンタイル値(ビンの上限値と最大値の小さい方で近似)
+    static inline std::uint64_t HistogramPercentile(const std::uint64_t (&histogram)[Instrumentation::LatencyHistogram::num_buckets],
+      std::uint64_t count, std::uint64_t max_value, double p) noexcept
+    {
+      const double threshold = p * static_cast<double>(count);
+      std::uint64_t cumulative = 0;
+      for (std::size_t i = 0; i < Instrumentation::LatencyHistogram::num_buckets; ++i)
+      {
+        cumulative += histogram[i];
+        if (cumulative > 0 && static_cast<double>(cumulative) >= threshold)
+        {
+          return (i == 0) ? 0 : (i >= 64) ? max_value : std::min(max_value, (std::uint64_t(1) << i) - 1);
+        }
+      }
+      return max_value;
+    }
+
+  } /* namespace Internal */
+
+  // 制御ループごとの記録
+  // 書き込みは実行スレッドのみが行う
+  struct ControlLoopStats
+  {
+    std::atomic<std::uint64_t> runs;        // 実行回数
+    std::atomic<std::uint64_t> overruns;    // 次の起床時刻までに終わらなかった回数
+    std::atomic<std::uint64_t> skipped;     // グループの実行が遅れて飛ばした起床の回数
+    std::atomic<std::uint64_t> max_exec_ns;
+    std::atomic<std::uint64_t> max_jitter_ns;
+    Instrumentation::LatencyHistogram exec_ns;   // コールバックの実行時間
+    Instrumentation::LatencyHistogram jitter_ns; // 起床予定時刻からコールバックの開始までの遅れ
+
+    ControlLoopStats() noexcept :
+      runs(0), overruns(0), skipped(0), max_exec_ns(0), max_jitter_ns(0), exec_ns(), jitter_ns()
+    {}
+
+    void Clear(void) noexcept
+    {
+      runs.store(0, std::memory_order_relaxed);
+      overruns.store(0, std::memory_order_relaxed);
+      skipped.store(0, std::memory_order_relaxed);
+      max_exec_ns.store(0, std::memory_order_relaxed);
+      max_jitter_ns.store(0, std::memory_order_relaxed);
+      exec_ns.Clear();
+      jitter_ns.Clear();
+    }
+  };
+
+  // 制御ループの記録のスナップショット
+  struct ControlLoopSnapshot
+  {
+    std::size_t id;
+    std::string name;
+    std::uint64_t period_ns;
+    std::uint64_t runs;
+    std::uint64_t overruns;
+    std::uint64_t skipped;
+    std::uint64_t max_exec_ns;
+    std::uint64_t max_jitter_ns;
+    std::uint64_t exec_histogram[Instrumentation::LatencyHistogram::num_buckets];
+    std::uint64_t jitter_histogram[Instrumentation::LatencyHistogram::num_buckets];
+
+    std::uint64_t ExecPercentile(double p) const noexcept
+    {
+      return Internal::HistogramPercentile(exec_histogram, runs, max_exec_ns, p);
+    }
+
+    std::uint64_t JitterPercentile(double p) const noexcept
+    {
+      return Internal::HistogramPercentile(jitter_histogram, runs, max_jitter_ns, p);
+    }
+  };
+
+  // PIDコントローラを制御ループとして呼び出すための束縛
+  // read(context)で偏差(目標値 - 計測値)を読み、PIDの出力を[lower upper]に制限してwrite(context, u)で書き出す
+  // 制限した場合はSetOutputで内部の出力値を書き戻し、速度形のPIDの積分が飽和値から先へ溜まらないようにする
+  // Controller: PIDController<T>など、operator()とSetOutputを持つもの
+  template <class Controller, class T>
+  struct PIDLoop
+  {
+    Controller &controller;
+    T (*read)(void*);
+    void (*write)(void*, T);
+    void* context;
+    T lower;
+    T upper;
+
+    void operator()(void)
+    {
+      const T u = controller(read(context));
+      const T limited = (u < lower) ? lower : (u > upper) ? upper : u;
+      if (limited != u)
+      {
+        controller.SetOutput(limited);
+      }
+      write(context, limited);
+    }
+  };
+
+  // PIDLoopの生成(型推論用)
+  template <class Controller, class T>
+  static inline PIDLoop<Controller,T> MakePIDLoop(Controller &controller, T (*read)(void*), void (*write)(void*, T),
+    void* context, T lower, T upper)
+  {
+    return PIDLoop<Controller,T>{controller, read, write, context, lower, upper};
+  }
+
+  // 固定周期の制御ループの実行器
+  // ループの登録はStart()の前に行う。コールバックと記録は実行器より長く生存すること
+  // Stop()は実行中の周期の終わり(最長で最も長い周期の1周期分)を待ってから戻る
+  class ControlExecutor
+  {
+  public:
+    using Callback = void (*)(void*);
+    static constexpr std::size_t invalid_id = static_cast<std::size_t>(-1);
+
+    // 実行スレッドの設定
+    struct Config
+    {
+      int cpu;            // 固定するCPU番号(負なら固定しない)
+      int fifo_priority;  // SCHED_FIFOの優先度(1-99、0なら通常のスケジューリング)
+
+      Config(void) : cpu(-1), fifo_priority(0) {}
+    };
+
+  private:
+    // 登録されたループ
+    struct Loop
+    {
+      Callback fn;
+      void* context;
+      ControlLoopStats* stats;
+    };
+
+    // 周期の同じループのグループ(起床ごとに登録順に続けて実行する)
+    struct Group
+    {
+      std::uint64_t period_ns;
+      std::uint64_t next_release_ns;
+      std::vector<Loop> loops;
+    };
+
+    // ループの情報(記録の読み出し用)
+    struct LoopInfo
+    {
+      std::string name;
+      std::uint64_t period_ns;
+      std::unique_ptr<ControlLoopStats> stats;
+    };
+
+    const Config config;
+    std::vector<Group> groups;
+    std::vector<LoopInfo> infos;
+    std::thread thread;
+    std::atomic<bool> running;
+    std::atomic<bool> pinned;
+    std::atomic<bool> realtime;
+
+  public:
+    explicit ControlExecutor(const Config &config = Config()) :
+      config(config),
+      groups(),
+      infos(),
+      thread(),
+      running(false),
+      pinned(false),
+      realtime(false)
+    {}
+
+    ControlExecutor(const ControlExecutor&) = delete;
+    ControlExecutor& operator=(const ControlExecutor&) = delete;
+
+    ~ControlExecutor()
+    {
+      Stop();
+    }
+
+    // ループの登録(周期period_ns、コールバックfn(context))
+    // ループの番号を返す。実行中または周期が0の場合は登録せずinvalid_idを返す
+    std::size_t AddLoop(std::uint64_t period_ns, Callback fn, void* context, const char* name)
+    {
+      if (running.load(std::memory_order_relaxed) || thread.joinable() || period_ns == 0 || fn == nullptr)
+      {
+        return invalid_id;
+      }
+      LoopInfo info;
+      info.name = (name != nullptr) ? name : "";
+      info.period_ns = period_ns;
+      info.stats.reset(new ControlLoopStats());
+      const Loop loop{fn, context, info.stats.get()};
+      infos.push_back(std::move(info));
+
+      for (Group &group : groups)
+      {
+        if (group.period_ns == period_ns)
+        {
+          group.loops.push_back(loop);
+          return infos.size() - 1;
+        }
+      }
+      groups.push_back(Group{period_ns, 0, std::vector<Loop>{loop}});
+      return infos.size() - 1;
+    }
+
+    // ループの登録(引数なしのoperator()を持つオブジェクト。PIDLoopなど)
+    template <class Callable>
+    std::size_t AddLoop(std::uint64_t period_ns, Callable &callable, const char* name)
+    {
+      return AddLoop(period_ns, [](void* p) { (*static_cast<Callable*>(p))(); }, &callable, name);
+    }
+
+    // 実行の開始
+    // 最初の起床は現在時刻から各グループの1周期後。スレッドを生成できなければ偽を返す
+    // (例外を無効にしてコンパイルした場合、スレッドを生成できなければstd::threadが異常終了させる)
+    bool Start(void)
+    {
+      if (thread.joinable() || groups.empty())
+      {
+        return false;
+      }
+      const std::uint64_t now = Internal::MonotonicNow();
+      for (Group &group : groups)
+      {
+        group.next_release_ns = now + group.period_ns;
+      }
+      running.store(true, std::memory_order_relaxed);
+      const auto body = [this](void)
+      {
+        Configure();
+        Run();
+      };
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+      // std::threadはスレッドを生成できないとstd::system_errorを送出するので、捕捉して停止状態に戻す
+      try
+      {
+        thread = std::thread(body);
+      }
+      catch (const std::system_error &)
+      {
+        running.store(false, std::memory_order_relaxed);
+        return false;
+      }
+#else
+      thread = std::thread(body);
+#endif
+      return true;
+    }
+
+    // 実行の停止
+    void Stop(void)
+    {
+      running.store(false, std::memory_order_relaxed);
+      if (thread.joinable())
+      {
+        thread.join();
+      }
+    }
+
+    // 実行スレッドをCPUに固定できたか
+    bool IsPinned(void) const noexcept
+    {
+      return pinned.load(std::memory_order_relaxed);
+    }
+
+    // 実行スレッドにSCHED_FIFOを適用できたか
+    bool IsRealtime(void) const noexcept
+    {
+      return realtime.load(std::memory_order_relaxed);
+    }
+
+    // 登録されたループの数
+    std::size_t NumLoops(void) const noexcept
+    {
+      return infos.size();
+    }
+
+    // ループの記録の取得
+    ControlLoopSnapshot Snapshot(std::size_t id) const
+    {
+      const LoopInfo &info = infos[id];
+      const ControlLoopStats &stats = *info.stats;
+      ControlLoopSnapshot snapshot;
+      snapshot.id = id;
+      snapshot.name = info.name;
+      snapshot.period_ns = info.period_ns;
+      snapshot.runs = stats.runs.load(std::memory_order_relaxed);
+      snapshot.overruns = stats.overruns.load(std::memory_order_relaxed);
+      snapshot.skipped = stats.skipped.load(std::memory_order_relaxed);
+      snapshot.max_exec_ns = stats.max_exec_ns.load(std::memory_order_relaxed);
+      snapshot.max_jitter_ns = stats.max_jitter_ns.load(std::memory_order_relaxed);
+      for (std::size_t i = 0; i < Instrumentation::LatencyHistogram::num_buckets; ++i)
+      {
+        snapshot.exec_histogram[i] = stats.exec_ns.Count(i);
+        snapshot.jitter_histogram[i] = stats.jitter_ns.Count(i);
+      }
+      return snapshot;
+    }
+
+    // 全ループの記録の初期化
+    // 実行中の場合、直後の記録と競合して値が残ることがある
+    void Reset(void)
+    {
+      for (LoopInfo &info : infos)
+      {
+        info.stats->Clear();
+      }
+    }
+
+    // 記録をタブ区切りテキストで出力
+    // 列: id, name, period, runs, overruns, skipped, exec p50/p99/max, jitter p50/p99/max (時間はns)
+    void Dump(std::ostream &os) const
+    {
+      os << "id\tname\tperiod_ns\truns\toverruns\tskipped\texec_p50_ns\texec_p99_ns\texec_max_ns"
+         << "\tjitter_p50_ns\tjitter_p99_ns\tjitter_max_ns\n";
+      for (std::size_t id = 0; id < infos.size(); ++id)
+      {
+        const ControlLoopSnapshot s = Snapshot(id);
+        os << s.id << "\t" << s.name << "\t" << s.period_ns << "\t" << s.runs << "\t" << s.overruns << "\t"
+           << s.skipped << "\t" << s.ExecPercentile(0.5) << "\t" << s.ExecPercentile(0.99) << "\t" << s.max_exec_ns
+           << "\t" << s.JitterPercentile(0.5) << "\t" << s.JitterPercentile(0.99) << "\t" << s.max_jitter_ns << "\n";
+      }
+    }
+
+  private:
+    // 実行スレッドのCPU固定とスケジューリングの設定(権限がなければ適用しない)
+    void Configure(void)
+    {
+#if defined(__linux__)
+      if (config.cpu >= 0 && config.cpu < CPU_SETSIZE)
+      {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(config.cpu, &set);
+        pinned.store(pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0, std::memory_order_relaxed);
+      }
+#endif
+      if (config.fifo_priority > 0)
+      {
+        sched_param param;
+        std::memset(&param, 0, sizeof(param));
+        param.sched_priority = config.fifo_priority;
+        realtime.store(pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0, std::memory_order_relaxed);
+      }
+    }
+
+    // 実行スレッドの本体
+    void Run(void)
+    {
+      while (running.load(std::memory_order_relaxed))
+      {
+        // 最も早い起床時刻まで待機する
+        std::uint64_t release = groups[0].next_release_ns;
+        for (const Group &group : groups)
+        {
+          release = (group.next_release_ns < release) ? group.next_release_ns : release;
+        }
+        Internal::SleepUntil(release);
+
+        for (Group &group : groups)
+        {
+          const std::uint64_t now = Internal::MonotonicNow();
+          if (group.next_release_ns > now)
+          {
+            continue;
+          }
+          RunGroup(group);
+        }
+      }
+    }
+
+    // グループの1回分の実行
+    void RunGroup(Group &group)
+    {
+      const std::uint64_t release = group.next_release_ns;
+      const std::uint64_t deadline = release + group.period_ns;
+      std::uint64_t start = Internal::MonotonicNow();
+      for (const Loop &loop : group.loops)
+      {
+        loop.fn(loop.context);
+        const std::uint64_t end = Internal::MonotonicNow();
+        ControlLoopStats &stats = *loop.stats;
+        Internal::AddRelaxed(stats.runs, 1);
+        stats.exec_ns.Record(end - start);
+        stats.jitter_ns.Record(start - release);
+        Internal::MaxRelaxed(stats.max_exec_ns, end - start);
+        Internal::MaxRelaxed(stats.max_jitter_ns, start - release);
+        if (end > deadline)
+        {
+          Internal::AddRelaxed(stats.overruns, 1);
+        }
+        start = end;
+      }
+
+      // 実行が次の起床時刻を過ぎた場合は、過ぎた分の起床を飛ばして周期の位相を保つ
+      std::uint64_t next = deadline;
+      if (start > next)
+      {
+        const std::uint64_t missed = (start - next) / group.period_ns + 1;
+        next += missed * group.period_ns;
+        for (const Loop &loop : group.loops)
+        {
+          Internal::AddRelaxed(loop.stats->skipped, missed);
+        }
+      }
+      group.next_release_ns = next;
+    }
+  };
+
+} /* namespace MyDSP */
+
+
+#endif /* MYDSP_CONTROLEXECUTOR_HPP_ */
@@ -11,6 +11,9 @@
 #define MYDSP_CONTROLLER_HPP_
 
 #include "Internal/ZeroInitializer.hpp"
+#include "Internal/InstrumentationHook.hpp"
+#include "Internal/StateSerializer.hpp"
+#include <cstddef>
 
 namespace MyDSP
 {
@@ -27,6 +30,9 @@ namespace MyDSP
       T1 &Xn2 = state[1];
       T1 &Yn1 = state[2];
       T2 b0, b1, b2;
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+      Instrumentation::Probe probe{"PID"}; // 計測点
+#endif
 
     public:
       // デフォルトコンストラクタ
@@ -76,9 +82,39 @@ namespace MyDSP
         return Yn1;
       }
 
+      // 状態変数の保存に必要なバイト数
+      static constexpr std::size_t StateBytes(void)
+      {
+        return StateSerializer<T1>::Bytes(3);
+      }
+
+      // 状態変数(直前の入力2つと出力)の保存
+      // StateBytes()バイトを書き込み、その値を返す。sizeが足りなければ何もせず0を返す
+      std::size_t SaveState(void* buffer, std::size_t size) const
+      {
+        return (size < StateBytes()) ? 0 : StateSerializer<T1>::Save(state, 3, buffer, 0);
+      }
+
+      // 状態変数の復元(同じ型のコントローラのSaveStateで保存したものを読み込み、読み込んだバイト数を返す)
+      // sizeが足りなければ何もせず0を返す
+      std::size_t RestoreState(const void* buffer, std::size_t size)
+      {
+        return (size < StateBytes()) ? 0 : StateSerializer<T1>::Restore(state, 3, buffer, 0);
+      }
+
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+      // 計測点の取得
+      Instrumentation::Probe& GetProbe(void)
+      {
+        return probe;
+      }
+
+#endif
       // PID制御
       T1 operator()(const T1 & in)
       {
+        MYDSP_INSTRUMENT_SCOPE(probe, 1);
+
         /* y[n] = b0 * x[n] + b1 * x[n-1] + b2 * x[n-2] + y[n-1] */
         T1 out = b0 * in + b1 * Xn1 + b2 * Xn2 + Yn1;
 
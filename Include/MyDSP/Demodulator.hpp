@@ -0,0 +1,149 @@
+/*
+ * Demodulator.hpp
+ *
+ *  Created on: 2026/10/18
+ *      Author: Shibasaki
+ *
+ * 実数信号の周波数・位相の復調
+ * ヒルベルト変換器による解析信号の生成、Atan2による偏角の計算、包絡線の計算を1回のブロック処理にまとめる
+ * FMDemodulator   : 瞬時周波数(隣り合う解析信号の共役積の偏角。位相のアンラップが要らない)
+ * PhaseDemodulator: 瞬時位相([-π +π]に折り返した値)
+ * float/double専用
+ */
+
+#ifndef MYDSP_DEMODULATOR_HPP_
+#define MYDSP_DEMODULATOR_HPP_
+
+#include "Internal/InstrumentationHook.hpp"
+#include "Internal/IndexSequence.hpp"
+#include "Internal/LUT.hpp"
+#include "Internal/Kernel.hpp"
+#include "Dispatch.hpp"
+#include "Const.hpp"
+#include <type_traits>
+#include <cstddef>
+
+namespace MyDSP
+{
+  namespace Internal
+  {
+    // ヒルベルト変換器の係数
+    // 長さ4*NumCoeffs-1の奇対称FIRで、中心からm(奇数)離れたタップは ±2/(πm) にBlackman窓を掛けたもの
+    // values[k]は m = 2k+1 の係数(中心より古い側が正)
+    template <class T, std::size_t NumCoeffs>
+    struct HilbertCoeffsImpl
+    {
+      T values[NumCoeffs];
+      template <std::size_t... Seq>
+      constexpr HilbertCoeffsImpl(SinCosTableGenerator<long double,4*NumCoeffs,4*NumCoeffs-1>&& table, IndexSequence<Seq...>) :
+        values{static_cast<T>(2.0L / (Pi<long double>() * (2 * Seq + 1))
+          * (0.42L + 0.5L * table.cos_vals[2*Seq+1] + 0.08L * table.cos_vals[(4*Seq+2)%(4*NumCoeffs)]))...}
+      {}
+      constexpr HilbertCoeffsImpl() :
+        HilbertCoeffsImpl(SinCosTableGenerator<long double,4*NumCoeffs,4*NumCoeffs-1>(), MakeIndexSequence<NumCoeffs>())
+      {}
+    };
+
+    // ヒルベルト変換器の係数の実体
+    template <class T, std::size_t NumCoeffs>
+    struct HilbertCoeffs
+    {
+      static constexpr HilbertCoeffsImpl<T,NumCoeffs> instance{};
+      static constexpr auto& values = instance.values;
+    };
+    template <class T, std::size_t NumCoeffs>
+    constexpr HilbertCoeffsImpl<T,NumCoeffs> HilbertCoeffs<T,NumCoeffs>::instance;
+
+    // 復調器
+    // 型に依存しない共通部分の実装
+    template <class T, std::size_t NumCoeffs, std::size_t Order, Demodulation Type>
+    class DemodulatorBase
+    {
+      static_assert(std::is_floating_point<T>::value, "Template parameter 'T' should be a floating point type");
+      static_assert(NumCoeffs > 0 && NumCoeffs <= demodulator_max_coeffs, "Template parameter 'NumCoeffs' should be in [1 64]");
+
+    public:
+      // ヒルベルト変換器のタップ数と群遅延(出力は入力からDelayサンプル遅れる)
+      static constexpr std::size_t NumTaps = NumCoeffs * 4 - 1;
+      static constexpr std::size_t Delay = NumCoeffs * 2 - 1;
+
+    protected:
+      using Coeffs = HilbertCoeffs<T,NumCoeffs>;
+
+      T history[NumTaps-1]; // 直近の入力(古い順)
+      T last[2];            // 直前の解析信号の実部と虚部
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+      Instrumentation::Probe probe{"Demodulator"}; // 計測点
+#endif
+
+      DemodulatorBase(void) :
+        history{},
+        last{}
+      {}
+
+    public:
+      // 状態変数の初期化
+      void Clear(void)
+      {
+        for (auto &element : history)
+        {
+          element = T();
+        }
+        last[0] = T();
+        last[1] = T();
+      }
+
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+      // 計測点の取得
+      Instrumentation::Probe& GetProbe(void)
+      {
+        return probe;
+      }
+
+#endif
+      // 復調処理本体
+      T operator()(const T & in)
+      {
+        MYDSP_INSTRUMENT_SCOPE(probe, 1);
+        T out;
+        DemodulateBlock<Order,Type>(Coeffs::values, NumCoeffs, history, last, &in, &out, static_cast<T*>(nullptr), 1);
+        return out;
+      }
+
+      // ブロック処理(inとoutは同じ領域でもよい)
+      // envelope: nullptrでなければ包絡線(解析信号の絶対値)を格納する
+      void Process(const T* in, T* out, std::size_t length, T* envelope = nullptr)
+      {
+        MYDSP_INSTRUMENT_SCOPE(probe, length);
+        DemodulateBlock<Order,Type>(Coeffs::values, NumCoeffs, history, last, in, out, envelope, length);
+      }
+    };
+
+    template <class T, std::size_t NumCoeffs, std::size_t Order, Demodulation Type>
+    constexpr std::size_t DemodulatorBase<T,NumCoeffs,Order,Type>::NumTaps;
+    template <class T, std::size_t NumCoeffs, std::size_t Order, Demodulation Type>
+    constexpr std::size_t DemodulatorBase<T,NumCoeffs,Order,Type>::Delay;
+
+  } /* namespace Internal */
+
+  // 周波数復調器
+  // 出力は瞬時周波数(rad/サンプル)。Hzにするにはサンプリング周波数/2πを掛ける
+  // NumCoeffs: ヒルベルト変換器の0でない係数の数の半分(タップ数は4*NumCoeffs-1)
+  //   通過域の下端はおよそ2/(4*NumCoeffs)(ナイキスト周波数で正規化)。低い搬送波ほど大きくする
+  // Order: Atan2のミニマックス多項式の次数
+  template <class T, std::size_t NumCoeffs = 16, std::size_t Order = 9>
+  class FMDemodulator : public Internal::DemodulatorBase<T,NumCoeffs,Order,Internal::Demodulation::Frequency>
+  {
+  };
+
+  // 位相復調器
+  // 出力は瞬時位相(rad, [-π +π])。テンプレート引数はFMDemodulatorと同じ
+  template <class T, std::size_t NumCoeffs = 16, std::size_t Order = 9>
+  class PhaseDemodulator : public Internal::DemodulatorBase<T,NumCoeffs,Order,Internal::Demodulation::Phase>
+  {
+  };
+
+} /* namespace MyDSP */
+
+
+#endif /* MYDSP_DEMODULATOR_HPP_ */
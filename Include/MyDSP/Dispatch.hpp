@@ -0,0 +1,844 @@
+/*
+ * Dispatch.hpp
+ *
+ *  Created on: 2026/10/18
+ *      Author: Shibasaki
+ *
+ * 実行時のCPU機能判定によるカーネルの切り替え
+ * Internal/Kernel.hpp のカーネルをSSE2/AVX2/AVX-512向けにtarget属性付きでコンパイルし、
+ * 初回呼び出し時にcpuidの結果から最適なものを選んで関数ポインタに保存する
+ * 以降の呼び出しのコストは間接呼び出し1回のみ
+ * x86上のGCC/Clang以外では、インクルード側のコンパイルオプションでコンパイルされた汎用版のみを使う
+ *
+ * 環境変数MYDSP_SIMDに generic/sse2/avx2/avx512 を指定すると、使用する命令セットの上限を制限できる
+ */
+
+#ifndef MYDSP_DISPATCH_HPP_
+#define MYDSP_DISPATCH_HPP_
+
+#include "Internal/Kernel.hpp"
+#include <atomic>
+#include <complex>
+#include <type_traits>
+#include <cstdlib>
+#include <cstring>
+#include <cstddef>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+  #define MYDSP_DISPATCH_X86 1
+  #define MYDSP_TARGET_SSE2   __attribute__((target("sse2")))
+  #define MYDSP_TARGET_AVX2   __attribute__((target("avx2,fma")))
+  #if defined(__clang__)
+    #define MYDSP_TARGET_AVX512 __attribute__((target("avx512f,avx2,fma")))
+  #else
+    #define MYDSP_TARGET_AVX512 __attribute__((target("avx512f,avx2,fma,prefer-vector-width=512")))
+  #endif
+#endif
+
+namespace MyDSP
+{
+  // 命令セットの水準
+  enum class SimdLevel
+  {
+    Generic = 0, // インクルード側のコンパイルオプションのまま
+    SSE2    = 1,
+    AVX2    = 2, // AVX2 + FMA
+    AVX512  = 3, // AVX-512F
+  };
+
+  // 命令セットの水準の名称
+  static inline const char* SimdLevelName(SimdLevel level) noexcept
+  {
+    return (level == SimdLevel::AVX512) ? "avx512"
+    :      (level == SimdLevel::AVX2)   ? "avx2"
+    :      (level == SimdLevel::SSE2)   ? "sse2"
+    :      "generic" ;
+  }
+
+  namespace Internal
+  {
+    // cpuidによる判定(環境変数による制限前)
+    static inline SimdLevel DetectCpuSimdLevel(void) noexcept
+    {
+#if defined(MYDSP_DISPATCH_X86)
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+      {
+        return SimdLevel::AVX512;
+      }
+      if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+      {
+        return SimdLevel::AVX2;
+      }
+      if (__builtin_cpu_supports("sse2"))
+      {
+        return SimdLevel::SSE2;
+      }
+#endif
+      return SimdLevel::Generic;
+    }
+
+    // 環境変数MYDSP_SIMDによる上限
+    static inline SimdLevel SimdLevelLimit(void) noexcept
+    {
+      const char* env = std::getenv("MYDSP_SIMD");
+      if (env == nullptr)
+      {
+        return SimdLevel::AVX512;
+      }
+      return (std::strcmp(env, "generic") == 0) ? SimdLevel::Generic
+      :      (std::strcmp(env, "sse2") == 0)    ? SimdLevel::SSE2
+      :      (std::strcmp(env, "avx2") == 0)    ? SimdLevel::AVX2
+      :      SimdLevel::AVX512 ;
+    }
+  } /* namespace Internal */
+
+  // 使用する命令セットの水準
+  // 初回呼び出し時に判定し、以降は同じ値を返す
+  static inline SimdLevel GetSimdLevel(void) noexcept
+  {
+    static const SimdLevel level = [](void)
+    {
+      const SimdLevel detected = Internal::DetectCpuSimdLevel();
+      const SimdLevel limit = Internal::SimdLevelLimit();
+      return (static_cast<int>(detected) < static_cast<int>(limit)) ? detected : limit;
+    }();
+    return level;
+  }
+
+  namespace Internal
+  {
+    // 命令セットごとの部分和の数(ベクトルレジスタ2本分)
+    template <class T, SimdLevel Level>
+    struct SimdLanes
+    {
+      static constexpr std::size_t value =
+        ((Level == SimdLevel::AVX512) ? 128 : (Level == SimdLevel::AVX2) ? 64 : 32) / sizeof(T);
+      static_assert(value >= 2, "Unsupported element size");
+    };
+
+    // 命令セット別のカーネルが用意されている型の組み合わせか
+    // T1: 入出力, T2: 係数, TS: 状態変数(係数・状態変数はT1そのもの、またはT1がfloatのときHalf/BFloat16)
+    template <class T1, class T2, class TS = T1>
+    struct HasDispatchedKernel :
+      std::integral_constant<bool,
+        std::is_floating_point<T1>::value && IsStorageOf<T1,T2>::value && IsStorageOf<T1,TS>::value>
+    {};
+
+    // 関数ポインタの切り替え
+    // Impl::Select()が返す関数を初回呼び出し時にfnへ保存する
+    // fnは定数初期化されるため、静的初期化の順序に依存しない
+    template <class Impl, class Ret, class... Args>
+    struct Dispatcher
+    {
+      using Fn = Ret (*)(Args...);
+      static std::atomic<Fn> fn;
+
+      static Ret Resolve(Args... args)
+      {
+        const Fn selected = Impl::Select(GetSimdLevel());
+        fn.store(selected, std::memory_order_relaxed);
+        return selected(args...);
+      }
+
+      static Ret Call(Args... args)
+      {
+        return fn.load(std::memory_order_relaxed)(args...);
+      }
+    };
+    template <class Impl, class Ret, class... Args>
+    std::atomic<typename Dispatcher<Impl,Ret,Args...>::Fn> Dispatcher<Impl,Ret,Args...>::fn{&Dispatcher<Impl,Ret,Args...>::Resolve};
+
+    // 命令セット別の関数の生成と選択
+    // Kernel::Run<Level>(args...)を命令セットごとのtarget属性付きの関数から呼び出す
+    // Runとカーネルは常にインライン展開されるので、カーネル本体は呼び出し元の命令セットでコンパイルされる
+    // Signature: 関数の型 Ret(Args...), MaxLevel: 使用する命令セットの上限(これより上の水準でもMaxLevel版を使う)
+    // 新しいカーネルは、このクラスを継承してRunを定義するだけでよい
+    template <class Kernel, class Signature, SimdLevel MaxLevel = SimdLevel::AVX512>
+    struct SimdDispatch;
+
+    template <class Kernel, class Ret, class... Args, SimdLevel MaxLevel>
+    struct SimdDispatch<Kernel, Ret(Args...), MaxLevel> :
+      Dispatcher<SimdDispatch<Kernel, Ret(Args...), MaxLevel>, Ret, Args...>
+    {
+      using Fn = Ret (*)(Args...);
+
+      static Ret Generic(Args... args)
+      {
+        return Kernel::template Run<SimdLevel::Generic>(args...);
+      }
+#if defined(MYDSP_DISPATCH_X86)
+      MYDSP_TARGET_SSE2
+      static Ret SSE2(Args... args)
+      {
+        return Kernel::template Run<SimdLevel::SSE2>(args...);
+      }
+      MYDSP_TARGET_AVX2
+      static Ret AVX2(Args... args)
+      {
+        return Kernel::template Run<SimdLevel::AVX2>(args...);
+      }
+      MYDSP_TARGET_AVX512
+      static Ret AVX512(Args... args)
+      {
+        return Kernel::template Run<SimdLevel::AVX512>(args...);
+      }
+#endif
+      static Fn Select(SimdLevel level) noexcept
+      {
+#if defined(MYDSP_DISPATCH_X86)
+        level = (static_cast<int>(level) < static_cast<int>(MaxLevel)) ? level : MaxLevel;
+        return (level == SimdLevel::AVX512) ? &AVX512
+        :      (level == SimdLevel::AVX2)   ? &AVX2
+        :      (level == SimdLevel::SSE2)   ? &SSE2
+        :      &Generic ;
+#else
+        (void)level;
+        return &Generic;
+#endif
+      }
+    };
+
+    // FIRフィルタのブロック処理
+    // TC/TS: 係数・ディレイラインの格納型
+    template <class T, class TC = T, class TS = T>
+    struct FIRBlockDispatch :
+      SimdDispatch<FIRBlockDispatch<T,TC,TS>, void(const TC*, TS*, std::size_t, std::size_t&, const T*, T*, std::size_t)>
+    {
+      template <SimdLevel Level>
+      MYDSP_ALWAYS_INLINE static void Run(const TC* c, TS* s, std::size_t taps, std::size_t &top, const T* in, T* out, std::size_t len)
+      {
+        FIRBlockKernel<T,SimdLanes<T,Level>::value>(c, s, taps, top, in, out, len);
+      }
+    };
+
+    // 多チャネル双二次IIRフィルタ(直接型II転置構成)のブロック処理
+    // TC/TS: 係数・状態変数の格納型
+    template <class T, class TC = T, class TS = T>
+    struct BiquadDF2TMultiChannelDispatch :
+      SimdDispatch<BiquadDF2TMultiChannelDispatch<T,TC,TS>, void(const TC*, TS*, std::size_t, std::size_t, const T*, T*, std::size_t)>
+    {
+      template <SimdLevel Level>
+      MYDSP_ALWAYS_INLINE static void Run(const TC* c, TS* s, std::size_t stages, std::size_t ch, const T* in, T* out, std::size_t len)
+      {
+        BiquadDF2TMultiChannelKernel<T,SimdLanes<T,Level>::value>(c, s, stages, ch, in, out, len);
+      }
+    };
+
+    // 双二次IIRフィルタ(直接型II転置構成)の先読み形式によるブロック処理
+    // TA: 状態変数と状態遷移行列の型
+    template <class T, std::size_t BlockSize, class TA = typename LookAheadStateType<T>::type>
+    struct BiquadDF2TLookAheadDispatch :
+      SimdDispatch<BiquadDF2TLookAheadDispatch<T,BlockSize,TA>,
+        void(const T*, const T*, const TA*, TA*, std::size_t, const T*, T*, std::size_t)>
+    {
+      template <SimdLevel Level>
+      MYDSP_ALWAYS_INLINE static void Run(const T* c, const T* m, const TA* a, TA* s, std::size_t stages,
+        const T* in, T* out, std::size_t len)
+      {
+        BiquadDF2TLookAheadKernel<T,BlockSize>(c, m, a, s, stages, in, out, len);
+      }
+    };
+
+    // 複素FIRフィルタのブロック処理
+    template <class T, bool ComplexCoeffs>
+    struct ComplexFIRBlockDispatch :
+      SimdDispatch<ComplexFIRBlockDispatch<T,ComplexCoeffs>,
+        void(const T*, const T*, T*, T*, std::size_t, std::size_t&, const T*, T*, std::size_t)>
+    {
+      template <SimdLevel Level>
+      MYDSP_ALWAYS_INLINE static void Run(const T* cr, const T* ci, T* sr, T* si, std::size_t taps, std::size_t &top,
+        const T* in, T* out, std::size_t len)
+      {
+        ComplexFIRBlockKernel<T,SimdLanes<T,Level>::value,ComplexCoeffs>(cr, ci, sr, si, taps, top, in, out, len);
+      }
+    };
+
+    // 複素係数の従属型双二次IIRフィルタ(直接型II転置構成)のブロック処理
+    // 1サンプルあたり実部と虚部の2要素しか並列性がないため、AVX-512版は速くならない(実測ではAVX2版の約2倍遅い)
+    // AVX-512でもAVX2版を使う
+    template <class T>
+    struct ComplexBiquadDF2TDispatch :
+      SimdDispatch<ComplexBiquadDF2TDispatch<T>, void(const T*, T*, std::size_t, const T*, T*, std::size_t), SimdLevel::AVX2>
+    {
+      template <SimdLevel Level>
+      MYDSP_ALWAYS_INLINE static void Run(const T* c, T* s, std::size_t stages, const T* in, T* out, std::size_t len)
+      {
+        ComplexBiquadDF2TKernel<T>(c, s, stages, in, out, len);
+      }
+    };
+
+    // Goertzelアルゴリズムの複数周波数分の処理
+    template <class T, std::size_t NumBins>
+    struct GoertzelDispatch :
+      SimdDispatch<GoertzelDispatch<T,NumBins>, void(const T*, T*, T*, const T*, std::size_t)>
+    {
+      template <SimdLevel Level>
+      MYDSP_ALWAYS_INLINE static void Run(const T* c, T* s1, T* s2, const T* in, std::size_t len)
+      {
+        GoertzelKernel<T,NumBins>(c, s1, s2, in, len);
+      }
+    };
+
+    // スライディングDFTの複数ビン分の処理
+    template <class T, std::size_t NumBins>
+    struct SlidingDFTDispatch :
+      SimdDispatch<SlidingDFTDispatch<T,NumBins>,
+        void(const T*, const T*, T, T, T*, T*, T*, std::size_t, std::size_t&, const T*, std::size_t)>
+    {
+      template <SimdLevel Level>
+      MYDSP_ALWAYS_INLINE static void Run(const T* wr, const T* wi, T r, T rn, T* xr, T* xi, T* ring, std::size_t n,
+        std::size_t &top, const T* in, std::size_t len)
+      {
+        SlidingDFTKernel<T,NumBins>(wr, wi, r, rn, xr, xi, ring, n, top, in, len);
+      }
+    };
+
+    // 移動窓の統計量の漸化式による更新
+    template <class T, MovingStatistic Stat>
+    struct MovingStatisticsUpdateDispatch :
+      SimdDispatch<MovingStatisticsUpdateDispatch<T,Stat>,
+        void(T*, std::size_t, std::size_t, std::size_t, const T*, T*, T*, const T*, T*, std::size_t)>
+    {
+      template <SimdLevel Level>
+      MYDSP_ALWAYS_INLINE static void Run(T* s, std::size_t win, std::size_t ch, std::size_t top, const T* k, T* s1, T* s2,
+        const T* in, T* out, std::size_t len)
+      {
+        MovingStatisticsUpdateKernel<T,Stat,SimdLanes<T,Level>::value>(s, win, ch, top, k, s1, s2, in, out, len);
+      }
+    };
+
+    // 移動窓の統計量の和の再計算
+    template <class T, MovingStatistic Stat>
+    struct MovingStatisticsRecomputeDispatch :
+      SimdDispatch<MovingStatisticsRecomputeDispatch<T,Stat>, void(const T*, std::size_t, std::size_t, T*, T*, T*)>
+    {
+      template <SimdLevel Level>
+      MYDSP_ALWAYS_INLINE static void Run(const T* x, std::size_t win, std::size_t ch, T* k, T* s1, T* s2)
+      {
+        MovingStatisticsRecomputeKernel<T,Stat,SimdLanes<T,Level>::value>(x, win, ch, k, s1, s2);
+      }
+    };
+
+    // FFT(順変換)
+    template <class T>
+    struct FFTDispatch :
+      SimdDispatch<FFTDispatch<T>, void(const T*, const T*, T*, T*, T*, T*, std::size_t)>
+    {
+      template <SimdLevel Level>
+      MYDSP_ALWAYS_INLINE static void Run(const T* wr, const T* wi, T* re, T* im, T* work_re, T* work_im, std::size_t len)
+      {
+        FFTKernel<T>(wr, wi, re, im, work_re, work_im, len);
+      }
+    };
+
+    // 任意比のリサンプラのブロック処理
+    template <class T>
+    struct ResamplerDispatch :
+      SimdDispatch<ResamplerDispatch<T>, std::size_t(const T*, std::size_t, std::size_t, T*, std::size_t&, double&, double,
+        const T*, std::size_t, std::size_t&, T*, std::size_t)>
+    {
+      template <SimdLevel Level>
+      MYDSP_ALWAYS_INLINE static std::size_t Run(const T* c, std::size_t taps, std::size_t phases, T* s, std::size_t &top,
+        double &pos, double step, const T* in, std::size_t in_len, std::size_t &consumed, T* out, std::size_t out_len)
+      {
+        return ResamplerKernel<T,SimdLanes<T,Level>::value>(
+          c, taps, phases, s, top, pos, step, in, in_len, consumed, out, out_len);
+      }
+    };
+
+    // 解析信号を求めてからの復調のブロック処理
+    template <class T, std::size_t Order, Demodulation Type>
+    struct DemodulatorDispatch :
+      SimdDispatch<DemodulatorDispatch<T,Order,Type>, void(const T*, std::size_t, T*, T*, const T*, T*, T*, std::size_t)>
+    {
+      template <SimdLevel Level>
+      MYDSP_ALWAYS_INLINE static void Run(const T* c, std::size_t num, T* h, T* last, const T* in, T* out, T* env, std::size_t len)
+      {
+        DemodulatorKernel<T,Order,Type>(c, num, h, last, in, out, env, len);
+      }
+    };
+
+    // sin,cosの配列処理
+    template <class T, std::size_t Order>
+    struct SinCosDispatch :
+      SimdDispatch<SinCosDispatch<T,Order>, void(const T*, T*, T*, std::size_t)>
+    {
+      template <SimdLevel Level>
+      MYDSP_ALWAYS_INLINE static void Run(const T* theta, T* s, T* c, std::size_t len)
+      {
+        SinCosKernel<T,Order>(theta, s, c, len);
+      }
+    };
+
+    // 平方根の配列処理
+    template <class T, SqrtAccuracy Accuracy>
+    struct SqrtDispatch :
+      SimdDispatch<SqrtDispatch<T,Accuracy>, void(const T*, T*, std::size_t)>
+    {
+      template <SimdLevel Level>
+      MYDSP_ALWAYS_INLINE static void Run(const T* in, T* out, std::size_t len)
+      {
+        SqrtKernel<T,Accuracy>(in, out, len);
+      }
+    };
+
+    // 逆平方根の配列処理
+    template <class T, SqrtAccuracy Accuracy>
+    struct RSqrtDispatch :
+      SimdDispatch<RSqrtDispatch<T,Accuracy>, void(const T*, T*, std::size_t)>
+    {
+      template <SimdLevel Level>
+      MYDSP_ALWAYS_INLINE static void Run(const T* in, T* out, std::size_t len)
+      {
+        RSqrtKernel<T,Accuracy>(in, out, len);
+      }
+    };
+
+    // 2乗ノルムの配列処理
+    template <class T, SqrtAccuracy Accuracy, bool Scaled>
+    struct HypotDispatch :
+      SimdDispatch<HypotDispatch<T,Accuracy,Scaled>, void(const T*, const T*, T*, std::size_t)>
+    {
+      template <SimdLevel Level>
+      MYDSP_ALWAYS_INLINE static void Run(const T* x, const T* y, T* out, std::size_t len)
+      {
+        HypotKernel<T,Accuracy,Scaled>(x, y, out, len);
+      }
+    };
+
+    // 複素数の絶対値の配列処理
+    template <class T, SqrtAccuracy Accuracy, bool Scaled>
+    struct MagnitudeDispatch :
+      SimdDispatch<MagnitudeDispatch<T,Accuracy,Scaled>, void(const T*, T*, std::size_t)>
+    {
+      template <SimdLevel Level>
+      MYDSP_ALWAYS_INLINE static void Run(const T* iq, T* out, std::size_t len)
+      {
+        MagnitudeKernel<T,Accuracy,Scaled>(iq, out, len);
+      }
+    };
+
+    // 従属型双二次IIRフィルタの周波数応答
+    template <class T>
+    struct BiquadResponseDispatch :
+      SimdDispatch<BiquadResponseDispatch<T>, void(const T*, std::size_t, const T*, T, T, T*, std::size_t)>
+    {
+      template <SimdLevel Level>
+      MYDSP_ALWAYS_INLINE static void Run(const T* c, std::size_t num, const T* w, T w0, T dw, T* out, std::size_t len)
+      {
+        BiquadResponseKernel<T>(c, num, w, w0, dw, out, len);
+      }
+    };
+
+    // FIRフィルタの周波数応答
+    template <class T>
+    struct FIRResponseDispatch :
+      SimdDispatch<FIRResponseDispatch<T>, void(const T*, std::size_t, const T*, T, T, T*, std::size_t)>
+    {
+      template <SimdLevel Level>
+      MYDSP_ALWAYS_INLINE static void Run(const T* c, std::size_t num, const T* w, T w0, T dw, T* out, std::size_t len)
+      {
+        FIRResponseKernel<T>(c, num, w, w0, dw, out, len);
+      }
+    };
+
+    // カルマンフィルタのバンクでまとめて処理するフィルタの数(256バイト分)
+    // 状態変数の配置がこの数で決まるため、命令セットによらず同じ値とする
+    // 16以下ではフィルタ方向のループが完全に展開され、別の方向にベクトル化されてしまうため、それより多くする
+    template <class T>
+    struct KalmanLanes
+    {
+      static constexpr std::size_t value = 256 / sizeof(T);
+    };
+
+    // カルマンフィルタのバンクの予測
+    template <class T, std::size_t NX, KalmanForm Form>
+    struct KalmanPredictDispatch :
+      SimdDispatch<KalmanPredictDispatch<T,NX,Form>, void(const T*, const T*, T*, T*, std::size_t)>
+    {
+      template <SimdLevel Level>
+      MYDSP_ALWAYS_INLINE static void Run(const T* f, const T* q, T* x, T* p, std::size_t blocks)
+      {
+        KalmanPredictKernel<T,KalmanLanes<T>::value,NX,Form>(f, q, x, p, blocks);
+      }
+    };
+
+    // カルマンフィルタのバンクの観測更新
+    template <class T, std::size_t NX, std::size_t NZ, KalmanForm Form>
+    struct KalmanUpdateDispatch :
+      SimdDispatch<KalmanUpdateDispatch<T,NX,NZ,Form>, void(const T*, const T*, const T*, T*, T*, T*, std::size_t)>
+    {
+      template <SimdLevel Level>
+      MYDSP_ALWAYS_INLINE static void Run(const T* h, const T* r, const T* z, T* x, T* p, T* v, std::size_t blocks)
+      {
+        KalmanUpdateKernel<T,KalmanLanes<T>::value,NX,NZ,Form>(h, r, z, x, p, v, blocks);
+      }
+    };
+
+  } /* namespace Internal */
+
+  // FIRフィルタのブロック処理(実行時に命令セットを選択)
+  // coeffs: タップ係数, state: タップ長の2倍の長さのディレイライン, state_top: ディレイラインの先頭
+  // Tがfloatのとき、係数とディレイラインはHalf/BFloat16で格納したものでもよい(積和はfloatで行う)
+  template <class T, class TC, class TS>
+  static inline auto FIRBlock(
+    const TC* coeffs,
+    TS* state,
+    std::size_t num_taps,
+    std::size_t &state_top,
+    const T* in,
+    T* out,
+    std::size_t length)
+    -> typename std::enable_if<Internal::HasDispatchedKernel<T,TC,TS>::value,void>::type
+  {
+    Internal::FIRBlockDispatch<T,TC,TS>::Call(coeffs, state, num_taps, state_top, in, out, length);
+  }
+
+  // 多チャネル従属型双二次IIRフィルタ(直接型II転置構成)のブロック処理(実行時に命令セットを選択)
+  // coeffs: [stage][5][channel], state: [stage][2][channel], in/out: [sample][channel]
+  // Tがfloatのとき、係数と状態変数はHalf/BFloat16で格納したものでもよい(漸化式はfloatで計算する)
+  template <class T, class TC, class TS>
+  static inline auto BiquadDF2TMultiChannelBlock(
+    const TC* coeffs,
+    TS* state,
+    std::size_t num_stages,
+    std::size_t num_channels,
+    const T* in,
+    T* out,
+    std::size_t length)
+    -> typename std::enable_if<Internal::HasDispatchedKernel<T,TC,TS>::value,void>::type
+  {
+    Internal::BiquadDF2TMultiChannelDispatch<T,TC,TS>::Call(coeffs, state, num_stages, num_channels, in, out, length);
+  }
+
+  // 従属型双二次IIRフィルタ(直接型II転置構成)の先読み形式によるブロック処理(実行時に命令セットを選択)
+  // coeffs: [stage][5], matrices: [stage][BlockSize+4][BlockSize], transitions: [stage][4], state: [stage][2]
+  // (配置はInternal::BiquadDF2TLookAheadKernelを参照。transitionsとstateはTがfloatのときdouble)
+  // inとoutは同じ領域でもよい
+  template <std::size_t BlockSize, class T>
+  static inline auto BiquadDF2TLookAheadBlock(
+    const T* coeffs,
+    const T* matrices,
+    const typename Internal::LookAheadStateType<T>::type* transitions,
+    typename Internal::LookAheadStateType<T>::type* state,
+    std::size_t num_stages,
+    const T* in,
+    T* out,
+    std::size_t length)
+    -> typename std::enable_if<std::is_floating_point<T>::value,void>::type
+  {
+    Internal::BiquadDF2TLookAheadDispatch<T,BlockSize>::Call(coeffs, matrices, transitions, state, num_stages, in, out, length);
+  }
+
+  // 複素FIRフィルタのブロック処理(実行時に命令セットを選択)
+  // coeffs_re/coeffs_im: タップ係数の実部・虚部(coeffs_imがnullptrなら実数の係数とする)
+  // state_re/state_im: 実部・虚部それぞれのタップ長の2倍の長さのディレイライン, state_top: ディレイラインの先頭
+  // inとoutは同じ領域でもよい
+  template <class T>
+  static inline auto ComplexFIRBlock(
+    const T* coeffs_re,
+    const T* coeffs_im,
+    T* state_re,
+    T* state_im,
+    std::size_t num_taps,
+    std::size_t &state_top,
+    const std::complex<T>* in,
+    std::complex<T>* out,
+    std::size_t length)
+    -> typename std::enable_if<std::is_floating_point<T>::value,void>::type
+  {
+    // std::complex<T>の配列は実部・虚部の順に並んだTの配列として扱える
+    const T* in_iq = reinterpret_cast<const T*>(in);
+    T* out_iq = reinterpret_cast<T*>(out);
+    if (coeffs_im == nullptr)
+    {
+      Internal::ComplexFIRBlockDispatch<T,false>::Call(coeffs_re, coeffs_im, state_re, state_im, num_taps, state_top,
+        in_iq, out_iq, length);
+    }
+    else
+    {
+      Internal::ComplexFIRBlockDispatch<T,true>::Call(coeffs_re, coeffs_im, state_re, state_im, num_taps, state_top,
+        in_iq, out_iq, length);
+    }
+  }
+
+  // 複素係数の従属型双二次IIRフィルタ(直接型II転置構成)のブロック処理(実行時に命令セットを選択)
+  // coeffs: [stage][5], state: [stage][2]。inとoutは同じ領域でもよい
+  template <class T>
+  static inline auto ComplexBiquadDF2TBlock(
+    const std::complex<T>* coeffs,
+    std::complex<T>* state,
+    std::size_t num_stages,
+    const std::complex<T>* in,
+    std::complex<T>* out,
+    std::size_t length)
+    -> typename std::enable_if<std::is_floating_point<T>::value,void>::type
+  {
+    Internal::ComplexBiquadDF2TDispatch<T>::Call(reinterpret_cast<const T*>(coeffs), reinterpret_cast<T*>(state),
+      num_stages, reinterpret_cast<const T*>(in), reinterpret_cast<T*>(out), length);
+  }
+
+  // Goertzelアルゴリズムの複数周波数分の処理(実行時に命令セットを選択)
+  // coeffs: [bin] (2cos(ω)), s1/s2: [bin] (1,2サンプル前の中間値)
+  template <std::size_t NumBins, class T>
+  static inline auto GoertzelBlock(
+    const T* coeffs,
+    T* s1,
+    T* s2,
+    const T* in,
+    std::size_t length)
+    -> typename std::enable_if<std::is_floating_point<T>::value,void>::type
+  {
+    Internal::GoertzelDispatch<T,NumBins>::Call(coeffs, s1, s2, in, length);
+  }
+
+  // スライディングDFTの複数ビン分の処理(実行時に命令セットを選択)
+  // twiddle_re/twiddle_im: [bin] (exp(j2πk/N)), x_re/x_im: [bin] (各ビンのDFT値)
+  // ring: 長さring_lengthのリングバッファ, ring_top: リングバッファの最古の位置
+  // damping: 減衰係数r, damping_n: rのring_length乗
+  template <std::size_t NumBins, class T>
+  static inline auto SlidingDFTBlock(
+    const T* twiddle_re,
+    const T* twiddle_im,
+    T damping,
+    T damping_n,
+    T* x_re,
+    T* x_im,
+    T* ring,
+    std::size_t ring_length,
+    std::size_t &ring_top,
+    const T* in,
+    std::size_t length)
+    -> typename std::enable_if<std::is_floating_point<T>::value,void>::type
+  {
+    Internal::SlidingDFTDispatch<T,NumBins>::Call(twiddle_re, twiddle_im, damping, damping_n, x_re, x_im,
+      ring, ring_length, ring_top, in, length);
+  }
+
+  // 移動窓の統計量のブロック処理(実行時に命令セットを選択)
+  // state: [2*window][channel]のディレイライン, state_top: ディレイラインの最古の位置
+  // countdown: 和を計算し直すまでのサンプル数(window以下)
+  // shift/sum1/sum2: [channel] (基準値、基準値を引いた値の和と2乗和)
+  // in/out: [sample][channel] (inとoutは同じ領域でもよい)
+  // windowサンプルごとに窓全体から和を計算し直し、丸め誤差の蓄積を打ち切る(1サンプルあたり加算2回程度に相当)
+  template <Internal::MovingStatistic Stat, class T>
+  static inline auto MovingStatisticsBlock(
+    T* state,
+    std::size_t window,
+    std::size_t num_channels,
+    std::size_t &state_top,
+    std::size_t &countdown,
+    T* shift,
+    T* sum1,
+    T* sum2,
+    const T* in,
+    T* out,
+    std::size_t length)
+    -> typename std::enable_if<std::is_floating_point<T>::value,void>::type
+  {
+    std::size_t pos = 0;
+    while (pos < length)
+    {
+      const std::size_t m = (length - pos < countdown) ? length - pos : countdown;
+      Internal::MovingStatisticsUpdateDispatch<T,Stat>::Call(state, window, num_channels, state_top, shift, sum1, sum2,
+        in + pos * num_channels, out + pos * num_channels, m);
+      state_top = (state_top + m) % window;
+      countdown -= m;
+      pos += m;
+      if (countdown == 0)
+      {
+        // [state_top, state_top+window)に窓全体が古い順に連続して並んでいる
+        Internal::MovingStatisticsRecomputeDispatch<T,Stat>::Call(state + state_top * num_channels, window, num_channels,
+          shift, sum1, sum2);
+        countdown = window;
+      }
+    }
+  }
+
+  // FFTの順変換(実行時に命令セットを選択)
+  // re/im: 長さlength(2の冪, 4以上)の実部・虚部(インプレース), work_re/work_im: 同じ長さの作業領域
+  // twiddle_re/twiddle_im: 長さ3*lengthの回転因子(配置はInternal::FFTKernelを参照)
+  template <class T>
+  static inline auto FFTBlock(
+    const T* twiddle_re,
+    const T* twiddle_im,
+    T* re,
+    T* im,
+    T* work_re,
+    T* work_im,
+    std::size_t length)
+    -> typename std::enable_if<std::is_floating_point<T>::value,void>::type
+  {
+    Internal::FFTDispatch<T>::Call(twiddle_re, twiddle_im, re, im, work_re, work_im, length);
+  }
+
+  // 任意比のリサンプリング(実行時に命令セットを選択)
+  // coeffs: [phase][4][num_taps]のFarrow構造の係数(num_tapsは16の倍数), state: タップ長の2倍の長さのディレイライン
+  // position: 次の出力の時刻(最新の入力からの経過、入力サンプル単位), step: 出力1サンプルあたりの入力サンプル数
+  // 出力数を返し、使った入力のサンプル数をconsumedに格納する
+  template <class T>
+  static inline auto ResampleBlock(
+    const T* coeffs,
+    std::size_t num_taps,
+    std::size_t num_phases,
+    T* state,
+    std::size_t &state_top,
+    double &position,
+    double step,
+    const T* in,
+    std::size_t in_length,
+    std::size_t &consumed,
+    T* out,
+    std::size_t out_length)
+    -> typename std::enable_if<std::is_floating_point<T>::value,std::size_t>::type
+  {
+    return Internal::ResamplerDispatch<T>::Call(coeffs, num_taps, num_phases, state, state_top, position, step,
+      in, in_length, consumed, out, out_length);
+  }
+
+  // 解析信号を求めてからの復調(実行時に命令セットを選択)
+  // coeffs: ヒルベルト変換器の奇数番目の係数(num_coeffs個、64以下), history: 直近の4*num_coeffs-2個の入力
+  // last: 直前の解析信号の実部と虚部, envelope: nullptrでなければ包絡線を格納する
+  template <std::size_t Order, Internal::Demodulation Type, class T>
+  static inline auto DemodulateBlock(
+    const T* coeffs,
+    std::size_t num_coeffs,
+    T* history,
+    T* last,
+    const T* in,
+    T* out,
+    T* envelope,
+    std::size_t length)
+    -> typename std::enable_if<std::is_floating_point<T>::value,void>::type
+  {
+    Internal::DemodulatorDispatch<T,Order,Type>::Call(coeffs, num_coeffs, history, last, in, out, envelope, length);
+  }
+
+  // sin,cosの配列処理(ミニマックス多項式による近似、実行時に命令セットを選択)
+  // Order: sinの多項式の次数(3から11までの奇数)
+  template <std::size_t Order, class T>
+  static inline auto SinCos(
+    const T* theta,
+    T* sin_vals,
+    T* cos_vals,
+    std::size_t length)
+    -> typename std::enable_if<std::is_floating_point<T>::value,void>::type
+  {
+    Internal::SinCosDispatch<T,Order>::Call(theta, sin_vals, cos_vals, length);
+  }
+
+  // 平方根・逆平方根の配列処理の精度
+  using SqrtAccuracy = Internal::SqrtAccuracy;
+
+  // 平方根の配列処理(実行時に命令セットを選択)
+  // 負の値とNaNは0とする(分岐せずにマスクで選ぶ)
+  // Accuracy = SqrtAccuracy::Exactはstd::sqrtと同じ値になるが、GCC/Clangでは-fno-math-errno(-ffast-mathに含まれる)を
+  // 指定しないとerrnoの設定のためにベクトル化されない。それ以外はニュートン法による近似で、常にベクトル化される
+  template <SqrtAccuracy Accuracy = SqrtAccuracy::Exact, class T>
+  static inline auto Sqrt(const T* in, T* out, std::size_t length)
+    -> typename std::enable_if<std::is_floating_point<T>::value,void>::type
+  {
+    Internal::SqrtDispatch<T,Accuracy>::Call(in, out, length);
+  }
+
+  // 逆平方根の配列処理(実行時に命令セットを選択)
+  // ビット操作で求めた初期値をニュートン法で改善する。Accuracyで反復回数を選ぶ
+  // 0以下の値とNaNは無限大、無限大は0とする
+  template <SqrtAccuracy Accuracy = SqrtAccuracy::High, class T>
+  static inline auto RSqrt(const T* in, T* out, std::size_t length)
+    -> typename std::enable_if<std::is_floating_point<T>::value,void>::type
+  {
+    Internal::RSqrtDispatch<T,Accuracy>::Call(in, out, length);
+  }
+
+  // 2乗ノルムの配列処理(実行時に命令セットを選択)
+  // MyDSP::Hypot(x, y)と同様に、極めて大きな値ではオーバーフローを起こす
+  template <SqrtAccuracy Accuracy = SqrtAccuracy::Exact, class T>
+  static inline auto Hypot(const T* x, const T* y, T* out, std::size_t length)
+    -> typename std::enable_if<std::is_floating_point<T>::value,void>::type
+  {
+    Internal::HypotDispatch<T,Accuracy,false>::Call(x, y, out, length);
+  }
+
+  // 2乗ノルムの配列処理(オーバーフロー対策付き、実行時に命令セットを選択)
+  // 2のべき乗で拡大縮小してから求めるので、値の範囲全体で誤差はHypotと同程度になる
+  template <SqrtAccuracy Accuracy = SqrtAccuracy::Exact, class T>
+  static inline auto HypotScaled(const T* x, const T* y, T* out, std::size_t length)
+    -> typename std::enable_if<std::is_floating_point<T>::value,void>::type
+  {
+    Internal::HypotDispatch<T,Accuracy,true>::Call(x, y, out, length);
+  }
+
+  // 複素数(IQ信号)の絶対値の配列処理(実行時に命令セットを選択)
+  template <SqrtAccuracy Accuracy = SqrtAccuracy::Exact, class T>
+  static inline auto Magnitude(const std::complex<T>* in, T* out, std::size_t length)
+    -> typename std::enable_if<std::is_floating_point<T>::value,void>::type
+  {
+    Internal::MagnitudeDispatch<T,Accuracy,false>::Call(reinterpret_cast<const T*>(in), out, length);
+  }
+
+  // 複素数(IQ信号)の絶対値の配列処理(オーバーフロー対策付き、実行時に命令セットを選択)
+  template <SqrtAccuracy Accuracy = SqrtAccuracy::Exact, class T>
+  static inline auto MagnitudeScaled(const std::complex<T>* in, T* out, std::size_t length)
+    -> typename std::enable_if<std::is_floating_point<T>::value,void>::type
+  {
+    Internal::MagnitudeDispatch<T,Accuracy,true>::Call(reinterpret_cast<const T*>(in), out, length);
+  }
+
+  // 従属型双二次IIRフィルタの周波数応答(実行時に命令セットを選択)
+  // coeffs: [stage][5] (b0,b1,b2,a1,a2)
+  // omegas: 角周波数(rad/sample)の配列。nullptrなら等間隔の格子 omega0 + step * n
+  template <class T>
+  static inline auto BiquadResponseBlock(
+    const T* coeffs,
+    std::size_t num_stages,
+    const T* omegas,
+    T omega0,
+    T step,
+    std::complex<T>* out,
+    std::size_t length)
+    -> typename std::enable_if<std::is_floating_point<T>::value,void>::type
+  {
+    Internal::BiquadResponseDispatch<T>::Call(coeffs, num_stages, omegas, omega0, step, reinterpret_cast<T*>(out), length);
+  }
+
+  // FIRフィルタの周波数応答(実行時に命令セットを選択)
+  // coeffs: タップ係数(num_taps >= 1), omegas: BiquadResponseBlockと同じ
+  template <class T>
+  static inline auto FIRResponseBlock(
+    const T* coeffs,
+    std::size_t num_taps,
+    const T* omegas,
+    T omega0,
+    T step,
+    std::complex<T>* out,
+    std::size_t length)
+    -> typename std::enable_if<std::is_floating_point<T>::value,void>::type
+  {
+    Internal::FIRResponseDispatch<T>::Call(coeffs, num_taps, omegas, omega0, step, reinterpret_cast<T*>(out), length);
+  }
+
+  // カルマンフィルタのバンクの予測(実行時に命令セットを選択)
+  // Internal::KalmanLanes<T>::value個のフィルタを1ブロックとし、num_blocksブロック分を処理する
+  // 配置はInternal::KalmanPredictKernelを参照
+  template <std::size_t NX, Internal::KalmanForm Form, class T>
+  static inline auto KalmanPredictBlock(const T* f, const T* q, T* x, T* p, std::size_t num_blocks)
+    -> typename std::enable_if<std::is_floating_point<T>::value,void>::type
+  {
+    Internal::KalmanPredictDispatch<T,NX,Form>::Call(f, q, x, p, num_blocks);
+  }
+
+  // カルマンフィルタのバンクの観測更新(実行時に命令セットを選択)
+  // 配置はInternal::KalmanUpdateKernelを参照
+  template <std::size_t NX, std::size_t NZ, Internal::KalmanForm Form, class T>
+  static inline auto KalmanUpdateBlock(const T* h, const T* r, const T* z, T* x, T* p, T* valid, std::size_t num_blocks)
+    -> typename std::enable_if<std::is_floating_point<T>::value,void>::type
+  {
+    Internal::KalmanUpdateDispatch<T,NX,NZ,Form>::Call(h, r, z, x, p, valid, num_blocks);
+  }
+
+} /* namespace MyDSP */
+
+
+#endif /* MYDSP_DISPATCH_HPP_ */
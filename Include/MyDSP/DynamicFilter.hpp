@@ -0,0 +1,528 @@
+/*
+ * DynamicFilter.hpp
+ *
+ *  Created on: 2026/10/18
+ *      Author: Shibasaki
+ *
+ * タップ数・段数を実行時に決める離散時間フィルタ
+ * 状態変数と係数はArenaから確保し、1つのフィルタの分は隣接して配置される
+ * 処理本体はコンパイル時にサイズが決まるフィルタ(Filter.hpp)と同じカーネルを使う
+ *
+ * Arenaの容量不足や不正なサイズで構築した場合はIsValid()が偽になる
+ * IsValid()が偽のインスタンスで処理を呼び出してはならない
+ */
+
+#ifndef MYDSP_DYNAMICFILTER_HPP_
+#define MYDSP_DYNAMICFILTER_HPP_
+
+#include "Internal/ZeroInitializer.hpp"
+#include "Internal/InstrumentationHook.hpp"
+#include "Internal/Kernel.hpp"
+#include "Internal/StateSerializer.hpp"
+#include "Arena.hpp"
+#include "Dispatch.hpp"
+#include <type_traits>
+#include <cstddef>
+
+namespace MyDSP
+{
+  // 従属型双二次IIRフィルタ(直接型I)
+  template <class T1, class T2>
+  class IIRBiquadCascadeDF1Dynamic
+  {
+  protected:
+    T1* state;         // [NumStages+1][2]
+    const T2* coeffs;  // [NumStages][5]
+    std::size_t num_stages;
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+    Instrumentation::Probe probe{"BiquadDF1Dynamic"}; // 計測点
+#endif
+
+  public:
+    // Arenaから確保するバイト数
+    static constexpr std::size_t RequiredBytes(std::size_t num_stages)
+    {
+      return Arena::RequiredBytes<T1>((num_stages + 1) * 2) + Arena::RequiredBytes<T2>(num_stages * 5);
+    }
+
+    // コンストラクタ(フィルタ係数の配列で初期化)
+    IIRBiquadCascadeDF1Dynamic(Arena &arena, const T2 (*coeffs_init)[5], std::size_t num_stages) :
+      state(nullptr),
+      coeffs(nullptr),
+      num_stages(0)
+    {
+      const std::size_t mark = arena.Used();
+      T1* state_new = arena.Allocate<T1>((num_stages + 1) * 2);
+      T2* coeffs_new = state_new ? arena.Allocate<T2>(num_stages * 5) : nullptr;
+      if (coeffs_new == nullptr)
+      {
+        arena.Rewind(mark);
+        return;
+      }
+      for (std::size_t stage = 0; stage < num_stages; ++stage)
+      {
+        for (std::size_t i = 0; i < 5; ++i)
+        {
+          coeffs_new[stage*5+i] = coeffs_init[stage][i];
+        }
+      }
+      this->state = state_new;
+      this->coeffs = coeffs_new;
+      this->num_stages = num_stages;
+      Clear();
+    }
+
+    IIRBiquadCascadeDF1Dynamic(const IIRBiquadCascadeDF1Dynamic&) = delete;
+    IIRBiquadCascadeDF1Dynamic& operator=(const IIRBiquadCascadeDF1Dynamic&) = delete;
+
+    // ムーブ(領域の参照を移す。移動元は無効になる)
+    IIRBiquadCascadeDF1Dynamic(IIRBiquadCascadeDF1Dynamic&& other) noexcept :
+      state(other.state),
+      coeffs(other.coeffs),
+      num_stages(other.num_stages)
+    {
+      other.state = nullptr;
+      other.coeffs = nullptr;
+      other.num_stages = 0;
+    }
+
+    // 構築に成功したか
+    bool IsValid(void) const
+    {
+      return coeffs != nullptr;
+    }
+
+    // 段数の取得
+    std::size_t GetNumStages(void) const
+    {
+      return num_stages;
+    }
+
+    // 状態変数の初期化
+    void Clear(void)
+    {
+      for (std::size_t i = 0; i < (num_stages + 1) * 2 && state != nullptr; ++i)
+      {
+        state[i] = Internal::ZeroInitializer<T1>();
+      }
+    }
+
+    // 一定値dc_valueを入力し続けたときの定常状態に初期化
+    // z = 1に極を持つ段があれば偽を返す(状態変数は変更しない)
+    bool InitSteadyState(const T1 & dc_value)
+    {
+      for (std::size_t stage = 0; stage < num_stages; ++stage)
+      {
+        T2 gain = T2();
+        const T2* c = coeffs + stage * 5;
+        if (!Internal::BiquadDCGain(c[0], c[1], c[2], c[3], c[4], gain))
+        {
+          return false;
+        }
+      }
+      // state[stage][0..1]は段stageへの入力(前段の出力)の履歴
+      T1 x = dc_value;
+      for (std::size_t stage = 0; stage <= num_stages; ++stage)
+      {
+        state[stage*2+0] = x;
+        state[stage*2+1] = x;
+        if (stage < num_stages)
+        {
+          T2 gain = T2();
+          const T2* c = coeffs + stage * 5;
+          Internal::BiquadDCGain(c[0], c[1], c[2], c[3], c[4], gain);
+          x = gain * x;
+        }
+      }
+      return true;
+    }
+
+    // 状態変数の保存に必要なバイト数
+    std::size_t StateBytes(void) const
+    {
+      return Internal::StateSerializer<T1>::Bytes((num_stages + 1) * 2);
+    }
+
+    // 状態変数の保存(StateBytes()バイトを書き込み、その値を返す。sizeが足りなければ何もせず0を返す)
+    std::size_t SaveState(void* buffer, std::size_t size) const
+    {
+      return (size < StateBytes()) ? 0 : Internal::StateSerializer<T1>::Save(state, (num_stages + 1) * 2, buffer, 0);
+    }
+
+    // 状態変数の復元(同じ型・同じ段数のフィルタのSaveStateで保存したものを読み込み、読み込んだバイト数を返す)
+    // sizeが足りなければ何もせず0を返す
+    std::size_t RestoreState(const void* buffer, std::size_t size)
+    {
+      return (size < StateBytes()) ? 0 : Internal::StateSerializer<T1>::Restore(state, (num_stages + 1) * 2, buffer, 0);
+    }
+
+    // フィルタ係数の取得([stage][5]の配置)
+    const T2* GetCoeffs(void) const
+    {
+      return coeffs;
+    }
+
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+    // 計測点の取得
+    Instrumentation::Probe& GetProbe(void)
+    {
+      return probe;
+    }
+
+#endif
+    // フィルタ処理本体
+    T1 operator()(const T1 & in)
+    {
+      MYDSP_INSTRUMENT_SCOPE(probe, 1);
+      return Internal::BiquadDF1StepKernel(coeffs, state, num_stages, in);
+    }
+
+    // ブロック処理
+    // inとoutは同じ領域でもよい
+    void Process(const T1* in, T1* out, std::size_t length)
+    {
+      MYDSP_INSTRUMENT_SCOPE(probe, length);
+      for (std::size_t n = 0; n < length; ++n)
+      {
+        out[n] = Internal::BiquadDF1StepKernel(coeffs, state, num_stages, in[n]);
+      }
+    }
+  };
+
+  // 従属型双二次IIRフィルタ(直接型II転置構成)
+  template <class T1, class T2>
+  class IIRBiquadCascadeDF2TDynamic
+  {
+  protected:
+    T1* state;         // [NumStages][2]
+    const T2* coeffs;  // [NumStages][5]
+    std::size_t num_stages;
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+    Instrumentation::Probe probe{"BiquadDF2TDynamic"}; // 計測点
+#endif
+
+  public:
+    // Arenaから確保するバイト数
+    static constexpr std::size_t RequiredBytes(std::size_t num_stages)
+    {
+      return Arena::RequiredBytes<T1>(num_stages * 2) + Arena::RequiredBytes<T2>(num_stages * 5);
+    }
+
+    // コンストラクタ(フィルタ係数の配列で初期化)
+    IIRBiquadCascadeDF2TDynamic(Arena &arena, const T2 (*coeffs_init)[5], std::size_t num_stages) :
+      state(nullptr),
+      coeffs(nullptr),
+      num_stages(0)
+    {
+      const std::size_t mark = arena.Used();
+      T1* state_new = arena.Allocate<T1>(num_stages * 2);
+      T2* coeffs_new = state_new ? arena.Allocate<T2>(num_stages * 5) : nullptr;
+      if (coeffs_new == nullptr)
+      {
+        arena.Rewind(mark);
+        return;
+      }
+      for (std::size_t stage = 0; stage < num_stages; ++stage)
+      {
+        for (std::size_t i = 0; i < 5; ++i)
+        {
+          coeffs_new[stage*5+i] = coeffs_init[stage][i];
+        }
+      }
+      this->state = state_new;
+      this->coeffs = coeffs_new;
+      this->num_stages = num_stages;
+      Clear();
+    }
+
+    IIRBiquadCascadeDF2TDynamic(const IIRBiquadCascadeDF2TDynamic&) = delete;
+    IIRBiquadCascadeDF2TDynamic& operator=(const IIRBiquadCascadeDF2TDynamic&) = delete;
+
+    // ムーブ(領域の参照を移す。移動元は無効になる)
+    IIRBiquadCascadeDF2TDynamic(IIRBiquadCascadeDF2TDynamic&& other) noexcept :
+      state(other.state),
+      coeffs(other.coeffs),
+      num_stages(other.num_stages)
+    {
+      other.state = nullptr;
+      other.coeffs = nullptr;
+      other.num_stages = 0;
+    }
+
+    // 構築に成功したか
+    bool IsValid(void) const
+    {
+      return coeffs != nullptr;
+    }
+
+    // 段数の取得
+    std::size_t GetNumStages(void) const
+    {
+      return num_stages;
+    }
+
+    // 状態変数の初期化
+    void Clear(void)
+    {
+      for (std::size_t i = 0; i < num_stages * 2; ++i)
+      {
+        state[i] = Internal::ZeroInitializer<T1>();
+      }
+    }
+
+    // 一定値dc_valueを入力し続けたときの定常状態に初期化
+    // 各段の直流利得から、段の入力xと出力yに対して d1 = y - b0 x, d2 = b2 x + a2 y とする
+    // z = 1に極を持つ段があれば偽を返す(状態変数は変更しない)
+    bool InitSteadyState(const T1 & dc_value)
+    {
+      for (std::size_t stage = 0; stage < num_stages; ++stage)
+      {
+        T2 gain = T2();
+        const T2* c = coeffs + stage * 5;
+        if (!Internal::BiquadDCGain(c[0], c[1], c[2], c[3], c[4], gain))
+        {
+          return false;
+        }
+      }
+      T1 x = dc_value;
+      for (std::size_t stage = 0; stage < num_stages; ++stage)
+      {
+        T2 gain = T2();
+        const T2* c = coeffs + stage * 5;
+        Internal::BiquadDCGain(c[0], c[1], c[2], c[3], c[4], gain);
+        const T1 y = gain * x;
+        state[stage*2+0] = y - c[0] * x;
+        state[stage*2+1] = c[2] * x + c[4] * y;
+        x = y;
+      }
+      return true;
+    }
+
+    // 状態変数の保存に必要なバイト数
+    std::size_t StateBytes(void) const
+    {
+      return Internal::StateSerializer<T1>::Bytes(num_stages * 2);
+    }
+
+    // 状態変数の保存(StateBytes()バイトを書き込み、その値を返す。sizeが足りなければ何もせず0を返す)
+    std::size_t SaveState(void* buffer, std::size_t size) const
+    {
+      return (size < StateBytes()) ? 0 : Internal::StateSerializer<T1>::Save(state, num_stages * 2, buffer, 0);
+    }
+
+    // 状態変数の復元(同じ型・同じ段数のフィルタのSaveStateで保存したものを読み込み、読み込んだバイト数を返す)
+    // sizeが足りなければ何もせず0を返す
+    std::size_t RestoreState(const void* buffer, std::size_t size)
+    {
+      return (size < StateBytes()) ? 0 : Internal::StateSerializer<T1>::Restore(state, num_stages * 2, buffer, 0);
+    }
+
+    // フィルタ係数の取得([stage][5]の配置)
+    const T2* GetCoeffs(void) const
+    {
+      return coeffs;
+    }
+
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+    // 計測点の取得
+    Instrumentation::Probe& GetProbe(void)
+    {
+      return probe;
+    }
+
+#endif
+    // フィルタ処理本体
+    T1 operator()(const T1 & in)
+    {
+      MYDSP_INSTRUMENT_SCOPE(probe, 1);
+      return Internal::BiquadDF2TStepKernel(coeffs, state, num_stages, in);
+    }
+
+    // ブロック処理
+    // inとoutは同じ領域でもよい
+    void Process(const T1* in, T1* out, std::size_t length)
+    {
+      MYDSP_INSTRUMENT_SCOPE(probe, length);
+      for (std::size_t n = 0; n < length; ++n)
+      {
+        out[n] = Internal::BiquadDF2TStepKernel(coeffs, state, num_stages, in[n]);
+      }
+    }
+  };
+
+  // FIRフィルタ
+  template <class T1, class T2>
+  class FIRDynamic
+  {
+  protected:
+    T1* state;     // タップ長の2倍の長さのディレイライン
+    T2* coeffs;    // 適応フィルタに使えるよう非const
+    std::size_t num_taps;
+    std::size_t state_top; // ディレイラインの先頭を指すインデックス番号
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+    Instrumentation::Probe probe{"FIRDynamic"}; // 計測点
+#endif
+
+  public:
+    // Arenaから確保するバイト数
+    static constexpr std::size_t RequiredBytes(std::size_t num_taps)
+    {
+      return Arena::RequiredBytes<T1>(num_taps * 2) + Arena::RequiredBytes<T2>(num_taps);
+    }
+
+    // コンストラクタ(フィルタ係数の配列で初期化)
+    FIRDynamic(Arena &arena, const T2* coeffs_init, std::size_t num_taps) :
+      state(nullptr),
+      coeffs(nullptr),
+      num_taps(0),
+      state_top(0)
+    {
+      const std::size_t mark = arena.Used();
+      T1* state_new = arena.Allocate<T1>(num_taps * 2);
+      T2* coeffs_new = state_new ? arena.Allocate<T2>(num_taps) : nullptr;
+      if (coeffs_new == nullptr)
+      {
+        arena.Rewind(mark);
+        return;
+      }
+      this->state = state_new;
+      this->coeffs = coeffs_new;
+      this->num_taps = num_taps;
+      SetCoeffs(coeffs_init);
+      Clear();
+    }
+
+    FIRDynamic(const FIRDynamic&) = delete;
+    FIRDynamic& operator=(const FIRDynamic&) = delete;
+
+    // ムーブ(領域の参照を移す。移動元は無効になる)
+    FIRDynamic(FIRDynamic&& other) noexcept :
+      state(other.state),
+      coeffs(other.coeffs),
+      num_taps(other.num_taps),
+      state_top(other.state_top)
+    {
+      other.state = nullptr;
+      other.coeffs = nullptr;
+      other.num_taps = 0;
+      other.state_top = 0;
+    }
+
+    // 構築に成功したか
+    bool IsValid(void) const
+    {
+      return coeffs != nullptr;
+    }
+
+    // タップ数の取得
+    std::size_t GetNumTaps(void) const
+    {
+      return num_taps;
+    }
+
+    // 状態変数の初期化
+    void Clear(void)
+    {
+      for (std::size_t i = 0; i < num_taps * 2; ++i)
+      {
+        state[i] = Internal::ZeroInitializer<T1>();
+      }
+    }
+
+    // 一定値dc_valueを入力し続けたときの定常状態に初期化(ディレイラインをdc_valueで埋める)
+    bool InitSteadyState(const T1 & dc_value)
+    {
+      for (std::size_t i = 0; i < num_taps * 2; ++i)
+      {
+        state[i] = dc_value;
+      }
+      return true;
+    }
+
+    // 状態変数の保存に必要なバイト数
+    std::size_t StateBytes(void) const
+    {
+      return Internal::StateSerializer<T1>::Bytes(num_taps);
+    }
+
+    // 状態変数の保存(StateBytes()バイトを書き込み、その値を返す。sizeが足りなければ何もせず0を返す)
+    // ディレイラインは先頭位置によらず古い順にGetNumTaps()個を保存する
+    std::size_t SaveState(void* buffer, std::size_t size) const
+    {
+      return (size < StateBytes()) ? 0 : Internal::StateSerializer<T1>::Save(state + state_top, num_taps, buffer, 0);
+    }
+
+    // 状態変数の復元(同じ型・同じタップ数のフィルタのSaveStateで保存したものを読み込み、読み込んだバイト数を返す)
+    // sizeが足りなければ何もせず0を返す
+    std::size_t RestoreState(const void* buffer, std::size_t size)
+    {
+      if (size < StateBytes())
+      {
+        return 0;
+      }
+      Internal::StateSerializer<T1>::Restore(state, num_taps, buffer, 0);
+      Internal::StateSerializer<T1>::Restore(state + num_taps, num_taps, buffer, 0);
+      state_top = 0;
+      return StateBytes();
+    }
+
+    // フィルタ係数の取得
+    const T2* GetCoeffs(void) const
+    {
+      return coeffs;
+    }
+
+    // フィルタ係数の再設定(GetNumTaps()個の要素を読む)
+    void SetCoeffs(const T2* coeffs_new)
+    {
+      for (std::size_t tap_cnt = 0; tap_cnt < num_taps; ++tap_cnt)
+      {
+        coeffs[tap_cnt] = coeffs_new[tap_cnt];
+      }
+    }
+
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+    // 計測点の取得
+    Instrumentation::Probe& GetProbe(void)
+    {
+      return probe;
+    }
+
+#endif
+    // フィルタ処理本体
+    T1 operator()(const T1 & in)
+    {
+      MYDSP_INSTRUMENT_SCOPE(probe, 1);
+      return Internal::FIRStepKernel(coeffs, state, num_taps, state_top, in);
+    }
+
+    // ブロック処理
+    // float/doubleで入出力と係数の型が同じ場合は、実行時に選択した命令セット向けのカーネルを使う
+    // inとoutは同じ領域でもよい
+    void Process(const T1* in, T1* out, std::size_t length)
+    {
+      MYDSP_INSTRUMENT_SCOPE(probe, length);
+      ProcessBlock(in, out, length, Internal::HasDispatchedKernel<T1,T2>());
+    }
+
+  protected:
+    // ブロック処理(命令セット別のカーネル)
+    void ProcessBlock(const T1* in, T1* out, std::size_t length, std::true_type)
+    {
+      FIRBlock<T1>(coeffs, state, num_taps, state_top, in, out, length);
+    }
+
+    // ブロック処理(汎用)
+    void ProcessBlock(const T1* in, T1* out, std::size_t length, std::false_type)
+    {
+      for (std::size_t n = 0; n < length; ++n)
+      {
+        out[n] = Internal::FIRStepKernel(coeffs, state, num_taps, state_top, in[n]);
+      }
+    }
+  };
+
+} /* namespace MyDSP */
+
+
+#endif /* MYDSP_DYNAMICFILTER_HPP_ */
@@ -0,0 +1,159 @@
+/*
+ * FFT.hpp
+ *
+ *  Created on: 2026/10/18
+ *      Author: Shibasaki
+ *
+ * 固定長の高速フーリエ変換
+ * 長さNは2の冪。実部と虚部を別々の配列(planar)で扱い、インプレースで変換する
+ * 基数2のStockham型(段ごとに作業領域と交互に読み書きする)で、ビット反転の並べ替えが要らない
+ * 回転因子はコンパイル時に生成したテーブルを使い、作業領域はメンバに持つため、変換ごとの準備処理やヒープ確保はない
+ * float/double専用
+ */
+
+#ifndef MYDSP_FFT_HPP_
+#define MYDSP_FFT_HPP_
+
+#include "Internal/IndexSequence.hpp"
+#include "Internal/LUT.hpp"
+#include "Internal/Kernel.hpp"
+#include "Dispatch.hpp"
+#include <type_traits>
+#include <cstddef>
+
+namespace MyDSP
+{
+  namespace Internal
+  {
+    // i以下で最大の2の冪(i >= 1)
+    constexpr std::size_t FloorPow2(std::size_t i)
+    {
+      return (i < 2) ? 1 : 2 * FloorPow2(i / 2);
+    }
+
+    // 回転因子のテーブルのi番目が、1周期をN分割したテーブルの何番目に当たるか
+    // [0, N)             : [m+p] = exp(-jπp/m) (m: 1,2,4,...,N/2, p < m)。[0]は使わない
+    // [N + k*N/2 + r]    : 段の長さS=2^k(k=0..3)の段用に、m = N/2Sの[m+p]をS個ずつ並べたもの(r = p*S+q)
+    constexpr std::size_t FFTTwiddleIndex(std::size_t i, std::size_t n)
+    {
+      return (i < 1) ? 0
+      :      (i < n) ? (i - FloorPow2(i)) * (n / (2 * FloorPow2(i)))
+      :      ((i - n) % (n / 2)) & ~((std::size_t(1) << ((i - n) / (n / 2))) - 1) ;
+    }
+
+    // FFTの回転因子のテーブル(配置はFFTTwiddleIndexを参照)
+    template <class T, std::size_t N>
+    struct FFTTwiddleImpl
+    {
+      T re[3*N];
+      T im[3*N];
+      template <std::size_t... Seq>
+      constexpr FFTTwiddleImpl(SinCosTableGenerator<long double,N,N/2-1>&& table, IndexSequence<Seq...>) :
+        re{static_cast<T>(table.cos_vals[FFTTwiddleIndex(Seq,N)])...},
+        im{static_cast<T>(table.sin_vals[FFTTwiddleIndex(Seq,N)])...}
+      {}
+      constexpr FFTTwiddleImpl() :
+        FFTTwiddleImpl(SinCosTableGenerator<long double,N,N/2-1>(), MakeIndexSequence<3*N>())
+      {}
+    };
+
+    // 回転因子のテーブルの実体
+    template <class T, std::size_t N>
+    struct FFTTwiddle
+    {
+      static constexpr FFTTwiddleImpl<T,N> instance{};
+    };
+    template <class T, std::size_t N>
+    constexpr FFTTwiddleImpl<T,N> FFTTwiddle<T,N>::instance;
+
+  } /* namespace Internal */
+
+  // 長さNの複素FFT
+  // 順変換: X[k] = Σ x[n] exp(-j2πkn/N)
+  // 逆変換: x[n] = 1/N Σ X[k] exp(+j2πkn/N)
+  template <class T, std::size_t N>
+  class FFT
+  {
+    static_assert(std::is_floating_point<T>::value, "Template parameter 'T' should be a floating point type");
+    static_assert(N >= 4 && (N & (N - 1)) == 0, "Template parameter 'N' should be a power of 2 (4 or more)");
+
+  protected:
+    T work_re[N]; // 作業領域
+    T work_im[N];
+
+  public:
+    static constexpr std::size_t Size = N;
+
+    // コンストラクタ
+    FFT(void) :
+      work_re{},
+      work_im{}
+    {}
+
+    // 順変換(インプレース)
+    void Forward(T* re, T* im)
+    {
+      FFTBlock(Internal::FFTTwiddle<T,N>::instance.re, Internal::FFTTwiddle<T,N>::instance.im,
+        re, im, work_re, work_im, N);
+    }
+
+    // 逆変換(インプレース、1/Nの正規化なし)
+    // 実部と虚部を入れ替えて順変換すると、共役を取った順変換と同じになることを使う
+    void InverseUnscaled(T* re, T* im)
+    {
+      FFTBlock(Internal::FFTTwiddle<T,N>::instance.re, Internal::FFTTwiddle<T,N>::instance.im,
+        im, re, work_im, work_re, N);
+    }
+
+    // 逆変換(インプレース)
+    void Inverse(T* re, T* im)
+    {
+      InverseUnscaled(re, im);
+      constexpr T scale = T(1) / static_cast<T>(N);
+      for (std::size_t i = 0; i < N; ++i)
+      {
+        re[i] *= scale;
+        im[i] *= scale;
+      }
+    }
+
+    // 2つの実数列a,bをre = a, im = bとして順変換した結果から、それぞれのスペクトルの[0 N/2]を取り出す
+    // A[k] = (Z[k] + conj(Z[N-k])) / 2, B[k] = (Z[k] - conj(Z[N-k])) / 2j
+    static void SplitRealPair(const T* re, const T* im, T* a_re, T* a_im, T* b_re, T* b_im)
+    {
+      for (std::size_t k = 0; k <= N / 2; ++k)
+      {
+        const std::size_t r = (N - k) & (N - 1);
+        a_re[k] = T(0.5) * (re[k] + re[r]);
+        a_im[k] = T(0.5) * (im[k] - im[r]);
+        b_re[k] = T(0.5) * (im[k] + im[r]);
+        b_im[k] = T(0.5) * (re[r] - re[k]);
+      }
+    }
+
+    // 2つの実数列のスペクトルA,Bの[0 N/2]から、Z = A + jBの全体を組み立てる
+    // Zを逆変換すると実部にa、虚部にbが得られる(A,Bの直流とN/2の虚部は0とみなす)
+    static void MergeRealPair(const T* a_re, const T* a_im, const T* b_re, const T* b_im, T* re, T* im)
+    {
+      re[0] = a_re[0];
+      im[0] = b_re[0];
+      for (std::size_t k = 1; k < N / 2; ++k)
+      {
+        re[k] = a_re[k] - b_im[k];
+        im[k] = a_im[k] + b_re[k];
+        re[N-k] = a_re[k] + b_im[k];
+        im[N-k] = b_re[k] - a_im[k];
+      }
+      re[N/2] = a_re[N/2];
+      im[N/2] = b_re[N/2];
+    }
+
+  };
+
+  template <class T, std::size_t N>
+  constexpr std::size_t FFT<T,N>::Size;
+
+} /* namespace MyDSP */
+
+
+#endif /* MYDSP_FFT_HPP_ */
@@ -13,6 +13,13 @@
 
 #include "Internal/IndexSequence.hpp"
 #include "Internal/ZeroInitializer.hpp"
+#include "Internal/InstrumentationHook.hpp"
+#include "Internal/Kernel.hpp"
+#include "Internal/StateSerializer.hpp"
+#include "Dispatch.hpp"
+#include "Storage.hpp"
+#include <complex>
+#include <type_traits>
 #include <cstddef>
 
 namespace MyDSP
@@ -27,6 +34,9 @@ namespace MyDSP
     protected:
       T1 state[NumStages+1][2];
       const T2 coeffs[NumStages][5];
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+      Instrumentation::Probe probe{"BiquadDF1"}; // 計測点
+#endif
 
     private:
       // コンストラクタ本体(移譲専用)
@@ -56,71 +66,126 @@ namespace MyDSP
         }
       }
 
+      // 一定値dc_valueを入力し続けたときの定常状態に初期化
+      // z = 1に極を持つ段があれば偽を返す(状態変数は変更しない)
+      bool InitSteadyState(const T1 & dc_value)
+      {
+        T2 gain[NumStages];
+        for (std::size_t stage = 0; stage < NumStages; ++stage)
+        {
+          const T2 (&c)[5] = coeffs[stage];
+          if (!BiquadDCGain(c[0], c[1], c[2], c[3], c[4], gain[stage]))
+          {
+            return false;
+          }
+        }
+        // state[stage]は段stageへの入力(前段の出力)の履歴
+        T1 x = dc_value;
+        for (std::size_t stage = 0; stage <= NumStages; ++stage)
+        {
+          state[stage][0] = x;
+          state[stage][1] = x;
+          if (stage < NumStages)
+          {
+            x = gain[stage] * x;
+          }
+        }
+        return true;
+      }
+
+      // 状態変数の保存に必要なバイト数
+      static constexpr std::size_t StateBytes(void)
+      {
+        return StateSerializer<T1>::Bytes((NumStages + 1) * 2);
+      }
+
+      // 状態変数の保存(StateBytes()バイトを書き込み、その値を返す。sizeが足りなければ何もせず0を返す)
+      std::size_t SaveState(void* buffer, std::size_t size) const
+      {
+        return (size < StateBytes()) ? 0 : StateSerializer<T1>::Save(&state[0][0], (NumStages + 1) * 2, buffer, 0);
+      }
+
+      // 状態変数の復元(同じ型のフィルタのSaveStateで保存したものを読み込み、読み込んだバイト数を返す)
+      // sizeが足りなければ何もせず0を返す
+      std::size_t RestoreState(const void* buffer, std::size_t size)
+      {
+        return (size < StateBytes()) ? 0 : StateSerializer<T1>::Restore(&state[0][0], (NumStages + 1) * 2, buffer, 0);
+      }
+
       // フィルタ係数の取得
       decltype((coeffs)) GetCoeffs(void) const
       {
         return coeffs;
       }
 
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+      // 計測点の取得
+      Instrumentation::Probe& GetProbe(void)
+      {
+        return probe;
+      }
+
+#endif
       // フィルタ処理本体
       T1 operator()(const T1 & in)
       {
-        T1 out;     // 出力
-        T1 Xn = in; // 中間入力
+        MYDSP_INSTRUMENT_SCOPE(probe, 1);
+        return Step(in);
+      }
 
-        for (std::size_t stage = 0; stage < NumStages; ++stage)
+      // ブロック処理
+      // inとoutは同じ領域でもよい
+      void Process(const T1* in, T1* out, std::size_t length)
+      {
+        MYDSP_INSTRUMENT_SCOPE(probe, length);
+        for (std::size_t n = 0; n < length; ++n)
         {
-          // フィルタ係数
-          const T2 &b0 = coeffs[stage][0];
-          const T2 &b1 = coeffs[stage][1];
-          const T2 &b2 = coeffs[stage][2];
-          const T2 &a1 = coeffs[stage][3];
-          const T2 &a2 = coeffs[stage][4];
-
-          // 状態変数
-          T1 &Xn1 = state[stage][0];
-          T1 &Xn2 = state[stage][1];
-          T1 &Yn1 = state[stage+1][0];
-          T1 &Yn2 = state[stage+1][1];
-
-          /* y[n] = b0 * x[n] + b1 * x[n-1] + b2 * x[n-2] + a1 * y[n-1] + a2 * y[n-2] */
-          out = (b0 * Xn) + (b1 * Xn1) + (b2 * Xn2) + (a1 * Yn1) + (a2 * Yn2);
-
-          // 状態の更新
-          Xn2 = Xn1;
-          Xn1 = Xn;
-          Xn  = out;
+          out[n] = Step(in[n]);
         }
-        T1 &Yn1 = state[NumStages][0];
-        T1 &Yn2 = state[NumStages][1];
-        Yn2 = Yn1;
-        Yn1 = out;
+      }
 
-        return out;
+    protected:
+      // 1サンプル分の処理
+      T1 Step(const T1 & in)
+      {
+        return BiquadDF1StepKernel(&coeffs[0][0], &state[0][0], NumStages, in);
       }
     };
 
     // 従属型双二次IIRフィルタ(直接型II転置構成)
     // 型に依存しない共通部分の実装
-    template <class T1, class T2, std::size_t NumStages>
+    // TS: 状態変数の格納型
+    // T2/TSがHalf/BFloat16のときは、処理の間だけfloatの局所配列に変換して保持する
+    template <class T1, class T2, std::size_t NumStages, class TS = T1>
     class BiquadDF2TBase
     {
     protected:
-      T1 state[NumStages][2];
+      static constexpr bool CompactStorage = IsCompactStorage<T2>::value || IsCompactStorage<TS>::value;
+      static_assert(!CompactStorage || (IsStorageOf<T1,T2>::value && IsStorageOf<T1,TS>::value),
+        "Half/BFloat16 storage requires float samples");
+
+      // 係数を与える型(縮小精度で格納する場合は入出力と同じ型で与える)
+      using CoeffValue = typename std::conditional<IsCompactStorage<T2>::value, T1, T2>::type;
+
+      TS state[NumStages][2];
       const T2 coeffs[NumStages][5];
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+      Instrumentation::Probe probe{"BiquadDF2T"}; // 計測点
+#endif
 
     private:
       // コンストラクタ本体(移譲専用)
       // index_sequenceを用いて係数配列を初期化
       template <std::size_t... Seq>
-      BiquadDF2TBase(decltype((coeffs)) coeffs, IndexSequence<Seq...>) :
+      BiquadDF2TBase(const CoeffValue (&coeffs)[NumStages][5], IndexSequence<Seq...>) :
         state{},
-        coeffs{{coeffs[Seq][0],coeffs[Seq][1],coeffs[Seq][2],coeffs[Seq][3],coeffs[Seq][4]}...}
+        coeffs{{static_cast<T2>(coeffs[Seq][0]),static_cast<T2>(coeffs[Seq][1]),static_cast<T2>(coeffs[Seq][2]),
+                static_cast<T2>(coeffs[Seq][3]),static_cast<T2>(coeffs[Seq][4])}...}
       {}
 
     protected:
       // コンストラクタ(フィルタ係数の配列で初期化)
-      explicit BiquadDF2TBase(const T2 (&coeffs)[NumStages][5]) :
+      explicit BiquadDF2TBase(const CoeffValue (&coeffs)[NumStages][5]) :
         BiquadDF2TBase(coeffs, MakeIndexSequence<NumStages>())
       {}
 
@@ -132,79 +197,176 @@ namespace MyDSP
         {
           for (auto &element : block)
           {
-            element = ZeroInitializer<T1>();
+            element = static_cast<TS>(ZeroInitializer<T1>());
           }
         }
       }
 
+      // 一定値dc_valueを入力し続けたときの定常状態に初期化
+      // 各段の直流利得から、段の入力xと出力yに対して d1 = y - b0 x, d2 = b2 x + a2 y とする
+      // z = 1に極を持つ段があれば偽を返す(状態変数は変更しない)
+      bool InitSteadyState(const T1 & dc_value)
+      {
+        CoeffValue gain[NumStages];
+        for (std::size_t stage = 0; stage < NumStages; ++stage)
+        {
+          if (!BiquadDCGain(static_cast<CoeffValue>(coeffs[stage][0]), static_cast<CoeffValue>(coeffs[stage][1]),
+                static_cast<CoeffValue>(coeffs[stage][2]), static_cast<CoeffValue>(coeffs[stage][3]),
+                static_cast<CoeffValue>(coeffs[stage][4]), gain[stage]))
+          {
+            return false;
+          }
+        }
+        T1 x = dc_value;
+        for (std::size_t stage = 0; stage < NumStages; ++stage)
+        {
+          const T1 y = gain[stage] * x;
+          state[stage][0] = static_cast<TS>(y - static_cast<CoeffValue>(coeffs[stage][0]) * x);
+          state[stage][1] = static_cast<TS>(static_cast<CoeffValue>(coeffs[stage][2]) * x
+            + static_cast<CoeffValue>(coeffs[stage][4]) * y);
+          x = y;
+        }
+        return true;
+      }
+
+      // 状態変数の保存に必要なバイト数
+      static constexpr std::size_t StateBytes(void)
+      {
+        return StateSerializer<TS>::Bytes(NumStages * 2);
+      }
+
+      // 状態変数の保存(StateBytes()バイトを書き込み、その値を返す。sizeが足りなければ何もせず0を返す)
+      // 縮小精度の格納形式では格納型のまま保存する
+      std::size_t SaveState(void* buffer, std::size_t size) const
+      {
+        return (size < StateBytes()) ? 0 : StateSerializer<TS>::Save(&state[0][0], NumStages * 2, buffer, 0);
+      }
+
+      // 状態変数の復元(同じ型のフィルタのSaveStateで保存したものを読み込み、読み込んだバイト数を返す)
+      // sizeが足りなければ何もせず0を返す
+      std::size_t RestoreState(const void* buffer, std::size_t size)
+      {
+        return (size < StateBytes()) ? 0 : StateSerializer<TS>::Restore(&state[0][0], NumStages * 2, buffer, 0);
+      }
+
       // フィルタ係数の取得
       decltype((coeffs)) GetCoeffs(void) const
       {
         return coeffs;
       }
 
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+      // 計測点の取得
+      Instrumentation::Probe& GetProbe(void)
+      {
+        return probe;
+      }
+
+#endif
       // フィルタ処理本体
       T1 operator()(const T1 & in)
       {
-        T1 out;                    // 出力
-        T1 Xn = in;                // 中間入力
-        T1 p0, p1, p2, p3, p4, A1; // 中間変数
+        MYDSP_INSTRUMENT_SCOPE(probe, 1);
+        return Step(in, std::integral_constant<bool,CompactStorage>());
+      }
+
+      // ブロック処理
+      // inとoutは同じ領域でもよい
+      void Process(const T1* in, T1* out, std::size_t length)
+      {
+        MYDSP_INSTRUMENT_SCOPE(probe, length);
+        ProcessBlock(in, out, length, std::integral_constant<bool,CompactStorage>());
+      }
 
+    protected:
+      // ブロック処理(係数・状態変数をそのまま使う)
+      void ProcessBlock(const T1* in, T1* out, std::size_t length, std::false_type)
+      {
+        for (std::size_t n = 0; n < length; ++n)
+        {
+          out[n] = Step(in[n], std::false_type());
+        }
+      }
+
+      // ブロック処理(縮小精度の格納形式)
+      // 係数と状態変数をfloatの局所配列に変換して処理し、状態変数を格納形式に戻す
+      // (状態変数の丸めは呼び出しごとに1回なので、ブロックが長いほど誤差は小さい)
+      void ProcessBlock(const T1* in, T1* out, std::size_t length, std::true_type)
+      {
+        T1 c[NumStages][5];
+        T1 d[NumStages][2];
         for (std::size_t stage = 0; stage < NumStages; ++stage)
         {
-          // フィルタ係数
-          const T2 &b0 = coeffs[stage][0];
-          const T2 &b1 = coeffs[stage][1];
-          const T2 &b2 = coeffs[stage][2];
-          const T2 &a1 = coeffs[stage][3];
-          const T2 &a2 = coeffs[stage][4];
+          for (std::size_t i = 0; i < 5; ++i)
+          {
+            c[stage][i] = static_cast<T1>(coeffs[stage][i]);
+          }
+          d[stage][0] = static_cast<T1>(state[stage][0]);
+          d[stage][1] = static_cast<T1>(state[stage][1]);
+        }
+        for (std::size_t n = 0; n < length; ++n)
+        {
+          out[n] = BiquadDF2TStepKernel(&c[0][0], &d[0][0], NumStages, in[n]);
+        }
+        for (std::size_t stage = 0; stage < NumStages; ++stage)
+        {
+          state[stage][0] = static_cast<TS>(d[stage][0]);
+          state[stage][1] = static_cast<TS>(d[stage][1]);
+        }
+      }
 
-          // 状態変数
-          T1 &d1 = state[stage][0];
-          T1 &d2 = state[stage][1];
+      // 1サンプル分の処理
+      T1 Step(const T1 & in, std::false_type)
+      {
+        return BiquadDF2TStepKernel(&coeffs[0][0], &state[0][0], NumStages, in);
+      }
 
-          /*  y[n] = b0 * x[n] + d1[n-1]             */
-          /* d1[n] = b1 * x[n] + a1 * y[n] + d2[n-1] */
-          /* d2[n] = b2 * x[n] + a2 * y[n]           */
-          p0 = b0 * Xn;
-          p1 = b1 * Xn;
-          out = p0 + d1;
-          p3 = a1 * out;
-          p2 = b2 * Xn;
-          A1 = p1 + p3;
-          p4 = a2 * out;
-          d1 = A1 + d2;
-          d2 = p2 + p4;
-
-          Xn = out;
-        }
+      // 1サンプル分の処理(縮小精度の格納形式)
+      T1 Step(const T1 & in, std::true_type)
+      {
+        T1 out;
+        ProcessBlock(&in, &out, 1, std::true_type());
         return out;
       }
     };
 
+    template <class T1, class T2, std::size_t NumStages, class TS>
+    constexpr bool BiquadDF2TBase<T1,T2,NumStages,TS>::CompactStorage;
+
     // FIRフィルタ
     // 型に依存しない共通部分の実装
-    template <class T1, class T2, std::size_t NumTaps>
+    // TS: ディレイラインの格納型
+    // T2/TSがHalf/BFloat16のときは、ブロック処理の間だけfloatの作業領域に変換して積和する
+    template <class T1, class T2, std::size_t NumTaps, class TS = T1>
     class FIRBase
     {
     protected:
-      T1 state[NumTaps*2]; // リングバッファの代わりにタップ長の2倍の長さの領域を使用
+      static_assert(!(IsCompactStorage<T2>::value || IsCompactStorage<TS>::value)
+        || (IsStorageOf<T1,T2>::value && IsStorageOf<T1,TS>::value), "Half/BFloat16 storage requires float samples");
+
+      // 係数を与える型(縮小精度で格納する場合は入出力と同じ型で与える)
+      using CoeffValue = typename std::conditional<IsCompactStorage<T2>::value, T1, T2>::type;
+
+      TS state[NumTaps*2]; // リングバッファの代わりにタップ長の2倍の長さの領域を使用
       T2 coeffs[NumTaps];  // 適応フィルタに使えるよう非constで宣言
       std::size_t state_top = 0; // ディレイラインの先頭を指すインデックス番号
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+      Instrumentation::Probe probe{"FIR"}; // 計測点
+#endif
 
     private:
       // コンストラクタ本体(移譲専用)
       // index_sequenceを用いて係数配列を初期化
       template <std::size_t... Seq>
-      FIRBase(const T2 (&coeffs)[NumTaps], IndexSequence<Seq...>) :
+      FIRBase(const CoeffValue (&coeffs)[NumTaps], IndexSequence<Seq...>) :
         state{},
-        coeffs{coeffs[Seq]...},
+        coeffs{static_cast<T2>(coeffs[Seq])...},
         state_top(0)
       {}
 
     protected:
       // コンストラクタ(フィルタ係数の配列で初期化)
-      explicit FIRBase(const T2 (&coeffs)[NumTaps]) :
+      explicit FIRBase(const CoeffValue (&coeffs)[NumTaps]) :
         FIRBase(coeffs, MakeIndexSequence<NumTaps>())
       {}
 
@@ -214,8 +376,45 @@ namespace MyDSP
       {
         for (auto &element : state)
         {
-            element = ZeroInitializer<T1>();
+            element = static_cast<TS>(ZeroInitializer<T1>());
+        }
+      }
+
+      // 一定値dc_valueを入力し続けたときの定常状態に初期化(ディレイラインをdc_valueで埋める)
+      bool InitSteadyState(const T1 & dc_value)
+      {
+        for (auto &element : state)
+        {
+            element = static_cast<TS>(dc_value);
+        }
+        return true;
+      }
+
+      // 状態変数の保存に必要なバイト数
+      static constexpr std::size_t StateBytes(void)
+      {
+        return StateSerializer<TS>::Bytes(NumTaps);
+      }
+
+      // 状態変数の保存(StateBytes()バイトを書き込み、その値を返す。sizeが足りなければ何もせず0を返す)
+      // ディレイラインは先頭位置によらず古い順にNumTaps個を保存する
+      std::size_t SaveState(void* buffer, std::size_t size) const
+      {
+        return (size < StateBytes()) ? 0 : StateSerializer<TS>::Save(&state[state_top], NumTaps, buffer, 0);
+      }
+
+      // 状態変数の復元(同じ型のフィルタのSaveStateで保存したものを読み込み、読み込んだバイト数を返す)
+      // sizeが足りなければ何もせず0を返す
+      std::size_t RestoreState(const void* buffer, std::size_t size)
+      {
+        if (size < StateBytes())
+        {
+          return 0;
         }
+        StateSerializer<TS>::Restore(&state[0], NumTaps, buffer, 0);
+        StateSerializer<TS>::Restore(&state[NumTaps], NumTaps, buffer, 0);
+        state_top = 0;
+        return StateBytes();
       }
 
       // フィルタ係数の取得
@@ -225,32 +424,194 @@ namespace MyDSP
       }
 
       // フィルタ係数の再設定
-      void SetCoeffs(const T2 (&coeffs_new)[NumTaps])
+      void SetCoeffs(const CoeffValue (&coeffs_new)[NumTaps])
       {
         for (std::size_t tap_cnt = 0; tap_cnt < NumTaps; ++tap_cnt)
         {
-          coeffs[tap_cnt] = coeffs_new[tap_cnt];
+          coeffs[tap_cnt] = static_cast<T2>(coeffs_new[tap_cnt]);
         }
       }
 
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+      // 計測点の取得
+      Instrumentation::Probe& GetProbe(void)
+      {
+        return probe;
+      }
+
+#endif
       // フィルタ処理本体
       T1 operator()(const T1 & in)
       {
-        T1 out = ZeroInitializer<T1>(); // 出力
+        MYDSP_INSTRUMENT_SCOPE(probe, 1);
+        return Step(in);
+      }
 
-        // ディレイラインの更新
-        state[state_top] = in;
-        state[state_top+NumTaps] = in;
-        state_top = (state_top + 1u) % NumTaps;
+      // ブロック処理
+      // float/doubleで入出力と係数の型が同じ場合(floatで係数・ディレイラインがHalf/BFloat16の場合を含む)は、
+      // 実行時に選択した命令セット向けのカーネルを使う
+      // inとoutは同じ領域でもよい
+      void Process(const T1* in, T1* out, std::size_t length)
+      {
+        MYDSP_INSTRUMENT_SCOPE(probe, length);
+        ProcessBlock(in, out, length, HasDispatchedKernel<T1,T2,TS>());
+      }
+
+    protected:
+      // ブロック処理(命令セット別のカーネル)
+      void ProcessBlock(const T1* in, T1* out, std::size_t length, std::true_type)
+      {
+        FIRBlock<T1>(coeffs, state, NumTaps, state_top, in, out, length);
+      }
+
+      // ブロック処理(汎用)
+      void ProcessBlock(const T1* in, T1* out, std::size_t length, std::false_type)
+      {
+        for (std::size_t n = 0; n < length; ++n)
+        {
+          out[n] = Step(in[n]);
+        }
+      }
+
+      // 1サンプル分の処理
+      T1 Step(const T1 & in)
+      {
+        return FIRStepKernel(coeffs, state, NumTaps, state_top, in);
+      }
+    };
+
+    // std::complex用FIRフィルタ
+    // 状態変数を実部・虚部に分けた配置(planar)で保持し、ブロック処理は出力サンプルの方向にベクトル化する
+    // T2がTなら実数係数、std::complex<T>なら複素係数
+    template <class T, class T2, std::size_t NumTaps>
+    class ComplexFIRBase
+    {
+      static_assert(std::is_floating_point<T>::value, "Template parameter 'T' should be a floating point type");
+
+    protected:
+      static constexpr bool ComplexCoeffs = !std::is_same<T,T2>::value;
+
+      T state_re[NumTaps*2]; // 入力の実部のディレイライン(FIRBaseと同じ配置)
+      T state_im[NumTaps*2]; // 入力の虚部のディレイライン
+      T2 coeffs[NumTaps];    // 係数(GetCoeffsが参照を返すために保持する。処理には実部・虚部の配列を使う)
+      T coeffs_re[NumTaps];  // 係数の実部
+      T coeffs_im[NumTaps];  // 係数の虚部(実数係数では0)
+      std::size_t state_top = 0; // ディレイラインの先頭を指すインデックス番号
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+      Instrumentation::Probe probe{"ComplexFIR"}; // 計測点
+#endif
+
+      // コンストラクタ(フィルタ係数の配列で初期化)
+      explicit ComplexFIRBase(const T2 (&coeffs)[NumTaps]) :
+        state_re{},
+        state_im{},
+        coeffs{},
+        coeffs_re{},
+        coeffs_im{},
+        state_top(0)
+      {
+        SetCoeffs(coeffs);
+      }
+
+    public:
+      // 状態変数の初期化
+      void Clear(void)
+      {
+        for (std::size_t i = 0; i < NumTaps*2; ++i)
+        {
+          state_re[i] = T();
+          state_im[i] = T();
+        }
+      }
+
+      // 一定値dc_valueを入力し続けたときの定常状態に初期化(ディレイラインをdc_valueで埋める)
+      bool InitSteadyState(const std::complex<T> & dc_value)
+      {
+        for (std::size_t i = 0; i < NumTaps*2; ++i)
+        {
+          state_re[i] = std::real(dc_value);
+          state_im[i] = std::imag(dc_value);
+        }
+        return true;
+      }
+
+      // 状態変数の保存に必要なバイト数
+      static constexpr std::size_t StateBytes(void)
+      {
+        return StateSerializer<T>::Bytes(NumTaps * 2);
+      }
 
-        // 積和演算の実行
+      // 状態変数の保存(StateBytes()バイトを書き込み、その値を返す。sizeが足りなければ何もせず0を返す)
+      // 実部・虚部のディレイラインを、それぞれ古い順にNumTaps個ずつ保存する
+      std::size_t SaveState(void* buffer, std::size_t size) const
+      {
+        if (size < StateBytes())
+        {
+          return 0;
+        }
+        const std::size_t offset = StateSerializer<T>::Save(&state_re[state_top], NumTaps, buffer, 0);
+        return StateSerializer<T>::Save(&state_im[state_top], NumTaps, buffer, offset);
+      }
+
+      // 状態変数の復元(同じ型のフィルタのSaveStateで保存したものを読み込み、読み込んだバイト数を返す)
+      // sizeが足りなければ何もせず0を返す
+      std::size_t RestoreState(const void* buffer, std::size_t size)
+      {
+        if (size < StateBytes())
+        {
+          return 0;
+        }
+        const std::size_t offset = StateSerializer<T>::Restore(&state_re[0], NumTaps, buffer, 0);
+        StateSerializer<T>::Restore(&state_re[NumTaps], NumTaps, buffer, 0);
+        StateSerializer<T>::Restore(&state_im[0], NumTaps, buffer, offset);
+        StateSerializer<T>::Restore(&state_im[NumTaps], NumTaps, buffer, offset);
+        state_top = 0;
+        return StateBytes();
+      }
+
+      // フィルタ係数の取得
+      auto GetCoeffs(void) const -> const T2 (&)[NumTaps]
+      {
+        return coeffs;
+      }
+
+      // フィルタ係数の再設定
+      void SetCoeffs(const T2 (&coeffs_new)[NumTaps])
+      {
         for (std::size_t tap_cnt = 0; tap_cnt < NumTaps; ++tap_cnt)
         {
-          out += coeffs[tap_cnt] * state[state_top+tap_cnt];
+          coeffs[tap_cnt] = coeffs_new[tap_cnt];
+          coeffs_re[tap_cnt] = std::real(coeffs_new[tap_cnt]);
+          coeffs_im[tap_cnt] = std::imag(coeffs_new[tap_cnt]);
         }
+      }
 
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+      // 計測点の取得
+      Instrumentation::Probe& GetProbe(void)
+      {
+        return probe;
+      }
+
+#endif
+      // フィルタ処理本体
+      std::complex<T> operator()(const std::complex<T> & in)
+      {
+        MYDSP_INSTRUMENT_SCOPE(probe, 1);
+        std::complex<T> out;
+        ComplexFIRStepKernel<T,ComplexCoeffs>(coeffs_re, coeffs_im, state_re, state_im, NumTaps, state_top,
+          reinterpret_cast<const T*>(&in), reinterpret_cast<T*>(&out));
         return out;
       }
+
+      // ブロック処理(実行時に選択した命令セット向けのカーネルを使う)
+      // inとoutは同じ領域でもよい
+      void Process(const std::complex<T>* in, std::complex<T>* out, std::size_t length)
+      {
+        MYDSP_INSTRUMENT_SCOPE(probe, length);
+        ComplexFIRBlock<T>(coeffs_re, ComplexCoeffs ? coeffs_im : nullptr, state_re, state_im, NumTaps, state_top,
+          in, out, length);
+      }
     };
 
   } /* namespace Internal */
@@ -269,29 +630,479 @@ namespace MyDSP
 
   // 従属型双二次IIRフィルタ(直接型II転置構成)
   // スカラ型およびstd::complex用
-  template <class T1, class T2, std::size_t NumStages>
-  class IIRBiquadCascadeDF2T : public Internal::BiquadDF2TBase<T1,T2,NumStages>
+  // T1がfloatのとき、T2(係数)とTS(状態変数の格納型)にHalf/BFloat16を指定できる(係数はfloatの配列で与える)
+  template <class T1, class T2, std::size_t NumStages, class TS = T1>
+  class IIRBiquadCascadeDF2T : public Internal::BiquadDF2TBase<T1,T2,NumStages,TS>
   {
   private:
-    using Base = Internal::BiquadDF2TBase<T1,T2,NumStages>;
+    using Base = Internal::BiquadDF2TBase<T1,T2,NumStages,TS>;
   public:
     // コンストラクタ(フィルタ係数の配列で初期化)
-    explicit IIRBiquadCascadeDF2T(const T2 (&coeffs)[NumStages][5]) : Base(coeffs) {}
+    explicit IIRBiquadCascadeDF2T(const typename Base::CoeffValue (&coeffs)[NumStages][5]) : Base(coeffs) {}
   };
 
   // FIRフィルタ
   // スカラ型およびstd::complex用
-  template <class T1, class T2, std::size_t NumTaps>
-  class FIR : public Internal::FIRBase<T1,T2,NumTaps>
+  // T1がfloatのとき、T2(係数)とTS(ディレイラインの格納型)にHalf/BFloat16を指定できる(係数はfloatの配列で与える)
+  template <class T1, class T2, std::size_t NumTaps, class TS = T1>
+  class FIR : public Internal::FIRBase<T1,T2,NumTaps,TS>
+  {
+  private:
+    using Base = Internal::FIRBase<T1,T2,NumTaps,TS>;
+  public:
+    // コンストラクタ(フィルタ係数の配列で初期化)
+    explicit FIR(const typename Base::CoeffValue (&coeffs)[NumTaps]) : Base(coeffs) {}
+  };
+
+  // 多チャネル従属型双二次IIRフィルタ(直接型II転置構成)
+  // 状態変数と係数をチャネルが最内となる配置(SoA)で保持し、チャネル方向にベクトル化して処理する
+  // チャネルごとに異なる係数を設定できる
+  // float/double専用
+  // TC/TS: 係数・状態変数の格納型(Tがfloatのとき、Half/BFloat16を指定できる)
+  //   ブロック処理では段ごとにfloatのレジスタへ変換して読み込み、漸化式はfloatで計算する
+  template <class T, std::size_t NumStages, std::size_t NumChannels, class TC = T, class TS = T>
+  class IIRBiquadCascadeDF2TBank
+  {
+    static_assert(std::is_floating_point<T>::value, "Template parameter 'T' should be a floating point type");
+    static_assert(Internal::IsStorageOf<T,TC>::value && Internal::IsStorageOf<T,TS>::value,
+      "Half/BFloat16 storage requires float samples");
+
+  protected:
+    TS state[NumStages][2][NumChannels];
+    TC coeffs[NumStages][5][NumChannels];
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+    Instrumentation::Probe probe{"BiquadDF2TBank"}; // 計測点
+#endif
+
+  public:
+    // コンストラクタ(全チャネル共通のフィルタ係数の配列で初期化)
+    explicit IIRBiquadCascadeDF2TBank(const T (&coeffs)[NumStages][5]) :
+      state{},
+      coeffs{}
+    {
+      for (std::size_t ch = 0; ch < NumChannels; ++ch)
+      {
+        SetCoeffs(ch, coeffs);
+      }
+    }
+
+    // 状態変数の初期化
+    void Clear(void)
+    {
+      for (auto &stage : state)
+      {
+        for (auto &block : stage)
+        {
+          for (auto &element : block)
+          {
+            element = static_cast<TS>(T());
+          }
+        }
+      }
+    }
+
+    // 一定値dc_value[ch]を入力し続けたときの定常状態に初期化
+    // z = 1に極を持つ段があるチャネルは状態変数を変更せず、偽を返す
+    bool InitSteadyState(const T (&dc_value)[NumChannels])
+    {
+      bool ok = true;
+      for (std::size_t ch = 0; ch < NumChannels; ++ch)
+      {
+        ok = InitSteadyState(ch, dc_value[ch]) && ok;
+      }
+      return ok;
+    }
+
+    // チャネルごとに、一定値dc_valueを入力し続けたときの定常状態に初期化(チャネルの追加時など)
+    // z = 1に極を持つ段があれば偽を返す(状態変数は変更しない)
+    bool InitSteadyState(std::size_t channel, const T & dc_value)
+    {
+      T gain[NumStages];
+      for (std::size_t stage = 0; stage < NumStages; ++stage)
+      {
+        if (!Internal::BiquadDCGain(static_cast<T>(coeffs[stage][0][channel]), static_cast<T>(coeffs[stage][1][channel]),
+              static_cast<T>(coeffs[stage][2][channel]), static_cast<T>(coeffs[stage][3][channel]),
+              static_cast<T>(coeffs[stage][4][channel]), gain[stage]))
+        {
+          return false;
+        }
+      }
+      T x = dc_value;
+      for (std::size_t stage = 0; stage < NumStages; ++stage)
+      {
+        const T y = gain[stage] * x;
+        state[stage][0][channel] = static_cast<TS>(y - static_cast<T>(coeffs[stage][0][channel]) * x);
+        state[stage][1][channel] = static_cast<TS>(static_cast<T>(coeffs[stage][2][channel]) * x
+          + static_cast<T>(coeffs[stage][4][channel]) * y);
+        x = y;
+      }
+      return true;
+    }
+
+    // 状態変数の保存に必要なバイト数(全チャネル分)
+    static constexpr std::size_t StateBytes(void)
+    {
+      return Internal::StateSerializer<TS>::Bytes(NumStages * 2 * NumChannels);
+    }
+
+    // 全チャネルの状態変数の保存(StateBytes()バイトを書き込み、その値を返す。sizeが足りなければ何もせず0を返す)
+    std::size_t SaveState(void* buffer, std::size_t size) const
+    {
+      return (size < StateBytes()) ? 0
+        : Internal::StateSerializer<TS>::Save(&state[0][0][0], NumStages * 2 * NumChannels, buffer, 0);
+    }
+
+    // 全チャネルの状態変数の復元(同じ型のバンクのSaveStateで保存したものを読み込み、読み込んだバイト数を返す)
+    // sizeが足りなければ何もせず0を返す
+    std::size_t RestoreState(const void* buffer, std::size_t size)
+    {
+      return (size < StateBytes()) ? 0
+        : Internal::StateSerializer<TS>::Restore(&state[0][0][0], NumStages * 2 * NumChannels, buffer, 0);
+    }
+
+    // チャネルごとのフィルタ係数の再設定
+    void SetCoeffs(std::size_t channel, const T (&coeffs_new)[NumStages][5])
+    {
+      for (std::size_t stage = 0; stage < NumStages; ++stage)
+      {
+        for (std::size_t i = 0; i < 5; ++i)
+        {
+          coeffs[stage][i][channel] = static_cast<TC>(coeffs_new[stage][i]);
+        }
+      }
+    }
+
+    // チャネルごとのフィルタ係数の取得
+    void GetCoeffs(std::size_t channel, T (&coeffs_out)[NumStages][5]) const
+    {
+      for (std::size_t stage = 0; stage < NumStages; ++stage)
+      {
+        for (std::size_t i = 0; i < 5; ++i)
+        {
+          coeffs_out[stage][i] = static_cast<T>(coeffs[stage][i][channel]);
+        }
+      }
+    }
+
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+    // 計測点の取得
+    Instrumentation::Probe& GetProbe(void)
+    {
+      return probe;
+    }
+
+#endif
+    // フィルタ処理本体(1フレーム分)
+    void operator()(const T (&in)[NumChannels], T (&out)[NumChannels])
+    {
+      Process(in, out, 1);
+    }
+
+    // ブロック処理
+    // in/out: [frame][channel]の配置(インターリーブ)。inとoutは同じ領域でもよい
+    void Process(const T* in, T* out, std::size_t frames)
+    {
+      MYDSP_INSTRUMENT_SCOPE(probe, frames * NumChannels);
+      BiquadDF2TMultiChannelBlock<T>(&coeffs[0][0][0], &state[0][0][0], NumStages, NumChannels, in, out, frames);
+    }
+  };
+
+  // 従属型双二次IIRフィルタ(直接型II転置構成)の先読み形式
+  // 1チャネルの高レートの信号向けに、BlockSizeサンプル分の出力とブロック後の状態変数を入力と状態変数から直接求める行列を
+  // 段ごとに用意し、1サンプルずつの漸化式の代わりに行列とベクトルの積で処理する(ブロックの間の依存関係は積和2回分になる)
+  // 積和の回数は1サンプルあたり段ごとにBlockSize+4回程度に増えるが、ベクトル命令で並列に処理される
+  // 状態変数と状態遷移行列は、Tがfloatのときdoubleで保持する(極が単位円に近いフィルタでも漸化式と同等以上の精度になる)
+  // float/double専用
+  // BlockSize: 4または8(16以上では行列がベクトルレジスタに収まらず、かえって遅くなる)
+  template <class T, std::size_t NumStages, std::size_t BlockSize = 8>
+  class IIRBiquadCascadeDF2TLookAhead
+  {
+    static_assert(std::is_floating_point<T>::value, "Template parameter 'T' should be a floating point type");
+    static_assert(BlockSize == 4 || BlockSize == 8, "Template parameter 'BlockSize' should be 4 or 8");
+
+  protected:
+    using StateValue = typename Internal::LookAheadStateType<T>::type;
+
+    StateValue state[NumStages][2];
+    StateValue transitions[NumStages][4];          // 状態遷移行列のBlockSize乗(A11,A12,A21,A22)
+    T coeffs[NumStages][5];
+    T matrices[NumStages][BlockSize+4][BlockSize]; // 列ごとに連続(Internal::BiquadDF2TLookAheadKernelを参照)
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+    Instrumentation::Probe probe{"BiquadDF2TLookAhead"}; // 計測点
+#endif
+
+  public:
+    // コンストラクタ(フィルタ係数の配列で初期化)
+    explicit IIRBiquadCascadeDF2TLookAhead(const T (&coeffs)[NumStages][5]) :
+      state{},
+      transitions{},
+      coeffs{},
+      matrices{}
+    {
+      SetCoeffs(coeffs);
+    }
+
+    // 状態変数の初期化
+    void Clear(void)
+    {
+      for (auto &block : state)
+      {
+        for (auto &element : block)
+        {
+          element = StateValue();
+        }
+      }
+    }
+
+    // 一定値dc_valueを入力し続けたときの定常状態に初期化(IIRBiquadCascadeDF2T::InitSteadyStateと同じ)
+    // z = 1に極を持つ段があれば偽を返す(状態変数は変更しない)
+    bool InitSteadyState(const T & dc_value)
+    {
+      StateValue gain[NumStages];
+      for (std::size_t stage = 0; stage < NumStages; ++stage)
+      {
+        const T (&c)[5] = coeffs[stage];
+        if (!Internal::BiquadDCGain<StateValue>(c[0], c[1], c[2], c[3], c[4], gain[stage]))
+        {
+          return false;
+        }
+      }
+      StateValue x = dc_value;
+      for (std::size_t stage = 0; stage < NumStages; ++stage)
+      {
+        const StateValue y = gain[stage] * x;
+        state[stage][0] = y - coeffs[stage][0] * x;
+        state[stage][1] = coeffs[stage][2] * x + coeffs[stage][4] * y;
+        x = y;
+      }
+      return true;
+    }
+
+    // 状態変数の保存に必要なバイト数
+    static constexpr std::size_t StateBytes(void)
+    {
+      return Internal::StateSerializer<StateValue>::Bytes(NumStages * 2);
+    }
+
+    // 状態変数の保存(StateBytes()バイトを書き込み、その値を返す。sizeが足りなければ何もせず0を返す)
+    std::size_t SaveState(void* buffer, std::size_t size) const
+    {
+      return (size < StateBytes()) ? 0
+        : Internal::StateSerializer<StateValue>::Save(&state[0][0], NumStages * 2, buffer, 0);
+    }
+
+    // 状態変数の復元(同じ型のフィルタのSaveStateで保存したものを読み込み、読み込んだバイト数を返す)
+    // sizeが足りなければ何もせず0を返す
+    std::size_t RestoreState(const void* buffer, std::size_t size)
+    {
+      return (size < StateBytes()) ? 0
+        : Internal::StateSerializer<StateValue>::Restore(&state[0][0], NumStages * 2, buffer, 0);
+    }
+
+    // フィルタ係数の再設定(状態変数は保持する)
+    // 行列はlong doubleで計算してから丸める
+    void SetCoeffs(const T (&coeffs_new)[NumStages][5])
+    {
+      for (std::size_t stage = 0; stage < NumStages; ++stage)
+      {
+        long double c[5];
+        for (std::size_t i = 0; i < 5; ++i)
+        {
+          coeffs[stage][i] = coeffs_new[stage][i];
+          c[i] = coeffs_new[stage][i];
+        }
+
+        // インパルス応答(Hの各列はこれを下にずらしたもの)と、その間の状態変数
+        // 時刻jの入力がブロック後の状態変数に与える寄与は、インパルスからBlockSize-jサンプル後の状態変数になる
+        long double h[BlockSize];
+        long double d_impulse[BlockSize+1][2] = {};
+        for (std::size_t k = 0; k < BlockSize; ++k)
+        {
+          d_impulse[k+1][0] = d_impulse[k][0];
+          d_impulse[k+1][1] = d_impulse[k][1];
+          h[k] = Internal::BiquadDF2TStepKernel(c, d_impulse[k+1], 1, (k == 0) ? 1.0L : 0.0L);
+        }
+        for (std::size_t j = 0; j < BlockSize; ++j)
+        {
+          for (std::size_t k = 0; k < BlockSize; ++k)
+          {
+            matrices[stage][j][k] = (k < j) ? T() : static_cast<T>(h[k-j]);
+          }
+          matrices[stage][BlockSize+2][j] = static_cast<T>(d_impulse[BlockSize-j][0]);
+          matrices[stage][BlockSize+3][j] = static_cast<T>(d_impulse[BlockSize-j][1]);
+        }
+
+        // 状態変数d1, d2を1とし、入力を0としたときの応答とブロック後の状態変数
+        for (std::size_t i = 0; i < 2; ++i)
+        {
+          long double d[2] = {(i == 0) ? 1.0L : 0.0L, (i == 1) ? 1.0L : 0.0L};
+          for (std::size_t k = 0; k < BlockSize; ++k)
+          {
+            matrices[stage][BlockSize+i][k] = static_cast<T>(Internal::BiquadDF2TStepKernel(c, d, 1, 0.0L));
+          }
+          transitions[stage][i] = static_cast<StateValue>(d[0]);
+          transitions[stage][i+2] = static_cast<StateValue>(d[1]);
+        }
+      }
+    }
+
+    // フィルタ係数の取得
+    decltype((coeffs)) GetCoeffs(void) const
+    {
+      return coeffs;
+    }
+
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+    // 計測点の取得
+    Instrumentation::Probe& GetProbe(void)
+    {
+      return probe;
+    }
+
+#endif
+    // フィルタ処理本体(1サンプルずつの漸化式)
+    T operator()(const T & in)
+    {
+      MYDSP_INSTRUMENT_SCOPE(probe, 1);
+      T out;
+      BiquadDF2TLookAheadBlock<BlockSize>(&coeffs[0][0], &matrices[0][0][0], &transitions[0][0], &state[0][0],
+        NumStages, &in, &out, 1);
+      return out;
+    }
+
+    // ブロック処理
+    // BlockSizeの倍数の長さで呼び出すと、端数を漸化式で処理せずに済む
+    // inとoutは同じ領域でもよい
+    void Process(const T* in, T* out, std::size_t length)
+    {
+      MYDSP_INSTRUMENT_SCOPE(probe, length);
+      BiquadDF2TLookAheadBlock<BlockSize>(&coeffs[0][0], &matrices[0][0][0], &transitions[0][0], &state[0][0],
+        NumStages, in, out, length);
+    }
+  };
+
+  // 従属型双二次IIRフィルタ(直接型II転置構成)
+  // std::complex<float/double>の入出力、実数係数用
+  // ブロック処理では実部・虚部を2チャネルとみなし、IIRBiquadCascadeDF2TBankと同じカーネルで処理する
+  template <class T, std::size_t NumStages>
+  class IIRBiquadCascadeDF2T<std::complex<T>,T,NumStages> : public Internal::BiquadDF2TBase<std::complex<T>,T,NumStages>
+  {
+    static_assert(std::is_floating_point<T>::value, "Template parameter 'T' should be a floating point type");
+
+  private:
+    using Base = Internal::BiquadDF2TBase<std::complex<T>,T,NumStages>;
+    T coeffs_iq[NumStages][5][2]; // 実部・虚部の2チャネル分に複製した係数
+
+  public:
+    // コンストラクタ(フィルタ係数の配列で初期化)
+    explicit IIRBiquadCascadeDF2T(const T (&coeffs)[NumStages][5]) : Base(coeffs)
+    {
+      for (std::size_t stage = 0; stage < NumStages; ++stage)
+      {
+        for (std::size_t i = 0; i < 5; ++i)
+        {
+          coeffs_iq[stage][i][0] = coeffs[stage][i];
+          coeffs_iq[stage][i][1] = coeffs[stage][i];
+        }
+      }
+    }
+
+    // ブロック処理
+    // 状態変数std::complex<T> state[NumStages][2]は2チャネル分の[stage][2][channel]と同じ配置になる
+    // inとoutは同じ領域でもよい
+    void Process(const std::complex<T>* in, std::complex<T>* out, std::size_t length)
+    {
+      MYDSP_INSTRUMENT_SCOPE(this->probe, length);
+      BiquadDF2TMultiChannelBlock<T>(&coeffs_iq[0][0][0], reinterpret_cast<T*>(&this->state[0][0]), NumStages, 2,
+        reinterpret_cast<const T*>(in), reinterpret_cast<T*>(out), length);
+    }
+  };
+
+  // 従属型双二次IIRフィルタ(直接型II転置構成)
+  // std::complex<float/double>の入出力、複素係数用
+  // 複素数の乗算を実数演算で展開したカーネルで処理する
+  template <class T, std::size_t NumStages>
+  class IIRBiquadCascadeDF2T<std::complex<T>,std::complex<T>,NumStages>
+    : public Internal::BiquadDF2TBase<std::complex<T>,std::complex<T>,NumStages>
   {
+    static_assert(std::is_floating_point<T>::value, "Template parameter 'T' should be a floating point type");
+
   private:
-    using Base = Internal::FIRBase<T1,T2,NumTaps>;
+    using Base = Internal::BiquadDF2TBase<std::complex<T>,std::complex<T>,NumStages>;
+
   public:
     // コンストラクタ(フィルタ係数の配列で初期化)
-    explicit FIR(const T2 (&coeffs)[NumTaps]) : Base(coeffs) {}
+    explicit IIRBiquadCascadeDF2T(const std::complex<T> (&coeffs)[NumStages][5]) : Base(coeffs) {}
+
+    // フィルタ処理本体
+    std::complex<T> operator()(const std::complex<T> & in)
+    {
+      MYDSP_INSTRUMENT_SCOPE(this->probe, 1);
+      std::complex<T> out;
+      Internal::ComplexBiquadDF2TKernel<T>(reinterpret_cast<const T*>(&this->coeffs[0][0]),
+        reinterpret_cast<T*>(&this->state[0][0]), NumStages, reinterpret_cast<const T*>(&in),
+        reinterpret_cast<T*>(&out), 1);
+      return out;
+    }
+
+    // ブロック処理(実行時に選択した命令セット向けのカーネルを使う)
+    // inとoutは同じ領域でもよい
+    void Process(const std::complex<T>* in, std::complex<T>* out, std::size_t length)
+    {
+      MYDSP_INSTRUMENT_SCOPE(this->probe, length);
+      ComplexBiquadDF2TBlock<T>(&this->coeffs[0][0], &this->state[0][0], NumStages, in, out, length);
+    }
+  };
+
+  // FIRフィルタ
+  // std::complex<float/double>の入出力、実数係数用
+  template <class T, std::size_t NumTaps>
+  class FIR<std::complex<T>,T,NumTaps> : public Internal::ComplexFIRBase<T,T,NumTaps>
+  {
+  private:
+    using Base = Internal::ComplexFIRBase<T,T,NumTaps>;
+  public:
+    // コンストラクタ(フィルタ係数の配列で初期化)
+    explicit FIR(const T (&coeffs)[NumTaps]) : Base(coeffs) {}
+  };
+
+  // FIRフィルタ
+  // std::complex<float/double>の入出力、複素係数用
+  template <class T, std::size_t NumTaps>
+  class FIR<std::complex<T>,std::complex<T>,NumTaps> : public Internal::ComplexFIRBase<T,std::complex<T>,NumTaps>
+  {
+  private:
+    using Base = Internal::ComplexFIRBase<T,std::complex<T>,NumTaps>;
+  public:
+    // コンストラクタ(フィルタ係数の配列で初期化)
+    explicit FIR(const std::complex<T> (&coeffs)[NumTaps]) : Base(coeffs) {}
   };
 
 #ifdef EIGEN_WORLD_VERSION
+  namespace Internal
+  {
+    // Eigen::Matrix(固定長のベクトル)を1サンプルとするブロック処理の型
+    // ブロックはチャネル数×サンプル数の行列で、1列が1サンプル
+    template <class Sample>
+    struct EigenBlock
+    {
+      using Scalar = typename Sample::Scalar;
+      static constexpr int Channels = Sample::SizeAtCompileTime;
+      using Type = Eigen::Matrix<Scalar,Channels,Eigen::Dynamic>;
+
+      // ブロック処理に対応したサンプル型かの検査(ブロック処理の関数内で呼ぶ)
+      static constexpr bool Check(void)
+      {
+        static_assert(Sample::IsVectorAtCompileTime && Channels != Eigen::Dynamic,
+          "Block processing requires a fixed-size vector sample type");
+        static_assert(sizeof(Sample) == sizeof(Scalar) * Channels,
+          "Sample type should be tightly packed");
+        return true;
+      }
+    };
+
+  } /* namespace Internal */
+
   // 従属型双二次IIRフィルタ(直接型I)
   // Eigen::Matrix用
   template <class T1, int... MatParams, class T2, std::size_t NumStages>
@@ -300,12 +1111,48 @@ namespace MyDSP
   {
   private:
     using Base = Internal::BiquadDF1Base<Eigen::Matrix<T1,MatParams...>,T2,NumStages>;
+    using Sample = Eigen::Matrix<T1,MatParams...>;
   public:
+    using Block = typename Internal::EigenBlock<Sample>::Type;
+
     // コンストラクタ(フィルタ係数の配列で初期化)
     explicit IIRBiquadCascadeDF1(const T2 (&coeffs)[NumStages][5]) : Base(coeffs)
     {
       this->Clear();
     }
+
+    using Base::Process;
+
+    // ブロック処理(チャネル数×サンプル数の行列)
+    // 既存のバッファをEigen::Mapで渡せばコピーは発生しない。inとoutは同じ領域でもよい
+    void Process(const Eigen::Ref<const Block> &in, Eigen::Ref<Block> out)
+    {
+      Internal::EigenBlock<Sample>::Check();
+      eigen_assert(in.cols() == out.cols());
+      MYDSP_INSTRUMENT_SCOPE(this->probe, static_cast<std::size_t>(in.cols()));
+
+      for (Eigen::Index n = 0; n < in.cols(); ++n)
+      {
+        Sample Xn = in.col(n); // 中間入力
+        Sample Yn;             // 各段の出力
+        for (std::size_t stage = 0; stage < NumStages; ++stage)
+        {
+          const T2 (&c)[5] = this->coeffs[stage];
+          Sample &Xn1 = this->state[stage][0];
+          Sample &Xn2 = this->state[stage][1];
+          const Sample &Yn1 = this->state[stage+1][0];
+          const Sample &Yn2 = this->state[stage+1][1];
+
+          Yn = (c[0] * Xn) + (c[1] * Xn1) + (c[2] * Xn2) + (c[3] * Yn1) + (c[4] * Yn2);
+          Xn2 = Xn1;
+          Xn1 = Xn;
+          Xn = Yn;
+        }
+        this->state[NumStages][1] = this->state[NumStages][0];
+        this->state[NumStages][0] = Xn;
+        out.col(n) = Xn;
+      }
+    }
   };
 
   // 従属型双二次IIRフィルタ(直接型II転置構成)
@@ -316,12 +1163,47 @@ namespace MyDSP
   {
   private:
     using Base = Internal::BiquadDF2TBase<Eigen::Matrix<T1,MatParams...>,T2,NumStages>;
+    using Sample = Eigen::Matrix<T1,MatParams...>;
   public:
+    using Block = typename Internal::EigenBlock<Sample>::Type;
+
     // コンストラクタ(フィルタ係数の配列で初期化)
     explicit IIRBiquadCascadeDF2T(const T2 (&coeffs)[NumStages][5]) : Base(coeffs)
     {
       this->Clear();
     }
+
+    using Base::Process;
+
+    // ブロック処理(チャネル数×サンプル数の行列)
+    // 既存のバッファをEigen::Mapで渡せばコピーは発生しない。inとoutは同じ領域でもよい
+    void Process(const Eigen::Ref<const Block> &in, Eigen::Ref<Block> out)
+    {
+      Internal::EigenBlock<Sample>::Check();
+      eigen_assert(in.cols() == out.cols());
+      MYDSP_INSTRUMENT_SCOPE(this->probe, static_cast<std::size_t>(in.cols()));
+
+      for (Eigen::Index n = 0; n < in.cols(); ++n)
+      {
+        Sample Xn = in.col(n); // 中間入力
+        Sample Yn;             // 各段の出力
+        for (std::size_t stage = 0; stage < NumStages; ++stage)
+        {
+          const T2 (&c)[5] = this->coeffs[stage];
+          Sample &d1 = this->state[stage][0];
+          Sample &d2 = this->state[stage][1];
+
+          /*  y[n] = b0 * x[n] + d1[n-1]             */
+          /* d1[n] = b1 * x[n] + a1 * y[n] + d2[n-1] */
+          /* d2[n] = b2 * x[n] + a2 * y[n]           */
+          Yn = (c[0] * Xn) + d1;
+          d1 = (c[1] * Xn) + (c[3] * Yn) + d2;
+          d2 = (c[2] * Xn) + (c[4] * Yn);
+          Xn = Yn;
+        }
+        out.col(n) = Xn;
+      }
+    }
   };
 
   // FIRフィルタ
@@ -332,12 +1214,59 @@ namespace MyDSP
   {
   private:
     using Base = Internal::FIRBase<Eigen::Matrix<T1,MatParams...>,T2,NumTaps>;
+    using Sample = Eigen::Matrix<T1,MatParams...>;
   public:
+    using Block = typename Internal::EigenBlock<Sample>::Type;
+
     // コンストラクタ(フィルタ係数の配列で初期化)
     explicit FIR(const T2 (&coeffs)[NumTaps]) : Base(coeffs)
     {
       this->Clear();
     }
+
+    using Base::Process;
+
+    // ブロック処理(チャネル数×サンプル数の行列)
+    // 既存のバッファをEigen::Mapで渡せばコピーは発生しない。inとoutは同じ領域でもよい
+    // 係数の型がサンプルのスカラ型と同じ場合は、ディレイラインをチャネル数×タップ数の行列とみなした
+    // 行列・ベクトル積で各サンプルの出力を求める
+    void Process(const Eigen::Ref<const Block> &in, Eigen::Ref<Block> out)
+    {
+      Internal::EigenBlock<Sample>::Check();
+      eigen_assert(in.cols() == out.cols());
+      MYDSP_INSTRUMENT_SCOPE(this->probe, static_cast<std::size_t>(in.cols()));
+      ProcessBlock(in, out, std::is_same<T1,T2>());
+    }
+
+  private:
+    // ブロック処理(行列・ベクトル積)
+    void ProcessBlock(const Eigen::Ref<const Block> &in, Eigen::Ref<Block> &out, std::true_type)
+    {
+      using History = Eigen::Matrix<T1,Internal::EigenBlock<Sample>::Channels,static_cast<int>(NumTaps)>;
+      using Coeffs = Eigen::Matrix<T1,static_cast<int>(NumTaps),1>;
+      const Eigen::Map<const Coeffs> c(this->coeffs);
+
+      std::size_t &top = this->state_top;
+      for (Eigen::Index n = 0; n < in.cols(); ++n)
+      {
+        // ディレイラインの更新
+        this->state[top] = in.col(n);
+        this->state[top+NumTaps] = this->state[top];
+        top = (top + 1u == NumTaps) ? 0 : top + 1u;
+
+        // 積和演算の実行(state[top]から古い順にNumTaps個のサンプルが連続して並ぶ)
+        out.col(n).noalias() = Eigen::Map<const History>(this->state[top].data()) * c;
+      }
+    }
+
+    // ブロック処理(汎用)
+    void ProcessBlock(const Eigen::Ref<const Block> &in, Eigen::Ref<Block> &out, std::false_type)
+    {
+      for (Eigen::Index n = 0; n < in.cols(); ++n)
+      {
+        out.col(n) = this->Step(in.col(n));
+      }
+    }
   };
 
 #endif /* #ifdef EIGEN_WORLD_VERSION */
@@ -0,0 +1,233 @@
+/*
+ * FrequencyResponse.hpp
+ *
+ *  Created on: 2026/10/18
+ *      Author: Shibasaki
+ *
+ * 双二次IIRフィルタ・FIRフィルタの周波数応答の評価
+ * FrequencyResponse       : 任意の角周波数(rad/sample)の配列での応答
+ * FrequencyResponseUniform: 等間隔の格子 omega0 + step * n での応答(角周波数の配列が要らない)
+ * FIRFrequencyResponseFFT : 格子 2πk/N (k = 0..N/2) でのFIRフィルタの応答をFFTで求める(タップ数が多い場合向け)
+ * 応答は周波数点の方向にベクトル化したカーネルで求め、sin,cosはミニマックス多項式で計算する
+ * フィルタのインスタンスを渡した場合は、その係数(縮小精度で格納したものはfloatに戻した値)の応答を求める
+ * float/double専用
+ */
+
+#ifndef MYDSP_FREQUENCYRESPONSE_HPP_
+#define MYDSP_FREQUENCYRESPONSE_HPP_
+
+#include "Filter.hpp"
+#include "FFT.hpp"
+#include "Dispatch.hpp"
+#include "Const.hpp"
+#include <complex>
+#include <type_traits>
+#include <cstddef>
+
+namespace MyDSP
+{
+  namespace Internal
+  {
+    // 格納型の係数をTに変換してから応答を求める
+    template <class T, class TC, std::size_t NumStages>
+    void BiquadResponse(const TC (&coeffs)[NumStages][5], const T* omegas, T omega0, T step,
+      std::complex<T>* out, std::size_t length)
+    {
+      T c[NumStages][5];
+      for (std::size_t stage = 0; stage < NumStages; ++stage)
+      {
+        for (std::size_t i = 0; i < 5; ++i)
+        {
+          c[stage][i] = static_cast<T>(coeffs[stage][i]);
+        }
+      }
+      BiquadResponseBlock<T>(&c[0][0], NumStages, omegas, omega0, step, out, length);
+    }
+
+    template <class T, class TC, std::size_t NumTaps>
+    void FIRResponse(const TC (&coeffs)[NumTaps], const T* omegas, T omega0, T step,
+      std::complex<T>* out, std::size_t length)
+    {
+      T c[NumTaps];
+      for (std::size_t tap = 0; tap < NumTaps; ++tap)
+      {
+        c[tap] = static_cast<T>(coeffs[tap]);
+      }
+      FIRResponseBlock<T>(c, NumTaps, omegas, omega0, step, out, length);
+    }
+
+  } /* namespace Internal */
+
+  // 従属型双二次IIRフィルタの周波数応答
+  // coeffs: IIRBiquadCascadeDF1/DF2Tと同じ形式の係数, omegas: 角周波数(rad/sample)の配列
+  template <class T, std::size_t NumStages>
+  static inline auto FrequencyResponse(const T (&coeffs)[NumStages][5], const T* omegas, std::complex<T>* out,
+    std::size_t length)
+    -> typename std::enable_if<std::is_floating_point<T>::value,void>::type
+  {
+    BiquadResponseBlock<T>(&coeffs[0][0], NumStages, omegas, T(), T(), out, length);
+  }
+
+  // FIRフィルタの周波数応答
+  // coeffs: FIRと同じ形式のタップ係数(coeffs[NumTaps-1]が最新の入力に掛かる)
+  template <class T, std::size_t NumTaps>
+  static inline auto FrequencyResponse(const T (&coeffs)[NumTaps], const T* omegas, std::complex<T>* out,
+    std::size_t length)
+    -> typename std::enable_if<std::is_floating_point<T>::value,void>::type
+  {
+    FIRResponseBlock<T>(coeffs, NumTaps, omegas, T(), T(), out, length);
+  }
+
+  // 従属型双二次IIRフィルタの周波数応答(等間隔の格子 omega0 + step * n)
+  template <class T, std::size_t NumStages>
+  static inline auto FrequencyResponseUniform(const T (&coeffs)[NumStages][5], T omega0, T step,
+    std::complex<T>* out, std::size_t length)
+    -> typename std::enable_if<std::is_floating_point<T>::value,void>::type
+  {
+    BiquadResponseBlock<T>(&coeffs[0][0], NumStages, nullptr, omega0, step, out, length);
+  }
+
+  // FIRフィルタの周波数応答(等間隔の格子 omega0 + step * n)
+  template <class T, std::size_t NumTaps>
+  static inline auto FrequencyResponseUniform(const T (&coeffs)[NumTaps], T omega0, T step,
+    std::complex<T>* out, std::size_t length)
+    -> typename std::enable_if<std::is_floating_point<T>::value,void>::type
+  {
+    FIRResponseBlock<T>(coeffs, NumTaps, nullptr, omega0, step, out, length);
+  }
+
+  // フィルタのインスタンスの周波数応答
+  template <class T, class TC, std::size_t NumStages>
+  static inline auto FrequencyResponse(const IIRBiquadCascadeDF1<T,TC,NumStages> &filter, const T* omegas,
+    std::complex<T>* out, std::size_t length)
+    -> typename std::enable_if<std::is_floating_point<T>::value,void>::type
+  {
+    Internal::BiquadResponse<T>(filter.GetCoeffs(), omegas, T(), T(), out, length);
+  }
+
+  template <class T, class TC, std::size_t NumStages, class TS>
+  static inline auto FrequencyResponse(const IIRBiquadCascadeDF2T<T,TC,NumStages,TS> &filter, const T* omegas,
+    std::complex<T>* out, std::size_t length)
+    -> typename std::enable_if<std::is_floating_point<T>::value,void>::type
+  {
+    Internal::BiquadResponse<T>(filter.GetCoeffs(), omegas, T(), T(), out, length);
+  }
+
+  template <class T, class TC, std::size_t NumTaps, class TS>
+  static inline auto FrequencyResponse(const FIR<T,TC,NumTaps,TS> &filter, const T* omegas,
+    std::complex<T>* out, std::size_t length)
+    -> typename std::enable_if<std::is_floating_point<T>::value,void>::type
+  {
+    Internal::FIRResponse<T>(filter.GetCoeffs(), omegas, T(), T(), out, length);
+  }
+
+  template <class T, class TC, std::size_t NumStages>
+  static inline auto FrequencyResponseUniform(const IIRBiquadCascadeDF1<T,TC,NumStages> &filter, T omega0, T step,
+    std::complex<T>* out, std::size_t length)
+    -> typename std::enable_if<std::is_floating_point<T>::value,void>::type
+  {
+    Internal::BiquadResponse<T>(filter.GetCoeffs(), nullptr, omega0, step, out, length);
+  }
+
+  template <class T, class TC, std::size_t NumStages, class TS>
+  static inline auto FrequencyResponseUniform(const IIRBiquadCascadeDF2T<T,TC,NumStages,TS> &filter, T omega0, T step,
+    std::complex<T>* out, std::size_t length)
+    -> typename std::enable_if<std::is_floating_point<T>::value,void>::type
+  {
+    Internal::BiquadResponse<T>(filter.GetCoeffs(), nullptr, omega0, step, out, length);
+  }
+
+  template <class T, class TC, std::size_t NumTaps, class TS>
+  static inline auto FrequencyResponseUniform(const FIR<T,TC,NumTaps,TS> &filter, T omega0, T step,
+    std::complex<T>* out, std::size_t length)
+    -> typename std::enable_if<std::is_floating_point<T>::value,void>::type
+  {
+    Internal::FIRResponse<T>(filter.GetCoeffs(), nullptr, omega0, step, out, length);
+  }
+
+  // FFTによるFIRフィルタの周波数応答
+  // 格子 ω_k = 2πk/N (k = 0..N/2) のN/2+1点の応答を求める
+  // この格子ではz^-kがkについて周期Nなので、タップ数がNを超える場合はNで折り返して足し込めば厳密に求まる
+  // 1点あたりの計算量がタップ数によらないため、タップ数が多い場合はFrequencyResponseUniformより速い
+  // インパルス応答の偶数番目を実部、奇数番目を虚部とした長さN/2の複素FFTで求める
+  // 作業領域をメンバに持つため、Nが大きい場合はヒープに確保すること
+  template <class T, std::size_t N>
+  class FIRFrequencyResponseFFT
+  {
+    static_assert(std::is_floating_point<T>::value, "Template parameter 'T' should be a floating point type");
+    static_assert(N >= 8 && (N & (N - 1)) == 0, "Template parameter 'N' should be a power of 2 (8 or more)");
+
+  protected:
+    static constexpr std::size_t M = N / 2;
+
+    FFT<T,M> fft;
+    T re[M];
+    T im[M];
+
+  public:
+    static constexpr std::size_t NumPoints = N / 2 + 1;
+
+    // コンストラクタ
+    FIRFrequencyResponseFFT(void) :
+      fft(),
+      re{},
+      im{}
+    {}
+
+    // 格子点kの角周波数
+    static constexpr T Omega(std::size_t k)
+    {
+      return static_cast<T>(2) * Pi<T>() * static_cast<T>(k) / static_cast<T>(N);
+    }
+
+    // FIRフィルタの応答(outにNumPoints点を書き込む)
+    // coeffs: FIRと同じ形式のタップ係数(coeffs[num_taps-1]が最新の入力に掛かる)
+    void operator()(const T* coeffs, std::size_t num_taps, std::complex<T>* out)
+    {
+      // インパルス応答h[n] = coeffs[num_taps-1-n]を長さNで折り返し、z[m] = h[2m] + j h[2m+1]として並べる
+      for (std::size_t i = 0; i < M; ++i)
+      {
+        re[i] = T();
+        im[i] = T();
+      }
+      for (std::size_t n = 0; n < num_taps; ++n)
+      {
+        const std::size_t i = n & (N - 1);
+        T* dst = (i & 1u) ? im : re;
+        dst[i >> 1] += coeffs[num_taps - 1 - n];
+      }
+      fft.Forward(re, im);
+
+      // 偶数番目・奇数番目のスペクトルE,Oを分離し、H[k] = E[k] + exp(-j2πk/N) O[k]とする
+      // exp(-j2πk/N)は長さNのFFTの回転因子のテーブル(最終段の分)を使う
+      const auto &twiddle = Internal::FFTTwiddle<T,N>::instance;
+      for (std::size_t k = 0; k < NumPoints; ++k)
+      {
+        const std::size_t k1 = k & (M - 1);
+        const std::size_t k2 = (M - k) & (M - 1);
+        const T e_re = T(0.5) * (re[k1] + re[k2]);
+        const T e_im = T(0.5) * (im[k1] - im[k2]);
+        const T o_re = T(0.5) * (im[k1] + im[k2]);
+        const T o_im = T(0.5) * (re[k2] - re[k1]);
+        const T w_re = (k < M) ? twiddle.re[M + k] : T(-1);
+        const T w_im = (k < M) ? -twiddle.im[M + k] : T(0);
+        out[k] = std::complex<T>(e_re + w_re * o_re - w_im * o_im, e_im + w_re * o_im + w_im * o_re);
+      }
+    }
+
+    template <std::size_t NumTaps>
+    void operator()(const T (&coeffs)[NumTaps], std::complex<T>* out)
+    {
+      (*this)(coeffs, NumTaps, out);
+    }
+  };
+
+  template <class T, std::size_t N>
+  constexpr std::size_t FIRFrequencyResponseFFT<T,N>::M;
+  template <class T, std::size_t N>
+  constexpr std::size_t FIRFrequencyResponseFFT<T,N>::NumPoints;
+
+} /* namespace MyDSP */
+
+
+#endif /* MYDSP_FREQUENCYRESPONSE_HPP_ */
@@ -0,0 +1,403 @@
+/*
+ * Instrumentation.hpp
+ *
+ *  Created on: 2026/10/18
+ *      Author: Shibasaki
+ *
+ * ホットパス計測
+ * MYDSP_ENABLE_INSTRUMENTATIONを定義してからフィルタ類のヘッダをインクルードすると、
+ * 各インスタンスの呼び出し回数・処理サンプル数・処理時間のヒストグラムが記録される
+ * 未定義の場合は計測フックが空になるため、オーバーヘッドは生じない
+ */
+
+#ifndef MYDSP_INSTRUMENTATION_HPP_
+#define MYDSP_INSTRUMENTATION_HPP_
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <ostream>
+#include <algorithm>
+#include <new>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#if defined(__x86_64__) || defined(__i386__)
+  #if defined(_MSC_VER)
+    #include <intrin.h>
+  #else
+    #include <x86intrin.h>
+  #endif
+#elif defined(__unix__) || defined(__APPLE__)
+  #include <time.h>
+#else
+  #include <chrono>
+#endif
+
+namespace MyDSP
+{
+  namespace Instrumentation
+  {
+    // 時刻の取得
+    // x86ではTSC(サイクル数)、それ以外ではモノトニック時計(ns)を返す
+    static inline std::uint64_t ReadTimestamp(void) noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__)
+      return __rdtsc();
+#elif defined(__unix__) || defined(__APPLE__)
+      timespec ts;
+      clock_gettime(CLOCK_MONOTONIC, &ts);
+      return static_cast<std::uint64_t>(ts.tv_sec) * 1000000000u + static_cast<std::uint64_t>(ts.tv_nsec);
+#else
+      return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    // ReadTimestamp()の単位
+    static inline const char* TimestampUnit(void) noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__)
+      return "cycles";
+#else
+      return "ns";
+#endif
+    }
+
+    // 2の冪で区切られたロックフリーなヒストグラム
+    // bucket[0]は値0、bucket[i]は[2^(i-1), 2^i)の範囲の値を数える
+    // 書き込みは単一スレッドから行うこと(読み出しは任意のスレッドから可能)
+    class LatencyHistogram
+    {
+    public:
+      static constexpr std::size_t num_buckets = 65;
+
+    private:
+      std::atomic<std::uint64_t> buckets[num_buckets];
+
+      // 単一書き込みスレッド用のインクリメント(ロック付き命令を使わない)
+      static void Add(std::atomic<std::uint64_t> &counter, std::uint64_t value) noexcept
+      {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+      }
+
+    public:
+      LatencyHistogram() noexcept
+      {
+        Clear();
+      }
+
+      LatencyHistogram(const LatencyHistogram&) = delete;
+      LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+      // 値に対応するビンの番号
+      static std::size_t BucketIndex(std::uint64_t value) noexcept
+      {
+#if defined(__GNUC__)
+        return (value == 0) ? 0 : static_cast<std::size_t>(64 - __builtin_clzll(value));
+#else
+        std::size_t index = 0;
+        while (value != 0)
+        {
+          value >>= 1;
+          ++index;
+        }
+        return index;
+#endif
+      }
+
+      // ビンの下限値
+      static std::uint64_t BucketLowerBound(std::size_t index) noexcept
+      {
+        return (index == 0) ? 0 : (std::uint64_t(1) << (index - 1));
+      }
+
+      // 値の記録
+      void Record(std::uint64_t value) noexcept
+      {
+        Add(buckets[BucketIndex(value)], 1);
+      }
+
+      // ビンの度数の取得
+      std::uint64_t Count(std::size_t index) const noexcept
+      {
+        return buckets[index].load(std::memory_order_relaxed);
+      }
+
+      // 度数の初期化
+      void Clear(void) noexcept
+      {
+        for (auto &bucket : buckets)
+        {
+          bucket.store(0, std::memory_order_relaxed);
+        }
+      }
+    };
+
+    // 計測結果のスナップショット
+    struct ProbeSnapshot
+    {
+      std::uint64_t id;
+      std::string name;
+      std::uint64_t calls;
+      std::uint64_t samples;
+      std::uint64_t total_ticks;
+      std::uint64_t max_ticks;
+      std::uint64_t histogram[LatencyHistogram::num_buckets];
+
+      // ヒストグラムから求めたパーセンタイル値(ビンの上限値と最大値の小さい方で近似)
+      std::uint64_t Percentile(double p) const noexcept
+      {
+        const double threshold = p * static_cast<double>(calls);
+        std::uint64_t cumulative = 0;
+        for (std::size_t i = 0; i < LatencyHistogram::num_buckets; ++i)
+        {
+          cumulative += histogram[i];
+          if (cumulative > 0 && static_cast<double>(cumulative) >= threshold)
+          {
+            return (i == 0) ? 0 : (i >= 64) ? max_ticks : std::min(max_ticks, (std::uint64_t(1) << i) - 1);
+          }
+        }
+        return max_ticks;
+      }
+    };
+
+    // インスタンスごとの計測データ
+    // 他のインスタンスとキャッシュラインを共有しないよう64バイト境界に配置する
+    // 書き込みはフィルタを実行するスレッドのみが行う
+    // nameの読み書きは登録簿のミューテックスで保護する(登録後の変更はRegistry::Renameで行う)
+    struct alignas(64) ProbeData
+    {
+      std::atomic<std::uint64_t> calls;
+      std::atomic<std::uint64_t> samples;
+      std::atomic<std::uint64_t> total_ticks;
+      std::atomic<std::uint64_t> max_ticks;
+      LatencyHistogram histogram;
+      std::uint64_t id;
+      char name[64];
+
+      ProbeData(std::uint64_t id, const char* name_src) noexcept :
+        calls(0), samples(0), total_ticks(0), max_ticks(0), histogram(), id(id), name{}
+      {
+        SetName(name_src);
+      }
+
+      void SetName(const char* name_src) noexcept
+      {
+        // strncpyは切り詰めの警告(-Wstringop-truncation)が出るため、長さを求めてから複写する
+        const std::size_t n = strnlen(name_src, sizeof(name) - 1);
+        std::memcpy(name, name_src, n);
+        name[n] = '\0';
+      }
+
+      // 1回の呼び出しの記録
+      void Record(std::uint64_t ticks, std::uint64_t num_samples) noexcept
+      {
+        calls.store(calls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        samples.store(samples.load(std::memory_order_relaxed) + num_samples, std::memory_order_relaxed);
+        total_ticks.store(total_ticks.load(std::memory_order_relaxed) + ticks, std::memory_order_relaxed);
+        if (ticks > max_ticks.load(std::memory_order_relaxed))
+        {
+          max_ticks.store(ticks, std::memory_order_relaxed);
+        }
+        histogram.Record(ticks);
+      }
+
+      void Clear(void) noexcept
+      {
+        calls.store(0, std::memory_order_relaxed);
+        samples.store(0, std::memory_order_relaxed);
+        total_ticks.store(0, std::memory_order_relaxed);
+        max_ticks.store(0, std::memory_order_relaxed);
+        histogram.Clear();
+      }
+    };
+
+    // 計測データの登録簿
+    // 登録・削除・スナップショットはミューテックスで保護する(ホットパスでは使用しない)
+    class Registry
+    {
+    private:
+      std::mutex mutex;
+      std::vector<ProbeData*> probes;
+      std::uint64_t next_id = 0;
+
+      Registry() = default;
+
+    public:
+      Registry(const Registry&) = delete;
+      Registry& operator=(const Registry&) = delete;
+
+      // 唯一のインスタンスの取得
+      // 静的記憶域のフィルタが破棄されるより先に破棄されないよう、意図的に解放しない
+      static Registry& Instance(void)
+      {
+        static Registry* const instance = new Registry();
+        return *instance;
+      }
+
+      // 計測データの生成と登録
+      // nameはロックを取ってから読むので、登録済みの計測データの名前を渡してもよい
+      ProbeData* Register(const char* name)
+      {
+        // C++17未満でも64バイト境界に配置されるよう、領域を余分に確保して位置を合わせる
+        void* raw = ::operator new(sizeof(ProbeData) + alignof(ProbeData) + sizeof(void*));
+        std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*);
+        addr = (addr + alignof(ProbeData) - 1) & ~static_cast<std::uintptr_t>(alignof(ProbeData) - 1);
+        reinterpret_cast<void**>(addr)[-1] = raw;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        ProbeData* data = new(reinterpret_cast<void*>(addr)) ProbeData(next_id++, name);
+        probes.push_back(data);
+        return data;
+      }
+
+      // 計測データの登録解除と破棄
+      void Unregister(ProbeData* data)
+      {
+        if (data == nullptr)
+        {
+          return;
+        }
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          probes.erase(std::remove(probes.begin(), probes.end(), data), probes.end());
+        }
+        void* raw = reinterpret_cast<void**>(data)[-1];
+        data->~ProbeData();
+        ::operator delete(raw);
+      }
+
+      // 名前の変更
+      // Snapshotや複製時の登録と競合しないようロックを取って書き換える
+      void Rename(ProbeData* data, const char* name)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        data->SetName(name);
+      }
+
+      // 全インスタンスの計測結果の取得
+      std::vector<ProbeSnapshot> Snapshot(void)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<ProbeSnapshot> result;
+        result.reserve(probes.size());
+        for (const ProbeData* data : probes)
+        {
+          ProbeSnapshot snapshot;
+          snapshot.id = data->id;
+          snapshot.name = data->name;
+          snapshot.calls = data->calls.load(std::memory_order_relaxed);
+          snapshot.samples = data->samples.load(std::memory_order_relaxed);
+          snapshot.total_ticks = data->total_ticks.load(std::memory_order_relaxed);
+          snapshot.max_ticks = data->max_ticks.load(std::memory_order_relaxed);
+          for (std::size_t i = 0; i < LatencyHistogram::num_buckets; ++i)
+          {
+            snapshot.histogram[i] = data->histogram.Count(i);
+          }
+          result.push_back(snapshot);
+        }
+        return result;
+      }
+
+      // 全インスタンスの計測結果の初期化
+      // 計測対象のスレッドが動作中の場合、直後の記録と競合して値が残ることがある
+      void Reset(void)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (ProbeData* data : probes)
+        {
+          data->Clear();
+        }
+      }
+
+      // 計測結果をタブ区切りテキストで出力
+      // 列: id, name, calls, samples, total, mean/call, mean/sample, p50, p99, max
+      void Dump(std::ostream &os)
+      {
+        const std::vector<ProbeSnapshot> snapshots = Snapshot();
+        const char* unit = TimestampUnit();
+        os << "id\tname\tcalls\tsamples\ttotal_" << unit << "\tmean_" << unit << "_per_call\tmean_"
+           << unit << "_per_sample\tp50_" << unit << "\tp99_" << unit << "\tmax_" << unit << "\n";
+        for (const ProbeSnapshot &s : snapshots)
+        {
+          const double per_call   = (s.calls   == 0) ? 0.0 : static_cast<double>(s.total_ticks) / s.calls;
+          const double per_sample = (s.samples == 0) ? 0.0 : static_cast<double>(s.total_ticks) / s.samples;
+          os << s.id << "\t" << s.name << "\t" << s.calls << "\t" << s.samples << "\t" << s.total_ticks << "\t"
+             << per_call << "\t" << per_sample << "\t" << s.Percentile(0.5) << "\t" << s.Percentile(0.99) << "\t"
+             << s.max_ticks << "\n";
+        }
+      }
+    };
+
+    // フィルタ等に埋め込まれる計測点
+    // インスタンスの生成時に登録簿へ登録し、破棄時に登録を解除する
+    class Probe
+    {
+    private:
+      ProbeData* data;
+
+    public:
+      explicit Probe(const char* name) : data(Registry::Instance().Register(name)) {}
+
+      // コピー先は別のインスタンスとして新たに登録する
+      Probe(const Probe& other) : data(Registry::Instance().Register(other.data->name)) {}
+
+      // 計測結果は各インスタンスに固有なので、代入では何もしない
+      Probe& operator=(const Probe&)
+      {
+        return *this;
+      }
+
+      ~Probe()
+      {
+        Registry::Instance().Unregister(data);
+      }
+
+      // 名前の設定(Dump出力でインスタンスを識別するため)
+      void SetName(const char* name)
+      {
+        Registry::Instance().Rename(data, name);
+      }
+
+      ProbeData& Data(void) noexcept
+      {
+        return *data;
+      }
+
+      const ProbeData& Data(void) const noexcept
+      {
+        return *data;
+      }
+    };
+
+    // スコープ内の処理時間を計測して記録する
+    class ScopedTimer
+    {
+    private:
+      ProbeData &data;
+      const std::uint64_t num_samples;
+      const std::uint64_t start;
+
+    public:
+      ScopedTimer(Probe &probe, std::uint64_t num_samples) noexcept :
+        data(probe.Data()),
+        num_samples(num_samples),
+        start(ReadTimestamp())
+      {}
+
+      ScopedTimer(const ScopedTimer&) = delete;
+      ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+      ~ScopedTimer()
+      {
+        data.Record(ReadTimestamp() - start, num_samples);
+      }
+    };
+
+  } /* namespace Instrumentation */
+} /* namespace MyDSP */
+
+
+#endif /* MYDSP_INSTRUMENTATION_HPP_ */
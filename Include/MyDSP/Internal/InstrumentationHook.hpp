@@ -0,0 +1,25 @@
+/*
+ * InstrumentationHook.hpp
+ *
+ *  Created on: 2026/10/18
+ *      Author: Shibasaki
+ *
+ * 計測フックの切り替え
+ * MYDSP_ENABLE_INSTRUMENTATIONが未定義の場合は何も展開しない
+ */
+
+#ifndef MYDSP_INTERNAL_INSTRUMENTATIONHOOK_HPP_
+#define MYDSP_INTERNAL_INSTRUMENTATIONHOOK_HPP_
+
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+  #include "../Instrumentation.hpp"
+
+  // スコープ終了までの処理時間をprobeに記録する
+  #define MYDSP_INSTRUMENT_SCOPE(probe, num_samples) \
+    const ::MyDSP::Instrumentation::ScopedTimer mydsp_instrument_scope_timer_((probe), (num_samples))
+#else
+  #define MYDSP_INSTRUMENT_SCOPE(probe, num_samples) ((void)0)
+#endif /* MYDSP_ENABLE_INSTRUMENTATION */
+
+
+#endif /* MYDSP_INTERNAL_INSTRUMENTATIONHOOK_HPP_ */
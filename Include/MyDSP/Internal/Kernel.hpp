@@ -0,0 +1,2437 @@
+/*
+ * Kernel.hpp
+ *
+ *  Created on: 2026/10/18
+ *      Author: Shibasaki
+ *
+ * 処理カーネル
+ * ポインタと長さだけを受け取る実装で、コンパイル時にサイズが決まるフィルタと実行時にサイズが決まるフィルタとで共有する
+ * Dispatch.hpp で命令セットごとにコンパイルされるため、常にインライン展開させる
+ */
+
+#ifndef MYDSP_INTERNAL_KERNEL_HPP_
+#define MYDSP_INTERNAL_KERNEL_HPP_
+
+#include "../Math.hpp"
+#include "../Storage.hpp"
+#include "ZeroInitializer.hpp"
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <limits>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__GNUC__)
+  #define MYDSP_ALWAYS_INLINE inline __attribute__((always_inline))
+  #define MYDSP_RESTRICT __restrict__
+#elif defined(_MSC_VER)
+  #define MYDSP_ALWAYS_INLINE __forceinline
+  #define MYDSP_RESTRICT __restrict
+#else
+  #define MYDSP_ALWAYS_INLINE inline
+  #define MYDSP_RESTRICT
+#endif
+
+namespace MyDSP
+{
+  namespace Internal
+  {
+    // 従属型双二次IIRフィルタ(直接型I)の1サンプル分の処理
+    // coeffs: [stage][5] (b0,b1,b2,a1,a2)
+    // state : [stage+1][2] (段の入力の過去値。最後の段は出力の過去値)
+    template <class T1, class T2>
+    MYDSP_ALWAYS_INLINE T1 BiquadDF1StepKernel(const T2* coeffs, T1* state, std::size_t num_stages, const T1 &in)
+    {
+      T1 out = in; // 出力
+      T1 Xn = in;  // 中間入力
+
+      for (std::size_t stage = 0; stage < num_stages; ++stage)
+      {
+        // フィルタ係数
+        const T2 &b0 = coeffs[stage*5+0];
+        const T2 &b1 = coeffs[stage*5+1];
+        const T2 &b2 = coeffs[stage*5+2];
+        const T2 &a1 = coeffs[stage*5+3];
+        const T2 &a2 = coeffs[stage*5+4];
+
+        // 状態変数
+        T1 &Xn1 = state[stage*2+0];
+        T1 &Xn2 = state[stage*2+1];
+        T1 &Yn1 = state[stage*2+2];
+        T1 &Yn2 = state[stage*2+3];
+
+        /* y[n] = b0 * x[n] + b1 * x[n-1] + b2 * x[n-2] + a1 * y[n-1] + a2 * y[n-2] */
+        out = (b0 * Xn) + (b1 * Xn1) + (b2 * Xn2) + (a1 * Yn1) + (a2 * Yn2);
+
+        // 状態の更新
+        Xn2 = Xn1;
+        Xn1 = Xn;
+        Xn  = out;
+      }
+      T1 &Yn1 = state[num_stages*2+0];
+      T1 &Yn2 = state[num_stages*2+1];
+      Yn2 = Yn1;
+      Yn1 = out;
+
+      return out;
+    }
+
+    // 従属型双二次IIRフィルタ(直接型II転置構成)の1サンプル分の処理
+    // coeffs: [stage][5] (b0,b1,b2,a1,a2)
+    // state : [stage][2]
+    template <class T1, class T2>
+    MYDSP_ALWAYS_INLINE T1 BiquadDF2TStepKernel(const T2* coeffs, T1* state, std::size_t num_stages, const T1 &in)
+    {
+      T1 out = in;               // 出力
+      T1 Xn = in;                // 中間入力
+      T1 p0, p1, p2, p3, p4, A1; // 中間変数
+
+      for (std::size_t stage = 0; stage < num_stages; ++stage)
+      {
+        // フィルタ係数
+        const T2 &b0 = coeffs[stage*5+0];
+        const T2 &b1 = coeffs[stage*5+1];
+        const T2 &b2 = coeffs[stage*5+2];
+        const T2 &a1 = coeffs[stage*5+3];
+        const T2 &a2 = coeffs[stage*5+4];
+
+        // 状態変数
+        T1 &d1 = state[stage*2+0];
+        T1 &d2 = state[stage*2+1];
+
+        /*  y[n] = b0 * x[n] + d1[n-1]             */
+        /* d1[n] = b1 * x[n] + a1 * y[n] + d2[n-1] */
+        /* d2[n] = b2 * x[n] + a2 * y[n]           */
+        p0 = b0 * Xn;
+        p1 = b1 * Xn;
+        out = p0 + d1;
+        p3 = a1 * out;
+        p2 = b2 * Xn;
+        A1 = p1 + p3;
+        p4 = a2 * out;
+        d1 = A1 + d2;
+        d2 = p2 + p4;
+
+        Xn = out;
+      }
+      return out;
+    }
+
+    // FIRフィルタの1サンプル分の処理
+    // state: タップ長の2倍の長さのディレイライン(TSはT1そのもの、または縮小精度の格納型)
+    // state_top: ディレイラインの先頭を指すインデックス番号(処理後の値に更新される)
+    template <class T1, class T2, class TS>
+    MYDSP_ALWAYS_INLINE T1 FIRStepKernel(const T2* coeffs, TS* state, std::size_t num_taps, std::size_t &state_top, const T1 &in)
+    {
+      T1 out = ZeroInitializer<T1>(); // 出力
+
+      // ディレイラインの更新
+      state[state_top] = in;
+      state[state_top+num_taps] = in;
+      state_top = (state_top + 1u == num_taps) ? 0 : state_top + 1u;
+
+      // 積和演算の実行
+      for (std::size_t tap_cnt = 0; tap_cnt < num_taps; ++tap_cnt)
+      {
+        out += coeffs[tap_cnt] * state[state_top+tap_cnt];
+      }
+
+      return out;
+    }
+
+    // 部分和の2分木状の足し合わせ
+    // 段ごとの幅をコンパイル時定数にして、各段をベクトル命令1つに展開させる
+    template <class T, std::size_t Width>
+    struct LaneReducer
+    {
+      MYDSP_ALWAYS_INLINE static T Apply(T* acc)
+      {
+        for (std::size_t lane = 0; lane < Width; ++lane)
+        {
+          acc[lane] += acc[lane+Width];
+        }
+        return LaneReducer<T,Width/2>::Apply(acc);
+      }
+    };
+
+    template <class T>
+    struct LaneReducer<T,0>
+    {
+      MYDSP_ALWAYS_INLINE static T Apply(T* acc)
+      {
+        return acc[0];
+      }
+    };
+
+    // 端数の積算
+    // Lanesに満たない残りを幅を半分ずつにしながら部分和へ加える(各段はベクトル命令1つに展開される)
+    template <class T, std::size_t Width>
+    struct LaneTail
+    {
+      MYDSP_ALWAYS_INLINE static void Apply(T* acc, const T* a, const T* b, std::size_t &i, std::size_t length)
+      {
+        if (i + Width <= length)
+        {
+          for (std::size_t lane = 0; lane < Width; ++lane)
+          {
+            acc[lane] += a[i+lane] * b[i+lane];
+          }
+          i += Width;
+        }
+        LaneTail<T,Width/2>::Apply(acc, a, b, i, length);
+      }
+    };
+
+    template <class T>
+    struct LaneTail<T,0>
+    {
+      MYDSP_ALWAYS_INLINE static void Apply(T*, const T*, const T*, std::size_t&, std::size_t) {}
+    };
+
+    // 内積
+    // 浮動小数点の加算順序を固定したままベクトル化できるよう、Lanes個の部分和に分けて積算し、
+    // 最後に部分和を2分木状に足し合わせる(Lanesが異なると丸め誤差の出方も変わる)
+    // 端数はLanes/2, Lanes/4, ..., 1要素ずつ部分和の先頭に加える
+    // Lanes: 2の冪
+    template <class T, std::size_t Lanes>
+    MYDSP_ALWAYS_INLINE T DotKernel(const T* MYDSP_RESTRICT a, const T* MYDSP_RESTRICT b, std::size_t length)
+    {
+      static_assert(Lanes >= 2 && (Lanes & (Lanes - 1)) == 0, "Template parameter 'Lanes' should be a power of 2");
+      T acc[Lanes] = {};
+      std::size_t i = 0;
+      for (; i + Lanes <= length; i += Lanes)
+      {
+        for (std::size_t lane = 0; lane < Lanes; ++lane)
+        {
+          acc[lane] += a[i+lane] * b[i+lane];
+        }
+      }
+      LaneTail<T,Lanes/2>::Apply(acc, a, b, i, length);
+      return LaneReducer<T,Lanes/2>::Apply(acc);
+    }
+
+    // 短いFIRフィルタのブロック処理で扱う最大のタップ数と、1回に処理するサンプル数
+    constexpr std::size_t fir_short_max_taps = 512;
+    constexpr std::size_t fir_chunk_length = 512;
+
+    // 短いFIRフィルタのブロック処理
+    // 直近のタップ数-1個のサンプルと入力を連続した作業領域に並べ、出力サンプルの方向にベクトル化する
+    // (タップごとに全出力へ積和するため、加算順序はFIRStepKernelと同じ)
+    // 作業領域に読み込んでから出力するので、inとoutは同じ領域でもよい
+    // 処理後のディレイラインはstate_top = 0の配置に並べ直す
+    template <class T>
+    MYDSP_ALWAYS_INLINE void FIRBlockShortKernel(
+      const T* coeffs,
+      T* state,
+      std::size_t num_taps,
+      std::size_t &state_top,
+      const T* in,
+      T* out,
+      std::size_t length)
+    {
+      T buffer[fir_short_max_taps - 1 + fir_chunk_length]; // [過去のサンプル | 入力]
+      T acc[fir_chunk_length];
+      const std::size_t history = num_taps - 1;
+
+      // ディレイラインから直近のサンプルを古い順に取り出す(最も古い1個は次の出力に使われない)
+      for (std::size_t i = 0; i < history; ++i)
+      {
+        buffer[i] = state[state_top+1u+i];
+      }
+
+      for (std::size_t n0 = 0; n0 < length; n0 += fir_chunk_length)
+      {
+        const std::size_t m = (length - n0 < fir_chunk_length) ? length - n0 : fir_chunk_length;
+        for (std::size_t j = 0; j < m; ++j)
+        {
+          buffer[history+j] = in[n0+j];
+          acc[j] = T();
+        }
+
+        // 積和演算の実行
+        for (std::size_t k = 0; k < num_taps; ++k)
+        {
+          const T c = coeffs[k];
+          const T* MYDSP_RESTRICT x = buffer + k;
+          for (std::size_t j = 0; j < m; ++j)
+          {
+            acc[j] += c * x[j];
+          }
+        }
+
+        for (std::size_t j = 0; j < m; ++j)
+        {
+          out[n0+j] = acc[j];
+        }
+        for (std::size_t i = 0; i < history; ++i)
+        {
+          buffer[i] = buffer[m+i];
+        }
+      }
+
+      // ディレイラインの更新
+      for (std::size_t i = 0; i < history; ++i)
+      {
+        state[1u+i] = buffer[i];
+        state[1u+i+num_taps] = buffer[i];
+      }
+      state_top = 0;
+    }
+
+    // FIRフィルタのブロック処理
+    // state: タップ長の2倍の長さのディレイライン(FIRBaseと同じ配置)
+    // state_top: ディレイラインの先頭を指すインデックス番号(処理後の値に更新される)
+    // 短いフィルタはFIRBlockShortKernelで、長いフィルタは出力サンプルごとの内積で処理する
+    template <class T, std::size_t Lanes>
+    MYDSP_ALWAYS_INLINE void FIRBlockKernel(
+      const T* coeffs,
+      T* state,
+      std::size_t num_taps,
+      std::size_t &state_top,
+      const T* in,
+      T* out,
+      std::size_t length)
+    {
+      if (num_taps <= fir_short_max_taps)
+      {
+        FIRBlockShortKernel(coeffs, state, num_taps, state_top, in, out, length);
+        return;
+      }
+
+      std::size_t top = state_top;
+      for (std::size_t n = 0; n < length; ++n)
+      {
+        // ディレイラインの更新
+        const T x = in[n];
+        state[top] = x;
+        state[top+num_taps] = x;
+        top = (top + 1u == num_taps) ? 0 : top + 1u;
+
+        // 積和演算の実行
+        // 最新のサンプルはレジスタの値を使い、直前に書き込んだ領域をベクトルロードしないようにする
+        // (ストアフォワーディングの失敗による停止を避ける)
+        out[n] = DotKernel<T,Lanes>(coeffs, state + top, num_taps - 1u) + coeffs[num_taps-1u] * x;
+      }
+      state_top = top;
+    }
+
+    // 係数またはディレイラインを縮小精度で格納したFIRフィルタのブロック処理
+    // TC/TS: 係数・ディレイラインの格納型(TそのものかHalf/BFloat16)
+    // 係数とディレイラインをTの作業領域に変換してから上のカーネルで処理し、ディレイラインを格納型に戻す
+    // (変換はブロックごとに1回で、積和はTで行う)
+    // 作業領域に収まらない長いフィルタは1サンプルずつ変換しながら処理する
+    template <class T, std::size_t Lanes, class TC, class TS>
+    MYDSP_ALWAYS_INLINE void FIRBlockKernel(
+      const TC* coeffs,
+      TS* state,
+      std::size_t num_taps,
+      std::size_t &state_top,
+      const T* in,
+      T* out,
+      std::size_t length)
+    {
+      if (num_taps > fir_short_max_taps)
+      {
+        for (std::size_t n = 0; n < length; ++n)
+        {
+          out[n] = FIRStepKernel(coeffs, state, num_taps, state_top, in[n]);
+        }
+        return;
+      }
+
+      T c[fir_short_max_taps];
+      T s[fir_short_max_taps*2];
+      for (std::size_t i = 0; i < num_taps; ++i)
+      {
+        c[i] = static_cast<T>(coeffs[i]);
+      }
+      for (std::size_t i = 0; i < num_taps*2; ++i)
+      {
+        s[i] = static_cast<T>(state[i]);
+      }
+
+      FIRBlockShortKernel(c, s, num_taps, state_top, in, out, length);
+
+      for (std::size_t i = 0; i < num_taps*2; ++i)
+      {
+        state[i] = static_cast<TS>(s[i]);
+      }
+    }
+
+    // 複素FIRフィルタの1サンプル分の処理(実部・虚部を分けたディレイライン)
+    // ComplexCoeffs: trueなら係数はcoeffs_re + j*coeffs_im、falseなら実数のcoeffs_re(coeffs_imは使わない)
+    // state_re/state_im: 実部・虚部それぞれのタップ長の2倍の長さのディレイライン(FIRStepKernelと同じ配置)
+    // in/out: 実部・虚部の順に並んだ1サンプル分(std::complexと同じ配置)
+    template <class T, bool ComplexCoeffs>
+    MYDSP_ALWAYS_INLINE void ComplexFIRStepKernel(const T* coeffs_re, const T* coeffs_im, T* state_re, T* state_im,
+      std::size_t num_taps, std::size_t &state_top, const T* in, T* out)
+    {
+      // ディレイラインの更新
+      state_re[state_top] = in[0];
+      state_re[state_top+num_taps] = in[0];
+      state_im[state_top] = in[1];
+      state_im[state_top+num_taps] = in[1];
+      state_top = (state_top + 1u == num_taps) ? 0 : state_top + 1u;
+
+      // 積和演算の実行
+      T out_re = T();
+      T out_im = T();
+      for (std::size_t tap_cnt = 0; tap_cnt < num_taps; ++tap_cnt)
+      {
+        const T xr = state_re[state_top+tap_cnt];
+        const T xi = state_im[state_top+tap_cnt];
+        out_re += coeffs_re[tap_cnt] * xr;
+        out_im += coeffs_re[tap_cnt] * xi;
+        if (ComplexCoeffs)
+        {
+          out_re -= coeffs_im[tap_cnt] * xi;
+          out_im += coeffs_im[tap_cnt] * xr;
+        }
+      }
+      out[0] = out_re;
+      out[1] = out_im;
+    }
+
+    // 短い複素FIRフィルタのブロック処理
+    // FIRBlockShortKernelと同様に、作業領域に実部・虚部を分けて並べ、出力サンプルの方向にベクトル化する
+    // 作業領域に読み込んでから出力するので、inとoutは同じ領域でもよい
+    template <class T, bool ComplexCoeffs>
+    MYDSP_ALWAYS_INLINE void ComplexFIRBlockShortKernel(const T* coeffs_re, const T* coeffs_im, T* state_re, T* state_im,
+      std::size_t num_taps, std::size_t &state_top, const T* in, T* out, std::size_t length)
+    {
+      constexpr std::size_t chunk_length = fir_chunk_length / 2; // 実部・虚部で2倍の作業領域を使うため半分にする
+      T buffer_re[fir_short_max_taps - 1 + chunk_length]; // [過去のサンプル | 入力]
+      T buffer_im[fir_short_max_taps - 1 + chunk_length];
+      T acc_re[chunk_length];
+      T acc_im[chunk_length];
+      const std::size_t history = num_taps - 1;
+
+      // ディレイラインから直近のサンプルを古い順に取り出す
+      for (std::size_t i = 0; i < history; ++i)
+      {
+        buffer_re[i] = state_re[state_top+1u+i];
+        buffer_im[i] = state_im[state_top+1u+i];
+      }
+
+      for (std::size_t n0 = 0; n0 < length; n0 += chunk_length)
+      {
+        const std::size_t m = (length - n0 < chunk_length) ? length - n0 : chunk_length;
+        for (std::size_t j = 0; j < m; ++j)
+        {
+          buffer_re[history+j] = in[(n0+j)*2+0];
+          buffer_im[history+j] = in[(n0+j)*2+1];
+          acc_re[j] = T();
+          acc_im[j] = T();
+        }
+
+        // 積和演算の実行
+        for (std::size_t k = 0; k < num_taps; ++k)
+        {
+          const T cr = coeffs_re[k];
+          const T* MYDSP_RESTRICT xr = buffer_re + k;
+          const T* MYDSP_RESTRICT xi = buffer_im + k;
+          if (ComplexCoeffs)
+          {
+            const T ci = coeffs_im[k];
+            for (std::size_t j = 0; j < m; ++j)
+            {
+              acc_re[j] += cr * xr[j] - ci * xi[j];
+              acc_im[j] += cr * xi[j] + ci * xr[j];
+            }
+          }
+          else
+          {
+            for (std::size_t j = 0; j < m; ++j)
+            {
+              acc_re[j] += cr * xr[j];
+              acc_im[j] += cr * xi[j];
+            }
+          }
+        }
+
+        for (std::size_t j = 0; j < m; ++j)
+        {
+          out[(n0+j)*2+0] = acc_re[j];
+          out[(n0+j)*2+1] = acc_im[j];
+        }
+        for (std::size_t i = 0; i < history; ++i)
+        {
+          buffer_re[i] = buffer_re[m+i];
+          buffer_im[i] = buffer_im[m+i];
+        }
+      }
+
+      // ディレイラインの更新
+      for (std::size_t i = 0; i < history; ++i)
+      {
+        state_re[1u+i] = buffer_re[i];
+        state_re[1u+i+num_taps] = buffer_re[i];
+        state_im[1u+i] = buffer_im[i];
+        state_im[1u+i+num_taps] = buffer_im[i];
+      }
+      state_top = 0;
+    }
+
+    // 複素FIRフィルタのブロック処理
+    // 引数はComplexFIRStepKernelと同じ。in/outはlength個の複素数(実部・虚部の順)
+    // 短いフィルタはComplexFIRBlockShortKernelで、長いフィルタは出力サンプルごとの内積で処理する
+    template <class T, std::size_t Lanes, bool ComplexCoeffs>
+    MYDSP_ALWAYS_INLINE void ComplexFIRBlockKernel(const T* coeffs_re, const T* coeffs_im, T* state_re, T* state_im,
+      std::size_t num_taps, std::size_t &state_top, const T* in, T* out, std::size_t length)
+    {
+      if (num_taps <= fir_short_max_taps)
+      {
+        ComplexFIRBlockShortKernel<T,ComplexCoeffs>(coeffs_re, coeffs_im, state_re, state_im, num_taps, state_top,
+          in, out, length);
+        return;
+      }
+
+      const std::size_t last = num_taps - 1u;
+      std::size_t top = state_top;
+      for (std::size_t n = 0; n < length; ++n)
+      {
+        // ディレイラインの更新
+        const T xr = in[n*2+0];
+        const T xi = in[n*2+1];
+        state_re[top] = xr;
+        state_re[top+num_taps] = xr;
+        state_im[top] = xi;
+        state_im[top+num_taps] = xi;
+        top = (top + 1u == num_taps) ? 0 : top + 1u;
+
+        // 積和演算の実行(最新のサンプルはレジスタの値を使う)
+        T yr = DotKernel<T,Lanes>(coeffs_re, state_re + top, last) + coeffs_re[last] * xr;
+        T yi = DotKernel<T,Lanes>(coeffs_re, state_im + top, last) + coeffs_re[last] * xi;
+        if (ComplexCoeffs)
+        {
+          yr -= DotKernel<T,Lanes>(coeffs_im, state_im + top, last) + coeffs_im[last] * xi;
+          yi += DotKernel<T,Lanes>(coeffs_im, state_re + top, last) + coeffs_im[last] * xr;
+        }
+        out[n*2+0] = yr;
+        out[n*2+1] = yi;
+      }
+      state_top = top;
+    }
+
+    // Width要素の複写
+    // ループで書くとmemcpyに置き換えられ、局所配列がレジスタに載らなくなるため再帰で展開する
+    template <class T, std::size_t Width>
+    struct LaneCopy
+    {
+      MYDSP_ALWAYS_INLINE static void Apply(T* dst, const T* src)
+      {
+        LaneCopy<T,Width/2>::Apply(dst, src);
+        LaneCopy<T,Width-Width/2>::Apply(dst + Width/2, src + Width/2);
+      }
+    };
+
+    template <class T>
+    struct LaneCopy<T,1>
+    {
+      MYDSP_ALWAYS_INLINE static void Apply(T* dst, const T* src)
+      {
+        dst[0] = src[0];
+      }
+    };
+
+    // 型を変換しながらのWidth要素の複写(縮小精度の格納型との間の読み書き用)
+    // 同じ型ならLaneCopyで展開し、異なる型なら回数が定数のループにしてベクトル化させる
+    // (ビット演算による変換は再帰で展開するとベクトル化されない)
+    template <std::size_t Width>
+    struct LaneConvert
+    {
+      template <class T>
+      MYDSP_ALWAYS_INLINE static void Apply(T* dst, const T* src)
+      {
+        LaneCopy<T,Width>::Apply(dst, src);
+      }
+
+      template <class Dst, class Src>
+      MYDSP_ALWAYS_INLINE static void Apply(Dst* MYDSP_RESTRICT dst, const Src* MYDSP_RESTRICT src)
+      {
+        for (std::size_t w = 0; w < Width; ++w)
+        {
+          dst[w] = static_cast<Dst>(src[w]);
+        }
+      }
+    };
+
+    // 多チャネル双二次IIRフィルタのWidthチャネル分の処理
+    // 係数と状態変数を局所配列(ベクトルレジスタ)に置いたまま、段ごとに全サンプルを処理する
+    // TC/TS: 係数・状態変数の格納型(TそのものかHalf/BFloat16)。局所配列に読み込むときにTへ変換する
+    // 残りのチャネルは幅を半分にして処理する
+    template <class T, std::size_t Width>
+    struct BiquadDF2TChannelBlock
+    {
+      template <class TC, class TS>
+      MYDSP_ALWAYS_INLINE static void Apply(const TC* coeffs, TS* state, std::size_t num_stages, std::size_t num_channels,
+        std::size_t &ch, const T* in, T* out, std::size_t length)
+      {
+        for (; ch + Width <= num_channels; ch += Width)
+        {
+          for (std::size_t stage = 0; stage < num_stages; ++stage)
+          {
+            T c[5][Width];
+            T d1[Width];
+            T d2[Width];
+            for (std::size_t i = 0; i < 5; ++i)
+            {
+              LaneConvert<Width>::Apply(c[i], coeffs + (stage * 5 + i) * num_channels + ch);
+            }
+            LaneConvert<Width>::Apply(d1, state + (stage * 2 + 0) * num_channels + ch);
+            LaneConvert<Width>::Apply(d2, state + (stage * 2 + 1) * num_channels + ch);
+
+            // 2段目以降は前段の出力(out)をその場で処理する
+            const T* src = (stage == 0) ? in : out;
+            for (std::size_t n = 0; n < length; ++n)
+            {
+              T x[Width];
+              LaneCopy<T,Width>::Apply(x, src + n * num_channels + ch);
+              for (std::size_t w = 0; w < Width; ++w)
+              {
+                /*  y[n] = b0 * x[n] + d1[n-1]             */
+                /* d1[n] = b1 * x[n] + a1 * y[n] + d2[n-1] */
+                /* d2[n] = b2 * x[n] + a2 * y[n]           */
+                const T y = c[0][w] * x[w] + d1[w];
+                d1[w] = c[1][w] * x[w] + c[3][w] * y + d2[w];
+                d2[w] = c[2][w] * x[w] + c[4][w] * y;
+                x[w] = y;
+              }
+              LaneCopy<T,Width>::Apply(out + n * num_channels + ch, x);
+            }
+            LaneConvert<Width>::Apply(state + (stage * 2 + 0) * num_channels + ch, d1);
+            LaneConvert<Width>::Apply(state + (stage * 2 + 1) * num_channels + ch, d2);
+          }
+        }
+        BiquadDF2TChannelBlock<T,Width/2>::Apply(coeffs, state, num_stages, num_channels, ch, in, out, length);
+      }
+    };
+
+    template <class T>
+    struct BiquadDF2TChannelBlock<T,0>
+    {
+      template <class TC, class TS>
+      MYDSP_ALWAYS_INLINE static void Apply(const TC*, TS*, std::size_t, std::size_t, std::size_t&, const T*, T*, std::size_t) {}
+    };
+
+    // 多チャネル従属型双二次IIRフィルタ(直接型II転置構成)のブロック処理
+    // チャネル方向にベクトル化する
+    // coeffs: [stage][5][channel] (b0,b1,b2,a1,a2)
+    // state : [stage][2][channel]
+    // in/out: [sample][channel] (inとoutは同じ領域でもよい)
+    // TC/TS: 係数・状態変数の格納型(TそのものかHalf/BFloat16)
+    template <class T, std::size_t Lanes, class TC, class TS>
+    MYDSP_ALWAYS_INLINE void BiquadDF2TMultiChannelKernel(
+      const TC* coeffs,
+      TS* state,
+      std::size_t num_stages,
+      std::size_t num_channels,
+      const T* in,
+      T* out,
+      std::size_t length)
+    {
+      std::size_t ch = 0;
+      BiquadDF2TChannelBlock<T,Lanes>::Apply(coeffs, state, num_stages, num_channels, ch, in, out, length);
+    }
+
+    // 先読み形式の状態変数と状態遷移行列の型
+    // 状態遷移行列の丸め誤差は極の位置の誤差になり、極が単位円に近いと出力の誤差が大きく増幅されるため、
+    // floatのときはdoubleで保持して計算する(ブロックあたり積和4回分なので、速度への影響は小さい)
+    template <class T>
+    struct LookAheadStateType
+    {
+      using type = typename std::conditional<std::is_same<T,float>::value, double, T>::type;
+    };
+
+    // 従属型双二次IIRフィルタ(直接型II転置構成)の先読み形式(ブロック状態空間表現)によるブロック処理
+    // 1チャネルの信号をBlockSizeサンプルずつ、段ごとに行列とベクトルの積で処理する
+    //   y  = H x + g1 * d1 + g2 * d2          (H: インパルス応答を並べた下三角テプリッツ行列)
+    //   d1 = A11 * d1 + A12 * d2 + q1・x     (A: 状態遷移行列のBlockSize乗)
+    //   d2 = A21 * d1 + A22 * d2 + q2・x
+    // ブロック間の依存関係は状態変数の積和2回分だけになり、行列の積はサンプルの方向にベクトル化される
+    // coeffs     : [stage][5] (b0,b1,b2,a1,a2。BlockSizeに満たない残りを1サンプルずつ処理するときに使う)
+    // matrices   : [stage][BlockSize+4][BlockSize] (列ごとに連続。H(BlockSize列), g1, g2, q1, q2)
+    // transitions: [stage][4] (A11,A12,A21,A22)
+    // state      : [stage][2]
+    // 行列と状態変数を局所変数(レジスタ)に置いたまま段ごとに全サンプルを処理する。inとoutは同じ領域でもよい
+    template <class T, std::size_t BlockSize>
+    MYDSP_ALWAYS_INLINE void BiquadDF2TLookAheadKernel(
+      const T* coeffs,
+      const T* matrices,
+      const typename LookAheadStateType<T>::type* transitions,
+      typename LookAheadStateType<T>::type* state,
+      std::size_t num_stages,
+      const T* in,
+      T* out,
+      std::size_t length)
+    {
+      using TA = typename LookAheadStateType<T>::type;
+      for (std::size_t stage = 0; stage < num_stages; ++stage)
+      {
+        T m[BlockSize+4][BlockSize];
+        for (std::size_t j = 0; j < BlockSize + 4; ++j)
+        {
+          LaneCopy<T,BlockSize>::Apply(m[j], matrices + (stage * (BlockSize + 4) + j) * BlockSize);
+        }
+        const T (&g1)[BlockSize] = m[BlockSize+0];
+        const T (&g2)[BlockSize] = m[BlockSize+1];
+        const T (&q1)[BlockSize] = m[BlockSize+2];
+        const T (&q2)[BlockSize] = m[BlockSize+3];
+        const TA* a = transitions + stage * 4;
+        TA d1 = state[stage * 2 + 0];
+        TA d2 = state[stage * 2 + 1];
+
+        // 2段目以降は前段の出力(out)をその場で処理する
+        const T* src = (stage == 0) ? in : out;
+        std::size_t n = 0;
+        for (; n + BlockSize <= length; n += BlockSize)
+        {
+          T x[BlockSize];
+          T y[BlockSize];
+          T p1[BlockSize];
+          T p2[BlockSize];
+          LaneCopy<T,BlockSize>::Apply(x, src + n);
+
+          // 入力の寄与(状態変数に依存しない)
+          for (std::size_t k = 0; k < BlockSize; ++k)
+          {
+            y[k] = m[0][k] * x[0];
+            p1[k] = q1[k] * x[k];
+            p2[k] = q2[k] * x[k];
+          }
+          for (std::size_t j = 1; j < BlockSize; ++j)
+          {
+            for (std::size_t k = 0; k < BlockSize; ++k)
+            {
+              y[k] += m[j][k] * x[j];
+            }
+          }
+
+          // 状態変数の寄与と更新
+          const T e1 = static_cast<T>(d1);
+          const T e2 = static_cast<T>(d2);
+          for (std::size_t k = 0; k < BlockSize; ++k)
+          {
+            y[k] += g1[k] * e1 + g2[k] * e2;
+          }
+          const TA s1 = LaneReducer<T,BlockSize/2>::Apply(p1);
+          const TA s2 = LaneReducer<T,BlockSize/2>::Apply(p2);
+          const TA d1_next = a[0] * d1 + a[1] * d2 + s1;
+          d2 = a[2] * d1 + a[3] * d2 + s2;
+          d1 = d1_next;
+          LaneCopy<T,BlockSize>::Apply(out + n, y);
+        }
+        if (n < length)
+        {
+          const TA c[5] = {coeffs[stage*5+0], coeffs[stage*5+1], coeffs[stage*5+2], coeffs[stage*5+3], coeffs[stage*5+4]};
+          TA d[2] = {d1, d2};
+          for (; n < length; ++n)
+          {
+            out[n] = static_cast<T>(BiquadDF2TStepKernel(c, d, 1, static_cast<TA>(src[n])));
+          }
+          d1 = d[0];
+          d2 = d[1];
+        }
+        state[stage * 2 + 0] = d1;
+        state[stage * 2 + 1] = d2;
+      }
+    }
+
+    // 複素係数の従属型双二次IIRフィルタのStages段分の処理
+    // 係数と状態変数を局所配列(レジスタ)に置き、サンプルごとに全段を処理する
+    // (段ごとの漸化式は互いに独立に進められるので、段数分の依存関係の待ちを重ねられる)
+    template <class T, std::size_t Stages>
+    MYDSP_ALWAYS_INLINE void ComplexBiquadDF2TPass(const T* coeffs, T* state, const T* in, T* out, std::size_t length)
+    {
+      T c[Stages*10];
+      T d[Stages*4];
+      LaneCopy<T,Stages*10>::Apply(c, coeffs);
+      LaneCopy<T,Stages*4>::Apply(d, state);
+      for (std::size_t n = 0; n < length; ++n)
+      {
+        T xr = in[n*2+0];
+        T xi = in[n*2+1];
+        for (std::size_t k = 0; k < Stages; ++k)
+        {
+          const T* ck = c + k * 10;
+          T* dk = d + k * 4;
+
+          /*  y[n] = b0 * x[n] + d1[n-1]             */
+          /* d1[n] = b1 * x[n] + a1 * y[n] + d2[n-1] */
+          /* d2[n] = b2 * x[n] + a2 * y[n]           */
+          const T yr = ck[0] * xr - ck[1] * xi + dk[0];
+          const T yi = ck[0] * xi + ck[1] * xr + dk[1];
+          dk[0] = ck[2] * xr - ck[3] * xi + ck[6] * yr - ck[7] * yi + dk[2];
+          dk[1] = ck[2] * xi + ck[3] * xr + ck[6] * yi + ck[7] * yr + dk[3];
+          dk[2] = ck[4] * xr - ck[5] * xi + ck[8] * yr - ck[9] * yi;
+          dk[3] = ck[4] * xi + ck[5] * xr + ck[8] * yi + ck[9] * yr;
+          xr = yr;
+          xi = yi;
+        }
+        out[n*2+0] = xr;
+        out[n*2+1] = xi;
+      }
+      LaneCopy<T,Stages*4>::Apply(state, d);
+    }
+
+    // 複素係数の従属型双二次IIRフィルタ(直接型II転置構成)のブロック処理
+    // 複素数の乗算を実数演算で展開し、最大4段ずつ係数と状態変数をレジスタに置いたまま処理する
+    // coeffs: [stage][5][2] (b0,b1,b2,a1,a2の実部・虚部。std::complexの配列と同じ配置)
+    // state : [stage][2][2] (d1,d2の実部・虚部)
+    // in/out: length個の複素数(実部・虚部の順)。inとoutは同じ領域でもよい
+    template <class T>
+    MYDSP_ALWAYS_INLINE void ComplexBiquadDF2TKernel(
+      const T* coeffs,
+      T* state,
+      std::size_t num_stages,
+      const T* in,
+      T* out,
+      std::size_t length)
+    {
+      // 2回目以降は前段の出力(out)をその場で処理する
+      const T* src = in;
+      std::size_t stage = 0;
+      for (; stage + 4 <= num_stages; stage += 4, src = out)
+      {
+        ComplexBiquadDF2TPass<T,4>(coeffs + stage * 10, state + stage * 4, src, out, length);
+      }
+      if (stage + 2 <= num_stages)
+      {
+        ComplexBiquadDF2TPass<T,2>(coeffs + stage * 10, state + stage * 4, src, out, length);
+        stage += 2;
+        src = out;
+      }
+      if (stage < num_stages)
+      {
+        ComplexBiquadDF2TPass<T,1>(coeffs + stage * 10, state + stage * 4, src, out, length);
+      }
+    }
+
+    // Goertzelアルゴリズムの複数周波数分の処理
+    // coeffs: [bin] (2cos(ω)), s1/s2: [bin] (1,2サンプル前の中間値)
+    // 周波数(ビン)が最内となるループにして、ビン方向にベクトル化する
+    template <class T, std::size_t NumBins>
+    MYDSP_ALWAYS_INLINE void GoertzelKernel(
+      const T* MYDSP_RESTRICT coeffs,
+      T* MYDSP_RESTRICT s1,
+      T* MYDSP_RESTRICT s2,
+      const T* MYDSP_RESTRICT in,
+      std::size_t length)
+    {
+      T c[NumBins];
+      T v1[NumBins];
+      T v2[NumBins];
+      LaneCopy<T,NumBins>::Apply(c, coeffs);
+      LaneCopy<T,NumBins>::Apply(v1, s1);
+      LaneCopy<T,NumBins>::Apply(v2, s2);
+      for (std::size_t n = 0; n < length; ++n)
+      {
+        const T x = in[n];
+        for (std::size_t k = 0; k < NumBins; ++k)
+        {
+          /* s[n] = x[n] + 2cos(ω) * s[n-1] - s[n-2] */
+          // x[n] - s[n-2]を先に求めておき、サンプル間の依存を積和1回にする
+          const T v0 = (x - v2[k]) + c[k] * v1[k];
+          v2[k] = v1[k];
+          v1[k] = v0;
+        }
+      }
+      LaneCopy<T,NumBins>::Apply(s1, v1);
+      LaneCopy<T,NumBins>::Apply(s2, v2);
+    }
+
+    // スライディングDFTの複数ビン分の処理
+    // twiddle_re/twiddle_im: [bin] (exp(j2πk/N)), x_re/x_im: [bin] (各ビンのDFT値)
+    // ring: 長さNのリングバッファ(N サンプル前の入力), ring_top: リングバッファの最古の位置
+    // damping: 減衰係数r, damping_n: rのN乗
+    /* X_k[n] = exp(j2πk/N) * (r * X_k[n-1] + x[n] - r^N * x[n-N]) */
+    template <class T, std::size_t NumBins>
+    MYDSP_ALWAYS_INLINE void SlidingDFTKernel(
+      const T* MYDSP_RESTRICT twiddle_re,
+      const T* MYDSP_RESTRICT twiddle_im,
+      T damping,
+      T damping_n,
+      T* MYDSP_RESTRICT x_re,
+      T* MYDSP_RESTRICT x_im,
+      T* MYDSP_RESTRICT ring,
+      std::size_t ring_length,
+      std::size_t &ring_top,
+      const T* MYDSP_RESTRICT in,
+      std::size_t length)
+    {
+      T wr[NumBins];
+      T wi[NumBins];
+      T xr[NumBins];
+      T xi[NumBins];
+      LaneCopy<T,NumBins>::Apply(wr, twiddle_re);
+      LaneCopy<T,NumBins>::Apply(wi, twiddle_im);
+      LaneCopy<T,NumBins>::Apply(xr, x_re);
+      LaneCopy<T,NumBins>::Apply(xi, x_im);
+      std::size_t top = ring_top;
+      for (std::size_t n = 0; n < length; ++n)
+      {
+        const T x = in[n];
+        const T comb = x - damping_n * ring[top];
+        ring[top] = x;
+        top = (top + 1 == ring_length) ? 0 : top + 1;
+        for (std::size_t k = 0; k < NumBins; ++k)
+        {
+          const T tr = damping * xr[k] + comb;
+          const T ti = damping * xi[k];
+          xr[k] = wr[k] * tr - wi[k] * ti;
+          xi[k] = wi[k] * tr + wr[k] * ti;
+        }
+      }
+      LaneCopy<T,NumBins>::Apply(x_re, xr);
+      LaneCopy<T,NumBins>::Apply(x_im, xi);
+      ring_top = top;
+    }
+
+    // 基数2・周波数間引きのStockham型FFTで、段の長さがコンパイル時定数S(8以下)の段
+    // x[q + S*p], x[q + S*(p+m)] から y[q + 2S*p], y[q + 2S*p + S] を求める(m = length/2S)
+    // twiddle_re/twiddle_im: [p*S+q] = cos(πp/m), sin(πp/m) (qについて同じ値を並べたもの)
+    // 読み出しは(p,q)について連続し、回転因子も連続して並ぶので、pの方向にベクトル化される
+    template <class T, std::size_t S>
+    MYDSP_ALWAYS_INLINE void FFTShortStage(
+      const T* MYDSP_RESTRICT twiddle_re,
+      const T* MYDSP_RESTRICT twiddle_im,
+      const T* MYDSP_RESTRICT x_re,
+      const T* MYDSP_RESTRICT x_im,
+      T* MYDSP_RESTRICT y_re,
+      T* MYDSP_RESTRICT y_im,
+      std::size_t length)
+    {
+      const std::size_t m = length / (2 * S);
+      for (std::size_t p = 0; p < m; ++p)
+      {
+        for (std::size_t q = 0; q < S; ++q)
+        {
+          const T wr = twiddle_re[p*S+q];
+          const T wi = twiddle_im[p*S+q];
+          const T ar = x_re[q+S*p], ai = x_im[q+S*p];
+          const T br = x_re[q+S*(p+m)], bi = x_im[q+S*(p+m)];
+          const T dr = ar - br;
+          const T di = ai - bi;
+          /* y0 = a + b, y1 = (a - b) * exp(-jπp/m) */
+          y_re[q+2*S*p] = ar + br;
+          y_im[q+2*S*p] = ai + bi;
+          y_re[q+2*S*p+S] = wr * dr + wi * di;
+          y_im[q+2*S*p+S] = wr * di - wi * dr;
+        }
+      }
+    }
+
+    // 基数2・周波数間引きのStockham型FFTで、段の長さs(16の倍数)が実行時に決まる段
+    // twiddle_re/twiddle_im: [m+p] = cos(πp/m), sin(πp/m) (m = length/2s)
+    // 最内ループ(q)は16要素ずつに区切り、回数をコンパイル時定数にしてベクトル命令に展開させる
+    template <class T>
+    MYDSP_ALWAYS_INLINE void FFTLongStage(
+      const T* MYDSP_RESTRICT twiddle_re,
+      const T* MYDSP_RESTRICT twiddle_im,
+      const T* MYDSP_RESTRICT x_re,
+      const T* MYDSP_RESTRICT x_im,
+      T* MYDSP_RESTRICT y_re,
+      T* MYDSP_RESTRICT y_im,
+      std::size_t s,
+      std::size_t length)
+    {
+      constexpr std::size_t block = 16;
+      const std::size_t m = length / (2 * s);
+      for (std::size_t p = 0; p < m; ++p)
+      {
+        const T wr = twiddle_re[m+p];
+        const T wi = twiddle_im[m+p];
+        for (std::size_t q0 = 0; q0 < s; q0 += block)
+        {
+          const T* MYDSP_RESTRICT ar = x_re + s * p + q0;
+          const T* MYDSP_RESTRICT ai = x_im + s * p + q0;
+          const T* MYDSP_RESTRICT br = x_re + s * (p + m) + q0;
+          const T* MYDSP_RESTRICT bi = x_im + s * (p + m) + q0;
+          T* MYDSP_RESTRICT y0r = y_re + 2 * s * p + q0;
+          T* MYDSP_RESTRICT y0i = y_im + 2 * s * p + q0;
+          T* MYDSP_RESTRICT y1r = y_re + 2 * s * p + s + q0;
+          T* MYDSP_RESTRICT y1i = y_im + 2 * s * p + s + q0;
+          for (std::size_t q = 0; q < block; ++q)
+          {
+            const T dr = ar[q] - br[q];
+            const T di = ai[q] - bi[q];
+            y0r[q] = ar[q] + br[q];
+            y0i[q] = ai[q] + bi[q];
+            y1r[q] = wr * dr + wi * di;
+            y1i[q] = wr * di - wi * dr;
+          }
+        }
+      }
+    }
+
+    // 基数2・周波数間引きのStockham型FFT(順変換)
+    // 段ごとに作業領域と交互に読み書きするため、ビット反転の並べ替えが要らず、出力は自然な順に並ぶ
+    // re/im: 長さlength(2の冪, 4以上)の実部・虚部, work_re/work_im: 同じ長さの作業領域
+    // twiddle_re/twiddle_im: 長さ3*lengthの回転因子
+    //   [0, length)                : [m+p] = cos(πp/m), sin(πp/m) (m: 1,2,4,...,length/2, p < m)
+    //   [length + k*length/2, ...) : 段の長さS=2^k(k=0..3)の段用に、[m+p]をS個ずつ並べたもの
+    // 逆変換はreとim、work_reとwork_imをそれぞれ入れ替えて呼び出す
+    template <class T>
+    MYDSP_ALWAYS_INLINE void FFTKernel(
+      const T* twiddle_re,
+      const T* twiddle_im,
+      T* re,
+      T* im,
+      T* work_re,
+      T* work_im,
+      std::size_t length)
+    {
+      T* x_re = re;
+      T* x_im = im;
+      T* y_re = work_re;
+      T* y_im = work_im;
+      const std::size_t half = length / 2;
+      std::size_t s = 1;
+      if (s < length)
+      {
+        FFTShortStage<T,1>(twiddle_re + length, twiddle_im + length, x_re, x_im, y_re, y_im, length);
+        std::swap(x_re, y_re);
+        std::swap(x_im, y_im);
+        s *= 2;
+      }
+      if (s < length)
+      {
+        FFTShortStage<T,2>(twiddle_re + length + half, twiddle_im + length + half, x_re, x_im, y_re, y_im, length);
+        std::swap(x_re, y_re);
+        std::swap(x_im, y_im);
+        s *= 2;
+      }
+      if (s < length)
+      {
+        FFTShortStage<T,4>(twiddle_re + length + 2 * half, twiddle_im + length + 2 * half, x_re, x_im, y_re, y_im, length);
+        std::swap(x_re, y_re);
+        std::swap(x_im, y_im);
+        s *= 2;
+      }
+      if (s < length)
+      {
+        FFTShortStage<T,8>(twiddle_re + length + 3 * half, twiddle_im + length + 3 * half, x_re, x_im, y_re, y_im, length);
+        std::swap(x_re, y_re);
+        std::swap(x_im, y_im);
+        s *= 2;
+      }
+      for (; s < length; s *= 2)
+      {
+        FFTLongStage<T>(twiddle_re, twiddle_im, x_re, x_im, y_re, y_im, s, length);
+        std::swap(x_re, y_re);
+        std::swap(x_im, y_im);
+      }
+      // 段数が奇数の場合は結果が作業領域にある
+      if (x_re != re)
+      {
+        for (std::size_t i = 0; i < length; ++i)
+        {
+          re[i] = x_re[i];
+          im[i] = x_im[i];
+        }
+      }
+    }
+
+    // 浮動小数点数のビット表現に関する定数
+    template <class T>
+    struct FloatBits;
+
+    template <>
+    struct FloatBits<float>
+    {
+      using Bits = std::uint32_t;
+      static constexpr Bits exponent_mask = 0x7f800000u;
+      static constexpr Bits exponent_one = 0x00800000u;   // 指数部の1
+      static constexpr Bits rsqrt_magic = 0x5f375a86u;    // 逆平方根の初期値を求める定数
+      static constexpr std::size_t high_newton_steps = 3;
+      static constexpr float subnormal_scale = 16777216.0f; // 2^24 (非正規化数を正規化数に移す)
+      static constexpr float subnormal_rsqrt = 4096.0f;     // 2^12
+    };
+
+    template <>
+    struct FloatBits<double>
+    {
+      using Bits = std::uint64_t;
+      static constexpr Bits exponent_mask = 0x7ff0000000000000u;
+      static constexpr Bits exponent_one = 0x0010000000000000u;
+      static constexpr Bits rsqrt_magic = 0x5fe6eb50c7b537a9u;
+      static constexpr std::size_t high_newton_steps = 4;
+      static constexpr double subnormal_scale = 18014398509481984.0; // 2^54
+      static constexpr double subnormal_rsqrt = 134217728.0;         // 2^27
+    };
+
+    template <class T>
+    MYDSP_ALWAYS_INLINE typename FloatBits<T>::Bits ToBits(T value)
+    {
+      typename FloatBits<T>::Bits bits;
+      std::memcpy(&bits, &value, sizeof(bits));
+      return bits;
+    }
+
+    template <class T>
+    MYDSP_ALWAYS_INLINE T FromBits(typename FloatBits<T>::Bits bits)
+    {
+      T value;
+      std::memcpy(&value, &bits, sizeof(value));
+      return value;
+    }
+
+    // 条件に応じた値の選択
+    // 比較結果から作ったマスクで選ぶ(三項演算子では片方の式の評価が分岐として残り、ループがベクトル化されない)
+    template <class T>
+    MYDSP_ALWAYS_INLINE T SelectValue(bool condition, T if_true, T if_false)
+    {
+      using Bits = typename FloatBits<T>::Bits;
+      const Bits mask = Bits(0) - static_cast<Bits>(condition);
+      return FromBits<T>((ToBits(if_true) & mask) | (ToBits(if_false) & ~mask));
+    }
+
+    // 移動窓の統計量の種類
+    enum class MovingStatistic
+    {
+      Mean,     // 平均
+      Variance, // 分散(窓長で割る母分散)
+      RMS       // 2乗平均平方根
+    };
+
+    // 移動窓の統計量のWidthチャネル分の処理
+    // 和と2乗和を漸化式で更新し、チャネル方向にベクトル化する
+    // 基準値(前回の再計算時の窓の平均)を引いた値の和で持ち、直流成分による桁落ちを防ぐ
+    // 残りのチャネルは幅を半分にして処理する
+    template <class T, MovingStatistic Stat, std::size_t Width>
+    struct MovingStatisticsChannelBlock
+    {
+      MYDSP_ALWAYS_INLINE static void Apply(T* state, std::size_t window, std::size_t num_channels, std::size_t &ch,
+        std::size_t state_top, const T* shift, T* sum1, T* sum2, const T* in, T* out, std::size_t length)
+      {
+        const T inv_window = T(1) / static_cast<T>(window);
+        for (; ch + Width <= num_channels; ch += Width)
+        {
+          T k[Width];
+          T k2[Width];
+          T s1[Width];
+          T s2[Width];
+          LaneCopy<T,Width>::Apply(k, shift + ch);
+          for (std::size_t w = 0; w < Width; ++w)
+          {
+            k2[w] = k[w] + k[w];
+          }
+          LaneCopy<T,Width>::Apply(s1, sum1 + ch);
+          LaneCopy<T,Width>::Apply(s2, sum2 + ch);
+          std::size_t top = state_top;
+          for (std::size_t n = 0; n < length; ++n)
+          {
+            T x[Width];
+            T o[Width];
+            T y[Width];
+            T* oldest = state + top * num_channels + ch;
+            LaneCopy<T,Width>::Apply(x, in + n * num_channels + ch);
+            LaneCopy<T,Width>::Apply(o, oldest);
+            for (std::size_t w = 0; w < Width; ++w)
+            {
+              /* (x - k) - (o - k) = x - o, (x - k)^2 - (o - k)^2 = (x - o) * (x + o - 2k) */
+              const T d = x[w] - o[w];
+              if (Stat != MovingStatistic::RMS)
+              {
+                s1[w] += d;
+              }
+              if (Stat != MovingStatistic::Mean)
+              {
+                s2[w] += d * ((x[w] + o[w]) - k2[w]);
+              }
+            }
+            // 丸め誤差で分散・2乗平均が負になった場合は0にする(マスクによる選択でベクトル化を保つ)
+            for (std::size_t w = 0; w < Width; ++w)
+            {
+              const T v = (Stat == MovingStatistic::Mean) ? k[w] + s1[w] * inv_window
+              :           (Stat == MovingStatistic::Variance) ? (s2[w] - s1[w] * s1[w] * inv_window) * inv_window
+              :           s2[w] * inv_window ;
+              y[w] = (Stat == MovingStatistic::Mean) ? v : SelectValue(v > T(0), v, T(0));
+            }
+            if (Stat == MovingStatistic::RMS)
+            {
+              for (std::size_t w = 0; w < Width; ++w)
+              {
+                y[w] = std::sqrt(y[w]);
+              }
+            }
+            // ディレイラインの更新(FIRStepKernelと同じく、タップ長の2倍の領域の2箇所に書き込む)
+            LaneCopy<T,Width>::Apply(oldest, x);
+            LaneCopy<T,Width>::Apply(oldest + window * num_channels, x);
+            top = (top + 1u == window) ? 0 : top + 1u;
+            LaneCopy<T,Width>::Apply(out + n * num_channels + ch, y);
+          }
+          LaneCopy<T,Width>::Apply(sum1 + ch, s1);
+          LaneCopy<T,Width>::Apply(sum2 + ch, s2);
+        }
+        MovingStatisticsChannelBlock<T,Stat,Width/2>::Apply(state, window, num_channels, ch, state_top, shift, sum1, sum2,
+          in, out, length);
+      }
+    };
+
+    template <class T, MovingStatistic Stat>
+    struct MovingStatisticsChannelBlock<T,Stat,0>
+    {
+      MYDSP_ALWAYS_INLINE static void Apply(T*, std::size_t, std::size_t, std::size_t&, std::size_t, const T*, T*, T*,
+        const T*, T*, std::size_t) {}
+    };
+
+    // 基準値kを引いた値の和(Square == trueなら2乗和も)のWidthチャネル分
+    // samples: [window][channel]
+    // 加算の依存関係の待ちを減らすため、4サンプルずつ2分木状に足してから和に加える
+    template <class T, std::size_t Width, bool Square>
+    MYDSP_ALWAYS_INLINE void MovingStatisticsSumAbout(const T* samples, std::size_t window, std::size_t stride,
+      const T (&k)[Width], T (&a1)[Width], T (&a2)[Width])
+    {
+      for (std::size_t w = 0; w < Width; ++w)
+      {
+        a1[w] = T();
+        a2[w] = T();
+      }
+      std::size_t i = 0;
+      for (; i + 4 <= window; i += 4)
+      {
+        T x0[Width], x1[Width], x2[Width], x3[Width];
+        const T* row = samples + i * stride;
+        LaneCopy<T,Width>::Apply(x0, row + 0 * stride);
+        LaneCopy<T,Width>::Apply(x1, row + 1 * stride);
+        LaneCopy<T,Width>::Apply(x2, row + 2 * stride);
+        LaneCopy<T,Width>::Apply(x3, row + 3 * stride);
+        for (std::size_t w = 0; w < Width; ++w)
+        {
+          const T d0 = x0[w] - k[w];
+          const T d1 = x1[w] - k[w];
+          const T d2 = x2[w] - k[w];
+          const T d3 = x3[w] - k[w];
+          a1[w] += (d0 + d1) + (d2 + d3);
+          if (Square)
+          {
+            a2[w] += (d0 * d0 + d1 * d1) + (d2 * d2 + d3 * d3);
+          }
+        }
+      }
+      for (; i < window; ++i)
+      {
+        T x[Width];
+        LaneCopy<T,Width>::Apply(x, samples + i * stride);
+        for (std::size_t w = 0; w < Width; ++w)
+        {
+          const T d = x[w] - k[w];
+          a1[w] += d;
+          if (Square)
+          {
+            a2[w] += d * d;
+          }
+        }
+      }
+    }
+
+    // 移動窓の統計量の和のWidthチャネル分の再計算(丸め誤差の蓄積を打ち切る)
+    // samples: [window][channel] (窓全体を古い順に並べたもの)
+    // 平均・分散では、1回目の走査で窓の平均を求めて新しい基準値とし、2回目の走査でその基準値を引いた和と2乗和を求める
+    // (前回の基準値のまわりの和から補正すると、基準値が窓の平均から離れている場合(直流成分の変化の直後など)に桁落ちする)
+    // RMSは基準値が0のままなので1回の走査で済む
+    // 残りのチャネルは幅を半分にして処理する
+    template <class T, MovingStatistic Stat, std::size_t Width>
+    struct MovingStatisticsRecomputeBlock
+    {
+      MYDSP_ALWAYS_INLINE static void Apply(const T* samples, std::size_t window, std::size_t num_channels, std::size_t &ch,
+        T* shift, T* sum1, T* sum2)
+      {
+        const std::size_t stride = num_channels;
+        for (; ch + Width <= num_channels; ch += Width)
+        {
+          T k[Width];
+          T a1[Width];
+          T a2[Width];
+          LaneCopy<T,Width>::Apply(k, shift + ch);
+          MovingStatisticsSumAbout<T,Width,Stat == MovingStatistic::RMS>(samples + ch, window, stride, k, a1, a2);
+          if (Stat != MovingStatistic::RMS)
+          {
+            const T inv_window = T(1) / static_cast<T>(window);
+            for (std::size_t w = 0; w < Width; ++w)
+            {
+              k[w] += a1[w] * inv_window;
+            }
+            MovingStatisticsSumAbout<T,Width,Stat == MovingStatistic::Variance>(samples + ch, window, stride, k, a1, a2);
+            LaneCopy<T,Width>::Apply(shift + ch, k);
+          }
+          LaneCopy<T,Width>::Apply(sum1 + ch, a1);
+          LaneCopy<T,Width>::Apply(sum2 + ch, a2);
+        }
+        MovingStatisticsRecomputeBlock<T,Stat,Width/2>::Apply(samples, window, num_channels, ch, shift, sum1, sum2);
+      }
+    };
+
+    template <class T, MovingStatistic Stat>
+    struct MovingStatisticsRecomputeBlock<T,Stat,0>
+    {
+      MYDSP_ALWAYS_INLINE static void Apply(const T*, std::size_t, std::size_t, std::size_t&, T*, T*, T*) {}
+    };
+
+    // 移動窓の統計量の漸化式による更新
+    // state : [2*window][channel] (タップ長の2倍の長さのディレイライン), state_top: ディレイラインの最古の位置
+    // shift/sum1/sum2: [channel] (基準値、基準値を引いた値の和と2乗和)
+    // in/out: [sample][channel] (inとoutは同じ領域でもよい)
+    // state_topの更新と和の再計算は呼び出し側で行う
+    // (再計算と同じ関数にインライン展開すると、漸化式のループがベクトル化されなくなるため分けている)
+    template <class T, MovingStatistic Stat, std::size_t Lanes>
+    MYDSP_ALWAYS_INLINE void MovingStatisticsUpdateKernel(
+      T* state,
+      std::size_t window,
+      std::size_t num_channels,
+      std::size_t state_top,
+      const T* shift,
+      T* sum1,
+      T* sum2,
+      const T* in,
+      T* out,
+      std::size_t length)
+    {
+      std::size_t ch = 0;
+      MovingStatisticsChannelBlock<T,Stat,Lanes>::Apply(state, window, num_channels, ch, state_top, shift, sum1, sum2,
+        in, out, length);
+    }
+
+    // 移動窓の統計量の和の再計算
+    // samples: [window][channel] (窓全体を古い順に並べたもの)
+    template <class T, MovingStatistic Stat, std::size_t Lanes>
+    MYDSP_ALWAYS_INLINE void MovingStatisticsRecomputeKernel(
+      const T* samples,
+      std::size_t window,
+      std::size_t num_channels,
+      T* shift,
+      T* sum1,
+      T* sum2)
+    {
+      std::size_t ch = 0;
+      MovingStatisticsRecomputeBlock<T,Stat,Lanes>::Apply(samples, window, num_channels, ch, shift, sum1, sum2);
+    }
+
+    // Farrow構造の係数との内積
+    // coeffs: [4][length] (位相内の位置muについての3次多項式の係数。[m][k]がmu^mの係数)
+    // タップごとに係数をmuについてホーナー法で評価してから積和する(部分和の足し合わせは1回で済む)
+    // length: Lanesの倍数
+    template <class T, std::size_t Lanes>
+    MYDSP_ALWAYS_INLINE T FarrowDotKernel(const T* MYDSP_RESTRICT coeffs, const T* MYDSP_RESTRICT x, std::size_t length, T mu)
+    {
+      const T* c0 = coeffs;
+      const T* c1 = coeffs + length;
+      const T* c2 = coeffs + length * 2;
+      const T* c3 = coeffs + length * 3;
+      T acc[Lanes] = {};
+      for (std::size_t i = 0; i + Lanes <= length; i += Lanes)
+      {
+        for (std::size_t lane = 0; lane < Lanes; ++lane)
+        {
+          const std::size_t k = i + lane;
+          acc[lane] += x[k] * (((c3[k] * mu + c2[k]) * mu + c1[k]) * mu + c0[k]);
+        }
+      }
+      return LaneReducer<T,Lanes/2>::Apply(acc);
+    }
+
+    // リサンプラの内積で使う部分和の最大数
+    // 出力1サンプルごとに部分和を足し合わせるので、タップ数が少ないと幅の広いベクトルは足し合わせの分だけ遅くなる
+    constexpr std::size_t resampler_max_lanes = 8;
+
+    // 任意比のリサンプラのブロック処理
+    // coeffs: [phase][4][num_taps] (位相ごとのFarrow構造の係数。タップは古いサンプルから順)
+    // state: タップ長の2倍の長さのディレイライン(FIRBaseと同じ配置)
+    // position: 次の出力の時刻(最新の入力サンプルからの経過時間、入力サンプル単位。処理後の値に更新される)
+    // step: 出力1サンプルあたりの入力サンプル数
+    // 出力がout_length個に達するか、入力を使い切って次の出力を計算できなくなるまで処理し、出力数を返す
+    // consumed: 使った入力のサンプル数
+    template <class T, std::size_t Lanes>
+    MYDSP_ALWAYS_INLINE std::size_t ResamplerKernel(
+      const T* coeffs,
+      std::size_t num_taps,
+      std::size_t num_phases,
+      T* state,
+      std::size_t &state_top,
+      double &position,
+      double step,
+      const T* in,
+      std::size_t in_length,
+      std::size_t &consumed,
+      T* out,
+      std::size_t out_length)
+    {
+      std::size_t top = state_top;
+      double t = position;
+      std::size_t n_in = 0;
+      std::size_t n_out = 0;
+      while (n_out < out_length)
+      {
+        // 出力の時刻が最新の入力サンプルから1サンプル以内になるまで入力を進める
+        while (t >= 1.0 && n_in < in_length)
+        {
+          const T x = in[n_in++];
+          state[top] = x;
+          state[top+num_taps] = x;
+          top = (top + 1u == num_taps) ? 0 : top + 1u;
+          t -= 1.0;
+        }
+        if (t >= 1.0)
+        {
+          break;
+        }
+
+        // 位相と位相内の位置
+        const double scaled = t * static_cast<double>(num_phases);
+        const std::size_t phase = static_cast<std::size_t>(scaled);
+        const T mu = static_cast<T>(scaled - static_cast<double>(phase));
+        out[n_out++] = FarrowDotKernel<T,(Lanes > resampler_max_lanes) ? resampler_max_lanes : Lanes>(
+          coeffs + phase * num_taps * 4, state + top, num_taps, mu);
+        t += step;
+      }
+      state_top = top;
+      position = t;
+      consumed = n_in;
+      return n_out;
+    }
+
+    // 復調の種類
+    enum class Demodulation
+    {
+      Frequency, // 瞬時周波数(rad/サンプル)
+      Phase      // 瞬時位相(rad, [-π +π])
+    };
+
+    // 復調器のヒルベルト変換器で扱う最大の係数の数と、1回に処理するサンプル数
+    constexpr std::size_t demodulator_max_coeffs = 64;
+    constexpr std::size_t demodulator_chunk_length = 256;
+
+    // 解析信号を求めてからの復調のブロック処理
+    // coeffs: ヒルベルト変換器(長さ4*num_coeffs-1の奇対称FIR)の中心から奇数番目の係数(偶数番目は0)
+    // history: 直近の4*num_coeffs-2個の入力(古い順)
+    // last: 直前の解析信号の実部と虚部(周波数の復調で使う)
+    // 実部は入力を群遅延(2*num_coeffs-1サンプル)だけ遅らせたもの、虚部はヒルベルト変換器の出力
+    // 対称性から差を取ってから係数を掛けるので、乗算は1サンプルあたりnum_coeffs回になる
+    // 周波数は隣り合う解析信号の共役積の偏角として求めるので、位相のアンラップが要らない
+    // envelope: nullptrでなければ包絡線(解析信号の絶対値)を格納する
+    // 作業領域に読み込んでから出力するので、inとoutは同じ領域でもよい
+    template <class T, std::size_t Order, Demodulation Type>
+    MYDSP_ALWAYS_INLINE void DemodulatorKernel(
+      const T* coeffs,
+      std::size_t num_coeffs,
+      T* history,
+      T* last,
+      const T* in,
+      T* out,
+      T* envelope,
+      std::size_t length)
+    {
+      T buffer[demodulator_max_coeffs * 4 - 2 + demodulator_chunk_length]; // [過去のサンプル | 入力]
+      T re[demodulator_chunk_length + 1]; // [直前の値 | 解析信号]
+      T im[demodulator_chunk_length + 1];
+      const std::size_t history_length = num_coeffs * 4 - 2;
+      const std::size_t center = num_coeffs * 2 - 1;
+
+      std::copy(history, history + history_length, buffer);
+      for (std::size_t pos = 0; pos < length; pos += demodulator_chunk_length)
+      {
+        const std::size_t m = std::min(demodulator_chunk_length, length - pos);
+        std::copy(in + pos, in + pos + m, buffer + history_length);
+
+        // 解析信号
+        re[0] = last[0];
+        im[0] = last[1];
+        const T* x = buffer + center;
+        for (std::size_t n = 0; n < m; ++n)
+        {
+          re[n+1] = x[n];
+          im[n+1] = T();
+        }
+        for (std::size_t k = 0; k < num_coeffs; ++k)
+        {
+          const T g = coeffs[k];
+          const std::size_t d = 2 * k + 1;
+          for (std::size_t n = 0; n < m; ++n)
+          {
+            im[n+1] += g * (x[n-d] - x[n+d]);
+          }
+        }
+
+        // 復調
+        if (Type == Demodulation::Frequency)
+        {
+          for (std::size_t n = 0; n < m; ++n)
+          {
+            const T a = re[n+1] * re[n] + im[n+1] * im[n];
+            const T b = im[n+1] * re[n] - re[n+1] * im[n];
+            out[pos+n] = Atan2<Order>(b, a);
+          }
+        }
+        else
+        {
+          for (std::size_t n = 0; n < m; ++n)
+          {
+            out[pos+n] = Atan2<Order>(im[n+1], re[n+1]);
+          }
+        }
+        if (envelope != nullptr)
+        {
+          for (std::size_t n = 0; n < m; ++n)
+          {
+            envelope[pos+n] = Hypot(re[n+1], im[n+1]);
+          }
+        }
+
+        last[0] = re[m];
+        last[1] = im[m];
+        std::copy(buffer + m, buffer + m + history_length, buffer);
+      }
+      std::copy(buffer, buffer + history_length, history);
+    }
+
+    // sin,cosの配列処理(ミニマックス多項式による近似)
+    template <class T, std::size_t Order>
+    MYDSP_ALWAYS_INLINE void SinCosKernel(
+      const T* MYDSP_RESTRICT theta,
+      T* MYDSP_RESTRICT sin_vals,
+      T* MYDSP_RESTRICT cos_vals,
+      std::size_t length)
+    {
+      for (std::size_t i = 0; i < length; ++i)
+      {
+        SinCos<Order>(theta[i], &sin_vals[i], &cos_vals[i]);
+      }
+    }
+
+    // 平方根・逆平方根の配列処理の精度
+    enum class SqrtAccuracy
+    {
+      Fast,   // ビット操作による初期値 + ニュートン法1回(相対誤差 約1.8e-3)
+      Medium, // ニュートン法2回(相対誤差 約4.7e-6)
+      High,   // ニュートン法をfloatでは3回、doubleでは4回(誤差は数ulp)
+      Exact   // std::sqrtによる正しく丸めた値(ベクトル化には-fno-math-errno等でerrnoの設定を省く必要がある)
+    };
+
+    // ニュートン法の回数
+    template <class T, SqrtAccuracy Accuracy>
+    struct NewtonSteps : std::integral_constant<std::size_t,
+      (Accuracy == SqrtAccuracy::Fast) ? 1 : (Accuracy == SqrtAccuracy::Medium) ? 2 : FloatBits<T>::high_newton_steps>
+    {};
+
+    // 正の有限値vの逆平方根の近似
+    // 指数部を半分にして符号を反転させたビット列を初期値とし、y = y (3 - v y^2) / 2 を反復する
+    // 非正規化数は2^24(doubleでは2^54)倍してから求め、結果を2^12(2^27)倍する
+    template <class T, std::size_t Steps>
+    MYDSP_ALWAYS_INLINE T RSqrtNewton(T v)
+    {
+      using Traits = FloatBits<T>;
+      const bool tiny = v < std::numeric_limits<T>::min();
+      const T u = v * SelectValue(tiny, Traits::subnormal_scale, T(1));
+      const T h = T(0.5) * u;
+      T y = FromBits<T>(Traits::rsqrt_magic - (ToBits(u) >> 1));
+      for (std::size_t k = 0; k < Steps; ++k)
+      {
+        y = y * (T(1.5) - h * y * y);
+      }
+      return y * SelectValue(tiny, Traits::subnormal_rsqrt, T(1));
+    }
+
+    // 平方根
+    // 負の値とNaNは0とする(MyDSP::Sqrt<float>と同じ)
+    template <class T, SqrtAccuracy Accuracy>
+    MYDSP_ALWAYS_INLINE auto SqrtLane(T x)
+      -> typename std::enable_if<Accuracy == SqrtAccuracy::Exact,T>::type
+    {
+      return std::sqrt(SelectValue(x > T(0), x, T(0)));
+    }
+
+    template <class T, SqrtAccuracy Accuracy>
+    MYDSP_ALWAYS_INLINE auto SqrtLane(T x)
+      -> typename std::enable_if<Accuracy != SqrtAccuracy::Exact,T>::type
+    {
+      // 0以下・NaN・無限大は1に置き換えて計算し、最後に選び直す
+      const bool finite = (x > T(0)) & (x < std::numeric_limits<T>::infinity());
+      const T v = SelectValue(finite, x, T(1));
+      const T s = v * RSqrtNewton<T,NewtonSteps<T,Accuracy>::value>(v);
+      return SelectValue(finite, s, SelectValue(x > T(0), x, T(0)));
+    }
+
+    // 逆平方根
+    // 負の値・0・NaNは無限大、無限大は0とする
+    template <class T, SqrtAccuracy Accuracy>
+    MYDSP_ALWAYS_INLINE auto RSqrtLane(T x)
+      -> typename std::enable_if<Accuracy == SqrtAccuracy::Exact,T>::type
+    {
+      return T(1) / std::sqrt(SelectValue(x > T(0), x, T(0)));
+    }
+
+    template <class T, SqrtAccuracy Accuracy>
+    MYDSP_ALWAYS_INLINE auto RSqrtLane(T x)
+      -> typename std::enable_if<Accuracy != SqrtAccuracy::Exact,T>::type
+    {
+      const bool finite = (x > T(0)) & (x < std::numeric_limits<T>::infinity());
+      const T v = SelectValue(finite, x, T(1));
+      const T y = RSqrtNewton<T,NewtonSteps<T,Accuracy>::value>(v);
+      return SelectValue(finite, y, SelectValue(x > T(0), T(0), std::numeric_limits<T>::infinity()));
+    }
+
+    // 2乗ノルムの拡大縮小(Scaled = true)で掛ける2のべき乗 2^e (|x|,|y|の大きい方の指数)
+    // 大きい方を[最小の正規化数 2^(最大の指数-1)]に制限してから指数部を取り出す
+    // 64ビット整数の比較はSSE2にないため、制限は浮動小数点数の比較で行う(NaNは下限に置き換わる)
+    template <class T>
+    MYDSP_ALWAYS_INLINE T HypotExponent(T ax, T ay)
+    {
+      using Traits = FloatBits<T>;
+      const T lo = std::numeric_limits<T>::min();
+      const T hi = FromBits<T>(Traits::exponent_mask - 2 * Traits::exponent_one);
+      T m = SelectValue(ax < ay, ay, ax);
+      m = SelectValue(m >= lo, m, lo);
+      m = SelectValue(m <= hi, m, hi);
+      return FromBits<T>(ToBits(m) & Traits::exponent_mask);
+    }
+
+    // 2乗ノルムの平方根を取る前の値
+    // Scaled = false: x^2 + y^2。|x|,|y|がfloatで約1.8e19(doubleで約1.3e154)を超えるとオーバーフローする
+    // Scaled = true : |x|,|y|に2^-eを掛けて[0 4)に収めてから2乗和を取る
+    //                 2のべき乗による拡大縮小は丸め誤差を生じないので、誤差はScaled = falseと同じ
+    template <class T, bool Scaled>
+    MYDSP_ALWAYS_INLINE auto HypotSquare(T x, T y)
+      -> typename std::enable_if<!Scaled,T>::type
+    {
+      return x * x + y * y;
+    }
+
+    template <class T, bool Scaled>
+    MYDSP_ALWAYS_INLINE auto HypotSquare(T x, T y)
+      -> typename std::enable_if<Scaled,T>::type
+    {
+      using Traits = FloatBits<T>;
+      const T ax = std::fabs(x);
+      const T ay = std::fabs(y);
+      const T scale = FromBits<T>(Traits::exponent_mask - Traits::exponent_one - ToBits(HypotExponent(ax, ay)));
+      const T sx = ax * scale;
+      const T sy = ay * scale;
+      return sx * sx + sy * sy;
+    }
+
+    // HypotSquareの平方根rを元の大きさに戻す
+    // 一方が無限大なら、もう一方がNaNでも無限大とする(std::hypotと同じ)
+    template <class T, bool Scaled>
+    MYDSP_ALWAYS_INLINE auto HypotRestore(T, T, T r)
+      -> typename std::enable_if<!Scaled,T>::type
+    {
+      return r;
+    }
+
+    template <class T, bool Scaled>
+    MYDSP_ALWAYS_INLINE auto HypotRestore(T x, T y, T r)
+      -> typename std::enable_if<Scaled,T>::type
+    {
+      const T ax = std::fabs(x);
+      const T ay = std::fabs(y);
+      const T inf = std::numeric_limits<T>::infinity();
+      return SelectValue((ax == inf) | (ay == inf), inf, r * HypotExponent(ax, ay));
+    }
+
+    // 2乗ノルム
+    template <class T, SqrtAccuracy Accuracy, bool Scaled>
+    MYDSP_ALWAYS_INLINE T HypotLane(T x, T y)
+    {
+      return HypotRestore<T,Scaled>(x, y, SqrtLane<T,Accuracy>(HypotSquare<T,Scaled>(x, y)));
+    }
+
+    // 非負の値の平方根(その場で書き換え)
+    // std::sqrtはerrnoの設定のためにベクトル化されず、前後の計算と同じループに置くとそれらもベクトル化されなくなる
+    // Accuracy = SqrtAccuracy::Exactのカーネルでは、引数の計算・平方根・後処理を別々のループにする
+    template <class T>
+    MYDSP_ALWAYS_INLINE void SqrtInPlace(T* values, std::size_t length)
+    {
+      for (std::size_t i = 0; i < length; ++i)
+      {
+        values[i] = std::sqrt(values[i]);
+      }
+    }
+
+    // 平方根の配列処理
+    template <class T, SqrtAccuracy Accuracy>
+    MYDSP_ALWAYS_INLINE void SqrtKernel(const T* MYDSP_RESTRICT in, T* MYDSP_RESTRICT out, std::size_t length)
+    {
+      if (Accuracy != SqrtAccuracy::Exact)
+      {
+        for (std::size_t i = 0; i < length; ++i)
+        {
+          out[i] = SqrtLane<T,Accuracy>(in[i]);
+        }
+        return;
+      }
+      for (std::size_t i = 0; i < length; ++i)
+      {
+        out[i] = SelectValue(in[i] > T(0), in[i], T(0));
+      }
+      SqrtInPlace(out, length);
+    }
+
+    // 逆平方根の配列処理
+    template <class T, SqrtAccuracy Accuracy>
+    MYDSP_ALWAYS_INLINE void RSqrtKernel(const T* MYDSP_RESTRICT in, T* MYDSP_RESTRICT out, std::size_t length)
+    {
+      if (Accuracy != SqrtAccuracy::Exact)
+      {
+        for (std::size_t i = 0; i < length; ++i)
+        {
+          out[i] = RSqrtLane<T,Accuracy>(in[i]);
+        }
+        return;
+      }
+      for (std::size_t i = 0; i < length; ++i)
+      {
+        out[i] = SelectValue(in[i] > T(0), in[i], T(0));
+      }
+      SqrtInPlace(out, length);
+      for (std::size_t i = 0; i < length; ++i)
+      {
+        out[i] = T(1) / out[i];
+      }
+    }
+
+    // 2乗ノルムの配列処理
+    // x[Stride * i], y[Stride * i]からout[i]を求める
+    template <class T, SqrtAccuracy Accuracy, bool Scaled, std::size_t Stride>
+    MYDSP_ALWAYS_INLINE void HypotStridedKernel(
+      const T* MYDSP_RESTRICT x,
+      const T* MYDSP_RESTRICT y,
+      T* MYDSP_RESTRICT out,
+      std::size_t length)
+    {
+      if (Accuracy != SqrtAccuracy::Exact)
+      {
+        for (std::size_t i = 0; i < length; ++i)
+        {
+          out[i] = HypotLane<T,Accuracy,Scaled>(x[Stride*i], y[Stride*i]);
+        }
+        return;
+      }
+      for (std::size_t i = 0; i < length; ++i)
+      {
+        const T s = HypotSquare<T,Scaled>(x[Stride*i], y[Stride*i]);
+        out[i] = SelectValue(s > T(0), s, T(0));
+      }
+      SqrtInPlace(out, length);
+      if (Scaled)
+      {
+        for (std::size_t i = 0; i < length; ++i)
+        {
+          out[i] = HypotRestore<T,Scaled>(x[Stride*i], y[Stride*i], out[i]);
+        }
+      }
+    }
+
+    // 2乗ノルムの配列処理
+    template <class T, SqrtAccuracy Accuracy, bool Scaled>
+    MYDSP_ALWAYS_INLINE void HypotKernel(
+      const T* MYDSP_RESTRICT x,
+      const T* MYDSP_RESTRICT y,
+      T* MYDSP_RESTRICT out,
+      std::size_t length)
+    {
+      HypotStridedKernel<T,Accuracy,Scaled,1>(x, y, out, length);
+    }
+
+    // 複素数の絶対値の配列処理
+    // iq: 実部と虚部を交互に並べた配列(std::complex<T>の配列と同じ配置)
+    template <class T, SqrtAccuracy Accuracy, bool Scaled>
+    MYDSP_ALWAYS_INLINE void MagnitudeKernel(const T* MYDSP_RESTRICT iq, T* MYDSP_RESTRICT out, std::size_t length)
+    {
+      HypotStridedKernel<T,Accuracy,Scaled,2>(iq, iq + 1, out, length);
+    }
+
+    // 周波数応答の評価で一度に処理する周波数点の数
+    constexpr std::size_t response_chunk_length = 128;
+
+    // 周波数応答の評価に使うsin,cosの多項式の次数(floatでは7次、doubleでは11次で丸め誤差と同程度になる)
+    template <class T>
+    struct ResponseSinCosOrder : std::integral_constant<std::size_t, std::is_same<T,float>::value ? 7 : 11>
+    {};
+
+    // 周波数点omega[n0, n0+m)の半角のsin,cos
+    // omegasがnullptrなら等間隔の格子 omega0 + step * n とする(点ごとに求めるので誤差は蓄積しない)
+    // 1 - cos(omega) = 2 sin^2(omega/2) として、直流付近の打ち消し誤差を避けるために半角で持つ
+    template <class T>
+    MYDSP_ALWAYS_INLINE void ResponseHalfAngleKernel(
+      const T* omegas,
+      T omega0,
+      T step,
+      std::size_t n0,
+      std::size_t m,
+      T* MYDSP_RESTRICT sin_half,
+      T* MYDSP_RESTRICT cos_half)
+    {
+      T half[response_chunk_length];
+      if (omegas != nullptr)
+      {
+        for (std::size_t j = 0; j < m; ++j)
+        {
+          half[j] = T(0.5) * omegas[n0+j];
+        }
+      }
+      else
+      {
+        // ブロック内の番号はintから変換する(size_tからの変換はベクトル化されない)
+        const T base = static_cast<T>(n0);
+        for (std::size_t j = 0; j < m; ++j)
+        {
+          half[j] = T(0.5) * (omega0 + step * (base + static_cast<T>(static_cast<int>(j))));
+        }
+      }
+      for (std::size_t j = 0; j < m; ++j)
+      {
+        SinCos<ResponseSinCosOrder<T>::value>(half[j], &sin_half[j], &cos_half[j]);
+      }
+    }
+
+    // 従属型双二次IIRフィルタの周波数応答 H(e^jω) = Π (b0 + b1 z^-1 + b2 z^-2) / (1 - a1 z^-1 - a2 z^-2)
+    // coeffs: [stage][5] (b0,b1,b2,a1,a2), out: 複素数の実部・虚部を交互に並べたもの
+    // 周波数点の方向にベクトル化する。分子・分母は直流利得の項と(1 - cos kω)の項に分けて、
+    //   Re = (b0 + b1 + b2) - b1 (1 - cos ω) - b2 (1 - cos 2ω), Im = -(b1 sin ω + b2 sin 2ω)
+    // のように求める(極が単位円に近い低域のフィルタでも、直流付近の分母の桁落ちが起きない)
+    template <class T>
+    MYDSP_ALWAYS_INLINE void BiquadResponseKernel(
+      const T* coeffs,
+      std::size_t num_stages,
+      const T* omegas,
+      T omega0,
+      T step,
+      T* MYDSP_RESTRICT out,
+      std::size_t length)
+    {
+      for (std::size_t n0 = 0; n0 < length; n0 += response_chunk_length)
+      {
+        const std::size_t m = (length - n0 < response_chunk_length) ? length - n0 : response_chunk_length;
+        T sh[response_chunk_length];
+        T ch[response_chunk_length];
+        T v1[response_chunk_length]; // 1 - cos ω
+        T v2[response_chunk_length]; // 1 - cos 2ω
+        T s1[response_chunk_length]; // sin ω
+        T s2[response_chunk_length]; // sin 2ω
+        T re[response_chunk_length];
+        T im[response_chunk_length];
+        ResponseHalfAngleKernel(omegas, omega0, step, n0, m, sh, ch);
+        for (std::size_t j = 0; j < m; ++j)
+        {
+          const T c1 = T(1) - T(2) * sh[j] * sh[j];
+          s1[j] = T(2) * sh[j] * ch[j];
+          v1[j] = T(2) * sh[j] * sh[j];
+          v2[j] = T(2) * s1[j] * s1[j];
+          s2[j] = T(2) * s1[j] * c1;
+          re[j] = T(1);
+          im[j] = T(0);
+        }
+
+        for (std::size_t stage = 0; stage < num_stages; ++stage)
+        {
+          const T b1 = coeffs[stage*5+1];
+          const T b2 = coeffs[stage*5+2];
+          const T a1 = coeffs[stage*5+3];
+          const T a2 = coeffs[stage*5+4];
+          const T sum_b = coeffs[stage*5+0] + b1 + b2;
+          const T sum_a = T(1) - a1 - a2;
+          for (std::size_t j = 0; j < m; ++j)
+          {
+            const T nr = sum_b - b1 * v1[j] - b2 * v2[j];
+            const T ni = -(b1 * s1[j] + b2 * s2[j]);
+            const T dr = sum_a + a1 * v1[j] + a2 * v2[j];
+            const T di = a1 * s1[j] + a2 * s2[j];
+            const T inv = T(1) / (dr * dr + di * di);
+            const T hr = (nr * dr + ni * di) * inv;
+            const T hi = (ni * dr - nr * di) * inv;
+            const T r = re[j] * hr - im[j] * hi;
+            im[j] = re[j] * hi + im[j] * hr;
+            re[j] = r;
+          }
+        }
+
+        for (std::size_t j = 0; j < m; ++j)
+        {
+          out[(n0+j)*2+0] = re[j];
+          out[(n0+j)*2+1] = im[j];
+        }
+      }
+    }
+
+    // FIRフィルタの周波数応答 H(e^jω) = Σ coeffs[num_taps-1-k] z^-k
+    // (FIRStepKernelと同じく、coeffs[num_taps-1]が最新の入力に掛かる)
+    // z^-1についてのホーナー法で、周波数点の方向にベクトル化する。out: 複素数の実部・虚部を交互に並べたもの
+    template <class T>
+    MYDSP_ALWAYS_INLINE void FIRResponseKernel(
+      const T* coeffs,
+      std::size_t num_taps,
+      const T* omegas,
+      T omega0,
+      T step,
+      T* MYDSP_RESTRICT out,
+      std::size_t length)
+    {
+      for (std::size_t n0 = 0; n0 < length; n0 += response_chunk_length)
+      {
+        const std::size_t m = (length - n0 < response_chunk_length) ? length - n0 : response_chunk_length;
+        T c1[response_chunk_length];
+        T s1[response_chunk_length];
+        T re[response_chunk_length];
+        T im[response_chunk_length];
+        ResponseHalfAngleKernel(omegas, omega0, step, n0, m, s1, c1);
+        for (std::size_t j = 0; j < m; ++j)
+        {
+          const T sh = s1[j];
+          s1[j] = T(2) * sh * c1[j];
+          c1[j] = T(1) - T(2) * sh * sh;
+          re[j] = coeffs[0];
+          im[j] = T(0);
+        }
+
+        // (re + j im) (cos ω - j sin ω) + coeffs[tap]
+        for (std::size_t tap = 1; tap < num_taps; ++tap)
+        {
+          const T c = coeffs[tap];
+          for (std::size_t j = 0; j < m; ++j)
+          {
+            const T r = re[j] * c1[j] + im[j] * s1[j] + c;
+            im[j] = im[j] * c1[j] - re[j] * s1[j];
+            re[j] = r;
+          }
+        }
+
+        for (std::size_t j = 0; j < m; ++j)
+        {
+          out[(n0+j)*2+0] = re[j];
+          out[(n0+j)*2+1] = im[j];
+        }
+      }
+    }
+
+    // カルマンフィルタの共分散の表現形式
+    enum class KalmanForm
+    {
+      Standard,   // P = (I - K H) P (計算量が最も少ないが、丸め誤差で対称性・正定値性が崩れやすい)
+      Joseph,     // P = (I - K H) P (I - K H)^T + K R K^T (丸め誤差で正定値性が崩れにくい)
+      SquareRoot  // P = S S^T となる下三角行列Sを直交変換で更新する(Pの条件数の平方根で済み、floatでも安定)
+    };
+
+    // 以下のカルマンフィルタのカーネルは、W個のフィルタの行列をフィルタが最内となる配置(SoA)で扱う
+    // Cols列の行列の要素(i,j)のフィルタwは[(i * Cols + j) * W + w]にあり、フィルタ方向にベクトル化する
+    // モデルの行列(F,H,Q,R)は全フィルタ共通で、行優先の通常の配置とする
+
+    // W個のフィルタ分の要素ごとの演算
+    // 作業用の配列の中の別の行どうしの演算でもベクトル化されるよう、引数が重ならないことを明示する
+    template <class T, std::size_t W>
+    struct KalmanLane
+    {
+      // dst = value
+      MYDSP_ALWAYS_INLINE static void Set(T* MYDSP_RESTRICT dst, T value)
+      {
+        for (std::size_t w = 0; w < W; ++w)
+        {
+          dst[w] = value;
+        }
+      }
+
+      // dst = src
+      MYDSP_ALWAYS_INLINE static void Copy(T* MYDSP_RESTRICT dst, const T* MYDSP_RESTRICT src)
+      {
+        for (std::size_t w = 0; w < W; ++w)
+        {
+          dst[w] = src[w];
+        }
+      }
+
+      // dst += a * b
+      MYDSP_ALWAYS_INLINE static void MulAdd(T* MYDSP_RESTRICT dst, const T* MYDSP_RESTRICT a, const T* MYDSP_RESTRICT b)
+      {
+        for (std::size_t w = 0; w < W; ++w)
+        {
+          dst[w] += a[w] * b[w];
+        }
+      }
+
+      // dst -= a * b
+      MYDSP_ALWAYS_INLINE static void MulSub(T* MYDSP_RESTRICT dst, const T* MYDSP_RESTRICT a, const T* MYDSP_RESTRICT b)
+      {
+        for (std::size_t w = 0; w < W; ++w)
+        {
+          dst[w] -= a[w] * b[w];
+        }
+      }
+
+      // dst += s * b (sは全フィルタ共通)
+      MYDSP_ALWAYS_INLINE static void ScaleAdd(T* MYDSP_RESTRICT dst, T s, const T* MYDSP_RESTRICT b)
+      {
+        for (std::size_t w = 0; w < W; ++w)
+        {
+          dst[w] += s * b[w];
+        }
+      }
+
+      // dst *= a
+      MYDSP_ALWAYS_INLINE static void Mul(T* MYDSP_RESTRICT dst, const T* MYDSP_RESTRICT a)
+      {
+        for (std::size_t w = 0; w < W; ++w)
+        {
+          dst[w] *= a[w];
+        }
+      }
+
+      // dst = (valid != 0) ? src : dst
+      MYDSP_ALWAYS_INLINE static void Select(T* MYDSP_RESTRICT dst, const T* MYDSP_RESTRICT src, const T* MYDSP_RESTRICT valid)
+      {
+        for (std::size_t w = 0; w < W; ++w)
+        {
+          dst[w] = (valid[w] != T(0)) ? src[w] : dst[w];
+        }
+      }
+    };
+
+    // Householder変換による行列の下三角化
+    // Rows×Cols (Rows <= Cols)の行列Aに右から直交行列を掛けて[L 0]とする(L L^T = A A^T、Lの対角成分は非負)
+    // Lは左のRows列に残り、それより右は0になる
+    template <class T, std::size_t W, std::size_t Rows, std::size_t Cols>
+    MYDSP_ALWAYS_INLINE void KalmanTriangularizeKernel(T* a)
+    {
+      static_assert(Rows <= Cols, "Triangularization requires Rows <= Cols");
+      using Lane = KalmanLane<T,W>;
+      for (std::size_t i = 0; i < Rows; ++i)
+      {
+        T* row = a + i * Cols * W;
+
+        // 行iの対角より右を0にする反射 u = (a_ii + sign(a_ii) σ, a_i,i+1, ...)、β = 2 / (u^T u)
+        T sigma[W];
+        T sign[W];
+        T u0[W];
+        T beta[W];
+        Lane::Set(sigma, T(0));
+        for (std::size_t c = i; c < Cols; ++c)
+        {
+          Lane::MulAdd(sigma, row + c * W, row + c * W);
+        }
+        for (std::size_t w = 0; w < W; ++w)
+        {
+          sigma[w] = std::sqrt(sigma[w]);
+          const T v0 = row[i*W+w];
+          sign[w] = std::copysign(T(1), v0);
+          u0[w] = v0 + sign[w] * sigma[w];
+          beta[w] = (sigma[w] > T(0)) ? T(1) / (sigma[w] * (sigma[w] + std::abs(v0))) : T(0);
+        }
+
+        // 残りの行への適用 a_r -= β (a_r・u) u
+        // 対角成分を正にするため、列iの符号を-sign(a_ii)倍する(L L^Tは変わらない)
+        for (std::size_t r = i + 1; r < Rows; ++r)
+        {
+          T* dst = a + r * Cols * W;
+          T dot[W];
+          Lane::Set(dot, T(0));
+          Lane::MulAdd(dot, dst + i * W, u0);
+          for (std::size_t c = i + 1; c < Cols; ++c)
+          {
+            Lane::MulAdd(dot, dst + c * W, row + c * W);
+          }
+          Lane::Mul(dot, beta);
+          for (std::size_t w = 0; w < W; ++w)
+          {
+            dst[i*W+w] = sign[w] * (u0[w] * dot[w] - dst[i*W+w]);
+          }
+          for (std::size_t c = i + 1; c < Cols; ++c)
+          {
+            Lane::MulSub(dst + c * W, dot, row + c * W);
+          }
+        }
+        Lane::Copy(row + i * W, sigma);
+        for (std::size_t c = i + 1; c < Cols; ++c)
+        {
+          Lane::Set(row + c * W, T(0));
+        }
+      }
+    }
+
+    // N×Nの対称行列のコレスキー分解 A = L L^T (下三角部分のみ参照し、Lで上書きする)
+    // 対角成分の逆数をinv_diagに書き込み、正定値でないフィルタはvalidを0にする(その場合の値は使えない)
+    template <class T, std::size_t W, std::size_t N>
+    MYDSP_ALWAYS_INLINE void KalmanCholeskyKernel(T* a, T* inv_diag, T* valid)
+    {
+      using Lane = KalmanLane<T,W>;
+      for (std::size_t j = 0; j < N; ++j)
+      {
+        T* diag = a + (j * N + j) * W;
+        for (std::size_t k = 0; k < j; ++k)
+        {
+          Lane::MulSub(diag, a + (j * N + k) * W, a + (j * N + k) * W);
+        }
+        for (std::size_t w = 0; w < W; ++w)
+        {
+          const bool positive = diag[w] > T(0); // NaNも除外する
+          valid[w] = positive ? valid[w] : T(0);
+          diag[w] = std::sqrt(positive ? diag[w] : T(1));
+          inv_diag[j*W+w] = T(1) / diag[w];
+        }
+        for (std::size_t i = j + 1; i < N; ++i)
+        {
+          T* dst = a + (i * N + j) * W;
+          for (std::size_t k = 0; k < j; ++k)
+          {
+            Lane::MulSub(dst, a + (i * N + k) * W, a + (j * N + k) * W);
+          }
+          Lane::Mul(dst, inv_diag + j * W);
+        }
+      }
+    }
+
+    // カルマンフィルタの予測 x = F x, P = F P F^T + Q
+    // f: [NX][NX], q: [NX][NX] (SquareRootの場合はQ = Gq Gq^Tとなる下三角行列Gq)
+    // x: [block][NX][W], p: [block][NX][NX][W] (SquareRootの場合はP = S S^Tとなる下三角行列S)
+    template <class T, std::size_t W, std::size_t NX, KalmanForm Form>
+    MYDSP_ALWAYS_INLINE void KalmanPredictKernel(const T* f, const T* q, T* x, T* p, std::size_t num_blocks)
+    {
+      using Lane = KalmanLane<T,W>;
+      for (std::size_t b = 0; b < num_blocks; ++b)
+      {
+        T* xb = x + b * NX * W;
+        T* pb = p + b * NX * NX * W;
+
+        T xn[NX*W];
+        for (std::size_t i = 0; i < NX; ++i)
+        {
+          Lane::Set(xn + i * W, T(0));
+          for (std::size_t k = 0; k < NX; ++k)
+          {
+            Lane::ScaleAdd(xn + i * W, f[i*NX+k], xb + k * W);
+          }
+        }
+        for (std::size_t i = 0; i < NX; ++i)
+        {
+          Lane::Copy(xb + i * W, xn + i * W);
+        }
+
+        if (Form == KalmanForm::SquareRoot)
+        {
+          // [F S  Gq]を下三角化し、左のNX列を新しいSとする
+          constexpr std::size_t Cols = 2 * NX;
+          T a[NX*Cols*W];
+          for (std::size_t i = 0; i < NX; ++i)
+          {
+            for (std::size_t j = 0; j < NX; ++j)
+            {
+              T* dst = a + (i * Cols + j) * W;
+              Lane::Set(dst, T(0));
+              for (std::size_t k = j; k < NX; ++k)
+              {
+                Lane::ScaleAdd(dst, f[i*NX+k], pb + (k * NX + j) * W);
+              }
+              Lane::Set(a + (i * Cols + NX + j) * W, q[i*NX+j]);
+            }
+          }
+          KalmanTriangularizeKernel<T,W,NX,Cols>(a);
+          for (std::size_t i = 0; i < NX; ++i)
+          {
+            for (std::size_t j = 0; j < NX; ++j)
+            {
+              Lane::Copy(pb + (i * NX + j) * W, a + (i * Cols + j) * W);
+            }
+          }
+        }
+        else
+        {
+          // FP = F P、P = FP F^T + Q (上三角を計算して対称に写す)
+          T fp[NX*NX*W];
+          for (std::size_t i = 0; i < NX; ++i)
+          {
+            for (std::size_t j = 0; j < NX; ++j)
+            {
+              T* dst = fp + (i * NX + j) * W;
+              Lane::Set(dst, T(0));
+              for (std::size_t k = 0; k < NX; ++k)
+              {
+                Lane::ScaleAdd(dst, f[i*NX+k], pb + (k * NX + j) * W);
+              }
+            }
+          }
+          for (std::size_t i = 0; i < NX; ++i)
+          {
+            for (std::size_t j = i; j < NX; ++j)
+            {
+              T* dst = pb + (i * NX + j) * W;
+              Lane::Set(dst, q[i*NX+j]);
+              for (std::size_t k = 0; k < NX; ++k)
+              {
+                Lane::ScaleAdd(dst, f[j*NX+k], fp + (i * NX + k) * W);
+              }
+              if (j != i)
+              {
+                Lane::Copy(pb + (j * NX + i) * W, dst);
+              }
+            }
+          }
+        }
+      }
+    }
+
+    // カルマンフィルタの観測更新
+    // h: [NZ][NX], r: [NZ][NZ] (SquareRootの場合はR = Gr Gr^Tとなる下三角行列Gr)
+    // z: [block][NZ][W], x: [block][NX][W], p: [block][NX][NX][W]
+    // valid: [block][W] 更新できたフィルタは1、イノベーションの共分散が正定値でなく更新しなかったフィルタは0
+    template <class T, std::size_t W, std::size_t NX, std::size_t NZ, KalmanForm Form>
+    MYDSP_ALWAYS_INLINE void KalmanUpdateKernel(const T* h, const T* r, const T* z, T* x, T* p, T* valid,
+      std::size_t num_blocks)
+    {
+      using Lane = KalmanLane<T,W>;
+      for (std::size_t b = 0; b < num_blocks; ++b)
+      {
+        const T* zb = z + b * NZ * W;
+        T* xb = x + b * NX * W;
+        T* pb = p + b * NX * NX * W;
+        T* vb = valid + b * W;
+
+        // イノベーション y = z - H x
+        T y[NZ*W];
+        for (std::size_t i = 0; i < NZ; ++i)
+        {
+          Lane::Copy(y + i * W, zb + i * W);
+          for (std::size_t k = 0; k < NX; ++k)
+          {
+            Lane::ScaleAdd(y + i * W, -h[i*NX+k], xb + k * W);
+          }
+        }
+        Lane::Set(vb, T(1));
+
+        T xn[NX*W];
+        T pn[NX*NX*W];
+        for (std::size_t i = 0; i < NX; ++i)
+        {
+          Lane::Copy(xn + i * W, xb + i * W);
+        }
+        if (Form == KalmanForm::SquareRoot)
+        {
+          // [Gr H S; 0 S]を下三角化すると[Sy 0; Kb S']になる
+          // Sy Sy^T = H P H^T + R、K = Kb Sy^-1、S'が更新後のS
+          constexpr std::size_t N = NZ + NX;
+          T a[N*N*W];
+          for (std::size_t i = 0; i < NZ; ++i)
+          {
+            for (std::size_t j = 0; j < NZ; ++j)
+            {
+              Lane::Set(a + (i * N + j) * W, r[i*NZ+j]);
+            }
+            for (std::size_t j = 0; j < NX; ++j)
+            {
+              T* dst = a + (i * N + NZ + j) * W;
+              Lane::Set(dst, T(0));
+              for (std::size_t k = j; k < NX; ++k)
+              {
+                Lane::ScaleAdd(dst, h[i*NX+k], pb + (k * NX + j) * W);
+              }
+            }
+          }
+          for (std::size_t i = 0; i < NX; ++i)
+          {
+            for (std::size_t j = 0; j < NZ; ++j)
+            {
+              Lane::Set(a + ((NZ + i) * N + j) * W, T(0));
+            }
+            for (std::size_t j = 0; j < NX; ++j)
+            {
+              Lane::Copy(a + ((NZ + i) * N + NZ + j) * W, pb + (i * NX + j) * W);
+            }
+          }
+          KalmanTriangularizeKernel<T,W,N,N>(a);
+
+          // e = Sy^-1 y (前進代入)、x' = x + Kb e
+          for (std::size_t i = 0; i < NZ; ++i)
+          {
+            for (std::size_t k = 0; k < i; ++k)
+            {
+              Lane::MulSub(y + i * W, a + (i * N + k) * W, y + k * W);
+            }
+            T inv[W];
+            for (std::size_t w = 0; w < W; ++w)
+            {
+              const T d = a[(i*N+i)*W+w];
+              const bool positive = d > T(0);
+              vb[w] = positive ? vb[w] : T(0);
+              inv[w] = T(1) / (positive ? d : T(1));
+            }
+            Lane::Mul(y + i * W, inv);
+          }
+          for (std::size_t i = 0; i < NX; ++i)
+          {
+            for (std::size_t k = 0; k < NZ; ++k)
+            {
+              Lane::MulAdd(xn + i * W, a + ((NZ + i) * N + k) * W, y + k * W);
+            }
+            for (std::size_t j = 0; j < NX; ++j)
+            {
+              Lane::Copy(pn + (i * NX + j) * W, a + ((NZ + i) * N + NZ + j) * W);
+            }
+          }
+        }
+        else
+        {
+          // PH^T、S = H P H^T + R (下三角のみ)
+          T pht[NX*NZ*W];
+          for (std::size_t i = 0; i < NX; ++i)
+          {
+            for (std::size_t j = 0; j < NZ; ++j)
+            {
+              T* dst = pht + (i * NZ + j) * W;
+              Lane::Set(dst, T(0));
+              for (std::size_t k = 0; k < NX; ++k)
+              {
+                Lane::ScaleAdd(dst, h[j*NX+k], pb + (i * NX + k) * W);
+              }
+            }
+          }
+          T s[NZ*NZ*W];
+          for (std::size_t i = 0; i < NZ; ++i)
+          {
+            for (std::size_t j = 0; j <= i; ++j)
+            {
+              T* dst = s + (i * NZ + j) * W;
+              Lane::Set(dst, r[i*NZ+j]);
+              for (std::size_t k = 0; k < NX; ++k)
+              {
+                Lane::ScaleAdd(dst, h[i*NX+k], pht + (k * NZ + j) * W);
+              }
+            }
+          }
+          T inv[NZ*W];
+          KalmanCholeskyKernel<T,W,NZ>(s, inv, vb);
+
+          // K = PH^T S^-1 (行ごとに L L^T k = (PH^T)の行 を解く)
+          T gain[NX*NZ*W];
+          for (std::size_t i = 0; i < NX; ++i)
+          {
+            T* k = gain + i * NZ * W;
+            for (std::size_t j = 0; j < NZ; ++j)
+            {
+              Lane::Copy(k + j * W, pht + (i * NZ + j) * W);
+              for (std::size_t c = 0; c < j; ++c)
+              {
+                Lane::MulSub(k + j * W, s + (j * NZ + c) * W, k + c * W);
+              }
+              Lane::Mul(k + j * W, inv + j * W);
+            }
+            for (std::size_t j = NZ; j-- > 0; )
+            {
+              for (std::size_t c = j + 1; c < NZ; ++c)
+              {
+                Lane::MulSub(k + j * W, s + (c * NZ + j) * W, k + c * W);
+              }
+              Lane::Mul(k + j * W, inv + j * W);
+            }
+          }
+
+          // x' = x + K y
+          for (std::size_t i = 0; i < NX; ++i)
+          {
+            for (std::size_t j = 0; j < NZ; ++j)
+            {
+              Lane::MulAdd(xn + i * W, gain + (i * NZ + j) * W, y + j * W);
+            }
+          }
+
+          if (Form == KalmanForm::Standard)
+          {
+            // P' = P - K (PH^T)^T (上三角を計算して対称に写す)
+            for (std::size_t i = 0; i < NX; ++i)
+            {
+              for (std::size_t j = i; j < NX; ++j)
+              {
+                T* dst = pn + (i * NX + j) * W;
+                Lane::Copy(dst, pb + (i * NX + j) * W);
+                for (std::size_t c = 0; c < NZ; ++c)
+                {
+                  Lane::MulSub(dst, gain + (i * NZ + c) * W, pht + (j * NZ + c) * W);
+                }
+                if (j != i)
+                {
+                  Lane::Copy(pn + (j * NX + i) * W, dst);
+                }
+              }
+            }
+          }
+          else
+          {
+            // A = I - K H、P' = A P A^T + K R K^T (上三角を計算して対称に写す)
+            T ia[NX*NX*W];
+            for (std::size_t i = 0; i < NX; ++i)
+            {
+              for (std::size_t j = 0; j < NX; ++j)
+              {
+                T* dst = ia + (i * NX + j) * W;
+                Lane::Set(dst, (i == j) ? T(1) : T(0));
+                for (std::size_t c = 0; c < NZ; ++c)
+                {
+                  Lane::ScaleAdd(dst, -h[c*NX+j], gain + (i * NZ + c) * W);
+                }
+              }
+            }
+            T ap[NX*NX*W];
+            for (std::size_t i = 0; i < NX; ++i)
+            {
+              for (std::size_t j = 0; j < NX; ++j)
+              {
+                T* dst = ap + (i * NX + j) * W;
+                Lane::Set(dst, T(0));
+                for (std::size_t k = 0; k < NX; ++k)
+                {
+                  Lane::MulAdd(dst, ia + (i * NX + k) * W, pb + (k * NX + j) * W);
+                }
+              }
+            }
+            T kr[NX*NZ*W];
+            for (std::size_t i = 0; i < NX; ++i)
+            {
+              for (std::size_t j = 0; j < NZ; ++j)
+              {
+                T* dst = kr + (i * NZ + j) * W;
+                Lane::Set(dst, T(0));
+                for (std::size_t c = 0; c < NZ; ++c)
+                {
+                  Lane::ScaleAdd(dst, r[c*NZ+j], gain + (i * NZ + c) * W);
+                }
+              }
+            }
+            for (std::size_t i = 0; i < NX; ++i)
+            {
+              for (std::size_t j = i; j < NX; ++j)
+              {
+                T* dst = pn + (i * NX + j) * W;
+                Lane::Set(dst, T(0));
+                for (std::size_t k = 0; k < NX; ++k)
+                {
+                  Lane::MulAdd(dst, ap + (i * NX + k) * W, ia + (j * NX + k) * W);
+                }
+                for (std::size_t c = 0; c < NZ; ++c)
+                {
+                  Lane::MulAdd(dst, kr + (i * NZ + c) * W, gain + (j * NZ + c) * W);
+                }
+                if (j != i)
+                {
+                  Lane::Copy(pn + (j * NX + i) * W, dst);
+                }
+              }
+            }
+          }
+        }
+
+        // 更新できなかったフィルタは状態を変更しない
+        for (std::size_t i = 0; i < NX; ++i)
+        {
+          Lane::Select(xb + i * W, xn + i * W, vb);
+        }
+        for (std::size_t i = 0; i < NX * NX; ++i)
+        {
+          Lane::Select(pb + i * W, pn + i * W, vb);
+        }
+      }
+    }
+
+  } /* namespace Internal */
+} /* namespace MyDSP */
+
+
+#endif /* MYDSP_INTERNAL_KERNEL_HPP_ */
@@ -0,0 +1,287 @@
+/*
+ * Minimax.hpp
+ *
+ *  Created on: 2026/10/18
+ *      Author: Shibasaki
+ *
+ * ミニマックス多項式の係数表
+ * 係数はRemezアルゴリズムにより相対誤差の最大値が最小になるよう求めたもの
+ */
+
+#ifndef MYDSP_INTERNAL_MINIMAX_HPP_
+#define MYDSP_INTERNAL_MINIMAX_HPP_
+
+#include "../Const.hpp"
+#include <cstddef>
+
+namespace MyDSP
+{
+  namespace Internal
+  {
+    // ホーナー法による多項式の評価
+    // c[0] + c[1] * t + c[2] * t^2 + ...
+    template <class T, std::size_t N>
+    static inline T Horner(const T (&c)[N], T t) noexcept
+    {
+      T r = c[N-1];
+      for (std::size_t i = N - 1; i > 0; --i)
+      {
+        r = r * t + c[i-1];
+      }
+      return r;
+    }
+
+    // atan(x) ≈ x * P(x^2) (|x| <= 1)
+    // Order: xについての多項式の次数
+    template <std::size_t Order>
+    struct AtanMinimax
+    {
+      static_assert(Order >= 3 && Order <= 17 && Order % 2 == 1,
+        "Template parameter 'Order' should be an odd number in [3, 17]");
+    };
+
+    template <>
+    struct AtanMinimax<3> // 最大相対誤差 1.3e-2
+    {
+      template <class T>
+      static T Eval(T t) noexcept
+      {
+        static constexpr T c[] = {
+          T(0.98731294065689586295L), T(-0.21187917036643597957L)};
+        return Horner(c, t);
+      }
+    };
+
+    template <>
+    struct AtanMinimax<5> // 最大相対誤差 1.6e-3
+    {
+      template <class T>
+      static T Eval(T t) noexcept
+      {
+        static constexpr T c[] = {
+          T(0.998424083042870764092L), T(-0.30103867975581025419L), T(0.0892504823941839969069L)};
+        return Horner(c, t);
+      }
+    };
+
+    template <>
+    struct AtanMinimax<7> // 最大相対誤差 2.1e-4
+    {
+      template <class T>
+      static T Eval(T t) noexcept
+      {
+        static constexpr T c[] = {
+          T(0.999787847552573117119L), T(-0.32580844804113742166L), T(0.155578753470416355074L),
+          T(-0.0443266137269730884603L)};
+        return Horner(c, t);
+      }
+    };
+
+    template <>
+    struct AtanMinimax<9> // 最大相対誤差 3.0e-5
+    {
+      template <class T>
+      static T Eval(T t) noexcept
+      {
+        static constexpr T c[] = {
+          T(0.999970033941117650235L), T(-0.331700840068061759324L), T(0.185215676266381118093L),
+          T(-0.0919265789687116347537L), T(0.0238634075143333927281L)};
+        return Horner(c, t);
+      }
+    };
+
+    template <>
+    struct AtanMinimax<11> // 最大相対誤差 4.4e-6
+    {
+      template <class T>
+      static T Eval(T t) noexcept
+      {
+        static constexpr T c[] = {
+          T(0.999995629605181147244L), T(-0.332994596835989898633L), T(0.195635924736668541285L),
+          T(-0.121239070582678185857L), T(0.0574773135628882575666L), T(-0.0134804695886856006301L)};
+        return Horner(c, t);
+      }
+    };
+
+    template <>
+    struct AtanMinimax<13> // 最大相対誤差 6.5e-7
+    {
+      template <class T>
+      static T Eval(T t) noexcept
+      {
+        static constexpr T c[] = {
+          T(0.999999347829618602296L), T(-0.333265149203353306062L), T(0.19881482463229933914L),
+          T(-0.134871914545479293338L), T(0.0838711920477443638244L), T(-0.0370130021597445249738L),
+          T(0.00786337700978290068931L)};
+        return Horner(c, t);
+      }
+    };
+
+    template <>
+    struct AtanMinimax<15> // 最大相対誤差 9.9e-8
+    {
+      template <class T>
+      static T Eval(T t) noexcept
+      {
+        static constexpr T c[] = {
+          T(0.999999900990349904241L), T(-0.333319907464813286918L), T(0.199697239001623712103L),
+          T(-0.140194809223923071923L), T(0.099142928567007302728L), T(-0.05948639345537083099L),
+          T(0.0242524032781506831152L), T(-0.00469327605757344656081L)};
+        return Horner(c, t);
+      }
+    };
+
+    template <>
+    struct AtanMinimax<17> // 最大相対誤差 1.5e-8
+    {
+      template <class T>
+      static T Eval(T t) noexcept
+      {
+        static constexpr T c[] = {
+          T(0.999999984765776362696L), T(-0.333330733450955910078L), T(0.199926193925705807144L),
+          T(-0.142036444739471760402L), T(0.106409340549835363978L), T(-0.0750429460290339731774L),
+          T(0.042691520032908254409L), T(-0.0160686294315737097569L), T(0.00284988973918914032322L)};
+        return Horner(c, t);
+      }
+    };
+
+    // pi/2を上位(Hi)と下位(Lo)の和に分けた値
+    // x - k * pi/2 を (x - k * Hi) - k * Lo として計算し、範囲縮小の丸め誤差を抑える
+    template <class T>
+    struct HalfPiSplit
+    {
+      static constexpr T Hi() { return HalfPi<T>(); }
+      static constexpr T Lo() { return static_cast<T>(HalfPi<long double>() - static_cast<long double>(Hi())); }
+    };
+
+    template <>
+    struct HalfPiSplit<float>
+    {
+      static constexpr float Hi() { return 1.57079637050628662109375f; }
+      static constexpr float Lo() { return -4.37113900018624283083602485579014153e-8f; }
+    };
+
+    template <>
+    struct HalfPiSplit<double>
+    {
+      static constexpr double Hi() { return 1.5707963267948966192313216916397514; }
+      static constexpr double Lo() { return 6.12323399573676588613032966137500529e-17; }
+    };
+
+    // sin(x) ≈ x * P(x^2), cos(x) ≈ Q(x^2) (|x| <= pi/4)
+    // Order: sinの多項式の次数(cosの多項式の次数はOrder+1)
+    template <std::size_t Order>
+    struct SinCosMinimax
+    {
+      static_assert(Order >= 3 && Order <= 11 && Order % 2 == 1,
+        "Template parameter 'Order' should be an odd number in [3, 11]");
+    };
+
+    template <>
+    struct SinCosMinimax<3> // 最大相対誤差 sin: 4.1e-4, cos: 1.2e-5
+    {
+      template <class T>
+      static T EvalSin(T t) noexcept
+      {
+        static constexpr T c[] = {
+          T(0.999591574215532392895L), T(-0.161535099332044023527L)};
+        return Horner(c, t);
+      }
+      template <class T>
+      static T EvalCos(T t) noexcept
+      {
+        static constexpr T c[] = {
+          T(0.999988216921536404497L), T(-0.499685484731540062214L), T(0.0403622939442047743184L)};
+        return Horner(c, t);
+      }
+    };
+
+    template <>
+    struct SinCosMinimax<5> // 最大相対誤差 sin: 1.5e-6, cos: 3.3e-8
+    {
+      template <class T>
+      static T EvalSin(T t) noexcept
+      {
+        static constexpr T c[] = {
+          T(0.999998492887290400929L), T(-0.166623823090420369197L), T(0.00815005655681677518226L)};
+        return Horner(c, t);
+      }
+      template <class T>
+      static T EvalCos(T t) noexcept
+      {
+        static constexpr T c[] = {
+          T(0.999999967386286736236L), T(-0.499998424342130555644L), T(0.041654419561764821628L),
+          T(-0.00135794040797342578837L)};
+        return Horner(c, t);
+      }
+    };
+
+    template <>
+    struct SinCosMinimax<7> // 最大相対誤差 sin: 3.2e-9, cos: 5.6e-11
+    {
+      template <class T>
+      static T EvalSin(T t) noexcept
+      {
+        static constexpr T c[] = {
+          T(0.999999996761798005636L), T(-0.166666502242396132567L), T(0.0083320164530641167157L),
+          T(-0.000195018220136852014938L)};
+        return Horner(c, t);
+      }
+      template <class T>
+      static T EvalCos(T t) noexcept
+      {
+        static constexpr T c[] = {
+          T(0.999999999943937322117L), T(-0.499999995715568581198L), T(0.041666613233473614074L),
+          T(-0.00138865291471446501475L), T(2.43726791771161930706e-05L)};
+        return Horner(c, t);
+      }
+    };
+
+    template <>
+    struct SinCosMinimax<9> // 最大相対誤差 sin: 4.5e-12, cos: 6.6e-14
+    {
+      template <class T>
+      static T EvalSin(T t) noexcept
+      {
+        static constexpr T c[] = {
+          T(0.999999999995450351636L), T(-0.166666666304461789957L), T(0.00833332869015204367242L),
+          T(-0.000198391783558792682106L), T(2.71715281052778814898e-06L)};
+        return Horner(c, t);
+      }
+      template <class T>
+      static T EvalCos(T t) noexcept
+      {
+        static constexpr T c[] = {
+          T(0.999999999999934358009L), T(-0.499999999992712488992L), T(0.0416666665336906568833L),
+          T(-0.0013888879934257849599L), T(2.47988442279011061973e-05L), T(-2.71679791856286844597e-07L)};
+        return Horner(c, t);
+      }
+    };
+
+    template <>
+    struct SinCosMinimax<11> // 最大相対誤差 sin: 4.5e-15, cos: 5.6e-17
+    {
+      template <class T>
+      static T EvalSin(T t) noexcept
+      {
+        static constexpr T c[] = {
+          T(0.999999999999995495248L), T(-0.166666666666148926646L), T(0.00833333332364686424457L),
+          T(-0.000198412631937791115864L), T(2.75552525634137731143e-06L), T(-2.47553079087081716854e-08L)};
+        return Horner(c, t);
+      }
+      template <class T>
+      static T EvalCos(T t) noexcept
+      {
+        static constexpr T c[] = {
+          T(0.999999999999999944272L), T(-0.499999999999991524792L), T(0.0416666666664539474518L),
+          T(-0.0013888888868720733723L), T(2.48015781481449385815e-05L), T(-2.75551779544383294885e-07L),
+          T(2.06274465285017138998e-09L)};
+        return Horner(c, t);
+      }
+    };
+
+  } /* namespace Internal */
+} /* namespace MyDSP */
+
+
+#endif /* MYDSP_INTERNAL_MINIMAX_HPP_ */
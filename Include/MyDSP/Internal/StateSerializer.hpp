@@ -0,0 +1,69 @@
+/*
+ * StateSerializer.hpp
+ *
+ *  Created on: 2026/10/18
+ *      Author: Shibasaki
+ *
+ * 状態変数の保存・復元と定常状態の計算の共通処理
+ * 保存形式は状態変数の要素をそのまま並べたもので、ヘッダや型の情報は持たない
+ * (同じ型・同じサイズのフィルタの間でのみ復元できる。エンディアンや浮動小数点形式の異なる環境との互換性はない)
+ */
+
+#ifndef MYDSP_INTERNAL_STATESERIALIZER_HPP_
+#define MYDSP_INTERNAL_STATESERIALIZER_HPP_
+
+#include <type_traits>
+#include <cstddef>
+#include <cstring>
+
+namespace MyDSP
+{
+  namespace Internal
+  {
+    // 状態変数の配列とバイト列の相互変換
+    // T: 要素の型(memcpyで複製できる型に限る。Eigen::Matrixは対象外)
+    template <class T>
+    struct StateSerializer
+    {
+      static_assert(std::is_trivially_copyable<T>::value, "State snapshot requires trivially copyable state type");
+
+      // count個の要素のバイト数
+      static constexpr std::size_t Bytes(std::size_t count)
+      {
+        return sizeof(T) * count;
+      }
+
+      // bufferの位置offsetからcount個の要素を書き込み、書き込んだ後の位置を返す
+      static std::size_t Save(const T* src, std::size_t count, void* buffer, std::size_t offset)
+      {
+        std::memcpy(static_cast<unsigned char*>(buffer) + offset, src, Bytes(count));
+        return offset + Bytes(count);
+      }
+
+      // bufferの位置offsetからcount個の要素を読み込み、読み込んだ後の位置を返す
+      static std::size_t Restore(T* dst, std::size_t count, const void* buffer, std::size_t offset)
+      {
+        std::memcpy(dst, static_cast<const unsigned char*>(buffer) + offset, Bytes(count));
+        return offset + Bytes(count);
+      }
+    };
+
+    // 双二次フィルタの直流利得 (b0 + b1 + b2) / (1 - a1 - a2)
+    // z = 1に極があり利得が有限でない場合は偽を返す(gainは変更しない)
+    template <class T>
+    bool BiquadDCGain(const T &b0, const T &b1, const T &b2, const T &a1, const T &a2, T &gain)
+    {
+      const T den = T(1) - a1 - a2;
+      if (den == T())
+      {
+        return false;
+      }
+      gain = (b0 + b1 + b2) / den;
+      return true;
+    }
+
+  } /* namespace Internal */
+} /* namespace MyDSP */
+
+
+#endif /* MYDSP_INTERNAL_STATESERIALIZER_HPP_ */
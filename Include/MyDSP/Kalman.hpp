@@ -0,0 +1,634 @@
+/*
+ * Kalman.hpp
+ *
+ *  Created on: 2026/10/18
+ *      Author: Shibasaki
+ *
+ * 固定サイズの線形カルマンフィルタ
+ * KalmanFilter: 状態数NX・観測数NZが固定の1本のフィルタ。作業領域はすべて固定長の配列で、ヒープ確保はない
+ * KalmanBank  : モデル(F,H,Q,R)が共通のNumFilters本のフィルタ。状態変数をフィルタが最内となる配置(SoA)で保持し、
+ *               フィルタ方向にベクトル化する(行列の次数が小さい場合、1本ずつ処理するより大幅に速い)
+ * 共分散の更新はKalmanFormで選択する(Standard / Joseph / SquareRoot)
+ * 計算は行優先の配列で行い、Eigenが使える場合はEigen::Matrix(固定サイズ)でのモデル・状態の受け渡しもできる
+ * float/double専用
+ */
+
+#ifndef MYDSP_KALMAN_HPP_
+#define MYDSP_KALMAN_HPP_
+
+#include "Internal/InstrumentationHook.hpp"
+#include "Internal/StateSerializer.hpp"
+#include "Internal/Kernel.hpp"
+#include "Dispatch.hpp"
+#include <limits>
+#include <type_traits>
+#include <cmath>
+#include <cstddef>
+
+namespace MyDSP
+{
+  // 共分散の表現形式
+  using KalmanForm = Internal::KalmanForm;
+
+  namespace Internal
+  {
+    // 半正定値の対称行列のコレスキー分解 A = L L^T (n×n、行優先、Lは下三角で上三角は0)
+    // 丸め誤差程度の負の対角成分は0とみなす(Qなど階数落ちした共分散を許す)
+    // 半正定値でない場合は偽を返す
+    template <class T>
+    bool KalmanFactor(const T* a, T* l, std::size_t n)
+    {
+      T scale = T(0);
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        scale = (std::abs(a[i*n+i]) > scale) ? std::abs(a[i*n+i]) : scale;
+      }
+      const T tolerance = std::numeric_limits<T>::epsilon() * static_cast<T>(4 * n) * scale;
+      for (std::size_t i = 0; i < n * n; ++i)
+      {
+        l[i] = T(0);
+      }
+      for (std::size_t j = 0; j < n; ++j)
+      {
+        T d = a[j*n+j];
+        for (std::size_t k = 0; k < j; ++k)
+        {
+          d -= l[j*n+k] * l[j*n+k];
+        }
+        if (!(d >= -tolerance))
+        {
+          return false;
+        }
+        if (d <= tolerance)
+        {
+          continue; // 列jは0のまま
+        }
+        const T ljj = std::sqrt(d);
+        l[j*n+j] = ljj;
+        for (std::size_t i = j + 1; i < n; ++i)
+        {
+          T s = a[i*n+j];
+          for (std::size_t k = 0; k < j; ++k)
+          {
+            s -= l[i*n+k] * l[j*n+k];
+          }
+          l[i*n+j] = s / ljj;
+        }
+      }
+      return true;
+    }
+
+    // 下三角行列Lから P = L L^T を求める
+    template <class T>
+    void KalmanSquare(const T* l, T* p, std::size_t n)
+    {
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        for (std::size_t j = 0; j <= i; ++j)
+        {
+          T s = T(0);
+          for (std::size_t k = 0; k <= j; ++k)
+          {
+            s += l[i*n+k] * l[j*n+k];
+          }
+          p[i*n+j] = s;
+          p[j*n+i] = s;
+        }
+      }
+    }
+
+    // 共分散行列を表現形式に合わせて格納する(SquareRootの場合は分解した下三角行列)
+    // 半正定値でなければ偽を返す(dstは変更しない)
+    template <class T, KalmanForm Form, std::size_t N>
+    bool KalmanStoreCovariance(const T (&a)[N][N], T (&dst)[N][N])
+    {
+      T l[N][N];
+      if (!KalmanFactor(&a[0][0], &l[0][0], N))
+      {
+        return false;
+      }
+      for (std::size_t i = 0; i < N; ++i)
+      {
+        for (std::size_t j = 0; j < N; ++j)
+        {
+          dst[i][j] = (Form == KalmanForm::SquareRoot) ? l[i][j] : a[i][j];
+        }
+      }
+      return true;
+    }
+
+    // 単位行列
+    template <class T, std::size_t N>
+    void KalmanIdentity(T (&a)[N][N])
+    {
+      for (std::size_t i = 0; i < N; ++i)
+      {
+        for (std::size_t j = 0; j < N; ++j)
+        {
+          a[i][j] = (i == j) ? T(1) : T(0);
+        }
+      }
+    }
+
+    // 配列の複写
+    template <class T, std::size_t Rows, std::size_t Cols>
+    void KalmanCopy(const T (&src)[Rows][Cols], T (&dst)[Rows][Cols])
+    {
+      for (std::size_t i = 0; i < Rows; ++i)
+      {
+        for (std::size_t j = 0; j < Cols; ++j)
+        {
+          dst[i][j] = src[i][j];
+        }
+      }
+    }
+
+#ifdef EIGEN_WORLD_VERSION
+    // Eigen::Matrixから行優先の配列への複写
+    template <class T, std::size_t Rows, std::size_t Cols, class Derived>
+    void KalmanFromEigen(const Eigen::MatrixBase<Derived> &src, T (&dst)[Rows][Cols])
+    {
+      static_assert(Derived::RowsAtCompileTime == static_cast<int>(Rows) && Derived::ColsAtCompileTime == static_cast<int>(Cols),
+        "Matrix size mismatch");
+      for (std::size_t i = 0; i < Rows; ++i)
+      {
+        for (std::size_t j = 0; j < Cols; ++j)
+        {
+          dst[i][j] = src(static_cast<Eigen::Index>(i), static_cast<Eigen::Index>(j));
+        }
+      }
+    }
+
+#endif /* #ifdef EIGEN_WORLD_VERSION */
+  } /* namespace Internal */
+
+  // 線形カルマンフィルタ
+  // x[n+1] = F x[n] + w (w ~ N(0,Q)), z[n] = H x[n] + v (v ~ N(0,R))
+  // Predict()で1ステップ進め、観測が得られたらUpdate(z)で補正する
+  // Form: 共分散の更新方法。Josephが既定で、floatでPの条件数が大きくなる場合はSquareRootを使う
+  template <class T, std::size_t NX, std::size_t NZ, KalmanForm Form = KalmanForm::Joseph>
+  class KalmanFilter
+  {
+    static_assert(std::is_floating_point<T>::value, "Template parameter 'T' should be a floating point type");
+    static_assert(NX >= 1 && NZ >= 1, "Template parameters 'NX' and 'NZ' should be 1 or more");
+
+  protected:
+    T x[NX];
+    T P[NX][NX]; // SquareRootの場合はP = S S^Tとなる下三角行列S
+    T F[NX][NX];
+    T H[NZ][NX];
+    T Q[NX][NX]; // SquareRootの場合は分解した下三角行列
+    T R[NZ][NZ]; // SquareRootの場合は分解した下三角行列
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+    Instrumentation::Probe probe{"Kalman"}; // 計測点
+#endif
+
+  public:
+    // コンストラクタ(F = I, H = 0, Q = 0, R = I, x = 0, P = I)
+    KalmanFilter(void) :
+      x{},
+      P{},
+      F{},
+      H{},
+      Q{},
+      R{}
+    {
+      Internal::KalmanIdentity(P);
+      Internal::KalmanIdentity(F);
+      Internal::KalmanIdentity(R);
+    }
+
+    // コンストラクタ(モデルで初期化。Q,Rが半正定値でなければ既定のモデルのまま)
+    KalmanFilter(const T (&F)[NX][NX], const T (&H)[NZ][NX], const T (&Q)[NX][NX], const T (&R)[NZ][NZ]) :
+      KalmanFilter()
+    {
+      SetModel(F, H, Q, R);
+    }
+
+    // モデルの再設定
+    // Q,Rが半正定値でなければ何もせず偽を返す
+    bool SetModel(const T (&F_new)[NX][NX], const T (&H_new)[NZ][NX], const T (&Q_new)[NX][NX], const T (&R_new)[NZ][NZ])
+    {
+      T q[NX][NX];
+      T r[NZ][NZ];
+      if (!Internal::KalmanStoreCovariance<T,Form>(Q_new, q)
+        || !Internal::KalmanStoreCovariance<T,Form>(R_new, r))
+      {
+        return false;
+      }
+      Internal::KalmanCopy(F_new, F);
+      Internal::KalmanCopy(H_new, H);
+      Internal::KalmanCopy(q, Q);
+      Internal::KalmanCopy(r, R);
+      return true;
+    }
+
+    // 状態の設定
+    // P0が半正定値でなければ何もせず偽を返す
+    bool SetState(const T (&x0)[NX], const T (&P0)[NX][NX])
+    {
+      T p[NX][NX];
+      if (!Internal::KalmanStoreCovariance<T,Form>(P0, p))
+      {
+        return false;
+      }
+      for (std::size_t i = 0; i < NX; ++i)
+      {
+        x[i] = x0[i];
+      }
+      Internal::KalmanCopy(p, P);
+      return true;
+    }
+
+    // 状態の推定値の取得
+    const T (&GetState(void) const)[NX]
+    {
+      return x;
+    }
+
+    // 推定誤差の共分散の取得
+    void GetCovariance(T (&P_out)[NX][NX]) const
+    {
+      if (Form == KalmanForm::SquareRoot)
+      {
+        Internal::KalmanSquare(&P[0][0], &P_out[0][0], NX);
+      }
+      else
+      {
+        Internal::KalmanCopy(P, P_out);
+      }
+    }
+
+    // 状態変数の保存に必要なバイト数
+    static constexpr std::size_t StateBytes(void)
+    {
+      return Internal::StateSerializer<T>::Bytes(NX + NX * NX);
+    }
+
+    // 状態変数の保存(StateBytes()バイトを書き込み、その値を返す。sizeが足りなければ何もせず0を返す)
+    std::size_t SaveState(void* buffer, std::size_t size) const
+    {
+      if (size < StateBytes())
+      {
+        return 0;
+      }
+      const std::size_t offset = Internal::StateSerializer<T>::Save(x, NX, buffer, 0);
+      return Internal::StateSerializer<T>::Save(&P[0][0], NX * NX, buffer, offset);
+    }
+
+    // 状態変数の復元(同じ型のフィルタのSaveStateで保存したものを読み込み、読み込んだバイト数を返す)
+    // sizeが足りなければ何もせず0を返す
+    std::size_t RestoreState(const void* buffer, std::size_t size)
+    {
+      if (size < StateBytes())
+      {
+        return 0;
+      }
+      const std::size_t offset = Internal::StateSerializer<T>::Restore(x, NX, buffer, 0);
+      return Internal::StateSerializer<T>::Restore(&P[0][0], NX * NX, buffer, offset);
+    }
+
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+    // 計測点の取得
+    Instrumentation::Probe& GetProbe(void)
+    {
+      return probe;
+    }
+
+#endif
+    // 予測 x = F x, P = F P F^T + Q
+    void Predict(void)
+    {
+      MYDSP_INSTRUMENT_SCOPE(probe, 1);
+      // Pは行をまたいで書き込むので、先頭の行(&P[0][0])ではなく配列全体を指すポインタとして渡す
+      // (インライン展開後にGCCが先頭の行の大きさで範囲外の書き込みと誤って警告するため)
+      Internal::KalmanPredictKernel<T,1,NX,Form>(&F[0][0], &Q[0][0], x, reinterpret_cast<T*>(&P), 1);
+    }
+
+    // 観測zによる更新
+    // イノベーションの共分散H P H^T + Rが正定値でなければ状態を変更せず偽を返す
+    bool Update(const T (&z)[NZ])
+    {
+      MYDSP_INSTRUMENT_SCOPE(probe, 1);
+      T valid;
+      Internal::KalmanUpdateKernel<T,1,NX,NZ,Form>(&H[0][0], &R[0][0], z, x, reinterpret_cast<T*>(&P), &valid, 1);
+      return valid != T(0);
+    }
+
+#ifdef EIGEN_WORLD_VERSION
+    using StateVector = Eigen::Matrix<T,static_cast<int>(NX),1>;
+    using StateMatrix = Eigen::Matrix<T,static_cast<int>(NX),static_cast<int>(NX)>;
+    using MeasurementVector = Eigen::Matrix<T,static_cast<int>(NZ),1>;
+    using MeasurementMatrix = Eigen::Matrix<T,static_cast<int>(NZ),static_cast<int>(NX)>;
+    using MeasurementCovariance = Eigen::Matrix<T,static_cast<int>(NZ),static_cast<int>(NZ)>;
+
+    // コンストラクタ(Eigen::Matrixのモデルで初期化)
+    KalmanFilter(const StateMatrix &F, const MeasurementMatrix &H, const StateMatrix &Q, const MeasurementCovariance &R) :
+      KalmanFilter()
+    {
+      SetModel(F, H, Q, R);
+    }
+
+    // モデルの再設定(Eigen::Matrix)
+    bool SetModel(const StateMatrix &F_new, const MeasurementMatrix &H_new, const StateMatrix &Q_new, const MeasurementCovariance &R_new)
+    {
+      T f[NX][NX], h[NZ][NX], q[NX][NX], r[NZ][NZ];
+      Internal::KalmanFromEigen(F_new, f);
+      Internal::KalmanFromEigen(H_new, h);
+      Internal::KalmanFromEigen(Q_new, q);
+      Internal::KalmanFromEigen(R_new, r);
+      return SetModel(f, h, q, r);
+    }
+
+    // 状態の設定(Eigen::Matrix)
+    bool SetState(const StateVector &x0, const StateMatrix &P0)
+    {
+      T v[NX], p[NX][NX];
+      for (std::size_t i = 0; i < NX; ++i)
+      {
+        v[i] = x0(static_cast<Eigen::Index>(i));
+      }
+      Internal::KalmanFromEigen(P0, p);
+      return SetState(v, p);
+    }
+
+    // 観測zによる更新(Eigen::Matrix)
+    bool Update(const MeasurementVector &z)
+    {
+      T v[NZ];
+      for (std::size_t i = 0; i < NZ; ++i)
+      {
+        v[i] = z(static_cast<Eigen::Index>(i));
+      }
+      return Update(v);
+    }
+
+    // 状態の推定値の取得(Eigen::Matrix)
+    StateVector GetStateVector(void) const
+    {
+      StateVector v;
+      for (std::size_t i = 0; i < NX; ++i)
+      {
+        v(static_cast<Eigen::Index>(i)) = x[i];
+      }
+      return v;
+    }
+
+    // 推定誤差の共分散の取得(Eigen::Matrix)
+    StateMatrix GetCovarianceMatrix(void) const
+    {
+      T p[NX][NX];
+      GetCovariance(p);
+      StateMatrix m;
+      for (std::size_t i = 0; i < NX; ++i)
+      {
+        for (std::size_t j = 0; j < NX; ++j)
+        {
+          m(static_cast<Eigen::Index>(i), static_cast<Eigen::Index>(j)) = p[i][j];
+        }
+      }
+      return m;
+    }
+
+#endif /* #ifdef EIGEN_WORLD_VERSION */
+  };
+
+  // モデルが共通の線形カルマンフィルタのバンク
+  // Internal::KalmanLanes<T>::value本(floatで64本、doubleで32本)ずつのブロックにまとめ、ブロック内はフィルタが最内となる配置で保持する
+  // 予測・更新はブロックごとに全フィルタをまとめて処理し、実行時に選択した命令セットでフィルタ方向にベクトル化する
+  // 作業領域をメンバに持つため、NumFiltersが大きい場合はヒープに確保すること
+  template <class T, std::size_t NX, std::size_t NZ, std::size_t NumFilters, KalmanForm Form = KalmanForm::Joseph>
+  class KalmanBank
+  {
+    static_assert(std::is_floating_point<T>::value, "Template parameter 'T' should be a floating point type");
+    static_assert(NX >= 1 && NZ >= 1, "Template parameters 'NX' and 'NZ' should be 1 or more");
+    static_assert(NumFilters >= 1, "Template parameter 'NumFilters' should be 1 or more");
+
+  protected:
+    static constexpr std::size_t W = Internal::KalmanLanes<T>::value;
+    static constexpr std::size_t NumBlocks = (NumFilters + W - 1) / W;
+
+    T x[NumBlocks][NX][W];
+    T P[NumBlocks][NX][NX][W]; // SquareRootの場合はP = S S^Tとなる下三角行列S
+    T z[NumBlocks][NZ][W];     // 観測値の並べ替え用
+    T valid[NumBlocks][W];     // 更新の成否
+    T F[NX][NX];
+    T H[NZ][NX];
+    T Q[NX][NX];
+    T R[NZ][NZ];
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+    Instrumentation::Probe probe{"KalmanBank"}; // 計測点
+#endif
+
+    // フィルタごとの状態の書き込み(Pは表現形式に合わせて格納済みのもの)
+    void Scatter(std::size_t filter, const T (&x0)[NX], const T (&p)[NX][NX])
+    {
+      const std::size_t b = filter / W;
+      const std::size_t w = filter % W;
+      for (std::size_t i = 0; i < NX; ++i)
+      {
+        x[b][i][w] = x0[i];
+        for (std::size_t j = 0; j < NX; ++j)
+        {
+          P[b][i][j][w] = p[i][j];
+        }
+      }
+    }
+
+  public:
+    // コンストラクタ(F = I, H = 0, Q = 0, R = I, 全フィルタ x = 0, P = I)
+    KalmanBank(void) :
+      x{},
+      P{},
+      z{},
+      valid{},
+      F{},
+      H{},
+      Q{},
+      R{}
+    {
+      Internal::KalmanIdentity(F);
+      Internal::KalmanIdentity(R);
+      for (auto &block : P)
+      {
+        for (std::size_t i = 0; i < NX; ++i)
+        {
+          for (std::size_t w = 0; w < W; ++w)
+          {
+            block[i][i][w] = T(1);
+          }
+        }
+      }
+    }
+
+    // コンストラクタ(モデルで初期化。Q,Rが半正定値でなければ既定のモデルのまま)
+    KalmanBank(const T (&F)[NX][NX], const T (&H)[NZ][NX], const T (&Q)[NX][NX], const T (&R)[NZ][NZ]) :
+      KalmanBank()
+    {
+      SetModel(F, H, Q, R);
+    }
+
+    // モデルの再設定(全フィルタ共通)
+    // Q,Rが半正定値でなければ何もせず偽を返す
+    bool SetModel(const T (&F_new)[NX][NX], const T (&H_new)[NZ][NX], const T (&Q_new)[NX][NX], const T (&R_new)[NZ][NZ])
+    {
+      T q[NX][NX];
+      T r[NZ][NZ];
+      if (!Internal::KalmanStoreCovariance<T,Form>(Q_new, q)
+        || !Internal::KalmanStoreCovariance<T,Form>(R_new, r))
+      {
+        return false;
+      }
+      Internal::KalmanCopy(F_new, F);
+      Internal::KalmanCopy(H_new, H);
+      Internal::KalmanCopy(q, Q);
+      Internal::KalmanCopy(r, R);
+      return true;
+    }
+
+    // 全フィルタの状態の設定
+    // P0が半正定値でなければ何もせず偽を返す
+    bool SetState(const T (&x0)[NX], const T (&P0)[NX][NX])
+    {
+      T p[NX][NX];
+      if (!Internal::KalmanStoreCovariance<T,Form>(P0, p))
+      {
+        return false;
+      }
+      for (std::size_t filter = 0; filter < NumBlocks * W; ++filter)
+      {
+        Scatter(filter, x0, p);
+      }
+      return true;
+    }
+
+    // フィルタごとの状態の設定
+    // P0が半正定値でなければ何もせず偽を返す
+    bool SetState(std::size_t filter, const T (&x0)[NX], const T (&P0)[NX][NX])
+    {
+      T p[NX][NX];
+      if (!Internal::KalmanStoreCovariance<T,Form>(P0, p))
+      {
+        return false;
+      }
+      Scatter(filter, x0, p);
+      return true;
+    }
+
+    // フィルタごとの状態の推定値の取得
+    void GetState(std::size_t filter, T (&x_out)[NX]) const
+    {
+      const std::size_t b = filter / W;
+      const std::size_t w = filter % W;
+      for (std::size_t i = 0; i < NX; ++i)
+      {
+        x_out[i] = x[b][i][w];
+      }
+    }
+
+    // フィルタごとの推定誤差の共分散の取得
+    void GetCovariance(std::size_t filter, T (&P_out)[NX][NX]) const
+    {
+      const std::size_t b = filter / W;
+      const std::size_t w = filter % W;
+      T p[NX][NX];
+      for (std::size_t i = 0; i < NX; ++i)
+      {
+        for (std::size_t j = 0; j < NX; ++j)
+        {
+          p[i][j] = P[b][i][j][w];
+        }
+      }
+      if (Form == KalmanForm::SquareRoot)
+      {
+        Internal::KalmanSquare(&p[0][0], &P_out[0][0], NX);
+      }
+      else
+      {
+        Internal::KalmanCopy(p, P_out);
+      }
+    }
+
+    // 状態変数の保存に必要なバイト数(全フィルタ分)
+    static constexpr std::size_t StateBytes(void)
+    {
+      return Internal::StateSerializer<T>::Bytes(NumBlocks * W * (NX + NX * NX));
+    }
+
+    // 全フィルタの状態変数の保存(StateBytes()バイトを書き込み、その値を返す。sizeが足りなければ何もせず0を返す)
+    std::size_t SaveState(void* buffer, std::size_t size) const
+    {
+      if (size < StateBytes())
+      {
+        return 0;
+      }
+      const std::size_t offset = Internal::StateSerializer<T>::Save(&x[0][0][0], NumBlocks * NX * W, buffer, 0);
+      return Internal::StateSerializer<T>::Save(&P[0][0][0][0], NumBlocks * NX * NX * W, buffer, offset);
+    }
+
+    // 全フィルタの状態変数の復元(同じ型のバンクのSaveStateで保存したものを読み込み、読み込んだバイト数を返す)
+    // sizeが足りなければ何もせず0を返す
+    std::size_t RestoreState(const void* buffer, std::size_t size)
+    {
+      if (size < StateBytes())
+      {
+        return 0;
+      }
+      const std::size_t offset = Internal::StateSerializer<T>::Restore(&x[0][0][0], NumBlocks * NX * W, buffer, 0);
+      return Internal::StateSerializer<T>::Restore(&P[0][0][0][0], NumBlocks * NX * NX * W, buffer, offset);
+    }
+
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+    // 計測点の取得
+    Instrumentation::Probe& GetProbe(void)
+    {
+      return probe;
+    }
+
+#endif
+    // 全フィルタの予測
+    void Predict(void)
+    {
+      MYDSP_INSTRUMENT_SCOPE(probe, NumFilters);
+      KalmanPredictBlock<NX,Form>(&F[0][0], &Q[0][0], &x[0][0][0], &P[0][0][0][0], NumBlocks);
+    }
+
+    // 全フィルタの観測による更新
+    // measurements: [filter][NZ]の配置の観測値
+    // updated: nullptrでなければ、フィルタごとに更新できたかを書き込む(NumFilters要素)
+    // 更新できたフィルタの数を返す(イノベーションの共分散が正定値でないフィルタは状態を変更しない)
+    std::size_t Update(const T* measurements, bool* updated = nullptr)
+    {
+      MYDSP_INSTRUMENT_SCOPE(probe, NumFilters);
+      for (std::size_t filter = 0; filter < NumFilters; ++filter)
+      {
+        for (std::size_t i = 0; i < NZ; ++i)
+        {
+          z[filter / W][i][filter % W] = measurements[filter * NZ + i];
+        }
+      }
+      KalmanUpdateBlock<NX,NZ,Form>(&H[0][0], &R[0][0], &z[0][0][0], &x[0][0][0], &P[0][0][0][0], &valid[0][0], NumBlocks);
+
+      std::size_t count = 0;
+      for (std::size_t filter = 0; filter < NumFilters; ++filter)
+      {
+        const bool ok = valid[filter / W][filter % W] != T(0);
+        count += ok ? 1u : 0u;
+        if (updated != nullptr)
+        {
+          updated[filter] = ok;
+        }
+      }
+      return count;
+    }
+  };
+
+  template <class T, std::size_t NX, std::size_t NZ, std::size_t NumFilters, KalmanForm Form>
+  constexpr std::size_t KalmanBank<T,NX,NZ,NumFilters,Form>::W;
+  template <class T, std::size_t NX, std::size_t NZ, std::size_t NumFilters, KalmanForm Form>
+  constexpr std::size_t KalmanBank<T,NX,NZ,NumFilters,Form>::NumBlocks;
+
+} /* namespace MyDSP */
+
+
+#endif /* MYDSP_KALMAN_HPP_ */
@@ -12,6 +12,7 @@
 
 #include "Const.hpp"
 #include "Internal/LUT.hpp"
+#include "Internal/Minimax.hpp"
 #include "BranchPrediction.hpp"
 #include <type_traits>
 #include <cmath>
@@ -80,6 +81,38 @@ namespace MyDSP
     : 0 ;
   }
 
+  // ミニマックス多項式によるatan(x)の近似
+  // Order: 多項式の次数(3から17までの奇数)。Atan<9>(x)のように次数を指定して呼び出す
+  // |x| > 1 の場合は atan(x) = ±pi/2 - atan(1/x) を用いる
+  template <std::size_t Order, class T>
+  static inline auto Atan(T x) noexcept
+    -> typename std::enable_if<std::is_floating_point<T>::value,T>::type
+  {
+    const T a = std::fabs(x);
+    const bool inverse = a > 1;
+    const T t = inverse ? 1 / a : a;
+    const T p = t * Internal::AtanMinimax<Order>::Eval(t * t);
+    return std::copysign(inverse ? HalfPi<T>() - p : p, x);
+  }
+
+  // ミニマックス多項式によるatan2(y,x)の近似
+  // Order: 多項式の次数(3から17までの奇数)
+  // 引数の絶対値の小さい方を大きい方で割って[0 1]に収めてから評価する
+  template <std::size_t Order, class T>
+  static inline auto Atan2(T y, T x) noexcept
+    -> typename std::enable_if<std::is_floating_point<T>::value,T>::type
+  {
+    const T ax = std::fabs(x);
+    const T ay = std::fabs(y);
+    const T num = (ax < ay) ? ax : ay;
+    const T den = (ax < ay) ? ay : ax;
+    const T t = (den > 0) ? num / den : T(0);
+    T r = t * Internal::AtanMinimax<Order>::Eval(t * t);
+    r = (ay > ax) ? HalfPi<T>() - r : r;
+    r = std::signbit(x) ? Pi<T>() - r : r;
+    return std::copysign(r, y);
+  }
+
   // 平方根
   // 基本的にはcmathで定義されたものをそのまま呼び出す
   // コンパイル時に実行できるかどうかは環境依存
@@ -176,6 +209,37 @@ namespace MyDSP
     *p_cos_val = (1.0f-fract)*c1 + fract*c2;
   }
 
+  // ミニマックス多項式によるsin(theta),cos(theta)の近似計算
+  // Order: sinの多項式の次数(3から11までの奇数)。SinCos<7>(theta, &s, &c)のように次数を指定して呼び出す
+  // pi/2の整数倍を差し引いて[-pi/4 +pi/4]に帰着させるため、入力範囲は[-pi +pi]に限らない
+  // (ただし|theta|が大きくなるほど帰着の誤差が増える。|theta|はintの範囲に収まる値であること)
+  template <std::size_t Order, class T>
+  static inline auto SinCos(
+    const T theta,
+    T * p_sin_val,
+    T * p_cos_val) noexcept
+    -> typename std::enable_if<std::is_floating_point<T>::value,void>::type
+  {
+    // pi/2を上位と下位に分けて帰着の丸め誤差を抑える
+    constexpr T half_pi_hi = Internal::HalfPiSplit<T>::Hi();
+    constexpr T half_pi_lo = Internal::HalfPiSplit<T>::Lo();
+
+    const T fk = theta * (2 / Pi<T>());
+    const int k = static_cast<int>(fk + ((fk >= 0) ? T(0.5) : T(-0.5)));
+    const T r = (theta - k * half_pi_hi) - k * half_pi_lo;
+    const T t = r * r;
+
+    const T s = r * Internal::SinCosMinimax<Order>::EvalSin(t);
+    const T c = Internal::SinCosMinimax<Order>::EvalCos(t);
+
+    // 象限に応じてsinとcosを入れ替え、符号を反転する
+    const unsigned quadrant = static_cast<unsigned>(k) & 3u;
+    const T a = (quadrant & 1u) ? c : s;
+    const T b = (quadrant & 1u) ? s : c;
+    *p_sin_val = (quadrant & 2u) ? -a : a;
+    *p_cos_val = ((quadrant + 1u) & 2u) ? -b : b;
+  }
+
 } /* namespace MyDSP */
 
 
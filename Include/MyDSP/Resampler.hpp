@@ -0,0 +1,273 @@
+/*
+ * Resampler.hpp
+ *
+ *  Created on: 2026/10/18
+ *      Author: Shibasaki
+ *
+ * 任意比のリサンプラ
+ * 原型の低域通過フィルタ(Kaiser窓を掛けたsinc)をPhases個の位相に分けたポリフェーズフィルタバンクと、
+ * 位相の間を3次のLagrange補間でつなぐFarrow構造を組み合わせ、有理数でない比や時間変化する比の変換に対応する
+ * 係数はコンパイル時に設計し、実行時の処理は出力1サンプルあたりタップ数の4倍の積和になる
+ * float/double専用
+ */
+
+#ifndef MYDSP_RESAMPLER_HPP_
+#define MYDSP_RESAMPLER_HPP_
+
+#include "Internal/InstrumentationHook.hpp"
+#include "Internal/IndexSequence.hpp"
+#include "Internal/Kernel.hpp"
+#include "Dispatch.hpp"
+#include "Const.hpp"
+#include <type_traits>
+#include <cmath>
+#include <cstddef>
+
+namespace MyDSP
+{
+  namespace Internal
+  {
+    // 原型フィルタの設計で目標とする阻止域減衰量(dB)
+    constexpr long double resampler_attenuation = 100.0L;
+
+    // sin(y)のマクローリン展開の第k項以降の和(term: 第k項, y2: y^2)
+    constexpr long double SinSeries(long double y2, long double term, int k)
+    {
+      return (term < 1e-24L && term > -1e-24L) ? term
+      :      term + SinSeries(y2, -term * y2 / ((2 * k) * (2 * k + 1)), k + 1) ;
+    }
+
+    // sin(πx)(xに最も近い整数kを引いて|x-k| <= 1/2に収めてから展開する)
+    constexpr long double SinPiReduced(long double r, long long k)
+    {
+      return ((k % 2 == 0) ? 1.0L : -1.0L) * SinSeries(Pi<long double>() * Pi<long double>() * r * r, Pi<long double>() * r, 1);
+    }
+
+    constexpr long double SinPi(long double x)
+    {
+      return SinPiReduced(x - static_cast<long long>(x < 0 ? x - 0.5L : x + 0.5L), static_cast<long long>(x < 0 ? x - 0.5L : x + 0.5L));
+    }
+
+    // 正規化sinc関数 sin(πx)/(πx)
+    constexpr long double Sinc(long double x)
+    {
+      return (x == 0) ? 1.0L : SinPi(x) / (Pi<long double>() * x);
+    }
+
+    // 0次の第1種変形ベッセル関数のべき級数 Σ (x^2/4)^k / (k!)^2 の第k項以降の和(q: x^2/4)
+    constexpr long double BesselI0Series(long double q, long double term, int k)
+    {
+      return (term < 1e-24L) ? term : term + BesselI0Series(q, term * q / (k * k), k + 1);
+    }
+
+    // I0(sqrt(x2))
+    constexpr long double BesselI0FromSquare(long double x2)
+    {
+      return BesselI0Series(x2 / 4, 1.0L, 1);
+    }
+
+    // 阻止域減衰量a(dB)を満たすKaiser窓のβ(a > 50)
+    constexpr long double KaiserBeta(long double a)
+    {
+      return 0.1102L * (a - 8.7L);
+    }
+
+    // Kaiser窓の長さがtaps入力サンプルのときの遷移帯域幅(入力のサンプリング周波数で正規化)
+    constexpr long double KaiserTransitionWidth(long double a, std::size_t taps)
+    {
+      return (a - 7.95L) / (2.285L * TwoPi<long double>() * static_cast<long double>(taps));
+    }
+
+    // 原型フィルタのカットオフ周波数(阻止域端から遷移帯域幅の半分だけ下げる)
+    constexpr long double ResamplerCutoff(std::size_t taps, std::size_t stopband_permille)
+    {
+      return static_cast<long double>(stopband_permille) / 1000.0L - KaiserTransitionWidth(resampler_attenuation, taps) / 2;
+    }
+
+    // 原型フィルタのインパルス応答 h(u) (u: 入力サンプル単位の時刻、台は[0 taps])
+    // 入力サンプル間隔で標本化した値の和がほぼ1になるよう正規化している
+    constexpr long double ResamplerPrototype(long double u, std::size_t taps, long double cutoff, long double beta)
+    {
+      return (u <= 0 || u >= static_cast<long double>(taps)) ? 0.0L
+      :      2 * cutoff * Sinc(2 * cutoff * (u - static_cast<long double>(taps) / 2))
+               * BesselI0FromSquare(beta * beta * (1 - (2 * u / taps - 1) * (2 * u / taps - 1)))
+               / BesselI0FromSquare(beta * beta) ;
+    }
+
+    // 原型フィルタを入力サンプル間隔の1/Phasesで標本化した値
+    // values[j+1] = h(j/Phases) (j: -1からTaps*Phases+1まで。両端は3次補間の端点用)
+    template <std::size_t Taps, std::size_t Phases, std::size_t StopbandPermille>
+    struct ResamplerPrototypeTable
+    {
+      long double values[Taps*Phases+3];
+      template <std::size_t... Seq>
+      constexpr ResamplerPrototypeTable(IndexSequence<Seq...>) :
+        values{ResamplerPrototype((static_cast<long double>(Seq) - 1) / Phases, Taps,
+          ResamplerCutoff(Taps, StopbandPermille), KaiserBeta(resampler_attenuation))...}
+      {}
+      constexpr ResamplerPrototypeTable() :
+        ResamplerPrototypeTable(MakeIndexSequence<Taps*Phases+3>())
+      {}
+    };
+
+    // 4点(y0: 位置-1, y1: 0, y2: 1, y3: 2)を通る3次のLagrange補間多項式の、位置muについてのm次の係数
+    constexpr long double LagrangeCubicCoeff(std::size_t m, long double y0, long double y1, long double y2, long double y3)
+    {
+      return (m == 0) ? y1
+      :      (m == 1) ? -y0 / 3 - y1 / 2 + y2 - y3 / 6
+      :      (m == 2) ? y0 / 2 - y1 + y2 / 2
+      :      -y0 / 6 + y1 / 2 - y2 / 2 + y3 / 6 ;
+    }
+
+    // Farrow構造の係数表のi番目の値([phase][m][k]。kはタップを古いサンプルから数えた番号)
+    // 位相p、位相内の位置muでのタップk(最新からtaps-1-k個前の入力)の係数は h(taps-1-k + (p + mu)/phases)
+    template <std::size_t Taps, std::size_t Phases>
+    constexpr long double ResamplerFarrowCoeff(const long double (&h)[Taps*Phases+3], std::size_t i)
+    {
+      return LagrangeCubicCoeff((i / Taps) % 4,
+        h[(Taps - 1 - i % Taps) * Phases + i / (4 * Taps) + 0],
+        h[(Taps - 1 - i % Taps) * Phases + i / (4 * Taps) + 1],
+        h[(Taps - 1 - i % Taps) * Phases + i / (4 * Taps) + 2],
+        h[(Taps - 1 - i % Taps) * Phases + i / (4 * Taps) + 3]);
+    }
+
+    // Farrow構造の係数表
+    template <class T, std::size_t Taps, std::size_t Phases, std::size_t StopbandPermille>
+    struct ResamplerCoeffsImpl
+    {
+      T values[Phases*4*Taps];
+      template <std::size_t... Seq>
+      constexpr ResamplerCoeffsImpl(ResamplerPrototypeTable<Taps,Phases,StopbandPermille>&& table, IndexSequence<Seq...>) :
+        values{static_cast<T>(ResamplerFarrowCoeff<Taps,Phases>(table.values, Seq))...}
+      {}
+      constexpr ResamplerCoeffsImpl() :
+        ResamplerCoeffsImpl(ResamplerPrototypeTable<Taps,Phases,StopbandPermille>(), MakeIndexSequence<Phases*4*Taps>())
+      {}
+    };
+
+    // 係数表の実体
+    template <class T, std::size_t Taps, std::size_t Phases, std::size_t StopbandPermille>
+    struct ResamplerCoeffs
+    {
+      static constexpr ResamplerCoeffsImpl<T,Taps,Phases,StopbandPermille> instance{};
+      static constexpr auto& values = instance.values;
+    };
+    template <class T, std::size_t Taps, std::size_t Phases, std::size_t StopbandPermille>
+    constexpr ResamplerCoeffsImpl<T,Taps,Phases,StopbandPermille> ResamplerCoeffs<T,Taps,Phases,StopbandPermille>::instance;
+
+  } /* namespace Internal */
+
+  // リサンプラのブロック処理の結果
+  struct ResamplerResult
+  {
+    std::size_t consumed; // 使った入力のサンプル数
+    std::size_t produced; // 出力したサンプル数
+  };
+
+  // 任意比のリサンプラ
+  // Taps: 1位相あたりのタップ数(16の倍数)。原型フィルタの長さ(入力サンプル単位)で、遷移帯域幅はおよそ6.4/Taps
+  // Phases: 位相の数。位相の間は3次補間するので、32程度で補間誤差は阻止域減衰量より十分小さくなる
+  // StopbandPermille: 阻止域端の周波数(入力のサンプリング周波数に対する千分率)
+  //   既定値の500は入力のナイキスト周波数で、アップサンプリングと比が1に近い変換向け
+  //   ダウンサンプリングでは出力のナイキスト周波数(比×500)以下にする
+  // 出力は入力からTaps/2サンプル(入力サンプル単位)遅れる
+  template <class T, std::size_t Taps = 64, std::size_t Phases = 32, std::size_t StopbandPermille = 500>
+  class ArbitraryResampler
+  {
+    static_assert(std::is_floating_point<T>::value, "Template parameter 'T' should be a floating point type");
+    static_assert(Taps >= 16 && Taps % 16 == 0, "Template parameter 'Taps' should be a multiple of 16");
+    static_assert(Phases >= 2, "Template parameter 'Phases' should be 2 or more");
+    static_assert(StopbandPermille > 0 && StopbandPermille <= 1000, "Template parameter 'StopbandPermille' should be in (0 1000]");
+    static_assert(Internal::ResamplerCutoff(Taps, StopbandPermille) > 0,
+      "Template parameter 'Taps' is too small for the stopband frequency");
+
+  public:
+    static constexpr std::size_t NumTaps = Taps;
+    static constexpr std::size_t NumPhases = Phases;
+    static constexpr std::size_t Delay = Taps / 2; // 入力サンプル単位の遅延
+
+  protected:
+    using Coeffs = Internal::ResamplerCoeffs<T,Taps,Phases,StopbandPermille>;
+
+    T state[Taps*2];           // リングバッファの代わりにタップ長の2倍の長さの領域を使用
+    std::size_t state_top;     // ディレイラインの最古の位置
+    double position;           // 次の出力の時刻(最新の入力サンプルからの経過、入力サンプル単位)
+    double step;               // 出力1サンプルあたりの入力サンプル数
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+    Instrumentation::Probe probe{"ArbitraryResampler"}; // 計測点
+#endif
+
+  public:
+    // コンストラクタ
+    // ratio: 出力と入力のサンプリング周波数の比(出力/入力、正の値)
+    explicit ArbitraryResampler(double ratio = 1.0) :
+      state{},
+      state_top(0),
+      position(1.0),
+      step(1.0 / ratio)
+    {}
+
+    // 状態変数の初期化
+    void Clear(void)
+    {
+      for (auto &element : state)
+      {
+        element = T();
+      }
+      state_top = 0;
+      position = 1.0;
+    }
+
+    // 変換比(出力/入力)の設定
+    // クロックのずれの追従などでブロックごとに変更してよい(次の出力から新しい比で進む)
+    void SetRatio(double ratio)
+    {
+      step = 1.0 / ratio;
+    }
+
+    // 変換比(出力/入力)の取得
+    double GetRatio(void) const
+    {
+      return 1.0 / step;
+    }
+
+    // in_length個の入力を全て使うために必要な出力領域の大きさ(上限)
+    std::size_t MaxOutputLength(std::size_t in_length) const
+    {
+      const double count = std::floor((static_cast<double>(in_length) + 1.0 - position) / step) + 1.0;
+      return (count > 0) ? static_cast<std::size_t>(count) : 0;
+    }
+
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+    // 計測点の取得
+    Instrumentation::Probe& GetProbe(void)
+    {
+      return probe;
+    }
+
+#endif
+    // ブロック処理
+    // 出力がout_length個に達するか、入力を使い切るまで処理する
+    // 使われなかった入力は、次の呼び出しで先頭から渡し直す
+    ResamplerResult Process(const T* in, std::size_t in_length, T* out, std::size_t out_length)
+    {
+      MYDSP_INSTRUMENT_SCOPE(probe, in_length);
+      ResamplerResult result;
+      result.produced = ResampleBlock<T>(Coeffs::values, Taps, Phases, state, state_top, position, step,
+        in, in_length, result.consumed, out, out_length);
+      return result;
+    }
+
+  };
+
+  template <class T, std::size_t Taps, std::size_t Phases, std::size_t StopbandPermille>
+  constexpr std::size_t ArbitraryResampler<T,Taps,Phases,StopbandPermille>::NumTaps;
+  template <class T, std::size_t Taps, std::size_t Phases, std::size_t StopbandPermille>
+  constexpr std::size_t ArbitraryResampler<T,Taps,Phases,StopbandPermille>::NumPhases;
+  template <class T, std::size_t Taps, std::size_t Phases, std::size_t StopbandPermille>
+  constexpr std::size_t ArbitraryResampler<T,Taps,Phases,StopbandPermille>::Delay;
+
+} /* namespace MyDSP */
+
+
+#endif /* MYDSP_RESAMPLER_HPP_ */
@@ -0,0 +1,406 @@
+/*
+ * STFT.hpp
+ *
+ *  Created on: 2026/10/18
+ *      Author: Shibasaki
+ *
+ * ストリーミング短時間フーリエ変換
+ * STFT       : 任意の長さのサンプル列を受け付け、Hopサンプルごとに長さFrameSizeの窓を掛けたフレームのスペクトルを出力する
+ * InverseSTFT: スペクトルのフレーム列から重畳加算(窓の2乗和で正規化)でサンプル列を復元する
+ * 実数のフレーム2つを1回の複素FFTでまとめて変換する
+ * 作業領域はすべてメンバ配列で持ち、構築後にメモリ確保は行わない
+ * float/double専用
+ */
+
+#ifndef MYDSP_STFT_HPP_
+#define MYDSP_STFT_HPP_
+
+#include "Internal/IndexSequence.hpp"
+#include "Internal/InstrumentationHook.hpp"
+#include "Internal/LUT.hpp"
+#include "FFT.hpp"
+#include <complex>
+#include <type_traits>
+#include <cmath>
+#include <cstddef>
+
+namespace MyDSP
+{
+  // 窓関数の種類(いずれもDFT用の周期的な窓)
+  enum class WindowType
+  {
+    Rectangular,
+    Hann,
+    Hamming,
+    Blackman,
+  };
+
+  namespace Internal
+  {
+    // 窓関数の値
+    // c1: cos(2πn/N), c2: cos(4πn/N)
+    constexpr long double WindowValue(WindowType type, long double c1, long double c2)
+    {
+      return (type == WindowType::Hann)     ? 0.5L - 0.5L * c1
+      :      (type == WindowType::Hamming)  ? 0.54L - 0.46L * c1
+      :      (type == WindowType::Blackman) ? 0.42L - 0.5L * c1 + 0.08L * c2
+      :      1.0L ;
+    }
+
+    // 三角関数テーブルから長さNの窓関数をコンパイル時に生成する
+    template <class T, std::size_t N, WindowType Type>
+    struct WindowTableImpl
+    {
+      T values[N];
+      template <std::size_t... Seq>
+      constexpr WindowTableImpl(SinCosTableGenerator<long double,N,N-1>&& table, IndexSequence<Seq...>) :
+        values{static_cast<T>(WindowValue(Type, table.cos_vals[Seq], table.cos_vals[(2*Seq)%N]))...}
+      {}
+      constexpr WindowTableImpl() :
+        WindowTableImpl(SinCosTableGenerator<long double,N,N-1>(), MakeIndexSequence<N>())
+      {}
+    };
+
+    // 窓関数テーブルの実体
+    template <class T, std::size_t N, WindowType Type>
+    struct WindowTable
+    {
+      static constexpr WindowTableImpl<T,N,Type> instance{};
+      static constexpr auto& values = instance.values;
+    };
+    template <class T, std::size_t N, WindowType Type>
+    constexpr WindowTableImpl<T,N,Type> WindowTable<T,N,Type>::instance;
+
+  } /* namespace Internal */
+
+  // ストリーミング短時間フーリエ変換
+  // 最初のフレームはFrameSizeサンプル入力した時点で、以降はHopサンプルごとに出力する
+  // スペクトルは正規化しない(X[k] = Σ w[n] x[n] exp(-j2πkn/N))
+  template <class T, std::size_t FrameSize, std::size_t Hop, WindowType Window = WindowType::Hann>
+  class STFT
+  {
+    static_assert(std::is_floating_point<T>::value, "Template parameter 'T' should be a floating point type");
+    static_assert(Hop > 0 && Hop <= FrameSize, "Template parameter 'Hop' should be in [1 FrameSize]");
+
+  public:
+    static constexpr std::size_t NumBins = FrameSize / 2 + 1;
+
+  protected:
+    using Transform = FFT<T,FrameSize>;
+    using WindowValues = Internal::WindowTable<T,FrameSize,Window>;
+
+    Transform transform;      // FFT(作業領域を含む)
+    T ring[FrameSize];        // 直近FrameSizeサンプルのリングバッファ
+    T work_re[FrameSize];     // 変換の作業領域(1つ目のフレーム)
+    T work_im[FrameSize];     // 変換の作業領域(2つ目のフレーム)
+    T spec_re[2][NumBins];    // 変換結果(1つ目と2つ目のフレーム)
+    T spec_im[2][NumBins];
+    std::size_t ring_top;     // リングバッファの最古の位置(次に書き込む位置)
+    std::size_t countdown;    // 次のフレームまでのサンプル数
+    std::size_t current;      // 呼び出し側に見せているフレーム(0 or 1)
+    bool pending;             // work_reに変換待ちのフレームがあるか
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+    Instrumentation::Probe probe{"STFT"}; // 計測点
+#endif
+
+  public:
+    STFT(void) :
+      transform(),
+      ring{},
+      work_re{},
+      work_im{},
+      spec_re{},
+      spec_im{},
+      ring_top(0),
+      countdown(FrameSize),
+      current(0),
+      pending(false)
+    {}
+
+    // 状態変数の初期化
+    void Clear(void)
+    {
+      for (auto &element : ring)
+      {
+        element = T();
+      }
+      ring_top = 0;
+      countdown = FrameSize;
+      current = 0;
+      pending = false;
+    }
+
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+    // 計測点の取得
+    Instrumentation::Probe& GetProbe(void)
+    {
+      return probe;
+    }
+
+#endif
+    // ブロック処理
+    // 任意の長さのサンプル列を受け付け、フレームが完成するたびにon_frame(*this)を呼び出す
+    // 1回の呼び出しの中で完成したフレームは2つずつまとめて変換する(on_frameの呼び出しはフレームの順)
+    // 戻り値は出力したフレームの数
+    template <class Callback>
+    std::size_t Process(const T* in, std::size_t length, Callback&& on_frame)
+    {
+      MYDSP_INSTRUMENT_SCOPE(probe, length);
+      std::size_t num_frames = 0;
+      std::size_t pos = 0;
+      while (pos < length)
+      {
+        const std::size_t n = (length - pos < countdown) ? length - pos : countdown;
+        Push(in + pos, n);
+        pos += n;
+        countdown -= n;
+        if (countdown > 0)
+        {
+          continue;
+        }
+        countdown = Hop;
+        if (!pending)
+        {
+          LoadFrame(work_re);
+          pending = true;
+          continue;
+        }
+        LoadFrame(work_im);
+        transform.Forward(work_re, work_im);
+        Transform::SplitRealPair(work_re, work_im, spec_re[0], spec_im[0], spec_re[1], spec_im[1]);
+        pending = false;
+        for (current = 0; current < 2; ++current)
+        {
+          on_frame(static_cast<const STFT&>(*this));
+        }
+        current = 1;
+        num_frames += 2;
+      }
+      // 対にならなかったフレームは単独で変換する
+      if (pending)
+      {
+        for (auto &element : work_im)
+        {
+          element = T();
+        }
+        transform.Forward(work_re, work_im);
+        for (std::size_t k = 0; k < NumBins; ++k)
+        {
+          spec_re[0][k] = work_re[k];
+          spec_im[0][k] = work_im[k];
+        }
+        pending = false;
+        current = 0;
+        on_frame(static_cast<const STFT&>(*this));
+        ++num_frames;
+      }
+      return num_frames;
+    }
+
+    // 直近のフレームの実部
+    const T (&GetReal(void) const)[NumBins]
+    {
+      return spec_re[current];
+    }
+
+    // 直近のフレームの虚部
+    const T (&GetImag(void) const)[NumBins]
+    {
+      return spec_im[current];
+    }
+
+    // 直近のフレームのk番目のビン
+    std::complex<T> GetBin(std::size_t k) const
+    {
+      return std::complex<T>(spec_re[current][k], spec_im[current][k]);
+    }
+
+    // 直近のフレームのパワー(|X|^2)
+    void GetPower(T (&out)[NumBins]) const
+    {
+      const T* re = spec_re[current];
+      const T* im = spec_im[current];
+      for (std::size_t k = 0; k < NumBins; ++k)
+      {
+        out[k] = re[k] * re[k] + im[k] * im[k];
+      }
+    }
+
+    // 直近のフレームの振幅(|X|)
+    void GetMagnitude(T (&out)[NumBins]) const
+    {
+      GetPower(out);
+      for (std::size_t k = 0; k < NumBins; ++k)
+      {
+        out[k] = std::sqrt(out[k]);
+      }
+    }
+
+  protected:
+    // リングバッファへの書き込み(n <= FrameSize)
+    void Push(const T* in, std::size_t n)
+    {
+      const std::size_t first = (n < FrameSize - ring_top) ? n : FrameSize - ring_top;
+      for (std::size_t i = 0; i < first; ++i)
+      {
+        ring[ring_top+i] = in[i];
+      }
+      for (std::size_t i = first; i < n; ++i)
+      {
+        ring[i-first] = in[i];
+      }
+      ring_top = (ring_top + n) % FrameSize;
+    }
+
+    // リングバッファから古い順に取り出し、窓を掛けてdstへ書き込む
+    void LoadFrame(T* dst) const
+    {
+      const T* w = WindowValues::values;
+      const std::size_t first = FrameSize - ring_top;
+      for (std::size_t i = 0; i < first; ++i)
+      {
+        dst[i] = ring[ring_top+i] * w[i];
+      }
+      for (std::size_t i = 0; i < ring_top; ++i)
+      {
+        dst[first+i] = ring[i] * w[first+i];
+      }
+    }
+  };
+
+  template <class T, std::size_t FrameSize, std::size_t Hop, WindowType Window>
+  constexpr std::size_t STFT<T,FrameSize,Hop,Window>::NumBins;
+
+  // 逆短時間フーリエ変換(重畳加算)
+  // 合成にも同じ窓を掛け、重なり合う窓の2乗和で正規化する
+  // STFTの出力をそのまま与えると、1フレームあたりHopサンプルを元の入力と同じ位置から復元する
+  // (ただし先頭のFrameSize-Hopサンプルは窓の重なりが揃わないため正しく復元されない)
+  template <class T, std::size_t FrameSize, std::size_t Hop, WindowType Window = WindowType::Hann>
+  class InverseSTFT
+  {
+    static_assert(std::is_floating_point<T>::value, "Template parameter 'T' should be a floating point type");
+    static_assert(Hop > 0 && Hop <= FrameSize, "Template parameter 'Hop' should be in [1 FrameSize]");
+
+  public:
+    static constexpr std::size_t NumBins = FrameSize / 2 + 1;
+
+  protected:
+    using Transform = FFT<T,FrameSize>;
+    using WindowValues = Internal::WindowTable<T,FrameSize,Window>;
+
+    Transform transform;  // FFT(作業領域を含む)
+    T ola[FrameSize];     // 重畳加算のリングバッファ
+    T work_re[FrameSize];
+    T work_im[FrameSize];
+    T inv_norm[Hop];      // 1 / (窓の2乗和 * FrameSize)
+    std::size_t ola_top;  // 次に出力する位置
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+    Instrumentation::Probe probe{"InverseSTFT"}; // 計測点
+#endif
+
+  public:
+    InverseSTFT(void) :
+      transform(),
+      ola{},
+      work_re{},
+      work_im{},
+      inv_norm{},
+      ola_top(0)
+    {
+      const T* w = WindowValues::values;
+      for (std::size_t i = 0; i < Hop; ++i)
+      {
+        T sum = T();
+        for (std::size_t n = i; n < FrameSize; n += Hop)
+        {
+          sum += w[n] * w[n];
+        }
+        // 窓の2乗和が0になる位置は復元できないので0を出力する
+        inv_norm[i] = (sum > T(0)) ? T(1) / (sum * static_cast<T>(FrameSize)) : T(0);
+      }
+    }
+
+    // 状態変数の初期化
+    void Clear(void)
+    {
+      for (auto &element : ola)
+      {
+        element = T();
+      }
+      ola_top = 0;
+    }
+
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+    // 計測点の取得
+    Instrumentation::Probe& GetProbe(void)
+    {
+      return probe;
+    }
+
+#endif
+    // ブロック処理
+    // re/im: [frame][NumBins]のスペクトル, out: num_frames * Hopサンプルの出力
+    // フレームは2つずつまとめて変換する
+    void Process(const T* re, const T* im, std::size_t num_frames, T* out)
+    {
+      MYDSP_INSTRUMENT_SCOPE(probe, num_frames * Hop);
+      std::size_t f = 0;
+      for (; f + 2 <= num_frames; f += 2)
+      {
+        Transform::MergeRealPair(re + f * NumBins, im + f * NumBins, re + (f + 1) * NumBins, im + (f + 1) * NumBins,
+          work_re, work_im);
+        transform.InverseUnscaled(work_re, work_im);
+        OverlapAdd(work_re, out + f * Hop);
+        OverlapAdd(work_im, out + (f + 1) * Hop);
+      }
+      if (f < num_frames)
+      {
+        const T* a_re = re + f * NumBins;
+        const T* a_im = im + f * NumBins;
+        work_re[0] = a_re[0];
+        work_im[0] = T();
+        for (std::size_t k = 1; k < FrameSize / 2; ++k)
+        {
+          work_re[k] = a_re[k];
+          work_im[k] = a_im[k];
+          work_re[FrameSize-k] = a_re[k];
+          work_im[FrameSize-k] = -a_im[k];
+        }
+        work_re[FrameSize/2] = a_re[FrameSize/2];
+        work_im[FrameSize/2] = T();
+        transform.InverseUnscaled(work_re, work_im);
+        OverlapAdd(work_re, out + f * Hop);
+      }
+    }
+
+  protected:
+    // 窓を掛けて重畳加算し、完成したHopサンプルを出力する
+    void OverlapAdd(const T* frame, T* out)
+    {
+      const T* w = WindowValues::values;
+      const std::size_t first = FrameSize - ola_top;
+      for (std::size_t i = 0; i < first; ++i)
+      {
+        ola[ola_top+i] += frame[i] * w[i];
+      }
+      for (std::size_t i = 0; i < ola_top; ++i)
+      {
+        ola[i] += frame[first+i] * w[first+i];
+      }
+      for (std::size_t i = 0; i < Hop; ++i)
+      {
+        T &element = ola[(ola_top + i) % FrameSize];
+        out[i] = element * inv_norm[i];
+        element = T();
+      }
+      ola_top = (ola_top + Hop) % FrameSize;
+    }
+  };
+
+  template <class T, std::size_t FrameSize, std::size_t Hop, WindowType Window>
+  constexpr std::size_t InverseSTFT<T,FrameSize,Hop,Window>::NumBins;
+
+} /* namespace MyDSP */
+
+
+#endif /* MYDSP_STFT_HPP_ */
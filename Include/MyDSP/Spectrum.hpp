@@ -0,0 +1,337 @@
+/*
+ * Spectrum.hpp
+ *
+ *  Created on: 2026/10/18
+ *      Author: Shibasaki
+ *
+ * 少数の周波数ビンの追跡
+ * トーン検出や商用電源周波数の監視など、必要なビンが少ない場合にFFTの代わりに使う
+ * GoertzelBank: ブロックごとに任意の周波数の成分を求める
+ * SlidingDFT  : 1サンプルごとに長さNのDFTの指定したビンを更新する
+ * どちらも周波数(ビン)が最内となる配置で保持し、ビン方向にベクトル化して処理する
+ * float/double専用
+ */
+
+#ifndef MYDSP_SPECTRUM_HPP_
+#define MYDSP_SPECTRUM_HPP_
+
+#include "Internal/InstrumentationHook.hpp"
+#include "Internal/Kernel.hpp"
+#include "Internal/LUT.hpp"
+#include "Dispatch.hpp"
+#include "Const.hpp"
+#include "Math.hpp"
+#include <complex>
+#include <type_traits>
+#include <cmath>
+#include <cstddef>
+
+namespace MyDSP
+{
+  namespace Internal
+  {
+    // exp(j2π*num/den)の実部と虚部
+    // num*sin_table_sizeがdenで割り切れる場合は正弦波テーブルの値をそのまま使い、
+    // それ以外はミニマックス多項式(倍精度)で求めて絶対値を1に正規化する
+    template <class T>
+    inline void UnitPhasor(std::size_t num, std::size_t den, T* p_cos_val, T* p_sin_val)
+    {
+      num %= den;
+      if ((num * sin_table_size) % den == 0)
+      {
+        const std::size_t index = num * sin_table_size / den;
+        *p_sin_val = SinTable<T>::values[index];
+        *p_cos_val = SinTable<T>::values[(index + sin_table_size / 4) % sin_table_size];
+        return;
+      }
+      // [-π +π]に収める
+      const double turn = static_cast<double>(num) / static_cast<double>(den);
+      const double theta = TwoPi<double>() * ((num * 2 > den) ? turn - 1.0 : turn);
+      double s, c;
+      SinCos<11>(theta, &s, &c);
+      const double norm = 1.0 / std::sqrt(s * s + c * c);
+      *p_cos_val = static_cast<T>(c * norm);
+      *p_sin_val = static_cast<T>(s * norm);
+    }
+
+    // 全てのビン番号がN未満か
+    template <std::size_t N>
+    constexpr bool BinsInRange(void)
+    {
+      return true;
+    }
+
+    template <std::size_t N, std::size_t First, std::size_t... Rest>
+    constexpr bool BinsInRange(void)
+    {
+      return (First < N) && BinsInRange<N,Rest...>();
+    }
+
+  } /* namespace Internal */
+
+  // Goertzelアルゴリズムによる複数周波数の成分の計算
+  // block_lengthサンプルごとに各周波数の成分(長さblock_lengthのDFTの1点に相当)を求める
+  // 周波数はサンプリング周波数で正規化した値(cycles/sample, [0 0.5])で指定する
+  template <class T, std::size_t NumBins>
+  class GoertzelBank
+  {
+    static_assert(std::is_floating_point<T>::value, "Template parameter 'T' should be a floating point type");
+    static_assert(NumBins > 0, "Template parameter 'NumBins' shouldn't be zero");
+
+  protected:
+    T coeffs[NumBins];   // 2cos(ω)
+    T cos_vals[NumBins]; // cos(ω)
+    T sin_vals[NumBins]; // sin(ω)
+    T s1[NumBins];       // 1サンプル前の中間値
+    T s2[NumBins];       // 2サンプル前の中間値
+    T result_re[NumBins];
+    T result_im[NumBins];
+    std::size_t block_length;
+    std::size_t count;   // 現在のブロックで処理済みのサンプル数
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+    Instrumentation::Probe probe{"GoertzelBank"}; // 計測点
+#endif
+
+  public:
+    // コンストラクタ(正規化周波数の配列とブロック長で初期化)
+    // block_lengthが0の場合は1として扱う
+    GoertzelBank(const T (&freqs)[NumBins], std::size_t block_length) :
+      coeffs{},
+      cos_vals{},
+      sin_vals{},
+      s1{},
+      s2{},
+      result_re{},
+      result_im{},
+      block_length((block_length > 0) ? block_length : 1),
+      count(0)
+    {
+      for (std::size_t bin = 0; bin < NumBins; ++bin)
+      {
+        SetFrequency(bin, freqs[bin]);
+      }
+    }
+
+    // 状態変数と結果の初期化
+    void Clear(void)
+    {
+      for (std::size_t bin = 0; bin < NumBins; ++bin)
+      {
+        s1[bin] = T();
+        s2[bin] = T();
+        result_re[bin] = T();
+        result_im[bin] = T();
+      }
+      count = 0;
+    }
+
+    // 周波数の再設定(正規化周波数)
+    // 処理中のブロックの途中で変更すると、そのブロックの結果は不定になる
+    void SetFrequency(std::size_t bin, T freq)
+    {
+      const double turn = static_cast<double>(freq) - std::floor(static_cast<double>(freq) + 0.5);
+      double s, c;
+      SinCos<11>(TwoPi<double>() * turn, &s, &c);
+      coeffs[bin] = static_cast<T>(2.0 * c);
+      cos_vals[bin] = static_cast<T>(c);
+      sin_vals[bin] = static_cast<T>(s);
+    }
+
+    // ブロック長の取得
+    std::size_t GetBlockLength(void) const
+    {
+      return block_length;
+    }
+
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+    // 計測点の取得
+    Instrumentation::Probe& GetProbe(void)
+    {
+      return probe;
+    }
+
+#endif
+    // ブロック処理
+    // 任意の長さのサンプル列を受け付け、ブロックが完了するたびにon_block(*this)を呼び出す
+    // 戻り値は完了したブロックの数
+    template <class Callback>
+    std::size_t Process(const T* in, std::size_t length, Callback&& on_block)
+    {
+      MYDSP_INSTRUMENT_SCOPE(probe, length);
+      std::size_t num_blocks = 0;
+      std::size_t pos = 0;
+      while (pos < length)
+      {
+        const std::size_t remaining = block_length - count;
+        const std::size_t n = (length - pos < remaining) ? length - pos : remaining;
+        GoertzelBlock<NumBins>(coeffs, s1, s2, in + pos, n);
+        pos += n;
+        count += n;
+        if (count == block_length)
+        {
+          FinishBlock();
+          ++num_blocks;
+          on_block(static_cast<const GoertzelBank&>(*this));
+        }
+      }
+      return num_blocks;
+    }
+
+    // ブロック処理(結果は最後に完了したブロックのものが残る)
+    std::size_t Process(const T* in, std::size_t length)
+    {
+      return Process(in, length, [](const GoertzelBank&){});
+    }
+
+    // 最後に完了したブロックの成分(位相はブロックの最後のサンプルが基準)
+    std::complex<T> GetBin(std::size_t bin) const
+    {
+      return std::complex<T>(result_re[bin], result_im[bin]);
+    }
+
+    // 最後に完了したブロックのパワー(|X|^2)
+    void GetPower(T (&out)[NumBins]) const
+    {
+      for (std::size_t bin = 0; bin < NumBins; ++bin)
+      {
+        out[bin] = result_re[bin] * result_re[bin] + result_im[bin] * result_im[bin];
+      }
+    }
+
+  protected:
+    // ブロックの結果を確定し、状態変数を初期化する
+    void FinishBlock(void)
+    {
+      for (std::size_t bin = 0; bin < NumBins; ++bin)
+      {
+        /* X = s[N-1] - exp(-jω) * s[N-2] */
+        result_re[bin] = s1[bin] - cos_vals[bin] * s2[bin];
+        result_im[bin] = sin_vals[bin] * s2[bin];
+        s1[bin] = T();
+        s2[bin] = T();
+      }
+      count = 0;
+    }
+  };
+
+  // スライディングDFT
+  // 直近Nサンプルに対する長さNのDFTのうち、ビン番号Bins...の値を1サンプルごとに更新する
+  // 回転因子の丸め誤差で値が発散しないよう、減衰係数r(<1)を掛けて更新する
+  // (直近Nサンプルにr^m (m: 経過サンプル数)の窓を掛けたDFTになる)
+  template <class T, std::size_t N, std::size_t... Bins>
+  class SlidingDFT
+  {
+    static_assert(std::is_floating_point<T>::value, "Template parameter 'T' should be a floating point type");
+    static_assert(N > 0, "Template parameter 'N' shouldn't be zero");
+    static_assert(sizeof...(Bins) > 0, "Template parameter 'Bins' shouldn't be empty");
+    static_assert(Internal::BinsInRange<N,Bins...>(), "Template parameter 'Bins' should be less than 'N'");
+
+  public:
+    static constexpr std::size_t NumBins = sizeof...(Bins);
+
+    // 減衰係数の既定値
+    static constexpr T DefaultDamping(void)
+    {
+      return static_cast<T>(0.99999);
+    }
+
+  protected:
+    T twiddle_re[NumBins];
+    T twiddle_im[NumBins];
+    T x_re[NumBins];
+    T x_im[NumBins];
+    T ring[N];
+    std::size_t ring_top;
+    T damping;
+    T damping_n;
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+    Instrumentation::Probe probe{"SlidingDFT"}; // 計測点
+#endif
+
+  public:
+    // コンストラクタ(減衰係数を指定)
+    explicit SlidingDFT(T damping = DefaultDamping()) :
+      twiddle_re{},
+      twiddle_im{},
+      x_re{},
+      x_im{},
+      ring{},
+      ring_top(0),
+      damping(damping),
+      damping_n(static_cast<T>(std::pow(static_cast<double>(damping), static_cast<double>(N))))
+    {
+      for (std::size_t i = 0; i < NumBins; ++i)
+      {
+        Internal::UnitPhasor(GetBinIndex(i), N, &twiddle_re[i], &twiddle_im[i]);
+      }
+    }
+
+    // 状態変数の初期化
+    void Clear(void)
+    {
+      for (std::size_t i = 0; i < NumBins; ++i)
+      {
+        x_re[i] = T();
+        x_im[i] = T();
+      }
+      for (auto &element : ring)
+      {
+        element = T();
+      }
+      ring_top = 0;
+    }
+
+    // i番目のビンのビン番号
+    static std::size_t GetBinIndex(std::size_t i)
+    {
+      const std::size_t bins[] = {Bins...};
+      return bins[i];
+    }
+
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+    // 計測点の取得
+    Instrumentation::Probe& GetProbe(void)
+    {
+      return probe;
+    }
+
+#endif
+    // 1サンプル分の更新
+    void operator()(const T & in)
+    {
+      MYDSP_INSTRUMENT_SCOPE(probe, 1);
+      Internal::SlidingDFTKernel<T,NumBins>(twiddle_re, twiddle_im, damping, damping_n, x_re, x_im,
+        ring, N, ring_top, &in, 1);
+    }
+
+    // ブロック処理
+    void Process(const T* in, std::size_t length)
+    {
+      MYDSP_INSTRUMENT_SCOPE(probe, length);
+      SlidingDFTBlock<NumBins>(twiddle_re, twiddle_im, damping, damping_n, x_re, x_im,
+        ring, N, ring_top, in, length);
+    }
+
+    // i番目のビンの値
+    std::complex<T> GetBin(std::size_t i) const
+    {
+      return std::complex<T>(x_re[i], x_im[i]);
+    }
+
+    // 各ビンのパワー(|X|^2)
+    void GetPower(T (&out)[NumBins]) const
+    {
+      for (std::size_t i = 0; i < NumBins; ++i)
+      {
+        out[i] = x_re[i] * x_re[i] + x_im[i] * x_im[i];
+      }
+    }
+  };
+
+  template <class T, std::size_t N, std::size_t... Bins>
+  constexpr std::size_t SlidingDFT<T,N,Bins...>::NumBins;
+
+} /* namespace MyDSP */
+
+
+#endif /* MYDSP_SPECTRUM_HPP_ */
@@ -0,0 +1,521 @@
+/*
+ * Statistics.hpp
+ *
+ *  Created on: 2026/10/18
+ *      Author: Shibasaki
+ *
+ * 移動窓の統計量
+ * MovingAverage/MovingVariance/MovingRMS: 直近Nサンプルの平均・分散・RMSを漸化式でO(1)/サンプルで求める
+ * ~Bank: 多チャネル版。状態変数をチャネルが最内となる配置(SoA)で保持し、チャネル方向にベクトル化する
+ * 丸め誤差の蓄積を抑えるため、Nサンプルごとに窓全体から和を計算し直す(float/double専用)
+ * MedianFilter: 直近Nサンプルの中央値を2つのヒープでO(log N)/サンプルで求める
+ * MovingMin/MovingMax: 直近Nサンプルの最小値・最大値を単調なdequeで償却O(1)/サンプルで求める
+ * いずれも作業領域はテンプレート引数から決まる固定長の配列で、ヒープ確保はない
+ */
+
+#ifndef MYDSP_STATISTICS_HPP_
+#define MYDSP_STATISTICS_HPP_
+
+#include "Internal/InstrumentationHook.hpp"
+#include "Internal/Kernel.hpp"
+#include "Dispatch.hpp"
+#include <functional>
+#include <type_traits>
+#include <cstddef>
+
+namespace MyDSP
+{
+  namespace Internal
+  {
+    // 移動窓の統計量
+    // 型に依存しない共通部分の実装
+    // 窓が埋まるまでは、不足分を0とみなした値を出力する
+    template <class T, std::size_t N, std::size_t NumChannels, MovingStatistic Stat>
+    class MovingStatisticsBase
+    {
+      static_assert(std::is_floating_point<T>::value, "Template parameter 'T' should be a floating point type");
+      static_assert(N > 0, "Template parameter 'N' shouldn't be zero");
+      static_assert(NumChannels > 0, "Template parameter 'NumChannels' shouldn't be zero");
+
+    protected:
+      T state[N*2][NumChannels]; // FIRBaseと同じく、リングバッファの代わりに窓長の2倍の長さの領域を使用
+      T shift[NumChannels];      // 基準値(前回の再計算時の窓の平均)
+      T sum1[NumChannels];       // 基準値を引いた値の和
+      T sum2[NumChannels];       // 基準値を引いた値の2乗和
+      std::size_t state_top;     // ディレイラインの最古の位置
+      std::size_t countdown;     // 和を計算し直すまでのサンプル数
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+      Instrumentation::Probe probe{"MovingStatistics"}; // 計測点
+#endif
+
+      MovingStatisticsBase(void) :
+        state{},
+        shift{},
+        sum1{},
+        sum2{},
+        state_top(0),
+        countdown(N)
+      {}
+
+    public:
+      // 窓長
+      static constexpr std::size_t WindowLength = N;
+
+      // 状態変数の初期化
+      void Clear(void)
+      {
+        for (auto &row : state)
+        {
+          for (auto &element : row)
+          {
+            element = T();
+          }
+        }
+        for (std::size_t ch = 0; ch < NumChannels; ++ch)
+        {
+          shift[ch] = T();
+          sum1[ch] = T();
+          sum2[ch] = T();
+        }
+        state_top = 0;
+        countdown = N;
+      }
+
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+      // 計測点の取得
+      Instrumentation::Probe& GetProbe(void)
+      {
+        return probe;
+      }
+
+#endif
+      // ブロック処理
+      // in/out: [frame][channel]の配置(インターリーブ)。inとoutは同じ領域でもよい
+      void Process(const T* in, T* out, std::size_t frames)
+      {
+        MYDSP_INSTRUMENT_SCOPE(probe, frames * NumChannels);
+        MovingStatisticsBlock<Stat>(&state[0][0], N, NumChannels, state_top, countdown, shift, sum1, sum2,
+          in, out, frames);
+      }
+
+    protected:
+      // 1フレーム分の処理(MovingStatisticsBlockと同じ手順をインライン展開して行う)
+      void Step(const T* in, T* out)
+      {
+        MovingStatisticsUpdateKernel<T,Stat,NumChannels>(&state[0][0], N, NumChannels, state_top, shift, sum1, sum2,
+          in, out, 1);
+        state_top = (state_top + 1u == N) ? 0 : state_top + 1u;
+        if (--countdown == 0)
+        {
+          MovingStatisticsRecomputeKernel<T,Stat,NumChannels>(&state[state_top][0], N, NumChannels, shift, sum1, sum2);
+          countdown = N;
+        }
+      }
+    };
+
+    template <class T, std::size_t N, std::size_t NumChannels, MovingStatistic Stat>
+    constexpr std::size_t MovingStatisticsBase<T,N,NumChannels,Stat>::WindowLength;
+
+    // 直近Nサンプルの最小値・最大値
+    // 型に依存しない共通部分の実装
+    // 単調なdeque(窓の中で、後から来たどのサンプルよりもCompareの意味で「前」にあるものだけを残す)を使う
+    // Compareがstd::lessなら最小値、std::greaterなら最大値
+    // 窓が埋まるまでは、不足分を0とみなした値を出力する
+    template <class T, std::size_t N, class Compare>
+    class MovingExtremumBase
+    {
+      static_assert(std::is_arithmetic<T>::value, "Template parameter 'T' should be an arithmetic type");
+      static_assert(N > 0, "Template parameter 'N' shouldn't be zero");
+
+    protected:
+      T values[N];             // dequeの値(リングバッファ)
+      std::size_t times[N];    // dequeの値が入力された時刻
+      std::size_t head;        // dequeの先頭の位置
+      std::size_t count;       // dequeの要素数
+      std::size_t time;        // 次のサンプルの時刻
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+      Instrumentation::Probe probe{"MovingExtremum"}; // 計測点
+#endif
+
+      MovingExtremumBase(void) :
+        values{},
+        times{},
+        head(0),
+        count(0),
+        time(0)
+      {
+        Clear();
+      }
+
+    public:
+      // 窓長
+      static constexpr std::size_t WindowLength = N;
+
+      // 状態変数の初期化
+      void Clear(void)
+      {
+        // 時刻N-1に入力された0だけを残しておくと、時刻0からN-1まで0が入力された状態と同じになる
+        values[0] = T();
+        times[0] = N - 1;
+        head = 0;
+        count = 1;
+        time = N;
+      }
+
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+      // 計測点の取得
+      Instrumentation::Probe& GetProbe(void)
+      {
+        return probe;
+      }
+
+#endif
+      // フィルタ処理本体
+      T operator()(const T & in)
+      {
+        MYDSP_INSTRUMENT_SCOPE(probe, 1);
+        return Step(in);
+      }
+
+      // ブロック処理(inとoutは同じ領域でもよい)
+      void Process(const T* in, T* out, std::size_t length)
+      {
+        MYDSP_INSTRUMENT_SCOPE(probe, length);
+        for (std::size_t n = 0; n < length; ++n)
+        {
+          out[n] = Step(in[n]);
+        }
+      }
+
+    protected:
+      // 1サンプル分の処理
+      T Step(const T & in)
+      {
+        const Compare compare{};
+        // 窓から出る先頭の要素を捨てる(要素は時刻順に並ぶので、出るのは高々1個)
+        if (time - times[head] >= N)
+        {
+          head = (head + 1u == N) ? 0 : head + 1u;
+          --count;
+        }
+        // 入力より「前」でない末尾の要素は、窓から出るまで最小(最大)値にならないので捨てる
+        while (count > 0 && !compare(values[(head + count - 1) % N], in))
+        {
+          --count;
+        }
+        const std::size_t tail = (head + count) % N;
+        values[tail] = in;
+        times[tail] = time;
+        ++count;
+        ++time;
+        return values[head];
+      }
+    };
+
+    template <class T, std::size_t N, class Compare>
+    constexpr std::size_t MovingExtremumBase<T,N,Compare>::WindowLength;
+
+  } /* namespace Internal */
+
+  // 移動平均
+  // 係数が全て1/NのFIRフィルタと同じ出力を、1サンプルあたりの加減算数回で求める
+  template <class T, std::size_t N>
+  class MovingAverage : public Internal::MovingStatisticsBase<T,N,1,Internal::MovingStatistic::Mean>
+  {
+  public:
+    // フィルタ処理本体
+    T operator()(const T & in)
+    {
+      MYDSP_INSTRUMENT_SCOPE(this->probe, 1);
+      T out = T();
+      this->Step(&in, &out);
+      return out;
+    }
+  };
+
+  // 移動分散(窓長Nで割る母分散)
+  template <class T, std::size_t N>
+  class MovingVariance : public Internal::MovingStatisticsBase<T,N,1,Internal::MovingStatistic::Variance>
+  {
+  public:
+    // フィルタ処理本体
+    T operator()(const T & in)
+    {
+      MYDSP_INSTRUMENT_SCOPE(this->probe, 1);
+      T out = T();
+      this->Step(&in, &out);
+      return out;
+    }
+  };
+
+  // 移動RMS(2乗平均平方根)
+  template <class T, std::size_t N>
+  class MovingRMS : public Internal::MovingStatisticsBase<T,N,1,Internal::MovingStatistic::RMS>
+  {
+  public:
+    // フィルタ処理本体
+    T operator()(const T & in)
+    {
+      MYDSP_INSTRUMENT_SCOPE(this->probe, 1);
+      T out = T();
+      this->Step(&in, &out);
+      return out;
+    }
+  };
+
+  // 多チャネル移動平均
+  template <class T, std::size_t N, std::size_t NumChannels>
+  class MovingAverageBank : public Internal::MovingStatisticsBase<T,N,NumChannels,Internal::MovingStatistic::Mean>
+  {
+  public:
+    // フィルタ処理本体(1フレーム分)
+    void operator()(const T (&in)[NumChannels], T (&out)[NumChannels])
+    {
+      MYDSP_INSTRUMENT_SCOPE(this->probe, NumChannels);
+      this->Step(in, out);
+    }
+  };
+
+  // 多チャネル移動分散
+  template <class T, std::size_t N, std::size_t NumChannels>
+  class MovingVarianceBank : public Internal::MovingStatisticsBase<T,N,NumChannels,Internal::MovingStatistic::Variance>
+  {
+  public:
+    // フィルタ処理本体(1フレーム分)
+    void operator()(const T (&in)[NumChannels], T (&out)[NumChannels])
+    {
+      MYDSP_INSTRUMENT_SCOPE(this->probe, NumChannels);
+      this->Step(in, out);
+    }
+  };
+
+  // 多チャネル移動RMS
+  template <class T, std::size_t N, std::size_t NumChannels>
+  class MovingRMSBank : public Internal::MovingStatisticsBase<T,N,NumChannels,Internal::MovingStatistic::RMS>
+  {
+  public:
+    // フィルタ処理本体(1フレーム分)
+    void operator()(const T (&in)[NumChannels], T (&out)[NumChannels])
+    {
+      MYDSP_INSTRUMENT_SCOPE(this->probe, NumChannels);
+      this->Step(in, out);
+    }
+  };
+
+  // メディアンフィルタ
+  // 直近Nサンプルの中央値を出力する(Nが偶数の場合は中央の2つの平均)
+  // 窓の下半分を最大ヒープ、上半分を最小ヒープに置き、最古のサンプルの値を入力で置き換えてヒープを修正する
+  // 窓が埋まるまでは、不足分を0とみなした値を出力する
+  template <class T, std::size_t N>
+  class MedianFilter
+  {
+    static_assert(std::is_arithmetic<T>::value, "Template parameter 'T' should be an arithmetic type");
+    static_assert(N > 0, "Template parameter 'N' shouldn't be zero");
+
+  public:
+    static constexpr std::size_t WindowLength = N;
+
+  protected:
+    static constexpr std::size_t LowerSize = (N + 1) / 2; // 最大ヒープ(下半分)の要素数
+
+    T values[N];              // 窓のサンプル(リングバッファ)
+    std::size_t heap[N];      // [0, LowerSize): 最大ヒープ, [LowerSize, N): 最小ヒープ (valuesの位置)
+    std::size_t position[N];  // valuesの各位置がheapのどこにあるか
+    std::size_t oldest;       // 最古のサンプルの位置
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+    Instrumentation::Probe probe{"MedianFilter"}; // 計測点
+#endif
+
+  public:
+    MedianFilter(void) :
+      values{},
+      heap{},
+      position{},
+      oldest(0)
+    {
+      Clear();
+    }
+
+    // 状態変数の初期化
+    void Clear(void)
+    {
+      for (std::size_t i = 0; i < N; ++i)
+      {
+        values[i] = T();
+        heap[i] = i;
+        position[i] = i;
+      }
+      oldest = 0;
+    }
+
+#ifdef MYDSP_ENABLE_INSTRUMENTATION
+    // 計測点の取得
+    Instrumentation::Probe& GetProbe(void)
+    {
+      return probe;
+    }
+
+#endif
+    // フィルタ処理本体
+    T operator()(const T & in)
+    {
+      MYDSP_INSTRUMENT_SCOPE(probe, 1);
+      return Step(in);
+    }
+
+    // ブロック処理(inとoutは同じ領域でもよい)
+    void Process(const T* in, T* out, std::size_t length)
+    {
+      MYDSP_INSTRUMENT_SCOPE(probe, length);
+      for (std::size_t n = 0; n < length; ++n)
+      {
+        out[n] = Step(in[n]);
+      }
+    }
+
+  protected:
+    // 1サンプル分の処理
+    T Step(const T & in)
+    {
+      const std::size_t slot = oldest;
+      oldest = (oldest + 1u == N) ? 0 : oldest + 1u;
+      const T prev = values[slot];
+      values[slot] = in;
+      const std::size_t i = position[slot];
+      if (i < LowerSize)
+      {
+        (prev < in) ? SiftUpLower(i) : SiftDownLower(i);
+      }
+      else
+      {
+        (in < prev) ? SiftUpUpper(i - LowerSize) : SiftDownUpper(i - LowerSize);
+      }
+      // 下半分の最大値が上半分の最小値を超えたら入れ替える(片方のヒープの値を1つ変えただけなので1回で足りる)
+      if (LowerSize < N && values[heap[LowerSize]] < values[heap[0]])
+      {
+        Swap(0, LowerSize);
+        SiftDownLower(0);
+        SiftDownUpper(0);
+      }
+      return Median();
+    }
+
+    // 中央値
+    T Median(void) const
+    {
+      const T lower = values[heap[0]];
+      if (N % 2 != 0)
+      {
+        return lower;
+      }
+      const T upper = values[heap[LowerSize]];
+      return lower + (upper - lower) / T(2);
+    }
+
+    // heapのi番目とj番目の入れ替え
+    void Swap(std::size_t i, std::size_t j)
+    {
+      const std::size_t tmp = heap[i];
+      heap[i] = heap[j];
+      heap[j] = tmp;
+      position[heap[i]] = i;
+      position[heap[j]] = j;
+    }
+
+    // 最大ヒープ(下半分)のi番目を上に移動
+    void SiftUpLower(std::size_t i)
+    {
+      while (i > 0)
+      {
+        const std::size_t parent = (i - 1) / 2;
+        if (!(values[heap[parent]] < values[heap[i]]))
+        {
+          break;
+        }
+        Swap(i, parent);
+        i = parent;
+      }
+    }
+
+    // 最大ヒープ(下半分)のi番目を下に移動
+    void SiftDownLower(std::size_t i)
+    {
+      for (;;)
+      {
+        const std::size_t left = 2 * i + 1;
+        if (left >= LowerSize)
+        {
+          break;
+        }
+        const std::size_t right = left + 1;
+        const std::size_t child = (right < LowerSize && values[heap[left]] < values[heap[right]]) ? right : left;
+        if (!(values[heap[i]] < values[heap[child]]))
+        {
+          break;
+        }
+        Swap(i, child);
+        i = child;
+      }
+    }
+
+    // 最小ヒープ(上半分)のi番目(heapの先頭からの位置はLowerSize+i)を上に移動
+    void SiftUpUpper(std::size_t i)
+    {
+      constexpr std::size_t UpperSize = N - LowerSize;
+      while (i > 0 && i < UpperSize)
+      {
+        const std::size_t parent = (i - 1) / 2;
+        if (!(values[heap[LowerSize+i]] < values[heap[LowerSize+parent]]))
+        {
+          break;
+        }
+        Swap(LowerSize + i, LowerSize + parent);
+        i = parent;
+      }
+    }
+
+    // 最小ヒープ(上半分)のi番目を下に移動
+    void SiftDownUpper(std::size_t i)
+    {
+      constexpr std::size_t UpperSize = N - LowerSize;
+      for (;;)
+      {
+        const std::size_t left = 2 * i + 1;
+        if (left >= UpperSize)
+        {
+          break;
+        }
+        const std::size_t right = left + 1;
+        const std::size_t child =
+          (right < UpperSize && values[heap[LowerSize+right]] < values[heap[LowerSize+left]]) ? right : left;
+        if (!(values[heap[LowerSize+child]] < values[heap[LowerSize+i]]))
+        {
+          break;
+        }
+        Swap(LowerSize + i, LowerSize + child);
+        i = child;
+      }
+    }
+  };
+
+  template <class T, std::size_t N>
+  constexpr std::size_t MedianFilter<T,N>::WindowLength;
+  template <class T, std::size_t N>
+  constexpr std::size_t MedianFilter<T,N>::LowerSize;
+
+  // 移動最小値(直近Nサンプルの最小値、償却O(1)/サンプル)
+  template <class T, std::size_t N>
+  class MovingMin : public Internal::MovingExtremumBase<T,N,std::less<T>>
+  {
+  };
+
+  // 移動最大値(直近Nサンプルの最大値、償却O(1)/サンプル)
+  template <class T, std::size_t N>
+  class MovingMax : public Internal::MovingExtremumBase<T,N,std::greater<T>>
+  {
+  };
+
+} /* namespace MyDSP */
+
+
+#endif /* MYDSP_STATISTICS_HPP_ */
@@ -0,0 +1,146 @@
+/*
+ * Storage.hpp
+ *
+ *  Created on: 2026/10/18
+ *      Author: Shibasaki
+ *
+ * 係数・状態変数の縮小精度の格納形式
+ * Half    : IEEE 754 binary16(符号1, 指数5, 仮数10ビット。有効桁は約3.3桁、最大65504)
+ * BFloat16: bfloat16(符号1, 指数8, 仮数7ビット。floatと同じ範囲で有効桁は約2.4桁)
+ * 格納専用の型で、演算はfloatに変換してから行う(floatからの変換は最近接偶数丸め)
+ * 変換は分岐のないビット演算で書いてあり、Dispatch.hpp のカーネル内ではベクトル命令に展開される
+ */
+
+#ifndef MYDSP_STORAGE_HPP_
+#define MYDSP_STORAGE_HPP_
+
+#include <type_traits>
+#include <cstdint>
+#include <cstring>
+
+namespace MyDSP
+{
+  namespace Internal
+  {
+    // floatとビット列の相互変換
+    inline float BitsToFloat(std::uint32_t bits)
+    {
+      float value;
+      std::memcpy(&value, &bits, sizeof(value));
+      return value;
+    }
+
+    inline std::uint32_t FloatToBits(float value)
+    {
+      std::uint32_t bits;
+      std::memcpy(&bits, &value, sizeof(bits));
+      return bits;
+    }
+
+    // 条件に応じたビット列の選択
+    // 比較結果から作ったマスクで選ぶ(三項演算子では分岐が残り、ループがベクトル化されないことがある)
+    inline std::uint32_t SelectBits(bool condition, std::uint32_t if_true, std::uint32_t if_false)
+    {
+      const std::uint32_t mask = 0u - static_cast<std::uint32_t>(condition);
+      return (if_true & mask) | (if_false & ~mask);
+    }
+
+    // binary16からfloatへの変換
+    // 正規化数は指数のバイアスを112加え、無限大・NaNはさらに112加える
+    // 非正規化数は仮数を2^-14の倍数として浮動小数点の減算で正規化する
+    inline float HalfBitsToFloat(std::uint16_t bits)
+    {
+      const std::uint32_t sign = static_cast<std::uint32_t>(bits & 0x8000u) << 16;
+      const std::uint32_t magnitude = static_cast<std::uint32_t>(bits & 0x7fffu) << 13;
+      const std::uint32_t exponent = magnitude & 0x0f800000u;
+      const std::uint32_t normal = magnitude + 0x38000000u;
+      const std::uint32_t special = magnitude + 0x70000000u;
+      const std::uint32_t subnormal = FloatToBits(BitsToFloat(magnitude + 0x38800000u) - BitsToFloat(0x38800000u));
+      const std::uint32_t result = SelectBits(exponent == 0x0f800000u, special, SelectBits(exponent == 0, subnormal, normal));
+      return BitsToFloat(result | sign);
+    }
+
+    // floatからbinary16への変換(最近接偶数丸め)
+    // 正規化数は指数のバイアスを引いてから仮数の下位13ビットを丸める
+    // 非正規化数は0.5を足して仮数の下位に揃え、浮動小数点の加算で丸める
+    // 範囲外は無限大、NaNはquiet NaNにする
+    inline std::uint16_t FloatToHalfBits(float value)
+    {
+      const std::uint32_t bits = FloatToBits(value);
+      const std::uint32_t sign = (bits >> 16) & 0x8000u;
+      const std::uint32_t magnitude = bits & 0x7fffffffu;
+      const std::uint32_t normal = (magnitude - 0x38000000u + 0x0fffu + ((magnitude >> 13) & 1u)) >> 13;
+      const std::uint32_t subnormal = FloatToBits(BitsToFloat(magnitude) + 0.5f) - 0x3f000000u;
+      const std::uint32_t overflow = 0x7c00u | (static_cast<std::uint32_t>(magnitude > 0x7f800000u) << 9);
+      const std::uint32_t result = SelectBits(magnitude >= 0x477ff000u, overflow,
+        SelectBits(magnitude < 0x38800000u, subnormal, normal));
+      return static_cast<std::uint16_t>(result | sign);
+    }
+
+    // bfloat16からfloatへの変換
+    inline float BFloat16BitsToFloat(std::uint16_t bits)
+    {
+      return BitsToFloat(static_cast<std::uint32_t>(bits) << 16);
+    }
+
+    // floatからbfloat16への変換(最近接偶数丸め。NaNはquiet NaNにする)
+    inline std::uint16_t FloatToBFloat16Bits(float value)
+    {
+      const std::uint32_t bits = FloatToBits(value);
+      const std::uint32_t rounded = (bits + 0x7fffu + ((bits >> 16) & 1u)) >> 16;
+      const std::uint32_t result = SelectBits((bits & 0x7fffffffu) > 0x7f800000u, (bits >> 16) | 0x0040u, rounded);
+      return static_cast<std::uint16_t>(result);
+    }
+  } /* namespace Internal */
+
+  // IEEE 754 binary16
+  // floatとの間で暗黙に変換できる
+  struct Half
+  {
+    std::uint16_t bits;
+
+    Half(void) = default;
+    Half(float value) : bits(Internal::FloatToHalfBits(value)) {}
+
+    operator float(void) const
+    {
+      return Internal::HalfBitsToFloat(bits);
+    }
+  };
+
+  // bfloat16
+  // floatとの間で暗黙に変換できる
+  struct BFloat16
+  {
+    std::uint16_t bits;
+
+    BFloat16(void) = default;
+    BFloat16(float value) : bits(Internal::FloatToBFloat16Bits(value)) {}
+
+    operator float(void) const
+    {
+      return Internal::BFloat16BitsToFloat(bits);
+    }
+  };
+
+  namespace Internal
+  {
+    // 縮小精度の格納形式か
+    template <class T>
+    struct IsCompactStorage : std::false_type {};
+    template <>
+    struct IsCompactStorage<Half> : std::true_type {};
+    template <>
+    struct IsCompactStorage<BFloat16> : std::true_type {};
+
+    // 演算型Tの値の格納型として使えるか(Tそのもの、またはTがfloatのときの縮小精度の形式)
+    template <class T, class S>
+    struct IsStorageOf :
+      std::integral_constant<bool, std::is_same<T,S>::value || (std::is_same<T,float>::value && IsCompactStorage<S>::value)>
+    {};
+  } /* namespace Internal */
+
+} /* namespace MyDSP */
+
+
+#endif /* MYDSP_STORAGE_HPP_ */
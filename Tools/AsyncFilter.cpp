@@ -0,0 +1,374 @@
+/*
+ * AsyncFilter.cpp
+ *
+ *  Created on: 2026/10/18
+ *      Author: Shibasaki
+ *
+ * ファイル・パイプからのストリームのフィルタ処理(読み書きと計算の重ね合わせ)
+ * モノラルのfloat32のraw信号をブロック単位で読み、FIR/双二次IIRフィルタの縦続接続を適用して書き出す
+ * 読み書きはAsyncBlockIO.hppのソース・シンク(io_uringまたはワーカースレッド)で行い、
+ * フィルタ処理はco_awaitで進むコルーチンとして書く(ブロックnの計算中にn+1の読み込みとn-1の書き出しが進む)
+ * --syncを指定すると、同じ処理を1スレッドで読み込み→計算→書き出しと順に行う(比較用)
+ *
+ * 使い方:
+ *   MyDSPAsyncFilter [--input FILE|-] [--output FILE|-] [--block N] [--backend auto|uring|thread] [--sync]
+ *     [--fir c0,c1,...|@FILE]... [--biquad b0,b1,b2,a1,a2[,...]|@FILE]...
+ *   --input/--outputの"-"(既定)は標準入力・標準出力。パイプもそのまま扱える
+ *   --fir/--biquadは指定した順に縦続接続される(係数の書式はMyDSPFilterFileと同じ)
+ *   処理したサンプル数・ブロック数・経過時間と計算に使った時間を標準エラーに出力する
+ */
+
+#include "MyDSP/AsyncBlockIO.hpp"
+#include "MyDSP/DynamicFilter.hpp"
+#include "MyDSP/Arena.hpp"
+#include "ToolsCommon.hpp"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+  using namespace MyDSPTools;
+
+  // コマンドライン設定
+  struct Config
+  {
+    std::string input = "-";
+    std::string output = "-";
+    std::size_t block = 4096;
+    MyDSP::AsyncIOBackend backend = MyDSP::AsyncIOBackend::Auto;
+    bool sync = false;
+    std::vector<StageConfig> stages;
+  };
+
+  void PrintUsage(std::ostream &os, const char* argv0)
+  {
+    os << "usage: " << argv0 << " [--input FILE|-] [--output FILE|-] [--block N] [--backend auto|uring|thread] [--sync]\n"
+       << "       [--fir c0,c1,...|@FILE]... [--biquad b0,b1,b2,a1,a2[,...]|@FILE]...\n";
+  }
+
+  bool ParseConfig(int argc, char** argv, Config &config, std::ostream &err)
+  {
+    for (int i = 1; i < argc; ++i)
+    {
+      const std::string arg = argv[i];
+      const bool has_value = (i + 1 < argc);
+      if (arg == "--input" && has_value)
+      {
+        config.input = argv[++i];
+      }
+      else if (arg == "--output" && has_value)
+      {
+        config.output = argv[++i];
+      }
+      else if (arg == "--block" && has_value)
+      {
+        if (!ParseSize(argv[++i], config.block) || config.block == 0)
+        {
+          err << "invalid block size\n";
+          return false;
+        }
+      }
+      else if (arg == "--backend" && has_value)
+      {
+        const std::string backend = argv[++i];
+        if (backend == "auto")
+        {
+          config.backend = MyDSP::AsyncIOBackend::Auto;
+        }
+        else if (backend == "uring")
+        {
+          config.backend = MyDSP::AsyncIOBackend::IoUring;
+        }
+        else if (backend == "thread")
+        {
+          config.backend = MyDSP::AsyncIOBackend::Thread;
+        }
+        else
+        {
+          err << "unknown backend: " << backend << "\n";
+          return false;
+        }
+      }
+      else if (arg == "--sync")
+      {
+        config.sync = true;
+      }
+      else if (IsStageOption(arg) && has_value)
+      {
+        if (!ParseStage(arg, argv[++i], config.stages, err))
+        {
+          return false;
+        }
+      }
+      else
+      {
+        err << "unknown or incomplete option: " << arg << "\n";
+        return false;
+      }
+    }
+    if (config.stages.empty())
+    {
+      err << "no filter stage specified\n";
+      return false;
+    }
+    return true;
+  }
+
+  // フィルタの縦続接続(ArenaにまとめてVectorの再確保なしに構築する)
+  class Chain
+  {
+  private:
+    using FIR = MyDSP::FIRDynamic<float,float>;
+    using Biquad = MyDSP::IIRBiquadCascadeDF2TDynamic<float,float>;
+
+    std::vector<unsigned char> arena_buffer;
+    std::vector<FIR> firs;
+    std::vector<Biquad> biquads;
+    std::vector<std::pair<StageConfig::Kind,std::size_t>> order;
+    double compute_seconds = 0.0;
+
+  public:
+    bool Build(const std::vector<StageConfig> &stages)
+    {
+      std::size_t bytes = 0;
+      std::size_t num_firs = 0;
+      for (const StageConfig &stage : stages)
+      {
+        const bool fir = (stage.kind == StageConfig::Kind::FIR);
+        bytes += fir ? FIR::RequiredBytes(stage.coeffs.size()) : Biquad::RequiredBytes(stage.coeffs.size() / 5);
+        num_firs += fir ? 1 : 0;
+      }
+      arena_buffer.resize(bytes + MyDSP::Arena::Alignment);
+      MyDSP::Arena arena(arena_buffer.data(), arena_buffer.size());
+      firs.reserve(num_firs);
+      biquads.reserve(stages.size() - num_firs);
+      for (const StageConfig &stage : stages)
+      {
+        if (stage.kind == StageConfig::Kind::FIR)
+        {
+          order.emplace_back(stage.kind, firs.size());
+          firs.emplace_back(arena, stage.coeffs.data(), stage.coeffs.size());
+          if (!firs.back().IsValid())
+          {
+            return false;
+          }
+        }
+        else
+        {
+          order.emplace_back(stage.kind, biquads.size());
+          biquads.emplace_back(arena, reinterpret_cast<const float (*)[5]>(stage.coeffs.data()), stage.coeffs.size() / 5);
+          if (!biquads.back().IsValid())
+          {
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+
+    void Process(const float* in, float* out, std::size_t length)
+    {
+      const auto start = std::chrono::steady_clock::now();
+      for (const auto &stage : order)
+      {
+        if (stage.first == StageConfig::Kind::FIR)
+        {
+          firs[stage.second].Process(in, out, length);
+        }
+        else
+        {
+          biquads[stage.second].Process(in, out, length);
+        }
+        in = out;
+      }
+      compute_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    double ComputeSeconds(void) const
+    {
+      return compute_seconds;
+    }
+  };
+
+  // 処理の集計
+  struct Totals
+  {
+    std::uint64_t samples = 0;
+    std::uint64_t blocks = 0;
+    bool ok = true;
+  };
+
+  // 読み込み→計算→書き出しを重ねて進めるフィルタ段
+  MyDSP::AsyncTask FilterStage(MyDSP::AsyncBlockSource<float> &source, MyDSP::AsyncBlockSink<float> &sink,
+    Chain &chain, Totals &totals)
+  {
+    while (MyDSP::SampleBlock<float> in = co_await source.Next())
+    {
+      MyDSP::SampleBlock<float> out = co_await sink.Acquire();
+      chain.Process(in.data, out.data, in.length);
+      if (!sink.Commit(out, in.length))
+      {
+        break;
+      }
+      totals.samples += in.length;
+      ++totals.blocks;
+    }
+    totals.ok = co_await sink.Flush() && source.GetError() == 0;
+  }
+
+  // 比較用の逐次処理(ブロックが埋まるかEOFまで読む)
+  bool ReadFull(int fd, unsigned char* data, std::size_t bytes, std::size_t &filled)
+  {
+    filled = 0;
+    while (filled < bytes)
+    {
+      const ssize_t result = read(fd, data + filled, bytes - filled);
+      if (result < 0 && errno == EINTR)
+      {
+        continue;
+      }
+      if (result <= 0)
+      {
+        return result == 0;
+      }
+      filled += static_cast<std::size_t>(result);
+    }
+    return true;
+  }
+
+  bool WriteFull(int fd, const unsigned char* data, std::size_t bytes)
+  {
+    while (bytes > 0)
+    {
+      const ssize_t result = write(fd, data, bytes);
+      if (result < 0 && errno == EINTR)
+      {
+        continue;
+      }
+      if (result <= 0)
+      {
+        return false;
+      }
+      data += result;
+      bytes -= static_cast<std::size_t>(result);
+    }
+    return true;
+  }
+
+  void RunSync(int in_fd, int out_fd, std::size_t block, Chain &chain, Totals &totals)
+  {
+    std::vector<float> in(block);
+    std::vector<float> out(block);
+    for (;;)
+    {
+      std::size_t filled = 0;
+      if (!ReadFull(in_fd, reinterpret_cast<unsigned char*>(in.data()), block * sizeof(float), filled))
+      {
+        totals.ok = false;
+        return;
+      }
+      const std::size_t length = filled / sizeof(float);
+      if (length == 0)
+      {
+        return;
+      }
+      chain.Process(in.data(), out.data(), length);
+      if (!WriteFull(out_fd, reinterpret_cast<const unsigned char*>(out.data()), length * sizeof(float)))
+      {
+        totals.ok = false;
+        return;
+      }
+      totals.samples += length;
+      ++totals.blocks;
+    }
+  }
+
+  const char* BackendName(MyDSP::AsyncIOBackend backend)
+  {
+    return (backend == MyDSP::AsyncIOBackend::IoUring) ? "io_uring" : "thread";
+  }
+
+} /* namespace */
+
+int main(int argc, char** argv)
+{
+  Config config;
+  if (!ParseConfig(argc, argv, config, std::cerr))
+  {
+    PrintUsage(std::cerr, argv[0]);
+    return 2;
+  }
+
+  Chain chain;
+  if (!chain.Build(config.stages))
+  {
+    std::cerr << "failed to build filter chain\n";
+    return 1;
+  }
+
+  const int in_fd = (config.input == "-") ? STDIN_FILENO : open(config.input.c_str(), O_RDONLY);
+  if (in_fd < 0)
+  {
+    std::cerr << config.input << ": " << std::strerror(errno) << "\n";
+    return 1;
+  }
+  const int out_fd = (config.output == "-") ? STDOUT_FILENO : open(config.output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (out_fd < 0)
+  {
+    std::cerr << config.output << ": " << std::strerror(errno) << "\n";
+    return 1;
+  }
+
+  Totals totals;
+  const auto start = std::chrono::steady_clock::now();
+  if (config.sync)
+  {
+    RunSync(in_fd, out_fd, config.block, chain, totals);
+    std::cerr << "mode: sync";
+  }
+  else
+  {
+    MyDSP::AsyncIOContext context(config.backend);
+    if (!context.IsValid())
+    {
+      std::cerr << "requested I/O backend is not available\n";
+      return 1;
+    }
+    MyDSP::AsyncBlockSource<float> source(context, in_fd, config.block);
+    MyDSP::AsyncBlockSink<float> sink(context, out_fd, config.block);
+    if (!context.Run(FilterStage(source, sink, chain, totals)))
+    {
+      totals.ok = false;
+    }
+    if (source.GetError() != 0)
+    {
+      std::cerr << config.input << ": " << std::strerror(source.GetError()) << "\n";
+    }
+    if (sink.GetError() != 0)
+    {
+      std::cerr << config.output << ": " << std::strerror(sink.GetError()) << "\n";
+    }
+    std::cerr << "mode: async (" << BackendName(context.GetBackend()) << ")";
+  }
+  const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  std::cerr << ", samples: " << totals.samples << ", blocks: " << totals.blocks
+            << ", elapsed: " << elapsed << " s, compute: " << chain.ComputeSeconds() << " s\n";
+
+  if (in_fd != STDIN_FILENO)
+  {
+    close(in_fd);
+  }
+  if (out_fd != STDOUT_FILENO)
+  {
+    close(out_fd);
+  }
+  return totals.ok ? 0 : 1;
+}
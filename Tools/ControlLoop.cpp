@@ -0,0 +1,212 @@
+/*
+ * ControlLoop.cpp
+ *
+ *  Created on: 2026/10/18
+ *      Author: Shibasaki
+ *
+ * 固定周期の制御ループの実行時間・起床の遅れの計測
+ * 1次遅れ系のプラントを模擬したPID制御ループをControlExecutorで指定した周期・時間だけ実行し、
+ * ループごとの実行回数・周期超過の回数・実行時間と起床の遅れのパーセンタイル値をタブ区切りで出力する
+ *
+ * 使い方:
+ *   MyDSPControlLoop [--period-us 1000,250] [--loops 4] [--seconds 5] [--cpu N] [--fifo PRIO] [--work N]
+ *   --period-usに複数の周期を並べると、それぞれの周期に--loops個ずつループを登録する
+ *   --workはループごとに1周期あたり追加で回すプラントの計算の回数(処理の重さの調整用)
+ *   SCHED_FIFOを適用できなかった場合も通常のスケジューリングで実行を続ける
+ */
+
+#include "MyDSP/ControlExecutor.hpp"
+#include "MyDSP/Controller.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+namespace
+{
+  // コマンドライン設定
+  struct Config
+  {
+    std::vector<std::uint64_t> periods_us{1000};
+    std::size_t loops = 4;
+    double seconds = 5.0;
+    int cpu = -1;
+    int fifo_priority = 0;
+    std::size_t work = 0;
+  };
+
+  void PrintUsage(std::ostream &os, const char* argv0)
+  {
+    os << "usage: " << argv0 << " [--period-us P[,P...]] [--loops N] [--seconds S] [--cpu N] [--fifo PRIO] [--work N]\n";
+  }
+
+  bool ParseInt(const char* text, long long &value)
+  {
+    char* end = nullptr;
+    value = std::strtoll(text, &end, 10);
+    return end != text && *end == '\0';
+  }
+
+  bool ParseConfig(int argc, char** argv, Config &config, std::ostream &err)
+  {
+    for (int i = 1; i < argc; ++i)
+    {
+      const std::string arg = argv[i];
+      if (i + 1 >= argc)
+      {
+        err << "missing value for " << arg << "\n";
+        return false;
+      }
+      const char* value = argv[++i];
+      long long parsed = 0;
+      if (arg == "--period-us")
+      {
+        std::string text = value;
+        std::replace(text.begin(), text.end(), ',', ' ');
+        std::istringstream iss(text);
+        std::string token;
+        config.periods_us.clear();
+        while (iss >> token)
+        {
+          if (!ParseInt(token.c_str(), parsed) || parsed <= 0)
+          {
+            err << "invalid period: " << token << "\n";
+            return false;
+          }
+          config.periods_us.push_back(static_cast<std::uint64_t>(parsed));
+        }
+        if (config.periods_us.empty())
+        {
+          err << "empty period list\n";
+          return false;
+        }
+      }
+      else if (arg == "--loops" && ParseInt(value, parsed) && parsed > 0)
+      {
+        config.loops = static_cast<std::size_t>(parsed);
+      }
+      else if (arg == "--seconds")
+      {
+        char* end = nullptr;
+        config.seconds = std::strtod(value, &end);
+        if (end == value || *end != '\0' || !(config.seconds > 0.0))
+        {
+          err << "invalid duration: " << value << "\n";
+          return false;
+        }
+      }
+      else if (arg == "--cpu" && ParseInt(value, parsed))
+      {
+        config.cpu = static_cast<int>(parsed);
+      }
+      else if (arg == "--fifo" && ParseInt(value, parsed) && parsed >= 0 && parsed <= 99)
+      {
+        config.fifo_priority = static_cast<int>(parsed);
+      }
+      else if (arg == "--work" && ParseInt(value, parsed) && parsed >= 0)
+      {
+        config.work = static_cast<std::size_t>(parsed);
+      }
+      else
+      {
+        err << "invalid option: " << arg << " " << value << "\n";
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // 模擬するプラント(1次遅れ系 y[n+1] = a y[n] + (1 - a) u[n])と目標値
+  struct Plant
+  {
+    float a;
+    float y;
+    float target;
+    std::size_t work;
+  };
+
+  // 偏差の読み出し
+  float ReadError(void* context)
+  {
+    const Plant &plant = *static_cast<const Plant*>(context);
+    return plant.target - plant.y;
+  }
+
+  // 操作量の書き出し(プラントを1周期分進める)
+  void WriteOutput(void* context, float u)
+  {
+    Plant &plant = *static_cast<Plant*>(context);
+    for (std::size_t i = 0; i <= plant.work; ++i)
+    {
+      plant.y = plant.a * plant.y + (1.0f - plant.a) * u;
+    }
+  }
+
+  using Loop = MyDSP::PIDLoop<MyDSP::PIDController<float>,float>;
+
+} /* namespace */
+
+int main(int argc, char** argv)
+{
+  Config config;
+  if (!ParseConfig(argc, argv, config, std::cerr))
+  {
+    PrintUsage(std::cerr, argv[0]);
+    return 2;
+  }
+
+  // PIDControllerは状態変数への参照をメンバに持つため、複製せずにその場で構築する
+  const std::size_t num_loops = config.periods_us.size() * config.loops;
+  std::unique_ptr<MyDSP::PIDController<float>[]> controllers(new MyDSP::PIDController<float>[num_loops]);
+  std::vector<Plant> plants(num_loops);
+  std::vector<Loop> loops;
+  loops.reserve(num_loops);
+  for (std::size_t i = 0; i < num_loops; ++i)
+  {
+    controllers[i].SetCoeffs(0.6f, 0.1f, 0.05f);
+    plants[i] = Plant{0.9f, 0.0f, 1.0f, config.work};
+    loops.push_back(MyDSP::MakePIDLoop(controllers[i], ReadError, WriteOutput, &plants[i], -10.0f, 10.0f));
+  }
+
+  MyDSP::ControlExecutor::Config executor_config;
+  executor_config.cpu = config.cpu;
+  executor_config.fifo_priority = config.fifo_priority;
+  MyDSP::ControlExecutor executor(executor_config);
+  for (std::size_t p = 0; p < config.periods_us.size(); ++p)
+  {
+    for (std::size_t i = 0; i < config.loops; ++i)
+    {
+      const std::size_t index = p * config.loops + i;
+      const std::string name = "pid" + std::to_string(index) + "@" + std::to_string(config.periods_us[p]) + "us";
+      executor.AddLoop(config.periods_us[p] * 1000u, loops[index], name.c_str());
+    }
+  }
+
+  if (!executor.Start())
+  {
+    std::cerr << "failed to start executor\n";
+    return 1;
+  }
+  std::this_thread::sleep_for(std::chrono::duration<double>(config.seconds));
+  executor.Stop();
+
+  std::cerr << "pinned: " << (executor.IsPinned() ? "yes" : "no")
+            << ", SCHED_FIFO: " << (executor.IsRealtime() ? "yes" : "no") << "\n";
+  executor.Dump(std::cout);
+
+  // 制御が収束しているかの確認(目標値との差の最大値)
+  float max_error = 0.0f;
+  for (const Plant &plant : plants)
+  {
+    max_error = std::max(max_error, std::abs(plant.target - plant.y));
+  }
+  std::cerr << "max tracking error: " << max_error << "\n";
+  return 0;
+}
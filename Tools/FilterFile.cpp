@@ -0,0 +1,659 @@
+/*
+ * FilterFile.cpp
+ *
+ *  Created on: 2026/10/18
+ *      Author: Shibasaki
+ *
+ * 大容量の信号ファイルのオフラインフィルタ処理
+ * インターリーブされた多チャネルのraw(int16/float32)ファイルをmmapし、
+ * 指定したFIR/双二次IIRフィルタの縦続接続をチャネルごとに適用して出力ファイル(または入力ファイル自身)へ書き出す
+ *
+ * - 入力はキャッシュに収まる大きさのタイル単位で処理する。スレッドどうしはタイルごとに待ち合わせず、それぞれ次のタイルへ進む
+ *   次のタイルはスレッドごとに分担した範囲をmadviseで先にページテーブルへ載せておく
+ * - スレッドには連続したチャネルの組を割り当てる。双二次IIRフィルタはその組の中でチャネル方向にベクトル化する
+ * - フィルタは実行時にタップ数・段数を決めるDynamicFilter.hppのクラスを使い、スレッドごとのArenaにまとめて確保する
+ *
+ * 使い方:
+ *   MyDSPFilterFile --input in.raw --output out.raw --channels 8 --format int16 \
+ *     --fir 0.25,0.5,0.25 --biquad 0.2,0.4,0.2,0.6,-0.2 [--threads 4] [--tile-kb 64]
+ *   --fir/--biquadは指定した順に縦続接続される。係数は","区切りで並べるか、"@ファイル名"で空白区切りのテキストを読む
+ *   --biquadは5個(b0,b1,b2,a1,a2)ずつの組を複数並べると多段になる
+ *   --outputの代わりに--in-placeを指定すると入力ファイルを上書きする
+ */
+
+#include "MyDSP/DynamicFilter.hpp"
+#include "MyDSP/Arena.hpp"
+#include "MyDSP/Dispatch.hpp"
+#include "ToolsCommon.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+  using namespace MyDSPTools;
+
+  // サンプルの形式
+  enum class SampleFormat
+  {
+    Int16,
+    Float32
+  };
+
+  std::size_t SampleBytes(SampleFormat format)
+  {
+    return (format == SampleFormat::Int16) ? sizeof(std::int16_t) : sizeof(float);
+  }
+
+  // コマンドライン設定
+  struct Config
+  {
+    std::string input;
+    std::string output;
+    bool in_place = false;
+    std::size_t channels = 1;
+    SampleFormat format = SampleFormat::Float32;
+    std::vector<StageConfig> stages;
+    std::size_t threads = 0;   // 0: 自動
+    std::size_t tile_kb = 64;  // タイルの大きさ(入力側、KiB)
+  };
+
+  void PrintUsage(std::ostream &os, const char* argv0)
+  {
+    os << "usage: " << argv0 << " --input FILE (--output FILE | --in-place) --channels N --format int16|float32\n"
+       << "       [--fir c0,c1,...|@FILE]... [--biquad b0,b1,b2,a1,a2[,...]|@FILE]...\n"
+       << "       [--threads N] [--tile-kb N]\n";
+  }
+
+  bool ParseConfig(int argc, char** argv, Config &config, std::ostream &err)
+  {
+    for (int i = 1; i < argc; ++i)
+    {
+      const std::string arg = argv[i];
+      const bool has_value = (i + 1 < argc);
+      if (arg == "--input" && has_value)
+      {
+        config.input = argv[++i];
+      }
+      else if (arg == "--output" && has_value)
+      {
+        config.output = argv[++i];
+      }
+      else if (arg == "--in-place")
+      {
+        config.in_place = true;
+      }
+      else if (arg == "--channels" && has_value)
+      {
+        if (!ParseSize(argv[++i], config.channels) || config.channels == 0)
+        {
+          err << "invalid channel count\n";
+          return false;
+        }
+      }
+      else if (arg == "--format" && has_value)
+      {
+        const std::string format = argv[++i];
+        if (format == "int16")
+        {
+          config.format = SampleFormat::Int16;
+        }
+        else if (format == "float32")
+        {
+          config.format = SampleFormat::Float32;
+        }
+        else
+        {
+          err << "unknown format: " << format << "\n";
+          return false;
+        }
+      }
+      else if (IsStageOption(arg) && has_value)
+      {
+        if (!ParseStage(arg, argv[++i], config.stages, err))
+        {
+          return false;
+        }
+      }
+      else if (arg == "--threads" && has_value)
+      {
+        if (!ParseSize(argv[++i], config.threads))
+        {
+          err << "invalid thread count\n";
+          return false;
+        }
+      }
+      else if (arg == "--tile-kb" && has_value)
+      {
+        if (!ParseSize(argv[++i], config.tile_kb) || config.tile_kb == 0)
+        {
+          err << "invalid tile size\n";
+          return false;
+        }
+      }
+      else
+      {
+        err << "unknown or incomplete option: " << arg << "\n";
+        return false;
+      }
+    }
+    if (config.input.empty() || (config.output.empty() == !config.in_place))
+    {
+      err << "specify --input and exactly one of --output / --in-place\n";
+      return false;
+    }
+    if (config.stages.empty())
+    {
+      err << "no filter stage specified\n";
+      return false;
+    }
+    return true;
+  }
+
+  // mmapしたファイル
+  class MappedFile
+  {
+  private:
+    int fd = -1;
+    unsigned char* data = nullptr;
+    std::size_t size = 0;
+
+  public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile()
+    {
+      if (data != nullptr)
+      {
+        munmap(data, size);
+      }
+      if (fd >= 0)
+      {
+        close(fd);
+      }
+    }
+
+    // 既存ファイルを開く
+    bool Open(const std::string &path, bool writable, std::ostream &err)
+    {
+      fd = open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+      struct stat st;
+      if (fd < 0 || fstat(fd, &st) != 0)
+      {
+        err << path << ": " << std::strerror(errno) << "\n";
+        return false;
+      }
+      return Map(path, static_cast<std::size_t>(st.st_size), writable, err);
+    }
+
+    // 指定サイズのファイルを作成して開く
+    // sourceと同じファイル(ハードリンク・シンボリックリンクを含む)なら、マップ済みの内容を切り詰めないように開くだけで失敗する
+    bool Create(const std::string &path, std::size_t bytes, const MappedFile &source, std::ostream &err)
+    {
+      fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+      struct stat st;
+      struct stat source_st;
+      if (fd < 0 || fstat(fd, &st) != 0 || fstat(source.fd, &source_st) != 0)
+      {
+        err << path << ": " << std::strerror(errno) << "\n";
+        return false;
+      }
+      if (st.st_dev == source_st.st_dev && st.st_ino == source_st.st_ino)
+      {
+        err << path << ": output is the same file as the input (use --in-place to overwrite it)\n";
+        return false;
+      }
+      if (ftruncate(fd, 0) != 0 || ftruncate(fd, static_cast<off_t>(bytes)) != 0)
+      {
+        err << path << ": " << std::strerror(errno) << "\n";
+        return false;
+      }
+      return Map(path, bytes, true, err);
+    }
+
+    unsigned char* Data(void) const
+    {
+      return data;
+    }
+
+    std::size_t Size(void) const
+    {
+      return size;
+    }
+
+  private:
+    bool Map(const std::string &path, std::size_t bytes, bool writable, std::ostream &err)
+    {
+      size = bytes;
+      if (bytes == 0)
+      {
+        return true;
+      }
+      void* ptr = mmap(nullptr, bytes, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);
+      if (ptr == MAP_FAILED)
+      {
+        err << path << ": mmap: " << std::strerror(errno) << "\n";
+        size = 0;
+        return false;
+      }
+      data = static_cast<unsigned char*>(ptr);
+      madvise(data, size, MADV_SEQUENTIAL);
+      return true;
+    }
+  };
+
+  // ページ境界に揃えたmadvise
+  void AdviseRange(unsigned char* base, std::size_t total, std::size_t offset, std::size_t length, int advice)
+  {
+    static const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    if (offset >= total)
+    {
+      return;
+    }
+    length = std::min(length, total - offset);
+    const std::size_t begin = offset / page * page;
+    madvise(base + begin, offset + length - begin, advice);
+  }
+
+  // スレッドが担当するチャネル群のフィルタの縦続接続
+  // FIRはチャネルごとに連続した配置(planar)で、双二次IIRはサンプルごとにチャネルが並ぶ配置(interleaved)で
+  // チャネル方向にベクトル化して処理する。段の種類が変わるところで配置を入れ替える
+  class GroupChain
+  {
+  private:
+    using FIR = MyDSP::FIRDynamic<float,float>;
+
+    // 多チャネル双二次IIRフィルタの1段分(係数: [stage][5][channel], 状態変数: [stage][2][channel])
+    struct BiquadBank
+    {
+      float* coeffs;
+      float* state;
+      std::size_t num_stages;
+    };
+
+    std::size_t channels = 0;
+    std::vector<FIR> firs;           // [FIRの段][channel]
+    std::vector<BiquadBank> biquads;
+    std::vector<std::pair<StageConfig::Kind,std::size_t>> order;
+
+  public:
+    // Arenaから確保するバイト数
+    static std::size_t RequiredBytes(const std::vector<StageConfig> &stages, std::size_t channels)
+    {
+      std::size_t bytes = 0;
+      for (const StageConfig &stage : stages)
+      {
+        bytes += (stage.kind == StageConfig::Kind::FIR)
+          ? FIR::RequiredBytes(stage.coeffs.size()) * channels
+          : MyDSP::Arena::RequiredBytes<float>(stage.coeffs.size() * channels)
+            + MyDSP::Arena::RequiredBytes<float>(stage.coeffs.size() / 5 * 2 * channels);
+      }
+      return bytes;
+    }
+
+    bool Build(MyDSP::Arena &arena, const std::vector<StageConfig> &stages, std::size_t num_channels)
+    {
+      channels = num_channels;
+      for (const StageConfig &stage : stages)
+      {
+        if (stage.kind == StageConfig::Kind::FIR)
+        {
+          order.emplace_back(stage.kind, firs.size());
+          for (std::size_t ch = 0; ch < channels; ++ch)
+          {
+            firs.emplace_back(arena, stage.coeffs.data(), stage.coeffs.size());
+            if (!firs.back().IsValid())
+            {
+              return false;
+            }
+          }
+        }
+        else
+        {
+          BiquadBank bank;
+          bank.num_stages = stage.coeffs.size() / 5;
+          bank.coeffs = arena.Allocate<float>(stage.coeffs.size() * channels);
+          bank.state = arena.Allocate<float>(bank.num_stages * 2 * channels);
+          if (bank.coeffs == nullptr || bank.state == nullptr)
+          {
+            return false;
+          }
+          for (std::size_t i = 0; i < stage.coeffs.size(); ++i)
+          {
+            std::fill_n(bank.coeffs + i * channels, channels, stage.coeffs[i]);
+          }
+          order.emplace_back(stage.kind, biquads.size());
+          biquads.push_back(bank);
+        }
+      }
+      return true;
+    }
+
+    // 最初の段が扱う配置(trueならplanar)
+    bool InputPlanar(void) const
+    {
+      return !order.empty() && order.front().first == StageConfig::Kind::FIR;
+    }
+
+    // interleaved: [frame][channel], planar: [channel][frame]の作業領域
+    // is_planarで入力がどちらにあるかを指定し、出力がどちらにあるかを返す
+    bool Process(float* interleaved, float* planar, std::size_t frames, bool is_planar)
+    {
+      for (const auto &stage : order)
+      {
+        if (stage.first == StageConfig::Kind::FIR)
+        {
+          if (!is_planar)
+          {
+            Transpose(interleaved, planar, frames, channels);
+            is_planar = true;
+          }
+          for (std::size_t ch = 0; ch < channels; ++ch)
+          {
+            float* samples = planar + ch * frames;
+            firs[stage.second + ch].Process(samples, samples, frames);
+          }
+        }
+        else
+        {
+          if (is_planar)
+          {
+            Transpose(planar, interleaved, channels, frames);
+            is_planar = false;
+          }
+          const BiquadBank &bank = biquads[stage.second];
+          MyDSP::BiquadDF2TMultiChannelBlock<float>(bank.coeffs, bank.state, bank.num_stages, channels,
+            interleaved, interleaved, frames);
+        }
+      }
+      return is_planar;
+    }
+
+  private:
+    // rows×colsの行列の転置
+    static void Transpose(const float* src, float* dst, std::size_t rows, std::size_t cols)
+    {
+      for (std::size_t r = 0; r < rows; ++r)
+      {
+        for (std::size_t c = 0; c < cols; ++c)
+        {
+          dst[c*rows+r] = src[r*cols+c];
+        }
+      }
+    }
+  };
+
+  // 変換ループはAVX2版も用意し、実行時に選ぶ(int16の変換はSSE2だけではベクトル化しにくい)
+#if defined(__GNUC__) && defined(__x86_64__) && !defined(__clang__)
+#define MYDSP_TOOL_CLONES __attribute__((target_clones("avx2","default")))
+#else
+#define MYDSP_TOOL_CLONES
+#endif
+
+  // ストライド付きの1チャネル分の変換
+  MYDSP_TOOL_CLONES
+  void ConvertToFloat(const std::int16_t* src, std::size_t src_stride, float* dst, std::size_t dst_stride, std::size_t count)
+  {
+    for (std::size_t n = 0; n < count; ++n)
+    {
+      dst[n*dst_stride] = static_cast<float>(src[n*src_stride]) * (1.0f / 32768.0f);
+    }
+  }
+
+  MYDSP_TOOL_CLONES
+  void ConvertToFloat(const float* src, std::size_t src_stride, float* dst, std::size_t dst_stride, std::size_t count)
+  {
+    for (std::size_t n = 0; n < count; ++n)
+    {
+      dst[n*dst_stride] = src[n*src_stride];
+    }
+  }
+
+  // int16へは丸めて飽和させる
+  MYDSP_TOOL_CLONES
+  void ConvertFromFloat(const float* src, std::size_t src_stride, std::int16_t* dst, std::size_t dst_stride, std::size_t count)
+  {
+    for (std::size_t n = 0; n < count; ++n)
+    {
+      float value = src[n*src_stride] * 32768.0f;
+      value = std::min(std::max(value + ((value >= 0.0f) ? 0.5f : -0.5f), -32768.0f), 32767.0f);
+      dst[n*dst_stride] = static_cast<std::int16_t>(static_cast<std::int32_t>(value));
+    }
+  }
+
+  MYDSP_TOOL_CLONES
+  void ConvertFromFloat(const float* src, std::size_t src_stride, float* dst, std::size_t dst_stride, std::size_t count)
+  {
+    for (std::size_t n = 0; n < count; ++n)
+    {
+      dst[n*dst_stride] = src[n*src_stride];
+    }
+  }
+
+  // タイル上の担当チャネル分と作業領域の対応
+  // 作業領域はplanarなら[channel][frame]、そうでなければ[frame][channel]
+  struct TileLayout
+  {
+    std::size_t channels;       // ファイルのチャネル数
+    std::size_t channel_begin;
+    std::size_t group;          // 担当チャネル数
+    std::size_t frames;
+    bool planar;
+
+    // 作業領域側のチャネルchの先頭と、フレーム間の間隔
+    std::size_t Offset(std::size_t ch) const
+    {
+      return planar ? ch * frames : ch;
+    }
+
+    std::size_t Stride(void) const
+    {
+      return planar ? 1 : group;
+    }
+
+    // 全チャネルを1つの連続した領域として変換できるか
+    bool IsContiguous(void) const
+    {
+      return group == channels && !planar;
+    }
+  };
+
+  // インターリーブされたタイルから担当チャネル分を取り出す
+  template <class Sample>
+  void LoadTile(const Sample* src, const TileLayout &layout, float* dst)
+  {
+    src += layout.channel_begin;
+    if (layout.IsContiguous())
+    {
+      ConvertToFloat(src, 1, dst, 1, layout.frames * layout.channels);
+      return;
+    }
+    for (std::size_t ch = 0; ch < layout.group; ++ch)
+    {
+      ConvertToFloat(src + ch, layout.channels, dst + layout.Offset(ch), layout.Stride(), layout.frames);
+    }
+  }
+
+  // 担当チャネル分をインターリーブされたタイルへ書き戻す
+  template <class Sample>
+  void StoreTile(Sample* dst, const TileLayout &layout, const float* src)
+  {
+    dst += layout.channel_begin;
+    if (layout.IsContiguous())
+    {
+      ConvertFromFloat(src, 1, dst, 1, layout.frames * layout.channels);
+      return;
+    }
+    for (std::size_t ch = 0; ch < layout.group; ++ch)
+    {
+      ConvertFromFloat(src + layout.Offset(ch), layout.Stride(), dst + ch, layout.channels, layout.frames);
+    }
+  }
+
+  void LoadTile(const unsigned char* tile, SampleFormat format, const TileLayout &layout, float* dst)
+  {
+    if (format == SampleFormat::Int16)
+    {
+      LoadTile(reinterpret_cast<const std::int16_t*>(tile), layout, dst);
+    }
+    else
+    {
+      LoadTile(reinterpret_cast<const float*>(tile), layout, dst);
+    }
+  }
+
+  void StoreTile(unsigned char* tile, SampleFormat format, const TileLayout &layout, const float* src)
+  {
+    if (format == SampleFormat::Int16)
+    {
+      StoreTile(reinterpret_cast<std::int16_t*>(tile), layout, src);
+    }
+    else
+    {
+      StoreTile(reinterpret_cast<float*>(tile), layout, src);
+    }
+  }
+
+  // スレッドごとの処理
+  struct Worker
+  {
+    std::size_t channel_begin;
+    std::size_t channel_end;
+    std::vector<unsigned char> arena_buffer;
+    GroupChain chain;
+    std::vector<float> interleaved;
+    std::vector<float> planar;
+  };
+
+} /* namespace */
+
+int main(int argc, char** argv)
+{
+  Config config;
+  if (!ParseConfig(argc, argv, config, std::cerr))
+  {
+    PrintUsage(std::cerr, argv[0]);
+    return 2;
+  }
+
+  // ファイルのマップ
+  MappedFile input;
+  if (!input.Open(config.input, config.in_place, std::cerr))
+  {
+    return 1;
+  }
+  MappedFile output;
+  if (!config.in_place && !output.Create(config.output, input.Size(), input, std::cerr))
+  {
+    return 1;
+  }
+  unsigned char* const src = input.Data();
+  unsigned char* const dst = config.in_place ? input.Data() : output.Data();
+
+  const std::size_t frame_bytes = config.channels * SampleBytes(config.format);
+  const std::size_t frames = input.Size() / frame_bytes;
+  const std::size_t remainder = input.Size() - frames * frame_bytes;
+  if (remainder != 0)
+  {
+    std::cerr << "warning: " << remainder << " trailing bytes are copied unchanged\n";
+    if (!config.in_place)
+    {
+      std::memcpy(dst + frames * frame_bytes, src + frames * frame_bytes, remainder);
+    }
+  }
+
+  // タイルとスレッドの構成
+  const std::size_t tile_frames = std::max<std::size_t>(config.tile_kb * 1024 / frame_bytes, 64);
+  std::size_t num_threads = config.threads ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+  num_threads = std::min(num_threads, config.channels);
+
+  std::vector<Worker> workers(num_threads);
+  for (std::size_t t = 0; t < num_threads; ++t)
+  {
+    Worker &worker = workers[t];
+    worker.channel_begin = config.channels * t / num_threads;
+    worker.channel_end = config.channels * (t + 1) / num_threads;
+    const std::size_t num_channels = worker.channel_end - worker.channel_begin;
+
+    // 担当チャネルの全フィルタを1つの領域に確保する
+    worker.arena_buffer.resize(GroupChain::RequiredBytes(config.stages, num_channels) + MyDSP::Arena::Alignment);
+    MyDSP::Arena arena(worker.arena_buffer.data(), worker.arena_buffer.size());
+    if (!worker.chain.Build(arena, config.stages, num_channels))
+    {
+      std::cerr << "failed to allocate filter state\n";
+      return 1;
+    }
+    worker.interleaved.resize(tile_frames * num_channels);
+    worker.planar.resize(tile_frames * num_channels);
+  }
+
+  // 先読みの方法(MADV_POPULATE_*が無い環境ではMADV_WILLNEEDで代用する)
+#ifdef MADV_POPULATE_READ
+  const int populate_read = MADV_POPULATE_READ;
+  const int populate_write = MADV_POPULATE_WRITE;
+#else
+  const int populate_read = MADV_WILLNEED;
+  const int populate_write = MADV_WILLNEED;
+#endif
+
+  // 処理
+  const auto start = std::chrono::steady_clock::now();
+  auto run = [&](std::size_t t)
+  {
+    Worker &worker = workers[t];
+    for (std::size_t frame = 0; frame < frames; frame += tile_frames)
+    {
+      const std::size_t length = std::min(tile_frames, frames - frame);
+      const std::size_t offset = frame * frame_bytes;
+      {
+        // 次のタイルを先にまとめてページテーブルへ載せ、1ページごとのページフォルトを避ける
+        // チャネルはフレームごとに並んでいて各スレッドがタイル全体に触れるので、タイルをスレッド数で分けて分担する
+        // (分担した範囲が間に合わなくても通常のページフォルトになるだけで、待ち合わせは要らない)
+        const std::size_t next_bytes = tile_frames * frame_bytes;
+        const std::size_t next = offset + length * frame_bytes + next_bytes * t / num_threads;
+        const std::size_t share = next_bytes * (t + 1) / num_threads - next_bytes * t / num_threads;
+        AdviseRange(src, input.Size(), next, share, populate_read);
+        AdviseRange(dst, input.Size(), next, share, populate_write);
+      }
+      TileLayout layout = { config.channels, worker.channel_begin, worker.channel_end - worker.channel_begin,
+        length, worker.chain.InputPlanar() };
+      LoadTile(src + offset, config.format, layout, layout.planar ? worker.planar.data() : worker.interleaved.data());
+      layout.planar = worker.chain.Process(worker.interleaved.data(), worker.planar.data(), length, layout.planar);
+      StoreTile(dst + offset, config.format, layout, layout.planar ? worker.planar.data() : worker.interleaved.data());
+    }
+  };
+  std::vector<std::thread> threads;
+  for (std::size_t t = 1; t < num_threads; ++t)
+  {
+    threads.emplace_back(run, t);
+  }
+  run(0);
+  for (std::thread &thread : threads)
+  {
+    thread.join();
+  }
+  const double seconds = std::max(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), 1e-9);
+
+  // 結果の報告
+  const double bytes = static_cast<double>(frames * frame_bytes);
+  std::cout << std::fixed << std::setprecision(3)
+            << "frames: " << frames << ", channels: " << config.channels << ", threads: " << num_threads
+            << ", tile: " << tile_frames << " frames\n"
+            << "elapsed: " << seconds << " s, input: " << bytes / seconds * 1e-9 << " GB/s"
+            << ", read+write: " << 2.0 * bytes / seconds * 1e-9 << " GB/s\n";
+  return 0;
+}
@@ -0,0 +1,117 @@
+/*
+ * ToolsCommon.hpp
+ *
+ *  Created on: 2026/10/18
+ *      Author: Shibasaki
+ *
+ * コマンドラインツール共通処理
+ * フィルタ段の設定と、--fir/--biquadの係数・数値の引数の解析
+ */
+
+#ifndef MYDSP_TOOLS_TOOLSCOMMON_HPP_
+#define MYDSP_TOOLS_TOOLSCOMMON_HPP_
+
+#include <algorithm>
+#include <fstream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdlib>
+
+namespace MyDSPTools
+{
+  // フィルタ段の設定
+  struct StageConfig
+  {
+    enum class Kind
+    {
+      FIR,
+      Biquad
+    } kind;
+    std::vector<float> coeffs; // Biquadの場合は[stage][5]
+  };
+
+  // 係数列の解析
+  // ","(または";"・空白)区切りで並べるか、"@ファイル名"で空白区切りのテキストを読む
+  inline bool ParseCoeffs(const std::string &arg, std::vector<float> &coeffs, std::ostream &err)
+  {
+    std::string text = arg;
+    if (!arg.empty() && arg[0] == '@')
+    {
+      std::ifstream ifs(arg.substr(1));
+      if (!ifs)
+      {
+        err << "cannot open coefficient file: " << arg.substr(1) << "\n";
+        return false;
+      }
+      std::ostringstream oss;
+      oss << ifs.rdbuf();
+      text = oss.str();
+    }
+    std::replace(text.begin(), text.end(), ',', ' ');
+    std::replace(text.begin(), text.end(), ';', ' ');
+    std::istringstream iss(text);
+    std::string token;
+    while (iss >> token)
+    {
+      char* end = nullptr;
+      const float value = std::strtof(token.c_str(), &end);
+      if (end == token.c_str() || *end != '\0')
+      {
+        err << "invalid coefficient: " << token << "\n";
+        return false;
+      }
+      coeffs.push_back(value);
+    }
+    if (coeffs.empty())
+    {
+      err << "empty coefficient list: " << arg << "\n";
+      return false;
+    }
+    return true;
+  }
+
+  inline bool ParseSize(const char* text, std::size_t &value)
+  {
+    char* end = nullptr;
+    const unsigned long long parsed = std::strtoull(text, &end, 10);
+    if (end == text || *end != '\0')
+    {
+      return false;
+    }
+    value = static_cast<std::size_t>(parsed);
+    return true;
+  }
+
+  // フィルタ段を追加するオプション(--fir/--biquad)か
+  inline bool IsStageOption(const std::string &option)
+  {
+    return option == "--fir" || option == "--biquad";
+  }
+
+  // --fir/--biquadの値を解析してフィルタ段を末尾に追加する(指定した順に縦続接続する)
+  // --biquadは5個(b0,b1,b2,a1,a2)ずつの組を複数並べると多段になる
+  inline bool ParseStage(const std::string &option, const char* value, std::vector<StageConfig> &stages,
+    std::ostream &err)
+  {
+    StageConfig stage;
+    stage.kind = (option == "--fir") ? StageConfig::Kind::FIR : StageConfig::Kind::Biquad;
+    if (!ParseCoeffs(value, stage.coeffs, err))
+    {
+      return false;
+    }
+    if (stage.kind == StageConfig::Kind::Biquad && stage.coeffs.size() % 5 != 0)
+    {
+      err << "biquad coefficients should be groups of 5 (b0,b1,b2,a1,a2)\n";
+      return false;
+    }
+    stages.push_back(stage);
+    return true;
+  }
+
+} /* namespace MyDSPTools */
+
+
+#endif /* MYDSP_TOOLS_TOOLSCOMMON_HPP_ */